@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+# Runs the headless locomotion benchmark and checks it against the baselines in
+# Benchmarks/Baselines/<Platform>. Exits non-zero on any stage regression.
+#
+# Usage:
+#   UE_ROOT=/opt/UnrealEngine Scripts/perf_gate.sh [--update-baseline] [extra gate args...]
+#
+# Environment:
+#   UE_ROOT        Engine install (required)
+#   PLS_CHARACTERS Comma-separated crowd sizes       (default: 16,64,256)
+#   PLS_LAYERS     Comma-separated layer configs     (default: None,Lean,Lean+FootIK+Bone)
+#   PLS_RUNS       Independent runs per scenario     (default: 7)
+#   PLS_FRAMES     Measured frames per run           (default: 600)
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+PROJECT_FILE="${PROJECT_DIR}/ProceduralLocomotionSystem.uproject"
+
+if [[ -z "${UE_ROOT:-}" ]]; then
+	echo "UE_ROOT is not set (path to the Unreal Engine install)." >&2
+	exit 2
+fi
+
+EDITOR_CMD="${UE_ROOT}/Engine/Binaries/Linux/UnrealEditor-Cmd"
+RESULT_FILE="${PROJECT_DIR}/Saved/Benchmarks/PerfGate.json"
+
+GATE_ARGS=()
+for arg in "$@"; do
+	case "${arg}" in
+		--update-baseline) GATE_ARGS+=("-UpdateBaseline") ;;
+		*) GATE_ARGS+=("${arg}") ;;
+	esac
+done
+
+"${EDITOR_CMD}" "${PROJECT_FILE}" -run=ProceduralLocomotionBenchmark \
+	-Characters="${PLS_CHARACTERS:-16,64,256}" \
+	-Layers="${PLS_LAYERS:-None,Lean,Lean+FootIK+Bone}" \
+	-Runs="${PLS_RUNS:-7}" \
+	-Frames="${PLS_FRAMES:-600}" \
+	-Output="${RESULT_FILE}" \
+	-unattended -nullrhi -nosplash -stdout
+
+"${EDITOR_CMD}" "${PROJECT_FILE}" -run=ProceduralLocomotionPerfGate \
+	-Result="${RESULT_FILE}" \
+	-BaselineDir="${PROJECT_DIR}/Benchmarks/Baselines" \
+	${GATE_ARGS[@]+"${GATE_ARGS[@]}"} \
+	-unattended -nullrhi -nosplash -stdout
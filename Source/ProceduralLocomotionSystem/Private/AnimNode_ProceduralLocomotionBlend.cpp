@@ -0,0 +1,344 @@
+#include "AnimNode_ProceduralLocomotionBlend.h"
+
+#include "Animation/AnimInstanceProxy.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimationPoseData.h"
+#include "Animation/BlendSpace.h"
+#include "Animation/BlendSpace1D.h"
+#include "AnimationRuntime.h"
+#include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionMarkerIndex.h"
+#include "ProceduralLocomotionSystem.h"
+#include "UObject/ObjectKey.h"
+
+/** Blend space sample weights at evenly spaced points over both axes. */
+struct FProceduralLocomotionBlendGrid
+{
+	// Triangulated blend spaces weight at most three samples and grid ones four.
+	static constexpr int32 MaxSamplesPerCell = 4;
+
+	struct FCell
+	{
+		uint8 SampleIndices[MaxSamplesPerCell] = {};
+		float Weights[MaxSamplesPerCell] = {};
+	};
+
+	int32 NumX = 0;
+	int32 NumY = 0;
+	FVector2f Min = FVector2f::ZeroVector;
+	FVector2f Max = FVector2f::ZeroVector;
+	FVector2f InvCellSize = FVector2f::ZeroVector;
+	bool bWrapX = false;
+	bool bWrapY = false;
+	TArray<FCell> Cells;
+
+	// Per blend space sample; the blend space keeps them alive.
+	TArray<const UAnimSequence*> Samples;
+	TArray<const UProceduralLocomotionMarkerIndex*> MarkerIndices;
+
+	const FCell& GetCell(int32 X, int32 Y) const { return Cells[Y * NumX + X]; }
+};
+
+namespace ProceduralLocomotionBlendGrid
+{
+	using FGrid = FProceduralLocomotionBlendGrid;
+
+	struct FGridKey
+	{
+		TObjectKey<UBlendSpace> BlendSpace;
+		int32 Resolution = 0;
+
+		bool operator==(const FGridKey& Other) const { return BlendSpace == Other.BlendSpace && Resolution == Other.Resolution; }
+		friend uint32 GetTypeHash(const FGridKey& Key) { return HashCombine(GetTypeHash(Key.BlendSpace), ::GetTypeHash(Key.Resolution)); }
+	};
+
+	// Game thread only (OnInitializeAnimInstance). Weak, so a grid goes away with its last node.
+	static TMap<FGridKey, TWeakPtr<const FGrid>> GSharedGrids;
+
+	static float WrapOrClamp(float Value, float Min, float Max, bool bWrap)
+	{
+		if (bWrap && Max > Min)
+		{
+			return Min + FMath::Fmod(FMath::Fmod(Value - Min, Max - Min) + (Max - Min), Max - Min);
+		}
+		return FMath::Clamp(Value, Min, Max);
+	}
+
+	static TSharedPtr<const FGrid> Build(const UBlendSpace& BlendSpace, int32 Resolution)
+	{
+		const int32 NumSamples = BlendSpace.GetBlendSamples().Num();
+		if (NumSamples == 0 || NumSamples > MAX_uint8)
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("Locomotion blend: %s has %d samples; a weight grid needs 1 to %d."),
+				*BlendSpace.GetName(), NumSamples, (int32)MAX_uint8);
+			return nullptr;
+		}
+
+		const bool bOneDimensional = BlendSpace.IsA<UBlendSpace1D>();
+		const FBlendParameter& ParamX = BlendSpace.GetBlendParameter(0);
+		const FBlendParameter& ParamY = BlendSpace.GetBlendParameter(1);
+
+		TSharedPtr<FGrid> Grid = MakeShared<FGrid>();
+		Grid->NumX = Resolution;
+		Grid->NumY = bOneDimensional ? 1 : Resolution;
+		Grid->Min = FVector2f(ParamX.Min, bOneDimensional ? 0.0f : ParamY.Min);
+		Grid->Max = FVector2f(ParamX.Max, bOneDimensional ? 0.0f : ParamY.Max);
+		Grid->InvCellSize.X = (Grid->NumX - 1) / FMath::Max(Grid->Max.X - Grid->Min.X, UE_KINDA_SMALL_NUMBER);
+		Grid->InvCellSize.Y = bOneDimensional ? 0.0f : (Grid->NumY - 1) / FMath::Max(Grid->Max.Y - Grid->Min.Y, UE_KINDA_SMALL_NUMBER);
+		Grid->bWrapX = ParamX.bWrapInput;
+		Grid->bWrapY = !bOneDimensional && ParamY.bWrapInput;
+		Grid->Cells.SetNum(Grid->NumX * Grid->NumY);
+
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		{
+			const UAnimSequence* Animation = BlendSpace.GetBlendSample(SampleIndex).Animation;
+			Grid->Samples.Add(Animation);
+			Grid->MarkerIndices.Add(UProceduralLocomotionMarkerIndex::Find(Animation));
+		}
+
+		TArray<FBlendSampleData> SampleData;
+		int32 CachedTriangulationIndex = INDEX_NONE;
+		for (int32 Y = 0; Y < Grid->NumY; ++Y)
+		{
+			for (int32 X = 0; X < Grid->NumX; ++X)
+			{
+				const FVector Input(
+					FMath::Lerp(Grid->Min.X, Grid->Max.X, (float)X / (Grid->NumX - 1)),
+					Grid->NumY > 1 ? FMath::Lerp(Grid->Min.Y, Grid->Max.Y, (float)Y / (Grid->NumY - 1)) : 0.0f,
+					0.0f);
+
+				SampleData.Reset();
+				if (!BlendSpace.GetSamplesFromBlendInput(Input, SampleData, CachedTriangulationIndex, true))
+				{
+					continue;
+				}
+
+				// Keep the heaviest samples if a blend space ever returns more than a cell holds.
+				SampleData.Sort([](const FBlendSampleData& A, const FBlendSampleData& B) { return A.TotalWeight > B.TotalWeight; });
+				const int32 NumKept = FMath::Min(SampleData.Num(), FGrid::MaxSamplesPerCell);
+				float TotalWeight = 0.0f;
+				for (int32 Kept = 0; Kept < NumKept; ++Kept)
+				{
+					TotalWeight += SampleData[Kept].TotalWeight;
+				}
+
+				FGrid::FCell& Cell = Grid->Cells[Y * Grid->NumX + X];
+				for (int32 Kept = 0; Kept < NumKept && TotalWeight > 0.0f; ++Kept)
+				{
+					Cell.SampleIndices[Kept] = (uint8)SampleData[Kept].SampleDataIndex;
+					Cell.Weights[Kept] = SampleData[Kept].TotalWeight / TotalWeight;
+				}
+			}
+		}
+		return Grid;
+	}
+
+	static TSharedPtr<const FGrid> FindOrBuild(const UBlendSpace& BlendSpace, int32 Resolution)
+	{
+		check(IsInGameThread());
+
+		const FGridKey Key{ TObjectKey<UBlendSpace>(&BlendSpace), Resolution };
+		if (TWeakPtr<const FGrid>* Existing = GSharedGrids.Find(Key))
+		{
+			if (TSharedPtr<const FGrid> Grid = Existing->Pin())
+			{
+				return Grid;
+			}
+		}
+
+		TSharedPtr<const FGrid> Grid = Build(BlendSpace, Resolution);
+		if (Grid)
+		{
+			GSharedGrids.Add(Key, Grid);
+		}
+		return Grid;
+	}
+
+	// Adds Weight x the cell's weights to Out, merging samples that are already in it.
+	template<typename ArrayType>
+	static void AccumulateCell(const FGrid::FCell& Cell, float Weight, ArrayType& Out)
+	{
+		if (Weight <= 0.0f)
+		{
+			return;
+		}
+
+		for (int32 Slot = 0; Slot < FGrid::MaxSamplesPerCell && Cell.Weights[Slot] > 0.0f; ++Slot)
+		{
+			const int32 SampleIndex = Cell.SampleIndices[Slot];
+			auto* Existing = Out.FindByPredicate([SampleIndex](const auto& Active) { return Active.SampleIndex == SampleIndex; });
+			if (Existing)
+			{
+				Existing->Weight += Weight * Cell.Weights[Slot];
+			}
+			else
+			{
+				auto& Added = Out.AddDefaulted_GetRef();
+				Added.SampleIndex = SampleIndex;
+				Added.Weight = Weight * Cell.Weights[Slot];
+			}
+		}
+	}
+
+	// Grid coordinate of Value on one axis: the lower point and the fraction towards the next one.
+	static void Locate(float Value, float Min, float Max, float InvCellSize, int32 NumPoints, bool bWrap, int32& OutIndex, float& OutAlpha)
+	{
+		if (NumPoints < 2)
+		{
+			OutIndex = 0;
+			OutAlpha = 0.0f;
+			return;
+		}
+
+		const float Coordinate = (WrapOrClamp(Value, Min, Max, bWrap) - Min) * InvCellSize;
+		OutIndex = FMath::Clamp(FMath::FloorToInt(Coordinate), 0, NumPoints - 2);
+		OutAlpha = FMath::Clamp(Coordinate - OutIndex, 0.0f, 1.0f);
+	}
+}
+
+void FAnimNode_ProceduralLocomotionBlend::OnInitializeAnimInstance(const FAnimInstanceProxy* InProxy, const UAnimInstance* InAnimInstance)
+{
+	Grid = BlendSpace ? ProceduralLocomotionBlendGrid::FindOrBuild(*BlendSpace, FMath::Clamp(GridResolution, 2, 256)) : nullptr;
+	SampleTimes.Init(0.0f, Grid ? Grid->Samples.Num() : 0);
+}
+
+void FAnimNode_ProceduralLocomotionBlend::Initialize_AnyThread(const FAnimationInitializeContext& Context)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(Initialize_AnyThread);
+	FAnimNode_Base::Initialize_AnyThread(Context);
+
+	ActiveSamples.Reset();
+	NormalizedTime = 0.0f;
+	for (float& SampleTime : SampleTimes)
+	{
+		SampleTime = 0.0f;
+	}
+}
+
+void FAnimNode_ProceduralLocomotionBlend::Update_AnyThread(const FAnimationUpdateContext& Context)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(Update_AnyThread);
+	GetEvaluateGraphExposedInputs().Execute(Context);
+
+	ActiveSamples.Reset();
+	if (!Grid)
+	{
+		return;
+	}
+
+	const UProceduralLocomotionAnimInstance* AnimInstance = Cast<UProceduralLocomotionAnimInstance>(Context.AnimInstanceProxy->GetAnimInstanceObject());
+	if (bUseAnimInstanceInputs && AnimInstance)
+	{
+		Speed = AnimInstance->GetGroundSpeed();
+		Direction = AnimInstance->GetDirection();
+	}
+
+	const float InputX = bDirectionOnHorizontalAxis ? Direction : Speed;
+	const float InputY = bDirectionOnHorizontalAxis ? Speed : Direction;
+
+	int32 X0, Y0;
+	float AlphaX, AlphaY;
+	ProceduralLocomotionBlendGrid::Locate(InputX, Grid->Min.X, Grid->Max.X, Grid->InvCellSize.X, Grid->NumX, Grid->bWrapX, X0, AlphaX);
+	ProceduralLocomotionBlendGrid::Locate(InputY, Grid->Min.Y, Grid->Max.Y, Grid->InvCellSize.Y, Grid->NumY, Grid->bWrapY, Y0, AlphaY);
+	const int32 X1 = FMath::Min(X0 + 1, Grid->NumX - 1);
+	const int32 Y1 = FMath::Min(Y0 + 1, Grid->NumY - 1);
+
+	ProceduralLocomotionBlendGrid::AccumulateCell(Grid->GetCell(X0, Y0), (1.0f - AlphaX) * (1.0f - AlphaY), ActiveSamples);
+	ProceduralLocomotionBlendGrid::AccumulateCell(Grid->GetCell(X1, Y0), AlphaX * (1.0f - AlphaY), ActiveSamples);
+	ProceduralLocomotionBlendGrid::AccumulateCell(Grid->GetCell(X0, Y1), (1.0f - AlphaX) * AlphaY, ActiveSamples);
+	ProceduralLocomotionBlendGrid::AccumulateCell(Grid->GetCell(X1, Y1), AlphaX * AlphaY, ActiveSamples);
+
+	ActiveSamples.RemoveAll([this](const FActiveSample& Active)
+	{
+		return Active.Weight <= ZERO_ANIMWEIGHT_THRESH || !Grid->Samples[Active.SampleIndex];
+	});
+
+	float TotalWeight = 0.0f;
+	float WeightedLength = 0.0f;
+	for (const FActiveSample& Active : ActiveSamples)
+	{
+		TotalWeight += Active.Weight;
+		WeightedLength += Active.Weight * Grid->Samples[Active.SampleIndex]->GetPlayLength();
+	}
+	if (TotalWeight <= 0.0f)
+	{
+		ActiveSamples.Reset();
+		return;
+	}
+
+	if (!bSyncToLocomotionPhase || !AnimInstance)
+	{
+		// Like a sync group: every sample at the same fraction, advancing at the blended length.
+		WeightedLength /= TotalWeight;
+		NormalizedTime = FMath::Frac(NormalizedTime + Context.GetDeltaTime() * PlayRate / FMath::Max(WeightedLength, UE_KINDA_SMALL_NUMBER));
+	}
+
+	const float Phase = AnimInstance ? AnimInstance->GetLocomotionPhase() : 0.0f;
+	for (FActiveSample& Active : ActiveSamples)
+	{
+		Active.Weight /= TotalWeight;
+
+		const float Length = Grid->Samples[Active.SampleIndex]->GetPlayLength();
+		const UProceduralLocomotionMarkerIndex* MarkerIndex = Grid->MarkerIndices[Active.SampleIndex];
+		if (bSyncToLocomotionPhase && AnimInstance)
+		{
+			Active.Time = MarkerIndex
+				? MarkerIndex->GetTimeAtPhase(Phase, SampleTimes[Active.SampleIndex])
+				: Phase * Length;
+		}
+		else
+		{
+			Active.Time = NormalizedTime * Length;
+		}
+		SampleTimes[Active.SampleIndex] = Active.Time;
+	}
+}
+
+void FAnimNode_ProceduralLocomotionBlend::Evaluate_AnyThread(FPoseContext& Output)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(Evaluate_AnyThread);
+
+	if (ActiveSamples.Num() == 0)
+	{
+		Output.ResetToRefPose();
+		return;
+	}
+
+	if (ActiveSamples.Num() == 1)
+	{
+		FAnimationPoseData PoseData(Output);
+		Grid->Samples[ActiveSamples[0].SampleIndex]->GetAnimationPose(PoseData, FAnimExtractContext((double)ActiveSamples[0].Time));
+		return;
+	}
+
+	const int32 NumActive = ActiveSamples.Num();
+	TArray<FCompactPose, TInlineAllocator<8>> Poses;
+	TArray<FBlendedCurve, TInlineAllocator<8>> Curves;
+	TArray<UE::Anim::FStackAttributeContainer, TInlineAllocator<8>> Attributes;
+	TArray<float, TInlineAllocator<8>> Weights;
+	Poses.SetNum(NumActive);
+	Curves.SetNum(NumActive);
+	Attributes.SetNum(NumActive);
+	Weights.SetNum(NumActive);
+
+	for (int32 Index = 0; Index < NumActive; ++Index)
+	{
+		const FActiveSample& Active = ActiveSamples[Index];
+		Poses[Index].SetBoneContainer(&Output.Pose.GetBoneContainer());
+		Curves[Index].InitFrom(Output.Curve);
+		Weights[Index] = Active.Weight;
+
+		FAnimationPoseData PoseData(Poses[Index], Curves[Index], Attributes[Index]);
+		Grid->Samples[Active.SampleIndex]->GetAnimationPose(PoseData, FAnimExtractContext((double)Active.Time));
+	}
+
+	FAnimationPoseData OutputData(Output);
+	FAnimationRuntime::BlendPosesTogether(Poses, Curves, Attributes, Weights, OutputData);
+}
+
+void FAnimNode_ProceduralLocomotionBlend::GatherDebugData(FNodeDebugData& DebugData)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(GatherDebugData);
+	DebugData.AddDebugItem(FString::Printf(TEXT("%s (%s, Speed: %.1f, Direction: %.1f, Samples: %d)"),
+		*DebugData.GetNodeName(this), BlendSpace ? *BlendSpace->GetName() : TEXT("None"), Speed, Direction, ActiveSamples.Num()), true);
+}
@@ -0,0 +1,116 @@
+#include "AnimNode_ProceduralMoCapPose.h"
+
+#include "Animation/AnimInstanceProxy.h"
+#include "BoneContainer.h"
+#include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionStats.h"
+
+namespace
+{
+	const UProceduralLocomotionAnimInstance* GetProceduralAnimInstance(const FAnimInstanceProxy* Proxy)
+	{
+		return Proxy ? Cast<UProceduralLocomotionAnimInstance>(Proxy->GetAnimInstanceObject()) : nullptr;
+	}
+}
+
+void FAnimNode_ProceduralMoCapPose::Initialize_AnyThread(const FAnimationInitializeContext& Context)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(Initialize_AnyThread);
+	FAnimNode_Base::Initialize_AnyThread(Context);
+	Source.Initialize(Context);
+
+	bHasFrame = false;
+	StreamWeight = 0.0f;
+}
+
+void FAnimNode_ProceduralMoCapPose::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(CacheBones_AnyThread);
+	Source.CacheBones(Context);
+
+	CompactBoneIndices.Reset();
+	const UProceduralLocomotionAnimInstance* AnimInstance = GetProceduralAnimInstance(Context.AnimInstanceProxy);
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	const FBoneContainer& RequiredBones = Context.AnimInstanceProxy->GetRequiredBones();
+	for (const FName BoneName : AnimInstance->GetMoCapBoneNames())
+	{
+		FBoneReference BoneReference(BoneName);
+		BoneReference.Initialize(RequiredBones);
+		CompactBoneIndices.Add(BoneReference.IsValidToEvaluate(RequiredBones)
+			? BoneReference.GetCompactPoseIndex(RequiredBones)
+			: FCompactPoseBoneIndex(INDEX_NONE));
+	}
+}
+
+void FAnimNode_ProceduralMoCapPose::Update_AnyThread(const FAnimationUpdateContext& Context)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(Update_AnyThread);
+	GetEvaluateGraphExposedInputs().Execute(Context);
+	Source.Update(Context);
+
+	const UProceduralLocomotionAnimInstance* AnimInstance = GetProceduralAnimInstance(Context.AnimInstanceProxy);
+	FProceduralLocomotionMoCapReceiver* Receiver = AnimInstance ? AnimInstance->GetMoCapReceiver() : nullptr;
+
+	const double Now = FPlatformTime::Seconds();
+	if (Receiver && Receiver->ConsumeLatest(Frame))
+	{
+		bHasFrame = true;
+		SET_FLOAT_STAT(STAT_PLS_MoCapLatencyMs, (float)((Now - Frame.ReceiveTimeSeconds) * 1000.0));
+	}
+
+	const bool bStreamLive = bHasFrame && Receiver && (Now - Frame.ReceiveTimeSeconds) <= StaleTimeout;
+	const float TargetWeight = bStreamLive ? 1.0f : 0.0f;
+	StreamWeight = BlendTime > 0.0f
+		? FMath::FInterpConstantTo(StreamWeight, TargetWeight, Context.GetDeltaTime(), 1.0f / BlendTime)
+		: TargetWeight;
+}
+
+void FAnimNode_ProceduralMoCapPose::Evaluate_AnyThread(FPoseContext& Output)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(Evaluate_AnyThread);
+	Source.Evaluate(Output);
+
+	const float Weight = FMath::Clamp(Alpha, 0.0f, 1.0f) * StreamWeight;
+	if (!bHasFrame || Weight <= ZERO_ANIMWEIGHT_THRESH)
+	{
+		return;
+	}
+
+	const int32 NumBones = FMath::Min(Frame.NumBones, CompactBoneIndices.Num());
+	for (int32 StreamBoneIndex = 0; StreamBoneIndex < NumBones; ++StreamBoneIndex)
+	{
+		const FCompactPoseBoneIndex BoneIndex = CompactBoneIndices[StreamBoneIndex];
+		if (!BoneIndex.IsValid())
+		{
+			continue;
+		}
+
+		FTransform& BoneTransform = Output.Pose[BoneIndex];
+		FTransform Streamed = Frame.BoneTransforms[StreamBoneIndex];
+		if (!bApplyBoneTranslations && StreamBoneIndex > 0)
+		{
+			Streamed.SetTranslation(BoneTransform.GetTranslation());
+		}
+
+		if (Weight >= 1.0f - ZERO_ANIMWEIGHT_THRESH)
+		{
+			BoneTransform = Streamed;
+		}
+		else
+		{
+			BoneTransform.BlendWith(Streamed, Weight);
+		}
+	}
+}
+
+void FAnimNode_ProceduralMoCapPose::GatherDebugData(FNodeDebugData& DebugData)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(GatherDebugData);
+	DebugData.AddDebugItem(FString::Printf(TEXT("%s (Frame: %llu, Weight: %.2f)"),
+		*DebugData.GetNodeName(this), bHasFrame ? Frame.FrameNumber : 0ull, StreamWeight));
+	Source.GatherDebugData(DebugData);
+}
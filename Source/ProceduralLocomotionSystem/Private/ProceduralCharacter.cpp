@@ -1,5 +1,12 @@
 #include "ProceduralCharacter.h"
 #include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionPoseRecordingSubsystem.h"
+#include "ProceduralLocomotionReplaySubsystem.h"
+#include "ProceduralLocomotionSettings.h"
+#include "ProceduralLocomotionStats.h"
+#include "ProceduralLocomotionSystem.h"
+#include "ProceduralLocomotionStreamingSubsystem.h"
+#include "ProceduralLocomotionTelemetrySubsystem.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
@@ -34,11 +41,178 @@ void AProceduralCharacter::BeginPlay()
 	Super::BeginPlay();
 	
 	SetupDefaultMeshAndAnimation();
+
+	SetLODSettings(LODSettings, LODErrorBudget);
+
+	if (UProceduralLocomotionTelemetrySubsystem* Telemetry = GetWorld()->GetSubsystem<UProceduralLocomotionTelemetrySubsystem>())
+	{
+		Telemetry->RegisterCharacter(this);
+	}
+	if (UProceduralLocomotionStreamingSubsystem* Streaming = GetWorld()->GetSubsystem<UProceduralLocomotionStreamingSubsystem>())
+	{
+		Streaming->RegisterCharacter(this);
+	}
+	if (UProceduralLocomotionPoseRecordingSubsystem* Recording = GetWorld()->GetSubsystem<UProceduralLocomotionPoseRecordingSubsystem>())
+	{
+		Recording->RegisterCharacter(this);
+	}
+	if (UProceduralLocomotionReplaySubsystem* Replays = GetWorld()->GetSubsystem<UProceduralLocomotionReplaySubsystem>())
+	{
+		Replays->RegisterCharacter(this);
+	}
+}
+
+void AProceduralCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UProceduralLocomotionTelemetrySubsystem* Telemetry = GetWorld()->GetSubsystem<UProceduralLocomotionTelemetrySubsystem>())
+	{
+		Telemetry->UnregisterCharacter(this);
+	}
+	if (UProceduralLocomotionStreamingSubsystem* Streaming = GetWorld()->GetSubsystem<UProceduralLocomotionStreamingSubsystem>())
+	{
+		Streaming->UnregisterCharacter(this);
+	}
+	if (UProceduralLocomotionPoseRecordingSubsystem* Recording = GetWorld()->GetSubsystem<UProceduralLocomotionPoseRecordingSubsystem>())
+	{
+		Recording->UnregisterCharacter(this);
+	}
+	if (UProceduralLocomotionReplaySubsystem* Replays = GetWorld()->GetSubsystem<UProceduralLocomotionReplaySubsystem>())
+	{
+		Replays->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AProceduralCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	UpdateLODLayers();
+}
+
+void AProceduralCharacter::FaceRotation(FRotator NewControlRotation, float DeltaTime)
+{
+	if (!bUseControllerRotationYaw || !UProceduralLocomotionAnimInstance::IsTurnInPlaceEnabled() || !UProceduralLocomotionAnimInstance::IsCharacterIdle(*this))
+	{
+		Super::FaceRotation(NewControlRotation, DeltaTime);
+		return;
+	}
+
+	// Every rotation moves the capsule, updates the component transforms and dirties replicated
+	// movement, so an idle character aiming around only turns once the aim is far off.
+	const FRotator CurrentRotation = GetActorRotation();
+	const float YawDelta = FMath::FindDeltaAngleDegrees(CurrentRotation.Yaw, NewControlRotation.Yaw);
+	if (FMath::Abs(YawDelta) > TurnInPlaceThreshold)
+	{
+		INC_DWORD_STAT(STAT_PLS_TurnInPlaceSteps);
+		SetActorRotation(FRotator(CurrentRotation.Pitch, NewControlRotation.Yaw, CurrentRotation.Roll));
+	}
+	else if (!FMath::IsNearlyZero(YawDelta))
+	{
+		INC_DWORD_STAT(STAT_PLS_IdleRotationsHeld);
+	}
+}
+
+void AProceduralCharacter::SetLODSettings(UProceduralLocomotionLODSettings* InSettings, float InErrorBudget)
+{
+	LODSettings = InSettings;
+	LODErrorBudget = InErrorBudget;
+
+	const FProceduralLocomotionLODConfig* Config = LODSettings ? LODSettings->FindConfigForErrorBudget(LODErrorBudget) : nullptr;
+	SetLODConfig(Config ? *Config : FProceduralLocomotionLODConfig());
+}
+
+void AProceduralCharacter::SetLODConfig(const FProceduralLocomotionLODConfig& InConfig)
+{
+	ActiveLODConfig = InConfig;
+	ApplyUpdateRateOptimizations();
+}
+
+void AProceduralCharacter::ApplyUpdateRateOptimizations()
+{
+	USkeletalMeshComponent* MeshComp = GetMesh();
+	if (!MeshComp)
+	{
+		return;
+	}
+
+	MeshComp->bEnableUpdateRateOptimizations = ActiveLODConfig.bEnableUpdateRateOptimizations;
+
+	// URO params are created when the mesh registers; patch them if they already exist and
+	// catch any later re-creation through the delegate.
+	MeshComp->OnAnimUpdateRateParamsCreated.BindUObject(this, &AProceduralCharacter::OnAnimUpdateRateParamsCreated);
+	if (MeshComp->AnimUpdateRateParams)
+	{
+		OnAnimUpdateRateParamsCreated(MeshComp->AnimUpdateRateParams);
+	}
+}
+
+void AProceduralCharacter::OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params)
+{
+	if (Params && ActiveLODConfig.UROVisibleDistanceFactorThresholds.Num() > 0)
+	{
+		Params->BaseVisibleDistanceFactorThesholds = ActiveLODConfig.UROVisibleDistanceFactorThresholds;
+	}
+}
+
+void AProceduralCharacter::UpdateLODLayers()
+{
+	USkeletalMeshComponent* MeshComp = GetMesh();
+	UProceduralLocomotionAnimInstance* AnimInstance = MeshComp ? Cast<UProceduralLocomotionAnimInstance>(MeshComp->GetAnimInstance()) : nullptr;
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	// The renderer records every view location it drew from last frame (split-screen included).
+	// With no views, e.g. on a dedicated server, everything stays at full quality.
+	float NearestViewDistanceSq = 0.0f;
+	const TArray<FVector>& ViewLocations = GetWorld()->ViewLocationsRenderedLastFrame;
+	if (ViewLocations.Num() > 0)
+	{
+		const FVector Location = GetActorLocation();
+		NearestViewDistanceSq = TNumericLimits<float>::Max();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			NearestViewDistanceSq = FMath::Min(NearestViewDistanceSq, FVector::DistSquared(Location, ViewLocation));
+		}
+	}
+
+	AnimInstance->SetLODLayers(ActiveLODConfig.GetLayersForDistance(FMath::Sqrt(NearestViewDistanceSq)));
+}
+
+const FProceduralLocomotionPoseSnapshot* AProceduralCharacter::GetPoseSnapshot() const
+{
+	const USkeletalMeshComponent* MeshComp = GetMesh();
+	const UProceduralLocomotionAnimInstance* AnimInstance = MeshComp ? Cast<UProceduralLocomotionAnimInstance>(MeshComp->GetAnimInstance()) : nullptr;
+	return AnimInstance ? &AnimInstance->GetPoseSnapshot() : nullptr;
+}
+
+int32 AProceduralCharacter::GetPoseSnapshotSlot(FName BoneName) const
+{
+	const FProceduralLocomotionPoseSnapshot* Snapshot = GetPoseSnapshot();
+	return Snapshot ? Snapshot->FindSlot(BoneName) : INDEX_NONE;
+}
+
+bool AProceduralCharacter::GetPoseSnapshotTransform(int32 Slot, FTransform& OutTransform) const
+{
+	const FProceduralLocomotionPoseSnapshot* Snapshot = GetPoseSnapshot();
+	return Snapshot && Snapshot->GetBoneTransform(Slot, OutTransform);
+}
+
+bool AProceduralCharacter::GetPoseSnapshotTransformByName(FName BoneName, FTransform& OutTransform) const
+{
+	return GetPoseSnapshotTransform(GetPoseSnapshotSlot(BoneName), OutTransform);
+}
+
+void AProceduralCharacter::AddHitReaction(const FVector& WorldDirection, float Strength)
+{
+	USkeletalMeshComponent* MeshComp = GetMesh();
+	if (UProceduralLocomotionAnimInstance* AnimInstance = MeshComp ? Cast<UProceduralLocomotionAnimInstance>(MeshComp->GetAnimInstance()) : nullptr)
+	{
+		AnimInstance->AddHitReaction(WorldDirection, Strength);
+	}
 }
 
 void AProceduralCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -58,15 +232,20 @@ void AProceduralCharacter::SetupDefaultMeshAndAnimation()
 	// via the Blueprint derived from this class or directly on instances.
 	// The AnimInstance is already set in the constructor.
 	
-	// If no mesh is assigned, try to load a default (UE5 Mannequin)
+	// If no mesh is assigned, fall back to the project default. The module prewarm normally has
+	// it resident already; otherwise this is a synchronous load on first spawn.
 	if (!MeshComp->GetSkeletalMeshAsset())
 	{
-		static ConstructorHelpers::FObjectFinder<USkeletalMesh> MeshFinder(
-			TEXT("/Engine/EngineMeshes/SkeletalCube")
-		);
-		if (MeshFinder.Succeeded())
+		const TSoftObjectPtr<USkeletalMesh>& DefaultMesh = UProceduralLocomotionSettings::Get()->DefaultCharacterMesh;
+		USkeletalMesh* Mesh = DefaultMesh.Get();
+		if (!Mesh && !DefaultMesh.IsNull())
+		{
+			UE_LOG(LogProceduralLocomotion, Verbose, TEXT("%s: default mesh %s was not prewarmed, loading synchronously"), *GetName(), *DefaultMesh.ToString());
+			Mesh = DefaultMesh.LoadSynchronous();
+		}
+		if (Mesh)
 		{
-			MeshComp->SetSkeletalMesh(MeshFinder.Object);
+			MeshComp->SetSkeletalMesh(Mesh);
 		}
 	}
 }
@@ -3,6 +3,57 @@
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
 								#include "Components/SkeletalMeshComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "ProceduralLocomotionMarkerIndex.h"
+#include "ProceduralLocomotionMath.h"
+#include "ProceduralLocomotionSettings.h"
+#include "ProceduralLocomotionStats.h"
+#include "ProceduralLocomotionStreamingSubsystem.h"
+
+// Layer toggles, used by the benchmark to measure layer configurations and handy for A/B checks in game.
+static TAutoConsoleVariable<bool> CVarTurnInPlaceEnabled(
+	TEXT("pls.TurnInPlace.Enable"),
+	true,
+	TEXT("Holds idle AProceduralCharacters' yaw until their aim passes TurnInPlaceThreshold, with UProceduralLocomotionAnimInstance playing the turns; off, they follow the aim every frame."));
+
+static TAutoConsoleVariable<bool> CVarProceduralLeaningEnabled(
+	TEXT("pls.Leaning.Enable"),
+	true,
+	TEXT("Enables the procedural leaning layer of UProceduralLocomotionAnimInstance."));
+
+static TAutoConsoleVariable<bool> CVarProceduralBoneEnabled(
+	TEXT("pls.ProceduralBone.Enable"),
+	true,
+	TEXT("Enables the procedural bone oscillation layer of UProceduralLocomotionAnimInstance."));
+
+static TAutoConsoleVariable<bool> CVarFootIKEnabled(
+	TEXT("pls.FootIK.Enable"),
+	true,
+	TEXT("Enables the foot IK ground traces of UProceduralLocomotionAnimInstance."));
+
+static TAutoConsoleVariable<bool> CVarMarkerSyncEnabled(
+	TEXT("pls.MarkerSync.Enable"),
+	true,
+	TEXT("Enables marker-index sync of UProceduralLocomotionAnimInstance::MarkerSyncSequences."));
+
+static TAutoConsoleVariable<bool> CVarHitReactionEnabled(
+	TEXT("pls.HitReaction.Enable"),
+	true,
+	TEXT("Enables the spring hit reactions of UProceduralLocomotionAnimInstance; while off, AddHitReaction is ignored."));
+
+namespace
+{
+	// Aligns a foot to the surface: roll from the normal's Y tilt, pitch from its X tilt.
+	FRotator GetFootRotation(const FVector& Normal)
+	{
+		return FRotator(
+			-FMath::RadiansToDegrees(FMath::Atan2(Normal.X, Normal.Z)),
+			0.0f,
+			FMath::RadiansToDegrees(FMath::Atan2(Normal.Y, Normal.Z)));
+	}
+}
 
 UProceduralLocomotionAnimInstance::UProceduralLocomotionAnimInstance() = default;
 
@@ -14,71 +65,707 @@ void UProceduralLocomotionAnimInstance::NativeInitializeAnimation()
 	if (CachedCharacter.IsValid())
 	{
 		LastYawDegrees = CachedCharacter->GetActorRotation().Yaw;
+		LastActorYaw = LastYawDegrees;
+	}
+
+	CacheMarkerSyncIndices();
+
+	const UWorld* World = GetWorld();
+	ClipStreaming = World ? World->GetSubsystem<UProceduralLocomotionStreamingSubsystem>() : nullptr;
+	GroundQueries = World ? World->GetSubsystem<UProceduralLocomotionGroundQuerySubsystem>() : nullptr;
+
+	// Editor previews and commandlets never listen, so they can't steal a stage performer's port.
+	if (bEnableMoCap && !MoCapReceiver && World && World->IsGameWorld())
+	{
+		MoCapReceiver = MakeUnique<FProceduralLocomotionMoCapReceiver>(MoCapPort, MoCapSubjectId);
+		if (!MoCapReceiver->Start())
+		{
+			MoCapReceiver.Reset();
+		}
 	}
 }
 
+void UProceduralLocomotionAnimInstance::NativeUninitializeAnimation()
+{
+	// Parallel evaluation has completed by now, so nothing is consuming from the receiver.
+	MoCapReceiver.Reset();
+
+	Super::NativeUninitializeAnimation();
+}
+
 void UProceduralLocomotionAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 {
 	Super::NativeUpdateAnimation(DeltaSeconds);
 
-	if (DeltaSeconds <= 0.0f)
+	FProceduralLocomotionAnimInput Input;
+	if (bReplayControlled)
 	{
-		return;
+		if (!bHasReplayInput)
+		{
+			return;
+		}
+		Input = ReplayInput;
+		bHasReplayInput = false;
+		PendingHitImpulse = FVector2f::ZeroVector;
 	}
-
-	ACharacter* Character = CachedCharacter.Get();
-	if (!Character)
+	else
 	{
-		Character = Cast<ACharacter>(TryGetPawnOwner());
-		CachedCharacter = Character;
-		if (!Character)
+		if (DeltaSeconds <= 0.0f)
 		{
 			return;
 		}
+
+		ACharacter* Character = CachedCharacter.Get();
+		if (!Character)
+		{
+			Character = Cast<ACharacter>(TryGetPawnOwner());
+			CachedCharacter = Character;
+			if (!Character)
+			{
+				return;
+			}
+		}
+		GatherInput(*Character, DeltaSeconds, Input);
+		Input.HitImpulse = PendingHitImpulse;
+		PendingHitImpulse = FVector2f::ZeroVector;
 	}
 
-	const UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
-	const FVector Velocity = MoveComp ? MoveComp->Velocity : Character->GetVelocity();
-	const FVector HorizontalVelocity(Velocity.X, Velocity.Y, 0.0f);
+	LastInput = Input;
+	++UpdateCount;
 
-	GroundSpeed = HorizontalVelocity.Size();
+	{
+		PLS_SCOPE_STAGE(Locomotion);
+
+		const FVector HorizontalVelocity(Input.Velocity.X, Input.Velocity.Y, 0.0f);
+
+		GroundSpeed = HorizontalVelocity.Size();
 
-	// Direction relative to the actor's facing (commonly fed into BlendSpaces)
-	Direction = CalculateDirection(HorizontalVelocity, Character->GetActorRotation());
+		// Direction relative to the actor's facing (commonly fed into BlendSpaces)
+		Direction = CalculateDirection(HorizontalVelocity, FRotator(Input.Rotation));
 
-	bIsAccelerating = MoveComp && (MoveComp->GetCurrentAcceleration().SizeSquared() > KINDA_SMALL_NUMBER);
+		bIsAccelerating = Input.Acceleration.SizeSquared() > KINDA_SMALL_NUMBER;
+
+		if (StrideLength > KINDA_SMALL_NUMBER)
+		{
+			LocomotionPhase = FMath::Frac(LocomotionPhase + GroundSpeed * Input.DeltaSeconds / StrideLength);
+		}
+
+		UpdateTurnInPlace(Input);
+
+		UpdateLocomotionClip();
+	}
 
-	UpdateProceduralLeaning(DeltaSeconds);
+	if (MarkerSyncIndices.Num() > 0 && CVarMarkerSyncEnabled.GetValueOnGameThread())
+	{
+		PLS_SCOPE_STAGE(MarkerSync);
+		UpdateMarkerSync();
+	}
+
+	{
+		PLS_SCOPE_STAGE(Leaning);
+		if (Input.Layers.bLeaning)
+		{
+			UpdateProceduralLeaning(Input);
+		}
+
+		// Hit reactions are upper-body perturbations like the lean, so they share its stage.
+		UpdateHitReaction(Input);
+	}
+
+	{
+		PLS_SCOPE_STAGE(FootIK);
+		UpdateFootIK(Input);
+	}
 
 	// Simple demo: rotate a named bone procedurally so you can
 	// produce an animation without external assets.
-	UpdateProceduralBone(DeltaSeconds);
+	if (Input.Layers.bProceduralBone)
+	{
+		PLS_SCOPE_STAGE(ProceduralBone);
+		UpdateProceduralBone(Input.DeltaSeconds);
+	}
 }
 
-void UProceduralLocomotionAnimInstance::UpdateProceduralLeaning(float DeltaSeconds)
+void UProceduralLocomotionAnimInstance::GatherInput(const ACharacter& Character, float DeltaSeconds, FProceduralLocomotionAnimInput& OutInput) const
 {
-	ACharacter* Character = CachedCharacter.Get();
-	if (!Character)
+	const UCharacterMovementComponent* MoveComp = Character.GetCharacterMovement();
+	OutInput.DeltaSeconds = DeltaSeconds;
+	OutInput.Location = Character.GetActorLocation();
+	OutInput.Rotation = FRotator3f(Character.GetActorRotation());
+	OutInput.AimYaw = Character.GetController() ? (float)Character.GetControlRotation().Yaw : OutInput.Rotation.Yaw;
+	OutInput.Velocity = FVector3f(MoveComp ? MoveComp->Velocity : Character.GetVelocity());
+	OutInput.Acceleration = MoveComp ? FVector3f(MoveComp->GetCurrentAcceleration()) : FVector3f::ZeroVector;
+	OutInput.bIdle = IsCharacterIdle(Character);
+	OutInput.bTurnInPlace = bEnableTurnInPlace && IsTurnInPlaceEnabled();
+
+	// The base UCharacterMovementComponent keeps the character on, with its (bone) transform.
+	const FBasedMovementInfo& BasedMovement = Character.GetBasedMovement();
+	if (UPrimitiveComponent* MovementBase = BasedMovement.MovementBase)
+	{
+		FVector BaseLocation;
+		FQuat BaseRotation;
+		if (MovementBaseUtility::GetMovementBaseTransform(MovementBase, BasedMovement.BoneName, BaseLocation, BaseRotation))
+		{
+			OutInput.BaseId = MovementBase->GetUniqueID();
+			OutInput.BaseLocation = BaseLocation;
+			OutInput.BaseRotation = FQuat4f(BaseRotation);
+		}
+	}
+
+	OutInput.Layers.bLeaning = LODLayers.bLeaning && CVarProceduralLeaningEnabled.GetValueOnGameThread();
+	OutInput.Layers.bProceduralBone = LODLayers.bProceduralBone && CVarProceduralBoneEnabled.GetValueOnGameThread();
+	OutInput.Layers.bFootIK = LODLayers.bFootIK && CVarFootIKEnabled.GetValueOnGameThread();
+
+	const USkeletalMeshComponent* MeshComp = GetSkelMeshComponent();
+	if (OutInput.Layers.bFootIK && MeshComp)
+	{
+		if (!LeftFootBoneName.IsNone())
+		{
+			OutInput.LeftFootTrace = FVector2f(FVector2D(MeshComp->GetSocketLocation(LeftFootBoneName)));
+		}
+		if (!RightFootBoneName.IsNone())
+		{
+			OutInput.RightFootTrace = FVector2f(FVector2D(MeshComp->GetSocketLocation(RightFootBoneName)));
+		}
+	}
+
+	UProceduralLocomotionGroundQuerySubsystem* Queries = GroundQueries.Get();
+	if (OutInput.Layers.bFootIK && Queries && UProceduralLocomotionGroundQuerySubsystem::IsEnabled())
+	{
+		OutInput.bScheduledGroundQueries = true;
+		Queries->ConsumeResult(this, 0, OutInput.LeftFootGround);
+		Queries->ConsumeResult(this, 1, OutInput.RightFootGround);
+	}
+}
+
+bool UProceduralLocomotionAnimInstance::IsCharacterIdle(const ACharacter& Character)
+{
+	const UCharacterMovementComponent* MoveComp = Character.GetCharacterMovement();
+	return MoveComp && MoveComp->IsMovingOnGround()
+		&& MoveComp->Velocity.SizeSquared2D() <= KINDA_SMALL_NUMBER
+		&& MoveComp->GetCurrentAcceleration().IsNearlyZero();
+}
+
+bool UProceduralLocomotionAnimInstance::IsTurnInPlaceEnabled()
+{
+	return CVarTurnInPlaceEnabled.GetValueOnGameThread();
+}
+
+FProceduralLocomotionAnimState UProceduralLocomotionAnimInstance::GetLayerState() const
+{
+	FProceduralLocomotionAnimState State;
+	State.LocomotionPhase = LocomotionPhase;
+	State.LeanAngle = LeanAngle;
+	State.LastYawDegrees = LastYawDegrees;
+	State.ProceduralTime = ProceduralTime;
+	State.LeftFootOffset = LeftFootOffset;
+	State.RightFootOffset = RightFootOffset;
+	State.PelvisOffset = PelvisOffset;
+	State.FootIKAlpha = FootIKAlpha;
+	State.RootYawOffset = RootYawOffset;
+	State.LastActorYaw = LastActorYaw;
+	State.TurnInPlaceYaw = TurnInPlaceYaw;
+	State.bTurningInPlace = bTurningInPlace;
+	State.bWasIdle = bWasIdle;
+	State.LeftFootRotation = LeftFootRotation;
+	State.RightFootRotation = RightFootRotation;
+	State.LeftFootPlant = LeftFootPlant;
+	State.RightFootPlant = RightFootPlant;
+	State.HitSprings = HitSprings;
+	return State;
+}
+
+void UProceduralLocomotionAnimInstance::SetLayerState(const FProceduralLocomotionAnimState& State)
+{
+	LocomotionPhase = State.LocomotionPhase;
+	LeanAngle = State.LeanAngle;
+	LastYawDegrees = State.LastYawDegrees;
+	ProceduralTime = State.ProceduralTime;
+	LeftFootOffset = State.LeftFootOffset;
+	RightFootOffset = State.RightFootOffset;
+	PelvisOffset = State.PelvisOffset;
+	FootIKAlpha = State.FootIKAlpha;
+	RootYawOffset = State.RootYawOffset;
+	LastActorYaw = State.LastActorYaw;
+	TurnInPlaceYaw = State.TurnInPlaceYaw;
+	bTurningInPlace = State.bTurningInPlace;
+	bWasIdle = State.bWasIdle;
+	LeftFootRotation = State.LeftFootRotation;
+	RightFootRotation = State.RightFootRotation;
+	LeftFootPlant = State.LeftFootPlant;
+	RightFootPlant = State.RightFootPlant;
+	HitSprings = State.HitSprings;
+	// The next update recomputes the rotations and clears this again if the springs are at rest.
+	bHitReactionActive = HitSprings.Num() > 0;
+}
+
+void UProceduralLocomotionAnimInstance::SetReplayControlled(bool bInReplayControlled)
+{
+	bReplayControlled = bInReplayControlled;
+	bHasReplayInput = false;
+}
+
+void UProceduralLocomotionAnimInstance::PushReplayInput(const FProceduralLocomotionAnimInput& Input)
+{
+	ReplayInput = Input;
+	bHasReplayInput = true;
+}
+
+void UProceduralLocomotionAnimInstance::AddHitReaction(const FVector& WorldDirection, float Strength)
+{
+	const AActor* Owner = GetOwningActor();
+	if (!Owner || !CVarHitReactionEnabled.GetValueOnGameThread())
+	{
+		return;
+	}
+
+	FVector LocalDirection = Owner->GetActorRotation().UnrotateVector(WorldDirection);
+	LocalDirection.Z = 0.0;
+	if (!LocalDirection.Normalize())
 	{
 		return;
 	}
+	PendingHitImpulse += FVector2f(FVector2D(LocalDirection)) * Strength;
+}
+
+void UProceduralLocomotionAnimInstance::NativePostEvaluateAnimation()
+{
+	Super::NativePostEvaluateAnimation();
 
-	const UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
-	const FVector WorldAccel = MoveComp ? MoveComp->GetCurrentAcceleration() : FVector::ZeroVector;
+	// Runs on the game thread once evaluation has finished and the component's buffers have
+	// been swapped, so the component-space pose here is the completed frame.
+	const USkeletalMeshComponent* MeshComp = GetSkelMeshComponent();
+	if (!MeshComp || SnapshotBoneNames.Num() == 0)
+	{
+		return;
+	}
+
+	const USkeletalMesh* Mesh = MeshComp->GetSkeletalMeshAsset();
+	if (!Mesh)
+	{
+		return;
+	}
+
+	if (PoseSnapshotMesh.Get() != Mesh)
+	{
+		PoseSnapshot.Initialize(SnapshotBoneNames, *MeshComp);
+		PoseSnapshotMesh = Mesh;
+	}
+
+	PoseSnapshot.Publish(*MeshComp, GFrameCounter);
+}
+
+void UProceduralLocomotionAnimInstance::UpdateTurnInPlace(const FProceduralLocomotionAnimInput& Input)
+{
+	const float ActorYaw = Input.Rotation.Yaw;
+	const float ActorYawDelta = FMath::FindDeltaAngleDegrees(LastActorYaw, ActorYaw);
+	LastActorYaw = ActorYaw;
+	const bool bStartedMoving = bWasIdle && !Input.bIdle;
+	bWasIdle = Input.bIdle;
+
+	if (!Input.bTurnInPlace)
+	{
+		// The actor follows the aim every frame, so the mesh simply follows the actor.
+		RootYawOffset = 0.0f;
+		bTurningInPlace = false;
+		TurnInPlaceYaw = 0.0f;
+		AimYawOffset = FMath::FindDeltaAngleDegrees(ActorYaw, Input.AimYaw);
+		return;
+	}
+
+	// The mesh keeps its facing while idle and through the snap to the held aim that
+	// AProceduralCharacter::FaceRotation makes on the first moving frame. After that it turns
+	// with the actor, so the lean and Direction see the facing the player sees.
+	if (Input.bIdle || bStartedMoving)
+	{
+		RootYawOffset = FRotator3f::NormalizeAxis(RootYawOffset - ActorYawDelta);
+	}
+
+	if (!Input.bIdle)
+	{
+		// Moving characters face where they go, so the mesh catches up with the actor.
+		RootYawOffset = FMath::FInterpTo(RootYawOffset, 0.0f, Input.DeltaSeconds, RootYawOffsetInterpSpeed);
+		bTurningInPlace = false;
+		TurnInPlaceYaw = 0.0f;
+	}
+	else
+	{
+		if (!bTurningInPlace && FMath::Abs(RootYawOffset) > TurnInPlaceMinAngle)
+		{
+			bTurningInPlace = true;
+			TurnInPlaceYaw = -RootYawOffset;
+		}
+
+		if (bTurningInPlace)
+		{
+			const float TurnStep = TurnInPlaceRate * Input.DeltaSeconds;
+			if (FMath::Abs(RootYawOffset) <= TurnStep)
+			{
+				RootYawOffset = 0.0f;
+				bTurningInPlace = false;
+				TurnInPlaceYaw = 0.0f;
+			}
+			else
+			{
+				RootYawOffset -= FMath::Sign(RootYawOffset) * TurnStep;
+			}
+		}
+	}
+
+	AimYawOffset = FMath::FindDeltaAngleDegrees(ActorYaw + RootYawOffset, Input.AimYaw);
+}
 
+void UProceduralLocomotionAnimInstance::UpdateProceduralLeaning(const FProceduralLocomotionAnimInput& Input)
+{
 	// Convert acceleration into local space so +Y means "accelerating to the right" relative to facing.
-	const FTransform ActorTransform(Character->GetActorRotation(), Character->GetActorLocation());
-	const FVector LocalAccel = ActorTransform.InverseTransformVectorNoScale(WorldAccel);
+	const FTransform ActorTransform(FRotator(Input.Rotation), Input.Location);
+	const FVector LocalAccel = ActorTransform.InverseTransformVectorNoScale(FVector(Input.Acceleration));
+
+	// Yaw rate of the mesh rather than the actor: a turn-in-place step snaps the actor by 90
+	// degrees or more in one frame while the mesh turns over the following ones.
+	const float CurrentYaw = FRotator3f::NormalizeAxis(Input.Rotation.Yaw + RootYawOffset);
+	if (Profile)
+	{
+		LeanAngle = ProceduralLocomotionMath::StepLean(LeanAngle, LastYawDegrees, CurrentYaw, (float)LocalAccel.Y, GroundSpeed, Input.DeltaSeconds,
+			GetLeanParams(), Profile->GetLeanResponse());
+	}
+	else
+	{
+		LeanAngle = ProceduralLocomotionMath::StepLean(LeanAngle, LastYawDegrees, CurrentYaw, (float)LocalAccel.Y, Input.DeltaSeconds, GetLeanParams());
+	}
+}
+
+ProceduralLocomotionMath::FLeanParams UProceduralLocomotionAnimInstance::GetLeanParams() const
+{
+	if (Profile)
+	{
+		return Profile->GetLeanParams();
+	}
+
+	ProceduralLocomotionMath::FLeanParams LeanParams;
+	LeanParams.MaxLeanAngle = MaxLeanAngle;
+	LeanParams.AccelerationLeanMultiplier = AccelerationLeanMultiplier;
+	LeanParams.YawRateLeanMultiplier = YawRateLeanMultiplier;
+	LeanParams.LeanInterpSpeed = LeanInterpSpeed;
+	return LeanParams;
+}
+
+ProceduralLocomotionMath::FBoneOscillationParams UProceduralLocomotionAnimInstance::GetProceduralBoneParams() const
+{
+	ProceduralLocomotionMath::FBoneOscillationParams OscillationParams;
+	OscillationParams.PitchAmplitude = ProceduralBonePitchAmplitude;
+	OscillationParams.YawAmplitude = ProceduralBoneYawAmplitude;
+	OscillationParams.Speed = ProceduralBoneSpeed;
+	return OscillationParams;
+}
+
+void UProceduralLocomotionAnimInstance::SetMarkerSyncSequences(const TArray<UAnimSequenceBase*>& Sequences)
+{
+	MarkerSyncSequences.Reset();
+	MarkerSyncSequences.Append(Sequences);
+	CacheMarkerSyncIndices();
+}
+
+void UProceduralLocomotionAnimInstance::UpdateLocomotionClip()
+{
+	const FProceduralLocomotionClip* Clip = Profile ? Profile->FindClipForSpeed(GroundSpeed) : nullptr;
+	LocomotionClipState = Clip ? Clip->State : NAME_None;
+
+	// With streaming on, only clips the subsystem holds count, so an evicted clip is let go here too.
+	const UProceduralLocomotionStreamingSubsystem* Streaming = ClipStreaming.Get();
+	if (!Clip)
+	{
+		LocomotionClip = nullptr;
+	}
+	else if (Streaming && UProceduralLocomotionSettings::Get()->bStreamLocomotionClips)
+	{
+		LocomotionClip = Streaming->GetResidentClip(Clip->Sequence);
+	}
+	else
+	{
+		LocomotionClip = Clip->Sequence.Get();
+	}
+	bLocomotionClipReady = LocomotionClip != nullptr;
+}
+
+void UProceduralLocomotionAnimInstance::CacheMarkerSyncIndices()
+{
+	MarkerSyncIndices.Reset();
+	for (const UAnimSequenceBase* Sequence : MarkerSyncSequences)
+	{
+		MarkerSyncIndices.Add(UProceduralLocomotionMarkerIndex::Find(Sequence));
+	}
+	MarkerSyncTimes.Init(0.0f, MarkerSyncSequences.Num());
+	TimeToLeftFootPlant = -1.0f;
+	TimeToRightFootPlant = -1.0f;
+}
+
+void UProceduralLocomotionAnimInstance::UpdateMarkerSync()
+{
+	// Each clip's time for the shared phase; hinting with last frame's time keeps a clip with
+	// several cycles in the one it is playing.
+	for (int32 Index = 0; Index < MarkerSyncIndices.Num(); ++Index)
+	{
+		if (const UProceduralLocomotionMarkerIndex* MarkerIndex = MarkerSyncIndices[Index])
+		{
+			MarkerSyncTimes[Index] = MarkerIndex->GetTimeAtPhase(LocomotionPhase, MarkerSyncTimes[Index]);
+		}
+	}
+
+	const UProceduralLocomotionMarkerIndex* FirstIndex = MarkerSyncIndices[0];
+	TimeToLeftFootPlant = FirstIndex ? GetTimeToFootPlant(*FirstIndex, LeftFootMarkerName) : -1.0f;
+	TimeToRightFootPlant = FirstIndex ? GetTimeToFootPlant(*FirstIndex, RightFootMarkerName) : -1.0f;
+}
+
+float UProceduralLocomotionAnimInstance::GetTimeToFootPlant(const UProceduralLocomotionMarkerIndex& Index, FName MarkerName) const
+{
+	const float ClipTime = MarkerSyncTimes[0];
+	const float ClipTimeToPlant = Index.GetTimeUntilMarker(MarkerName, ClipTime);
+	if (ClipTimeToPlant < 0.0f || GroundSpeed <= KINDA_SMALL_NUMBER || StrideLength <= KINDA_SMALL_NUMBER)
+	{
+		return -1.0f;
+	}
+
+	// Playback follows distance, so convert the remaining phase to time at the current speed.
+	const float PhaseToPlant = FMath::Frac(Index.GetPhaseAtTime(ClipTime + ClipTimeToPlant) - LocomotionPhase);
+	return PhaseToPlant * StrideLength / GroundSpeed;
+}
+
+void UProceduralLocomotionAnimInstance::UpdateFootIK(const FProceduralLocomotionAnimInput& Input)
+{
+	const float DeltaSeconds = Input.DeltaSeconds;
+	if (!Input.Layers.bFootIK)
+	{
+		// Hold the last offsets and fade the IK out instead of snapping the feet. The plants may be
+		// stale by the time the layer comes back, so they are traced again then.
+		FootIKAlpha = FMath::FInterpTo(FootIKAlpha, 0.0f, DeltaSeconds, FootIKInterpSpeed);
+		LeftFootPlant.bValid = false;
+		RightFootPlant.bValid = false;
+		return;
+	}
+
+	ACharacter* Character = CachedCharacter.Get();
+	if (!Character || !GetSkelMeshComponent())
+	{
+		return;
+	}
+
+	const float CapsuleBottomZ = Input.Location.Z - Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	const FTransform BaseTransform(FQuat(Input.BaseRotation), Input.BaseLocation);
+	FRotator LeftTargetRotation = FRotator::ZeroRotator;
+	FRotator RightTargetRotation = FRotator::ZeroRotator;
+	const float LeftTarget = LeftFootBoneName.IsNone() ? 0.0f
+		: UpdateFootPlant(LeftFootPlant, 0, Input.LeftFootTrace, LeftFootTraceDistance, CapsuleBottomZ, Input, BaseTransform, LeftTargetRotation);
+	const float RightTarget = RightFootBoneName.IsNone() ? 0.0f
+		: UpdateFootPlant(RightFootPlant, 1, Input.RightFootTrace, RightFootTraceDistance, CapsuleBottomZ, Input, BaseTransform, RightTargetRotation);
+
+	LeftFootOffset = FMath::FInterpTo(LeftFootOffset, LeftTarget, DeltaSeconds, FootIKInterpSpeed);
+	RightFootOffset = FMath::FInterpTo(RightFootOffset, RightTarget, DeltaSeconds, FootIKInterpSpeed);
+	PelvisOffset = FMath::FInterpTo(PelvisOffset, FMath::Min3(LeftTarget, RightTarget, 0.0f), DeltaSeconds, FootIKInterpSpeed);
+	LeftFootRotation = FMath::RInterpTo(LeftFootRotation, LeftTargetRotation, DeltaSeconds, FootIKInterpSpeed);
+	RightFootRotation = FMath::RInterpTo(RightFootRotation, RightTargetRotation, DeltaSeconds, FootIKInterpSpeed);
+	FootIKAlpha = FMath::FInterpTo(FootIKAlpha, 1.0f, DeltaSeconds, FootIKInterpSpeed);
+}
+
+void UProceduralLocomotionAnimInstance::UpdateHitReaction(const FProceduralLocomotionAnimInput& Input)
+{
+	const int32 NumBones = HitReactionBones.Num();
+	if (HitSprings.Num() != NumBones || HitReactionRotations.Num() != NumBones)
+	{
+		HitSprings.SetNumZeroed(NumBones);
+		HitReactionRotations.Init(FRotator::ZeroRotator, NumBones);
+	}
+
+	// Nearly every character is at rest on nearly every frame; they cost one branch.
+	const bool bHasImpulse = !Input.HitImpulse.IsZero();
+	if ((!bHitReactionActive && !bHasImpulse) || Input.DeltaSeconds <= 0.0f)
+	{
+		return;
+	}
+
+	// Bends are in actor space; the rotations go to the ABP in component space.
+	const USkeletalMeshComponent* MeshComp = GetSkelMeshComponent();
+	const FRotator MeshRotation = MeshComp ? MeshComp->GetRelativeRotation() : FRotator::ZeroRotator;
+
+	bool bAnyActive = false;
+	for (int32 Index = 0; Index < NumBones; ++Index)
+	{
+		const FProceduralLocomotionHitReactionBone& Bone = HitReactionBones[Index];
+		FVector4f& Spring = HitSprings[Index];
+		Spring.Z += Input.HitImpulse.X * Bone.Weight;
+		Spring.W += Input.HitImpulse.Y * Bone.Weight;
+
+		ProceduralLocomotionMath::FSpringParams SpringParams;
+		SpringParams.Stiffness = Bone.Stiffness;
+		SpringParams.DampingRatio = Bone.DampingRatio;
+		ProceduralLocomotionMath::StepSpring(Spring.X, Spring.Z, Input.DeltaSeconds, SpringParams);
+		ProceduralLocomotionMath::StepSpring(Spring.Y, Spring.W, Input.DeltaSeconds, SpringParams);
+
+		float BendAngle = FMath::Sqrt(Spring.X * Spring.X + Spring.Y * Spring.Y);
+		if (BendAngle > HitReactionMaxAngle)
+		{
+			const float Scale = HitReactionMaxAngle / BendAngle;
+			Spring.X *= Scale;
+			Spring.Y *= Scale;
+			BendAngle = HitReactionMaxAngle;
+		}
+
+		if (BendAngle < 0.01f && FMath::Abs(Spring.Z) + FMath::Abs(Spring.W) < 0.1f)
+		{
+			Spring = FVector4f(0.0f, 0.0f, 0.0f, 0.0f);
+			HitReactionRotations[Index] = FRotator::ZeroRotator;
+			continue;
+		}
+		bAnyActive = true;
+
+		// Tilts the bone's up axis towards the bend: about Z x Bend, by its length.
+		if (BendAngle > KINDA_SMALL_NUMBER)
+		{
+			const FVector Axis = MeshRotation.UnrotateVector(FVector(-Spring.Y, Spring.X, 0.0f) / BendAngle);
+			HitReactionRotations[Index] = FQuat(Axis, FMath::DegreesToRadians(BendAngle)).Rotator();
+		}
+		else
+		{
+			HitReactionRotations[Index] = FRotator::ZeroRotator;
+		}
+	}
+	bHitReactionActive = bAnyActive;
+}
+
+float UProceduralLocomotionAnimInstance::UpdateFootPlant(FProceduralLocomotionFootPlant& Plant, int32 FootSlot, const FVector2f& FootLocation,
+	float TraceDistance, float CapsuleBottomZ, const FProceduralLocomotionAnimInput& Input, const FTransform& BaseTransform, FRotator& OutFootRotation) const
+{
+	OutFootRotation = FRotator::ZeroRotator;
 
-	const float CurrentYaw = Character->GetActorRotation().Yaw;
-	const float YawDelta = FMath::FindDeltaAngleDegrees(LastYawDegrees, CurrentYaw);
-	const float YawRateDegPerSec = YawDelta / FMath::Max(DeltaSeconds, KINDA_SMALL_NUMBER);
-	LastYawDegrees = CurrentYaw;
+	// The plant follows its base wherever it has moved. It is only traced again once the foot
+	// steps away from it, the character changes base, or it leaves the trace range (jumps, falls).
+	const bool bOnPlantBase = Plant.bValid && Plant.BaseId == Input.BaseId;
+	if (bOnPlantBase)
+	{
+		const FVector PlantLocation = BaseTransform.TransformPosition(Plant.Location);
+		const float Offset = (float)(PlantLocation.Z - CapsuleBottomZ);
+		if (FVector2D::DistSquared(FVector2D(PlantLocation), FVector2D(FootLocation)) <= FMath::Square(FootPlantTolerance)
+			&& Offset <= FootTraceStartHeight && Offset >= -TraceDistance)
+		{
+			INC_DWORD_STAT(STAT_PLS_FootPlantsReused);
+			OutFootRotation = GetFootRotation(BaseTransform.TransformVectorNoScale(FVector(Plant.Normal)));
+			return Offset;
+		}
+	}
 
-	float TargetLeanAngle = (LocalAccel.Y * AccelerationLeanMultiplier) + (YawRateDegPerSec * YawRateLeanMultiplier);
-	TargetLeanAngle = FMath::Clamp(TargetLeanAngle, -MaxLeanAngle, MaxLeanAngle);
+	FVector GroundLocation;
+	FVector GroundNormal;
+	bool bHit = false;
+	if (Input.bScheduledGroundQueries)
+	{
+		const FProceduralLocomotionGroundHit& Served = FootSlot == 0 ? Input.LeftFootGround : Input.RightFootGround;
+		if (!Served.bServed)
+		{
+			RequestFootGround(FootSlot, FootLocation, TraceDistance, CapsuleBottomZ);
+			return bOnPlantBase ? ExtrapolateFootPlant(Plant, FootLocation, TraceDistance, CapsuleBottomZ, BaseTransform, OutFootRotation) : 0.0f;
+		}
+		bHit = Served.bHit;
+		GroundLocation = Served.Location;
+		GroundNormal = FVector(Served.Normal);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_PLS_FootTraces);
+		bHit = TraceFootGround(FootLocation, TraceDistance, CapsuleBottomZ, GroundLocation, GroundNormal);
+	}
+
+	if (!bHit)
+	{
+		// Misses aren't kept, so the foot picks up ground as soon as there is some.
+		Plant.bValid = false;
+		return 0.0f;
+	}
+
+	Plant.Location = BaseTransform.InverseTransformPosition(GroundLocation);
+	Plant.Normal = FVector3f(BaseTransform.InverseTransformVectorNoScale(GroundNormal));
+	Plant.BaseId = Input.BaseId;
+	Plant.bValid = true;
+	OutFootRotation = GetFootRotation(GroundNormal);
+	return (float)(GroundLocation.Z - CapsuleBottomZ);
+}
+
+float UProceduralLocomotionAnimInstance::ExtrapolateFootPlant(const FProceduralLocomotionFootPlant& Plant, const FVector2f& FootLocation, float TraceDistance,
+	float CapsuleBottomZ, const FTransform& BaseTransform, FRotator& OutFootRotation) const
+{
+	// The plant's surface continued under the foot: exact on flat and evenly sloped ground, and
+	// off only until the query is served on steps and bumps.
+	const FVector PlantLocation = BaseTransform.TransformPosition(Plant.Location);
+	const FVector Normal = BaseTransform.TransformVectorNoScale(FVector(Plant.Normal));
+	if (Normal.Z <= KINDA_SMALL_NUMBER)
+	{
+		return 0.0f;
+	}
+
+	const double GroundZ = PlantLocation.Z - (Normal.X * (FootLocation.X - PlantLocation.X) + Normal.Y * (FootLocation.Y - PlantLocation.Y)) / Normal.Z;
+	const float Offset = (float)(GroundZ - CapsuleBottomZ);
+	if (Offset > FootTraceStartHeight || Offset < -TraceDistance)
+	{
+		return 0.0f;
+	}
+
+	INC_DWORD_STAT(STAT_PLS_FootPlantsExtrapolated);
+	OutFootRotation = GetFootRotation(Normal);
+	return Offset;
+}
+
+void UProceduralLocomotionAnimInstance::RequestFootGround(int32 FootSlot, const FVector2f& FootLocation, float TraceDistance, float CapsuleBottomZ) const
+{
+	// Replays get served results from the recording and never queue their own.
+	UProceduralLocomotionGroundQuerySubsystem* Queries = GroundQueries.Get();
+	const USkeletalMeshComponent* MeshComp = GetSkelMeshComponent();
+	if (!Queries || !MeshComp || bReplayControlled)
+	{
+		return;
+	}
+
+	FProceduralLocomotionGroundQuery Query;
+	Query.Start = FVector(FootLocation.X, FootLocation.Y, CapsuleBottomZ + FootTraceStartHeight);
+	Query.End = FVector(FootLocation.X, FootLocation.Y, CapsuleBottomZ - TraceDistance);
+	Query.BoundsRadius = (float)MeshComp->Bounds.SphereRadius;
+	Query.bRecentlyRendered = MeshComp->WasRecentlyRendered(0.2f);
+	Query.IgnoredActor = TryGetPawnOwner();
+
+	// A foot about to plant, or standing, shows a wrong ground right away; one mid-swing can wait.
+	const float TimeToPlant = FootSlot == 0 ? TimeToLeftFootPlant : TimeToRightFootPlant;
+	if (TimeToPlant >= 0.0f)
+	{
+		Query.Urgency = 1.0f - FMath::Clamp(TimeToPlant / 0.3f, 0.0f, 1.0f);
+	}
+	else if (GroundSpeed <= KINDA_SMALL_NUMBER)
+	{
+		Query.Urgency = 1.0f;
+	}
+
+	Queries->RequestQuery(this, FootSlot, Query);
+}
+
+bool UProceduralLocomotionAnimInstance::TraceFootGround(const FVector2f& FootLocation, float TraceDistance, float CapsuleBottomZ, FVector& OutLocation, FVector& OutNormal) const
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return false;
+	}
+
+	const FVector TraceStart(FootLocation.X, FootLocation.Y, CapsuleBottomZ + FootTraceStartHeight);
+	const FVector TraceEnd(FootLocation.X, FootLocation.Y, CapsuleBottomZ - TraceDistance);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProceduralFootIK), false, TryGetPawnOwner());
+	FHitResult Hit;
+	if (!World->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, ECC_Visibility, QueryParams))
+	{
+		return false;
+	}
 
-	LeanAngle = FMath::FInterpTo(LeanAngle, TargetLeanAngle, DeltaSeconds, LeanInterpSpeed);
+	OutLocation = Hit.ImpactPoint;
+	OutNormal = Hit.ImpactNormal;
+	return true;
 }
 
 void UProceduralLocomotionAnimInstance::UpdateProceduralBone(float DeltaSeconds)
@@ -102,8 +789,9 @@ void UProceduralLocomotionAnimInstance::UpdateProceduralBone(float DeltaSeconds)
 		return;
 	}
 
-	const float Pitch = FMath::Sin(ProceduralTime * ProceduralBoneSpeed) * ProceduralBonePitchAmplitude;
-	const float Yaw = FMath::Cos(ProceduralTime * ProceduralBoneSpeed) * ProceduralBoneYawAmplitude;
+	float Pitch = 0.0f;
+	float Yaw = 0.0f;
+	ProceduralLocomotionMath::ComputeBoneOscillation(ProceduralTime, GetProceduralBoneParams(), Pitch, Yaw);
 
 	// Apply rotation in component space; you can change to EBoneSpaces::Type::WorldSpace if desired.
 	SkelComp->SetBoneRotationByName(ProceduralBoneName, FRotator(Pitch, Yaw, 0.0f), EBoneSpaces::ComponentSpace);
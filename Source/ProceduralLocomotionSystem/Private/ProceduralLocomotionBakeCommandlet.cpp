@@ -0,0 +1,452 @@
+#include "ProceduralLocomotionBakeCommandlet.h"
+
+#include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionCommandletUtils.h"
+#include "ProceduralLocomotionMath.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Animation/AnimData/IAnimationDataController.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Async/ParallelFor.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace ProceduralLocomotionBake
+{
+	struct FBakeSettings
+	{
+		float Speed = 300.0f;
+		float DurationSeconds = 8.0f;
+		int32 SampleRate = 30;
+		FName LeanBone = TEXT("spine_01");
+		// Character forward in component space; +Y for the UE5 mannequin, which is imported facing +Y.
+		FVector MeshForward = FVector::RightVector;
+		FName ProceduralBone = NAME_None;
+		float StrideLength = 150.0f;
+		ProceduralLocomotionMath::FLeanParams LeanParams;
+		// Views the anim class profile's baked curves, which outlive the bake.
+		ProceduralLocomotionMath::FLeanResponse LeanResponse;
+		ProceduralLocomotionMath::FBoneOscillationParams BoneParams;
+	};
+
+	enum class EPathPreset : uint8
+	{
+		Straight,
+		Circle,
+		Slalom,
+		Figure8,
+	};
+
+	static const TCHAR* GetPresetName(EPathPreset Preset)
+	{
+		switch (Preset)
+		{
+		case EPathPreset::Straight: return TEXT("Straight");
+		case EPathPreset::Circle: return TEXT("Circle");
+		case EPathPreset::Slalom: return TEXT("Slalom");
+		case EPathPreset::Figure8: return TEXT("Figure8");
+		}
+		return TEXT("Unknown");
+	}
+
+	// Turn rate of each preset in degrees per second at time Time, for a character moving at Speed.
+	static float GetPresetYawRate(EPathPreset Preset, float Time, float Speed)
+	{
+		constexpr float TurnRadius = 400.0f;
+		constexpr float SlalomPeriodSeconds = 2.5f;
+		constexpr float SlalomPeakYawRate = 90.0f;
+
+		const float CircleYawRate = FMath::RadiansToDegrees(Speed / TurnRadius);
+		switch (Preset)
+		{
+		case EPathPreset::Circle:
+			return CircleYawRate;
+		case EPathPreset::Slalom:
+			return SlalomPeakYawRate * FMath::Sin(2.0f * UE_PI * Time / SlalomPeriodSeconds);
+		case EPathPreset::Figure8:
+		{
+			// One full loop each way, switching direction where the loops touch.
+			const float LoopSeconds = 360.0f / CircleYawRate;
+			return FMath::Fmod(Time, 2.0f * LoopSeconds) < LoopSeconds ? CircleYawRate : -CircleYawRate;
+		}
+		default:
+			return 0.0f;
+		}
+	}
+
+	// What the anim instance would see along a path, one entry per output frame.
+	struct FLayerTrack
+	{
+		TArray<float> Lean;
+		TArray<float> Phase;
+		TArray<float> BonePitch;
+		TArray<float> BoneYaw;
+	};
+
+	static void RecordLayers(EPathPreset Preset, const FBakeSettings& Settings, int32 NumKeys, FLayerTrack& OutTrack)
+	{
+		// Sub-steps keep the lean interpolation close to a 60+ Hz game tick whatever the sample rate.
+		const int32 SubSteps = FMath::Max(1, FMath::CeilToInt(120.0f / Settings.SampleRate));
+		const float Dt = 1.0f / (Settings.SampleRate * SubSteps);
+
+		float Time = 0.0f;
+		float Yaw = 0.0f;
+		float LastYaw = 0.0f;
+		float Lean = 0.0f;
+		float Phase = 0.0f;
+
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			if (Key > 0)
+			{
+				for (int32 Step = 0; Step < SubSteps; ++Step)
+				{
+					const float YawRate = GetPresetYawRate(Preset, Time, Settings.Speed);
+
+					// Following the path at constant speed, the only acceleration is centripetal.
+					const float LocalAccelY = Settings.Speed * FMath::DegreesToRadians(YawRate);
+
+					Yaw = FRotator::NormalizeAxis(Yaw + YawRate * Dt);
+					Lean = ProceduralLocomotionMath::StepLean(Lean, LastYaw, Yaw, LocalAccelY, Settings.Speed, Dt, Settings.LeanParams, Settings.LeanResponse);
+					Phase = FMath::Frac(Phase + Settings.Speed * Dt / Settings.StrideLength);
+					Time += Dt;
+				}
+			}
+
+			float Pitch = 0.0f;
+			float BoneYaw = 0.0f;
+			ProceduralLocomotionMath::ComputeBoneOscillation(Time, Settings.BoneParams, Pitch, BoneYaw);
+
+			OutTrack.Lean.Add(Lean);
+			OutTrack.Phase.Add(Phase);
+			OutTrack.BonePitch.Add(Pitch);
+			OutTrack.BoneYaw.Add(BoneYaw);
+		}
+	}
+
+	// The walk cycle pre-sampled into local bone transforms, so composition never touches UObjects.
+	struct FCycleTable
+	{
+		int32 NumBones = 0;
+		int32 NumFrames = 0;
+		TArray<FTransform> Transforms; // [Frame * NumBones + Bone], skeleton bone order
+
+		const FTransform& Get(int32 Frame, int32 Bone) const { return Transforms[Frame * NumBones + Bone]; }
+	};
+
+	static void SampleCycle(const UAnimSequence* WalkAnim, int32 NumBones, int32 NumFrames, FCycleTable& OutTable)
+	{
+		OutTable.NumBones = NumBones;
+		OutTable.NumFrames = NumFrames;
+		OutTable.Transforms.SetNum(NumBones * NumFrames);
+
+		const double Length = WalkAnim->GetPlayLength();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const FAnimExtractContext Context(Length * Frame / NumFrames);
+			for (int32 Bone = 0; Bone < NumBones; ++Bone)
+			{
+				WalkAnim->GetBoneTransform(OutTable.Transforms[Frame * NumBones + Bone], FSkeletonPoseBoneIndex(Bone), Context, false);
+			}
+		}
+	}
+
+	// Composes a component-space rotation onto a bone's local transform, given the bone's parent in component space.
+	static void ApplyComponentSpaceRotation(FTransform& Local, const FQuat& ParentComponentRotation, const FQuat& Rotation)
+	{
+		Local.SetRotation((ParentComponentRotation.Inverse() * Rotation * ParentComponentRotation * Local.GetRotation()).GetNormalized());
+	}
+
+	// Rotation of a bone's parent in component space, from a local pose in skeleton bone order.
+	static FQuat GetParentComponentRotation(const FReferenceSkeleton& RefSkeleton, const FTransform* LocalPose, int32 BoneIndex)
+	{
+		FQuat Rotation = FQuat::Identity;
+		for (int32 Parent = RefSkeleton.GetParentIndex(BoneIndex); Parent != INDEX_NONE; Parent = RefSkeleton.GetParentIndex(Parent))
+		{
+			Rotation = LocalPose[Parent].GetRotation() * Rotation;
+		}
+		return Rotation;
+	}
+
+	// Per-bone key arrays in the layout IAnimationDataController expects.
+	struct FBakedTracks
+	{
+		TArray<TArray<FVector3f>> Positions;
+		TArray<TArray<FQuat4f>> Rotations;
+		TArray<TArray<FVector3f>> Scales;
+
+		void Init(int32 NumBones, int32 NumKeys)
+		{
+			Positions.SetNum(NumBones);
+			Rotations.SetNum(NumBones);
+			Scales.SetNum(NumBones);
+			for (int32 Bone = 0; Bone < NumBones; ++Bone)
+			{
+				Positions[Bone].SetNumUninitialized(NumKeys);
+				Rotations[Bone].SetNumUninitialized(NumKeys);
+				Scales[Bone].SetNumUninitialized(NumKeys);
+			}
+		}
+
+		void SetKey(int32 Bone, int32 Key, const FTransform& Transform)
+		{
+			Positions[Bone][Key] = FVector3f(Transform.GetTranslation());
+			Rotations[Bone][Key] = FQuat4f(Transform.GetRotation());
+			Scales[Bone][Key] = FVector3f(Transform.GetScale3D());
+		}
+	};
+
+	static void ComposePreset(const FLayerTrack& Track, const FCycleTable& Cycle, const FReferenceSkeleton& RefSkeleton,
+		int32 LeanBoneIndex, int32 ProceduralBoneIndex, const FVector& MeshForward, FBakedTracks& OutTracks)
+	{
+		const int32 NumKeys = Track.Lean.Num();
+		OutTracks.Init(Cycle.NumBones, NumKeys);
+
+		TArray<FTransform> Pose;
+		Pose.SetNum(Cycle.NumBones);
+
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			// Play the cycle back by stride phase, the way the runtime graph syncs it to ground speed.
+			const float CycleFrame = Track.Phase[Key] * Cycle.NumFrames;
+			const int32 FrameA = FMath::FloorToInt(CycleFrame) % Cycle.NumFrames;
+			const int32 FrameB = (FrameA + 1) % Cycle.NumFrames;
+			const float Alpha = CycleFrame - FMath::FloorToFloat(CycleFrame);
+			for (int32 Bone = 0; Bone < Cycle.NumBones; ++Bone)
+			{
+				Pose[Bone].Blend(Cycle.Get(FrameA, Bone), Cycle.Get(FrameB, Bone), Alpha);
+			}
+
+			// Lean rolls about the character's forward axis, toward the inside of the turn.
+			if (LeanBoneIndex != INDEX_NONE)
+			{
+				const FQuat LeanRotation(MeshForward, FMath::DegreesToRadians(Track.Lean[Key]));
+				ApplyComponentSpaceRotation(Pose[LeanBoneIndex], GetParentComponentRotation(RefSkeleton, Pose.GetData(), LeanBoneIndex), LeanRotation);
+			}
+
+			// Applied on top of the cycle; the runtime node replaces the bone's rotation instead.
+			if (ProceduralBoneIndex != INDEX_NONE)
+			{
+				const FQuat BoneRotation = FRotator(Track.BonePitch[Key], Track.BoneYaw[Key], 0.0f).Quaternion();
+				ApplyComponentSpaceRotation(Pose[ProceduralBoneIndex], GetParentComponentRotation(RefSkeleton, Pose.GetData(), ProceduralBoneIndex), BoneRotation);
+			}
+
+			for (int32 Bone = 0; Bone < Cycle.NumBones; ++Bone)
+			{
+				OutTracks.SetKey(Bone, Key, Pose[Bone]);
+			}
+		}
+	}
+
+	// Reference pose with the lean bone rolled from -MaxLeanAngle (first key) to +MaxLeanAngle (last key).
+	static void ComposeLeanPoses(const FReferenceSkeleton& RefSkeleton, int32 LeanBoneIndex, float MaxLeanAngle, const FVector& MeshForward, int32 NumKeys, FBakedTracks& OutTracks)
+	{
+		const TArray<FTransform>& RefPose = RefSkeleton.GetRefBonePose();
+		OutTracks.Init(RefPose.Num(), NumKeys);
+
+		const FQuat ParentRotation = GetParentComponentRotation(RefSkeleton, RefPose.GetData(), LeanBoneIndex);
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			const float Lean = FMath::Lerp(-MaxLeanAngle, MaxLeanAngle, (float)Key / (NumKeys - 1));
+			for (int32 Bone = 0; Bone < RefPose.Num(); ++Bone)
+			{
+				FTransform Local = RefPose[Bone];
+				if (Bone == LeanBoneIndex)
+				{
+					ApplyComponentSpaceRotation(Local, ParentRotation, FQuat(MeshForward, FMath::DegreesToRadians(Lean)));
+				}
+				OutTracks.SetKey(Bone, Key, Local);
+			}
+		}
+	}
+
+	static bool SaveSequence(const FString& PackageName, USkeleton* Skeleton, const FReferenceSkeleton& RefSkeleton,
+		const FBakedTracks& Tracks, int32 SampleRate, bool bAdditive)
+	{
+#if WITH_EDITOR
+		UPackage* Package = CreatePackage(*PackageName);
+		const FString AssetName = FPackageName::GetLongPackageAssetName(PackageName);
+
+		UAnimSequence* Sequence = NewObject<UAnimSequence>(Package, *AssetName, RF_Public | RF_Standalone);
+		Sequence->SetSkeleton(Skeleton);
+		if (bAdditive)
+		{
+			Sequence->AdditiveAnimType = AAT_LocalSpaceBase;
+			Sequence->RefPoseType = ABPT_RefPose;
+		}
+
+		const int32 NumKeys = Tracks.Positions.Num() > 0 ? Tracks.Positions[0].Num() : 0;
+		IAnimationDataController& Controller = Sequence->GetController();
+		Controller.OpenBracket(FText::FromString(TEXT("Bake procedural locomotion")), false);
+		Controller.InitializeModel();
+		Controller.SetFrameRate(FFrameRate(SampleRate, 1), false);
+		Controller.SetNumberOfFrames(FFrameNumber(FMath::Max(NumKeys - 1, 1)), false);
+		for (int32 Bone = 0; Bone < Tracks.Positions.Num(); ++Bone)
+		{
+			const FName BoneName = RefSkeleton.GetBoneName(Bone);
+			Controller.AddBoneCurve(BoneName, false);
+			Controller.SetBoneTrackKeys(BoneName, Tracks.Positions[Bone], Tracks.Rotations[Bone], Tracks.Scales[Bone], false);
+		}
+		Controller.NotifyPopulated();
+		Controller.CloseBracket(false);
+
+		// Compresses with the skeleton's default settings so the asset is ready to cook.
+		Sequence->CacheDerivedDataForCurrentPlatform();
+		return ProceduralLocomotionCommandlet::SaveAssetPackage(Sequence);
+#else
+		return false;
+#endif
+	}
+
+	static TArray<EPathPreset> ParsePresets(const FString& Params)
+	{
+		FString Value = TEXT("All");
+		FParse::Value(*Params, TEXT("Presets="), Value, false);
+
+		const EPathPreset AllPresets[] = { EPathPreset::Straight, EPathPreset::Circle, EPathPreset::Slalom, EPathPreset::Figure8 };
+		TArray<EPathPreset> Presets;
+		TArray<FString> Names;
+		Value.ParseIntoArray(Names, TEXT(","));
+		for (const FString& Name : Names)
+		{
+			for (const EPathPreset Preset : AllPresets)
+			{
+				if (Name.Equals(TEXT("All"), ESearchCase::IgnoreCase) || Name.Equals(GetPresetName(Preset), ESearchCase::IgnoreCase))
+				{
+					Presets.AddUnique(Preset);
+				}
+			}
+		}
+		return Presets;
+	}
+}
+
+UProceduralLocomotionBakeCommandlet::UProceduralLocomotionBakeCommandlet()
+{
+	LogToConsole = true;
+}
+
+int32 UProceduralLocomotionBakeCommandlet::Main(const FString& Params)
+{
+	using namespace ProceduralLocomotionBake;
+
+	FString WalkAnimPath;
+	if (!FParse::Value(*Params, TEXT("WalkAnim="), WalkAnimPath))
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Bake: -WalkAnim=<AnimSequence> is required."));
+		return 1;
+	}
+
+	UAnimSequence* WalkAnim = LoadObject<UAnimSequence>(nullptr, *WalkAnimPath);
+	USkeleton* Skeleton = WalkAnim ? WalkAnim->GetSkeleton() : nullptr;
+	if (!Skeleton)
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Bake: could not load %s or its skeleton."), *WalkAnimPath);
+		return 1;
+	}
+
+	// Layer tuning from the anim class the characters actually use.
+	UClass* AnimClass = UProceduralLocomotionAnimInstance::StaticClass();
+	FString AnimClassPath;
+	if (FParse::Value(*Params, TEXT("AnimClass="), AnimClassPath))
+	{
+		UClass* LoadedClass = LoadObject<UClass>(nullptr, *AnimClassPath);
+		if (!LoadedClass || !LoadedClass->IsChildOf(UProceduralLocomotionAnimInstance::StaticClass()))
+		{
+			UE_LOG(LogProceduralLocomotion, Error, TEXT("Bake: %s is not a UProceduralLocomotionAnimInstance class."), *AnimClassPath);
+			return 1;
+		}
+		AnimClass = LoadedClass;
+	}
+	const UProceduralLocomotionAnimInstance* AnimDefaults = GetDefault<UProceduralLocomotionAnimInstance>(AnimClass);
+
+	FBakeSettings Settings;
+	Settings.LeanParams = AnimDefaults->GetLeanParams();
+	if (const UProceduralLocomotionProfile* Profile = AnimDefaults->GetProfile())
+	{
+		Settings.LeanResponse = Profile->GetLeanResponse();
+	}
+	Settings.BoneParams = AnimDefaults->GetProceduralBoneParams();
+	Settings.ProceduralBone = AnimDefaults->GetProceduralBoneName();
+	Settings.StrideLength = FMath::Max(AnimDefaults->GetStrideLength(), 1.0f);
+	FParse::Value(*Params, TEXT("Speed="), Settings.Speed);
+	FParse::Value(*Params, TEXT("Duration="), Settings.DurationSeconds);
+	FParse::Value(*Params, TEXT("SampleRate="), Settings.SampleRate);
+	FParse::Value(*Params, TEXT("LeanBone="), Settings.LeanBone);
+	FString ForwardAxis;
+	if (FParse::Value(*Params, TEXT("ForwardAxis="), ForwardAxis))
+	{
+		Settings.MeshForward = ForwardAxis.Equals(TEXT("X"), ESearchCase::IgnoreCase) ? FVector::ForwardVector : FVector::RightVector;
+	}
+	Settings.SampleRate = FMath::Clamp(Settings.SampleRate, 1, 120);
+	Settings.DurationSeconds = FMath::Max(Settings.DurationSeconds, 1.0f / Settings.SampleRate);
+
+	FString OutputPath = TEXT("/Game/Locomotion/Baked");
+	FParse::Value(*Params, TEXT("OutputPath="), OutputPath);
+
+	const TArray<EPathPreset> Presets = ParsePresets(Params);
+	if (Presets.Num() == 0)
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Bake: no known presets in -Presets (Straight, Circle, Slalom, Figure8 or All)."));
+		return 1;
+	}
+
+	const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+	const int32 NumBones = RefSkeleton.GetNum();
+	const int32 LeanBoneIndex = RefSkeleton.FindBoneIndex(Settings.LeanBone);
+	const int32 ProceduralBoneIndex = RefSkeleton.FindBoneIndex(Settings.ProceduralBone);
+	if (LeanBoneIndex == INDEX_NONE)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Bake: skeleton has no lean bone %s; leaning is not baked."), *Settings.LeanBone.ToString());
+	}
+
+	// Sampling the source touches the asset, so it happens once here; composition below is pure math.
+	FCycleTable Cycle;
+	SampleCycle(WalkAnim, NumBones, FMath::Max(WalkAnim->GetNumberOfSampledKeys() - 1, 1), Cycle);
+
+	const int32 NumKeys = FMath::RoundToInt(Settings.DurationSeconds * Settings.SampleRate) + 1;
+	TArray<FBakedTracks> Results;
+	Results.SetNum(Presets.Num());
+	ParallelFor(Presets.Num(), [&](int32 PresetIndex)
+	{
+		FLayerTrack Track;
+		RecordLayers(Presets[PresetIndex], Settings, NumKeys, Track);
+		ComposePreset(Track, Cycle, RefSkeleton, LeanBoneIndex, ProceduralBoneIndex, Settings.MeshForward, Results[PresetIndex]);
+	});
+
+	int32 NumFailed = 0;
+	for (int32 PresetIndex = 0; PresetIndex < Presets.Num(); ++PresetIndex)
+	{
+		const FString PackageName = OutputPath / FString::Printf(TEXT("AS_Baked_%s"), GetPresetName(Presets[PresetIndex]));
+		if (SaveSequence(PackageName, Skeleton, RefSkeleton, Results[PresetIndex], Settings.SampleRate, false))
+		{
+			UE_LOG(LogProceduralLocomotion, Display, TEXT("Bake: wrote %s (%d frames)"), *PackageName, NumKeys);
+		}
+		else
+		{
+			UE_LOG(LogProceduralLocomotion, Error, TEXT("Bake: failed to save %s (requires an editor build)."), *PackageName);
+			++NumFailed;
+		}
+	}
+
+	if (FParse::Param(*Params, TEXT("LeanPoses")) && LeanBoneIndex != INDEX_NONE)
+	{
+		constexpr int32 NumLeanPoses = 9;
+		FBakedTracks LeanPoses;
+		ComposeLeanPoses(RefSkeleton, LeanBoneIndex, Settings.LeanParams.MaxLeanAngle, Settings.MeshForward, NumLeanPoses, LeanPoses);
+
+		const FString PackageName = OutputPath / TEXT("AS_Baked_LeanPoses");
+		if (SaveSequence(PackageName, Skeleton, RefSkeleton, LeanPoses, Settings.SampleRate, true))
+		{
+			UE_LOG(LogProceduralLocomotion, Display, TEXT("Bake: wrote %s (%d poses, +/-%.1f deg)"), *PackageName, NumLeanPoses, Settings.LeanParams.MaxLeanAngle);
+		}
+		else
+		{
+			UE_LOG(LogProceduralLocomotion, Error, TEXT("Bake: failed to save %s (requires an editor build)."), *PackageName);
+			++NumFailed;
+		}
+	}
+
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,179 @@
+#include "ProceduralLocomotionBenchmarkCommandlet.h"
+
+#include "ProceduralCharacter.h"
+#include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionBenchmarkResult.h"
+#include "ProceduralLocomotionBenchmarkWorld.h"
+#include "ProceduralLocomotionStats.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace ProceduralLocomotionBenchmark
+{
+	struct FLayerToggle
+	{
+		const TCHAR* LayerName;
+		const TCHAR* CVarName;
+	};
+
+	// Layer names accepted by -Layers= and the console variable each one switches on.
+	static const FLayerToggle LayerToggles[] =
+	{
+		{ TEXT("Lean"), TEXT("pls.Leaning.Enable") },
+		{ TEXT("FootIK"), TEXT("pls.FootIK.Enable") },
+		{ TEXT("Bone"), TEXT("pls.ProceduralBone.Enable") },
+		{ TEXT("Sync"), TEXT("pls.MarkerSync.Enable") },
+	};
+
+	static void ApplyLayerConfig(const FString& Layers)
+	{
+		TArray<FString> EnabledLayers;
+		Layers.ParseIntoArray(EnabledLayers, TEXT("+"));
+
+		for (const FLayerToggle& Toggle : LayerToggles)
+		{
+			if (IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Toggle.CVarName))
+			{
+				CVar->Set(EnabledLayers.Contains(Toggle.LayerName), ECVF_SetByCode);
+			}
+		}
+	}
+
+	static void ParseList(const FString& Params, const TCHAR* Key, const TCHAR* Default, TArray<FString>& OutValues)
+	{
+		FString Value = Default;
+		FParse::Value(*Params, Key, Value, false);
+		Value.ParseIntoArray(OutValues, TEXT(","));
+	}
+}
+
+UProceduralLocomotionBenchmarkCommandlet::UProceduralLocomotionBenchmarkCommandlet()
+{
+	LogToConsole = true;
+}
+
+int32 UProceduralLocomotionBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace ProceduralLocomotionBenchmark;
+
+	TArray<FString> CharacterCounts;
+	TArray<FString> LayerConfigs;
+	ParseList(Params, TEXT("Characters="), TEXT("64"), CharacterCounts);
+	ParseList(Params, TEXT("Layers="), TEXT("Lean+FootIK+Bone"), LayerConfigs);
+
+	int32 NumRuns = 7;
+	int32 NumFrames = 600;
+	int32 NumWarmupFrames = 60;
+	float DeltaSeconds = 1.0f / 30.0f;
+	FString OutputFile = FPaths::ProjectSavedDir() / TEXT("Benchmarks/ProceduralLocomotionBenchmark.json");
+
+	FParse::Value(*Params, TEXT("Runs="), NumRuns);
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Warmup="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaSeconds);
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+
+	NumRuns = FMath::Max(NumRuns, 1);
+	NumFrames = FMath::Max(NumFrames, 1);
+
+	// Clips for the Sync layer; each character keeps all of them phase-locked, as a blend would.
+	TArray<FString> SyncClipPaths;
+	ParseList(Params, TEXT("SyncClips="), TEXT(""), SyncClipPaths);
+	TArray<UAnimSequenceBase*> SyncClips;
+	for (const FString& SyncClipPath : SyncClipPaths)
+	{
+		if (UAnimSequenceBase* SyncClip = LoadObject<UAnimSequenceBase>(nullptr, *SyncClipPath))
+		{
+			SyncClips.Add(SyncClip);
+		}
+		else
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("Could not load sync clip %s."), *SyncClipPath);
+		}
+	}
+
+	ProceduralLocomotionStageTiming::SetCaptureEnabled(true);
+
+	TArray<FProceduralLocomotionBenchmarkResult> Results;
+	for (const FString& CharacterCount : CharacterCounts)
+	{
+		const int32 NumCharacters = FCString::Atoi(*CharacterCount);
+		for (const FString& Layers : LayerConfigs)
+		{
+			FProceduralLocomotionBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+			Result.Scenario = FProceduralLocomotionBenchmarkResult::MakeScenarioName(NumCharacters, Layers);
+			Result.NumCharacters = NumCharacters;
+			Result.Layers = Layers;
+			Result.FramesPerRun = NumFrames;
+			Result.Platform = ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName());
+			Result.BuildConfiguration = LexToString(FApp::GetBuildConfiguration());
+
+			ApplyLayerConfig(Layers);
+
+			for (int32 RunIndex = 0; RunIndex < NumRuns; ++RunIndex)
+			{
+				// A fresh world per run keeps the runs independent for the perf gate's statistics.
+				{
+					FProceduralLocomotionBenchmarkWorld BenchWorld(TEXT("ProceduralLocomotionBenchmark"));
+					if (!BenchWorld.IsValid())
+					{
+						UE_LOG(LogProceduralLocomotion, Error, TEXT("Failed to create benchmark world."));
+						return 1;
+					}
+
+					for (int32 CharacterIndex = 0; CharacterIndex < NumCharacters; ++CharacterIndex)
+					{
+						AProceduralCharacter* Character = BenchWorld.SpawnCharacter(CharacterIndex);
+						USkeletalMeshComponent* MeshComp = Character ? Character->GetMesh() : nullptr;
+						UProceduralLocomotionAnimInstance* AnimInstance = MeshComp ? Cast<UProceduralLocomotionAnimInstance>(MeshComp->GetAnimInstance()) : nullptr;
+						if (AnimInstance && SyncClips.Num() > 0)
+						{
+							AnimInstance->SetMarkerSyncSequences(SyncClips);
+						}
+					}
+
+					for (int32 Frame = 0; Frame < NumWarmupFrames; ++Frame)
+					{
+						BenchWorld.Step(DeltaSeconds);
+					}
+
+					ProceduralLocomotionStageTiming::Reset();
+					const uint64 StartCycles = FPlatformTime::Cycles64();
+					for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+					{
+						BenchWorld.Step(DeltaSeconds);
+					}
+					const uint64 FrameCycles = FPlatformTime::Cycles64() - StartCycles;
+
+					for (int32 StageIndex = 0; StageIndex < (int32)EProceduralLocomotionStage::Num; ++StageIndex)
+					{
+						const EProceduralLocomotionStage Stage = (EProceduralLocomotionStage)StageIndex;
+						const double StageMs = FPlatformTime::ToMilliseconds64(ProceduralLocomotionStageTiming::GetCycles(Stage)) / NumFrames;
+						Result.StageSamplesMs.FindOrAdd(ProceduralLocomotionStageTiming::GetStageName(Stage)).Add(StageMs);
+					}
+					Result.StageSamplesMs.FindOrAdd(TEXT("Frame")).Add(FPlatformTime::ToMilliseconds64(FrameCycles) / NumFrames);
+				}
+
+				CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			}
+
+			UE_LOG(LogProceduralLocomotion, Display, TEXT("%s: %d runs x %d frames done."), *Result.Scenario, NumRuns, NumFrames);
+		}
+	}
+
+	ProceduralLocomotionStageTiming::SetCaptureEnabled(false);
+
+	if (!FProceduralLocomotionBenchmarkResult::SaveToFile(OutputFile, Results))
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Failed to write benchmark result to %s"), *OutputFile);
+		return 1;
+	}
+
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Benchmark result written to %s"), *OutputFile);
+	return 0;
+}
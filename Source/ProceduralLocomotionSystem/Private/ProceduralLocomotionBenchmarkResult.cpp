@@ -0,0 +1,130 @@
+#include "ProceduralLocomotionBenchmarkResult.h"
+
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace ProceduralLocomotionBenchmarkResult
+{
+	static TSharedRef<FJsonObject> ToJson(const FProceduralLocomotionBenchmarkResult& Result)
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("Scenario"), Result.Scenario);
+		Object->SetNumberField(TEXT("Characters"), Result.NumCharacters);
+		Object->SetStringField(TEXT("Layers"), Result.Layers);
+		Object->SetNumberField(TEXT("FramesPerRun"), Result.FramesPerRun);
+		Object->SetStringField(TEXT("Platform"), Result.Platform);
+		Object->SetStringField(TEXT("BuildConfiguration"), Result.BuildConfiguration);
+
+		TSharedRef<FJsonObject> Stages = MakeShared<FJsonObject>();
+		for (const TPair<FString, TArray<double>>& Stage : Result.StageSamplesMs)
+		{
+			TArray<TSharedPtr<FJsonValue>> Samples;
+			for (const double Sample : Stage.Value)
+			{
+				Samples.Add(MakeShared<FJsonValueNumber>(Sample));
+			}
+			Stages->SetArrayField(Stage.Key, Samples);
+		}
+		Object->SetObjectField(TEXT("StageSamplesMs"), Stages);
+
+		return Object;
+	}
+
+	static bool FromJson(const FJsonObject& Object, FProceduralLocomotionBenchmarkResult& OutResult)
+	{
+		if (!Object.TryGetStringField(TEXT("Scenario"), OutResult.Scenario))
+		{
+			return false;
+		}
+
+		Object.TryGetNumberField(TEXT("Characters"), OutResult.NumCharacters);
+		Object.TryGetStringField(TEXT("Layers"), OutResult.Layers);
+		Object.TryGetNumberField(TEXT("FramesPerRun"), OutResult.FramesPerRun);
+		Object.TryGetStringField(TEXT("Platform"), OutResult.Platform);
+		Object.TryGetStringField(TEXT("BuildConfiguration"), OutResult.BuildConfiguration);
+
+		const TSharedPtr<FJsonObject>* Stages = nullptr;
+		if (!Object.TryGetObjectField(TEXT("StageSamplesMs"), Stages))
+		{
+			return false;
+		}
+
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Stage : (*Stages)->Values)
+		{
+			TArray<double>& Samples = OutResult.StageSamplesMs.Add(Stage.Key);
+			for (const TSharedPtr<FJsonValue>& Sample : Stage.Value->AsArray())
+			{
+				Samples.Add(Sample->AsNumber());
+			}
+		}
+
+		return true;
+	}
+}
+
+bool FProceduralLocomotionBenchmarkResult::LoadFromFile(const FString& Filename, TArray<FProceduralLocomotionBenchmarkResult>& OutResults)
+{
+	FString Contents;
+	if (!FFileHelper::LoadFileToString(Contents, *Filename))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Contents), Root) || !Root.IsValid())
+	{
+		return false;
+	}
+
+	int32 Version = 0;
+	if (!Root->TryGetNumberField(TEXT("Version"), Version) || Version > FormatVersion)
+	{
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* Scenarios = nullptr;
+	if (!Root->TryGetArrayField(TEXT("Scenarios"), Scenarios))
+	{
+		return false;
+	}
+
+	for (const TSharedPtr<FJsonValue>& Value : *Scenarios)
+	{
+		const TSharedPtr<FJsonObject>* Object = nullptr;
+		FProceduralLocomotionBenchmarkResult Result;
+		if (Value->TryGetObject(Object) && ProceduralLocomotionBenchmarkResult::FromJson(**Object, Result))
+		{
+			OutResults.Add(MoveTemp(Result));
+		}
+	}
+
+	return true;
+}
+
+bool FProceduralLocomotionBenchmarkResult::SaveToFile(const FString& Filename, const TArray<FProceduralLocomotionBenchmarkResult>& Results)
+{
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("Version"), FormatVersion);
+
+	TArray<TSharedPtr<FJsonValue>> Scenarios;
+	for (const FProceduralLocomotionBenchmarkResult& Result : Results)
+	{
+		Scenarios.Add(MakeShared<FJsonValueObject>(ProceduralLocomotionBenchmarkResult::ToJson(Result)));
+	}
+	Root->SetArrayField(TEXT("Scenarios"), Scenarios);
+
+	FString Contents;
+	if (!FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Contents)))
+	{
+		return false;
+	}
+
+	return FFileHelper::SaveStringToFile(Contents, *Filename);
+}
+
+FString FProceduralLocomotionBenchmarkResult::MakeScenarioName(int32 NumCharacters, const FString& Layers)
+{
+	return FString::Printf(TEXT("Crowd%d_%s"), NumCharacters, Layers.IsEmpty() ? TEXT("None") : *Layers);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// One benchmark invocation: a scenario (character count + layer config) measured over several
+// runs. Each stage stores one sample per run, in milliseconds of game-thread time per frame.
+struct FProceduralLocomotionBenchmarkResult
+{
+	static constexpr int32 FormatVersion = 1;
+
+	FString Scenario;
+	int32 NumCharacters = 0;
+	FString Layers;
+	int32 FramesPerRun = 0;
+	FString Platform;
+	FString BuildConfiguration;
+
+	TMap<FString, TArray<double>> StageSamplesMs;
+
+	// Result files may hold one or more scenarios; these read and write the array form.
+	static bool LoadFromFile(const FString& Filename, TArray<FProceduralLocomotionBenchmarkResult>& OutResults);
+	static bool SaveToFile(const FString& Filename, const TArray<FProceduralLocomotionBenchmarkResult>& Results);
+
+	// Scenario names double as baseline file names, e.g. "Crowd64_Lean+Bone".
+	static FString MakeScenarioName(int32 NumCharacters, const FString& Layers);
+};
@@ -0,0 +1,330 @@
+#include "ProceduralLocomotionBenchmarkWorld.h"
+
+#include "ProceduralCharacter.h"
+#include "ProceduralLocomotionSettings.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Math/RandomStream.h"
+
+namespace ProceduralLocomotionBenchmark
+{
+	// The figure-8 from standalone_animation_demo.py, scaled from metres to centimetres.
+	static constexpr float PathAngularSpeed = 0.3f;
+	static constexpr float GroundHalfExtent = 20000.0f;
+	static constexpr float SpawnHeight = 100.0f;
+}
+
+FProceduralLocomotionBenchmarkWorld::FProceduralLocomotionBenchmarkWorld(const TCHAR* WorldName)
+{
+	if (!GEngine)
+	{
+		return;
+	}
+
+	World = UWorld::CreateWorld(EWorldType::Game, false, FName(WorldName));
+	if (!World)
+	{
+		return;
+	}
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	CharacterMesh = UProceduralLocomotionSettings::Get()->DefaultCharacterMesh.LoadSynchronous();
+
+	SpawnGround();
+}
+
+FProceduralLocomotionBenchmarkWorld::~FProceduralLocomotionBenchmarkWorld()
+{
+	if (!World)
+	{
+		return;
+	}
+
+	UnloadStreamingLevel();
+
+	Characters.Reset();
+	Pool.Reset();
+	Paths.Reset();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World = nullptr;
+}
+
+void FProceduralLocomotionBenchmarkWorld::SpawnGround()
+{
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!CubeMesh)
+	{
+		return;
+	}
+
+	// The basic cube is 100cm; scale it into a thin slab whose top face sits at Z = 0.
+	const float HalfExtent = ProceduralLocomotionBenchmark::GroundHalfExtent;
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AStaticMeshActor* Ground = World->SpawnActor<AStaticMeshActor>(FVector(0.0f, 0.0f, -50.0f), FRotator::ZeroRotator, SpawnParams);
+	if (Ground)
+	{
+		// Static components refuse mesh changes once the world is playing.
+		Ground->SetMobility(EComponentMobility::Movable);
+		Ground->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+		Ground->SetActorScale3D(FVector(HalfExtent / 50.0f, HalfExtent / 50.0f, 1.0f));
+	}
+}
+
+FProceduralLocomotionBenchmarkWorld::FPathParams FProceduralLocomotionBenchmarkWorld::MakePath(int32 Seed) const
+{
+	FRandomStream Stream(Seed);
+
+	FPathParams Path;
+	Path.Center = FVector(Stream.FRandRange(-0.5f, 0.5f), Stream.FRandRange(-0.5f, 0.5f), 0.0f) * ProceduralLocomotionBenchmark::GroundHalfExtent;
+	Path.Radius = Stream.FRandRange(200.0f, 400.0f);
+	Path.Phase = Stream.FRandRange(0.0f, 2.0f * PI);
+	return Path;
+}
+
+AProceduralCharacter* FProceduralLocomotionBenchmarkWorld::SpawnCharacter(int32 Seed, ULevel* OverrideLevel)
+{
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	const FPathParams Path = MakePath(Seed);
+	const FVector SpawnLocation = Path.Center + FVector(0.0f, 0.0f, ProceduralLocomotionBenchmark::SpawnHeight);
+	const FTransform SpawnTransform(FRotator::ZeroRotator, SpawnLocation);
+
+	// Deferred so the mesh is in place before BeginPlay and the character skips its default mesh lookup.
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.OverrideLevel = OverrideLevel;
+	SpawnParams.bDeferConstruction = true;
+
+	AProceduralCharacter* Character = World->SpawnActor<AProceduralCharacter>(AProceduralCharacter::StaticClass(), SpawnTransform, SpawnParams);
+	if (!Character)
+	{
+		return nullptr;
+	}
+
+	if (USkeletalMeshComponent* MeshComp = Character->GetMesh())
+	{
+		if (CharacterMesh)
+		{
+			MeshComp->SetSkeletalMesh(CharacterMesh);
+		}
+
+		// Nothing is rendered headless; make sure the pose is still evaluated every tick.
+		MeshComp->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	}
+
+	if (UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement())
+	{
+		// Benchmark characters are not possessed; let movement input drive them anyway.
+		MoveComp->bRunPhysicsWithNoController = true;
+	}
+
+	Character->FinishSpawning(SpawnTransform);
+
+	Characters.Add(Character);
+	Paths.Add(Character, Path);
+	return Character;
+}
+
+void FProceduralLocomotionBenchmarkWorld::DespawnCharacter(AProceduralCharacter* Character)
+{
+	if (!Character)
+	{
+		return;
+	}
+
+	Characters.RemoveSingleSwap(Character);
+	Pool.RemoveSingleSwap(Character);
+	Paths.Remove(Character);
+	Character->Destroy();
+}
+
+void FProceduralLocomotionBenchmarkWorld::ReleaseToPool(AProceduralCharacter* Character)
+{
+	if (!Character || Characters.RemoveSingleSwap(Character) == 0)
+	{
+		return;
+	}
+
+	Character->SetActorHiddenInGame(true);
+	Character->SetActorEnableCollision(false);
+	Character->SetActorTickEnabled(false);
+	if (USkeletalMeshComponent* MeshComp = Character->GetMesh())
+	{
+		MeshComp->SetComponentTickEnabled(false);
+	}
+	if (UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement())
+	{
+		MoveComp->StopMovementImmediately();
+		MoveComp->SetComponentTickEnabled(false);
+	}
+
+	Paths.Remove(Character);
+	Pool.Add(Character);
+}
+
+AProceduralCharacter* FProceduralLocomotionBenchmarkWorld::AcquireFromPool(int32 Seed)
+{
+	if (Pool.Num() == 0)
+	{
+		return SpawnCharacter(Seed);
+	}
+
+	AProceduralCharacter* Character = Pool.Pop();
+	const FPathParams Path = MakePath(Seed);
+	Character->TeleportTo(Path.Center + FVector(0.0f, 0.0f, ProceduralLocomotionBenchmark::SpawnHeight), FRotator::ZeroRotator);
+
+	Character->SetActorHiddenInGame(false);
+	Character->SetActorEnableCollision(true);
+	Character->SetActorTickEnabled(true);
+	if (USkeletalMeshComponent* MeshComp = Character->GetMesh())
+	{
+		MeshComp->SetComponentTickEnabled(true);
+
+		// A pooled character comes back with a fresh anim instance, as a newly spawned one would.
+		MeshComp->InitAnim(true);
+	}
+	if (UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement())
+	{
+		MoveComp->SetComponentTickEnabled(true);
+	}
+
+	Characters.Add(Character);
+	Paths.Add(Character, Path);
+	return Character;
+}
+
+void FProceduralLocomotionBenchmarkWorld::SetCharacterDormant(AProceduralCharacter* Character, bool bDormant)
+{
+	if (Character)
+	{
+		Character->SetNetDormancy(bDormant ? DORM_DormantAll : DORM_Awake);
+	}
+}
+
+bool FProceduralLocomotionBenchmarkWorld::LoadStreamingLevel(const FString& LevelPackageName)
+{
+	if (!World || StreamingLevel)
+	{
+		return false;
+	}
+
+	bool bSuccess = false;
+	StreamingLevel = ULevelStreamingDynamic::LoadLevelInstance(World, LevelPackageName, FVector::ZeroVector, FRotator::ZeroRotator, bSuccess);
+	if (!bSuccess || !StreamingLevel)
+	{
+		StreamingLevel = nullptr;
+		return false;
+	}
+
+	GEngine->BlockTillLevelStreamingCompleted(World);
+	return GetStreamedLevel() != nullptr;
+}
+
+void FProceduralLocomotionBenchmarkWorld::UnloadStreamingLevel()
+{
+	if (!World || !StreamingLevel)
+	{
+		return;
+	}
+
+	// Forget characters living in the level; unloading destroys them.
+	if (ULevel* Level = GetStreamedLevel())
+	{
+		for (int32 Index = Characters.Num() - 1; Index >= 0; --Index)
+		{
+			if (Characters[Index]->GetLevel() == Level)
+			{
+				Paths.Remove(Characters[Index]);
+				Characters.RemoveAtSwap(Index);
+			}
+		}
+		Pool.RemoveAllSwap([Level](const AProceduralCharacter* Character) { return Character->GetLevel() == Level; });
+	}
+
+	StreamingLevel->SetShouldBeLoaded(false);
+	StreamingLevel->SetShouldBeVisible(false);
+	StreamingLevel->SetIsRequestingUnloadAndRemoval(true);
+	GEngine->BlockTillLevelStreamingCompleted(World);
+	StreamingLevel = nullptr;
+}
+
+ULevel* FProceduralLocomotionBenchmarkWorld::GetStreamedLevel() const
+{
+	return StreamingLevel ? StreamingLevel->GetLoadedLevel() : nullptr;
+}
+
+void FProceduralLocomotionBenchmarkWorld::DriveCharacters()
+{
+	for (AProceduralCharacter* Character : Characters)
+	{
+		const FPathParams* Path = Paths.Find(Character);
+		if (!Path)
+		{
+			continue;
+		}
+
+		const float T = ElapsedTime * ProceduralLocomotionBenchmark::PathAngularSpeed + Path->Phase;
+		const FVector Target = Path->Center + FVector(Path->Radius * FMath::Sin(T), 0.5f * Path->Radius * FMath::Sin(2.0f * T), 0.0f);
+		const FVector ToTarget = (Target - Character->GetActorLocation()).GetSafeNormal2D();
+		Character->AddMovementInput(ToTarget, 1.0f);
+	}
+}
+
+void FProceduralLocomotionBenchmarkWorld::EmulateRendering()
+{
+	World->ViewLocationsRenderedLastFrame.Reset();
+	if (!Viewpoint.IsSet())
+	{
+		return;
+	}
+
+	World->ViewLocationsRenderedLastFrame.Add(Viewpoint.GetValue());
+
+	// Screen size as a 90 degree FOV view would compute it: bounds radius over distance.
+	const float RenderTime = World->GetTimeSeconds();
+	for (AProceduralCharacter* Character : Characters)
+	{
+		if (USkeletalMeshComponent* MeshComp = Character->GetMesh())
+		{
+			const float Distance = FMath::Max(FVector::Dist(MeshComp->Bounds.Origin, Viewpoint.GetValue()), 1.0f);
+			MeshComp->MaxDistanceFactor = MeshComp->Bounds.SphereRadius / Distance;
+			MeshComp->SetLastRenderTime(RenderTime);
+		}
+	}
+}
+
+void FProceduralLocomotionBenchmarkWorld::Step(float DeltaSeconds)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	DriveCharacters();
+	EmulateRendering();
+
+	// Update rate optimisations and anim caches key off the global frame counter, which only the
+	// engine loop advances; a commandlet has to move it along itself.
+	++GFrameCounter;
+	World->Tick(LEVELTICK_All, DeltaSeconds);
+	ElapsedTime += DeltaSeconds;
+}
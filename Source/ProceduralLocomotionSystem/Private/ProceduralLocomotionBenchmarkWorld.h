@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AProceduralCharacter;
+class ULevel;
+class ULevelStreamingDynamic;
+class USkeletalMesh;
+class UWorld;
+
+// Transient game world used by the headless benchmark commandlets. It owns a ground slab,
+// spawns procedural characters and steers them along deterministic figure-8 paths (the
+// same pattern the Python demo uses) so lean and turn-rate layers see realistic input.
+class FProceduralLocomotionBenchmarkWorld
+{
+public:
+	explicit FProceduralLocomotionBenchmarkWorld(const TCHAR* WorldName);
+	~FProceduralLocomotionBenchmarkWorld();
+
+	FProceduralLocomotionBenchmarkWorld(const FProceduralLocomotionBenchmarkWorld&) = delete;
+	FProceduralLocomotionBenchmarkWorld& operator=(const FProceduralLocomotionBenchmarkWorld&) = delete;
+
+	bool IsValid() const { return World != nullptr; }
+	UWorld* GetWorld() const { return World; }
+
+	// Mesh assigned to spawned characters before BeginPlay. Defaults to the project default character mesh.
+	void SetCharacterMesh(USkeletalMesh* InMesh) { CharacterMesh = InMesh; }
+
+	// Seed selects the path centre, phase and radius, so runs with equal seeds move identically.
+	// Characters spawned into a streamed level go away with it when it unloads.
+	AProceduralCharacter* SpawnCharacter(int32 Seed, ULevel* OverrideLevel = nullptr);
+	void DespawnCharacter(AProceduralCharacter* Character);
+
+	const TArray<AProceduralCharacter*>& GetCharacters() const { return Characters; }
+	int32 GetNumCharacters() const { return Characters.Num(); }
+
+	// --- Pooling: released characters are hidden and stop ticking instead of being destroyed ---
+	void ReleaseToPool(AProceduralCharacter* Character);
+	AProceduralCharacter* AcquireFromPool(int32 Seed);
+	int32 GetNumPooled() const { return Pool.Num(); }
+
+	void SetCharacterDormant(AProceduralCharacter* Character, bool bDormant);
+
+	// --- Level streaming: one dynamic level instance at a time ---
+	bool LoadStreamingLevel(const FString& LevelPackageName);
+	void UnloadStreamingLevel();
+	ULevel* GetStreamedLevel() const;
+
+	// Emulates a camera at this location. Headless there is no renderer to record view locations,
+	// render times and screen sizes, which distance LOD and update rate optimisations rely on.
+	void SetViewpoint(const FVector& InViewpoint) { Viewpoint = InViewpoint; }
+	void ClearViewpoint() { Viewpoint.Reset(); }
+
+	// Feeds path-following movement input and ticks the world once.
+	void Step(float DeltaSeconds);
+
+	float GetElapsedTime() const { return ElapsedTime; }
+
+private:
+	struct FPathParams
+	{
+		FVector Center = FVector::ZeroVector;
+		float Radius = 300.0f;
+		float Phase = 0.0f;
+	};
+
+	void SpawnGround();
+	void DriveCharacters();
+	void EmulateRendering();
+	FPathParams MakePath(int32 Seed) const;
+
+	UWorld* World = nullptr;
+	USkeletalMesh* CharacterMesh = nullptr;
+
+	TArray<AProceduralCharacter*> Characters;
+	TArray<AProceduralCharacter*> Pool;
+	TMap<const AProceduralCharacter*, FPathParams> Paths;
+
+	ULevelStreamingDynamic* StreamingLevel = nullptr;
+
+	TOptional<FVector> Viewpoint;
+
+	float ElapsedTime = 0.0f;
+};
@@ -0,0 +1,70 @@
+#include "ProceduralLocomotionCommandletUtils.h"
+
+#include "ProceduralLocomotionSystem.h"
+#include "Animation/AnimSequence.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+namespace ProceduralLocomotionCommandlet
+{
+	TArray<UAnimSequence*> LoadClips(const FString& Params)
+	{
+		FString Value;
+		FParse::Value(*Params, TEXT("Clips="), Value, false);
+		TArray<FString> Entries;
+		Value.ParseIntoArray(Entries, TEXT(","));
+
+		IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+		AssetRegistry.SearchAllAssets(true);
+
+		TArray<UAnimSequence*> Clips;
+		for (const FString& Entry : Entries)
+		{
+			TArray<FAssetData> Assets;
+			if (FPackageName::DoesPackageExist(Entry))
+			{
+				AssetRegistry.GetAssetsByPackageName(FName(*Entry), Assets);
+			}
+			else
+			{
+				FARFilter Filter;
+				Filter.PackagePaths.Add(FName(*Entry));
+				Filter.ClassPaths.Add(UAnimSequence::StaticClass()->GetClassPathName());
+				Filter.bRecursivePaths = true;
+				Filter.bRecursiveClasses = true;
+				AssetRegistry.GetAssets(Filter, Assets);
+			}
+
+			for (const FAssetData& Asset : Assets)
+			{
+				if (UAnimSequence* Clip = Cast<UAnimSequence>(Asset.GetAsset()))
+				{
+					Clips.AddUnique(Clip);
+				}
+			}
+		}
+		return Clips;
+	}
+
+	bool SaveAssetPackage(UObject* Asset)
+	{
+#if WITH_EDITOR
+		UPackage* Package = Asset->GetPackage();
+		Package->MarkPackageDirty();
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		if (!UPackage::SavePackage(Package, Asset, *Filename, SaveArgs))
+		{
+			UE_LOG(LogProceduralLocomotion, Error, TEXT("Could not save %s to %s."), *Asset->GetPathName(), *Filename);
+			return false;
+		}
+		return true;
+#else
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Could not save %s: saving packages requires an editor build."), *Asset->GetPathName());
+		return false;
+#endif
+	}
+}
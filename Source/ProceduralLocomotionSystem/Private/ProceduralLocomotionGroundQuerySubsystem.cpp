@@ -0,0 +1,209 @@
+#include "ProceduralLocomotionGroundQuerySubsystem.h"
+
+#include "ProceduralLocomotionSettings.h"
+#include "ProceduralLocomotionStats.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	// Queries not renewed and results not picked up for this long belong to characters that no
+	// longer need them (they lost the foot IK layer, found their ground, or went away).
+	constexpr double AbandonedSeconds = 1.0;
+
+	FAutoConsoleCommandWithWorld GroundQueryReportCommand(
+		TEXT("pls.GroundQuery.Report"),
+		TEXT("Logs the foot IK ground query scheduler: queries served against the budget, queue depth and query age."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UProceduralLocomotionGroundQuerySubsystem* GroundQueries = World ? World->GetSubsystem<UProceduralLocomotionGroundQuerySubsystem>() : nullptr)
+			{
+				GroundQueries->LogReport();
+			}
+		}));
+}
+
+void UProceduralLocomotionGroundQuerySubsystem::Deinitialize()
+{
+	Pending.Reset();
+	Served.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UProceduralLocomotionGroundQuerySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UProceduralLocomotionGroundQuerySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProceduralLocomotionGroundQuerySubsystem, STATGROUP_Tickables);
+}
+
+bool UProceduralLocomotionGroundQuerySubsystem::IsEnabled()
+{
+	return UProceduralLocomotionSettings::Get()->bScheduleGroundQueries;
+}
+
+uint64 UProceduralLocomotionGroundQuerySubsystem::MakeKey(const UObject* Requester, int32 Slot)
+{
+	return ((uint64)Requester->GetUniqueID() << 8) | (uint8)Slot;
+}
+
+void UProceduralLocomotionGroundQuerySubsystem::RequestQuery(const UObject* Requester, int32 Slot, const FProceduralLocomotionGroundQuery& Query)
+{
+	const double Now = FPlatformTime::Seconds();
+	FPendingQuery& Entry = Pending.FindOrAdd(MakeKey(Requester, Slot));
+	if (Entry.FirstRequestTime == 0.0)
+	{
+		Entry.FirstRequestTime = Now;
+	}
+	Entry.LastRequestTime = Now;
+	Entry.Query = Query;
+}
+
+bool UProceduralLocomotionGroundQuerySubsystem::ConsumeResult(const UObject* Requester, int32 Slot, FProceduralLocomotionGroundHit& OutHit)
+{
+	FServedQuery Result;
+	if (!Served.RemoveAndCopyValue(MakeKey(Requester, Slot), Result))
+	{
+		return false;
+	}
+	OutHit = Result.Hit;
+	return true;
+}
+
+void UProceduralLocomotionGroundQuerySubsystem::Tick(float DeltaTime)
+{
+	const UProceduralLocomotionSettings* Settings = UProceduralLocomotionSettings::Get();
+	Report.Budget = Settings->bScheduleGroundQueries ? Settings->GroundQueryBudget : 0;
+	Report.NumServed = 0;
+	Report.AverageAgeMs = 0.0f;
+	Report.MaxAgeMs = 0.0f;
+
+	const double Now = FPlatformTime::Seconds();
+	if (!Settings->bScheduleGroundQueries)
+	{
+		Pending.Reset();
+		Served.Reset();
+	}
+	RemoveAbandoned(Now);
+
+	if (Pending.Num() > 0)
+	{
+		struct FQueuedQuery
+		{
+			uint64 Key;
+			float Priority;
+		};
+		auto HigherPriority = [](const FQueuedQuery& A, const FQueuedQuery& B) { return A.Priority > B.Priority; };
+
+		const TArray<FVector>& ViewLocations = GetWorld()->ViewLocationsRenderedLastFrame;
+		TArray<FQueuedQuery> Queue;
+		Queue.Reserve(Pending.Num());
+		for (const TPair<uint64, FPendingQuery>& Pair : Pending)
+		{
+			Queue.Add({ Pair.Key, GetPriority(Pair.Value, ViewLocations, Now) });
+		}
+		Queue.Heapify(HigherPriority);
+
+		double TotalAgeSeconds = 0.0;
+		const int32 NumToServe = FMath::Min(Report.Budget, Queue.Num());
+		for (int32 Index = 0; Index < NumToServe; ++Index)
+		{
+			FQueuedQuery Next;
+			Queue.HeapPop(Next, HigherPriority);
+
+			const FPendingQuery Query = Pending.FindAndRemoveChecked(Next.Key);
+			FServedQuery& Result = Served.Add(Next.Key);
+			Result.Hit = Trace(Query.Query);
+			Result.ServedTime = Now;
+
+			const double AgeSeconds = Now - Query.FirstRequestTime;
+			TotalAgeSeconds += AgeSeconds;
+			Report.MaxAgeMs = FMath::Max(Report.MaxAgeMs, (float)(AgeSeconds * 1000.0));
+		}
+
+		Report.NumServed = NumToServe;
+		Report.AverageAgeMs = NumToServe > 0 ? (float)(TotalAgeSeconds * 1000.0 / NumToServe) : 0.0f;
+	}
+
+	Report.QueueDepth = Pending.Num();
+	Report.PeakQueueDepth = FMath::Max(Report.PeakQueueDepth, Report.QueueDepth);
+
+	SET_DWORD_STAT(STAT_PLS_GroundQueryQueueDepth, Report.QueueDepth);
+	SET_DWORD_STAT(STAT_PLS_GroundQueriesServed, Report.NumServed);
+	SET_FLOAT_STAT(STAT_PLS_GroundQueryBudgetUsed, Report.Budget > 0 ? 100.0f * Report.NumServed / Report.Budget : 0.0f);
+	SET_FLOAT_STAT(STAT_PLS_GroundQueryAverageAgeMs, Report.AverageAgeMs);
+	SET_FLOAT_STAT(STAT_PLS_GroundQueryMaxAgeMs, Report.MaxAgeMs);
+}
+
+void UProceduralLocomotionGroundQuerySubsystem::RemoveAbandoned(double Now)
+{
+	for (TMap<uint64, FPendingQuery>::TIterator It = Pending.CreateIterator(); It; ++It)
+	{
+		if (Now - It.Value().LastRequestTime > AbandonedSeconds)
+		{
+			It.RemoveCurrent();
+		}
+	}
+	for (TMap<uint64, FServedQuery>::TIterator It = Served.CreateIterator(); It; ++It)
+	{
+		if (Now - It.Value().ServedTime > AbandonedSeconds)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+float UProceduralLocomotionGroundQuerySubsystem::GetPriority(const FPendingQuery& Entry, const TArray<FVector>& ViewLocations, double Now) const
+{
+	const UProceduralLocomotionSettings* Settings = UProceduralLocomotionSettings::Get();
+	const FProceduralLocomotionGroundQuery& Query = Entry.Query;
+
+	// Same views as the LOD tiers: with none (a dedicated server) every character counts as near.
+	float Distance = 0.0f;
+	if (ViewLocations.Num() > 0)
+	{
+		float DistanceSq = TNumericLimits<float>::Max();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			DistanceSq = FMath::Min(DistanceSq, (float)FVector::DistSquared(Query.Start, ViewLocation));
+		}
+		Distance = FMath::Sqrt(DistanceSq);
+	}
+
+	// Bounds radius over distance stands in for the projected size; it orders characters the same way.
+	const float ScreenSize = Query.bRecentlyRendered ? FMath::Min(Query.BoundsRadius / FMath::Max(Distance, 1.0f), 1.0f) : 0.0f;
+	const float Nearness = 1.0f - FMath::Clamp(Distance / FMath::Max(Settings->GroundQueryFarDistance, 1.0f), 0.0f, 1.0f);
+	const float WaitSeconds = (float)(Now - Entry.FirstRequestTime);
+
+	return Settings->GroundQueryScreenSizeWeight * ScreenSize
+		+ Settings->GroundQueryDistanceWeight * Nearness
+		+ Settings->GroundQueryUrgencyWeight * Query.Urgency
+		+ Settings->GroundQueryStalenessWeight * WaitSeconds;
+}
+
+FProceduralLocomotionGroundHit UProceduralLocomotionGroundQuerySubsystem::Trace(const FProceduralLocomotionGroundQuery& Query) const
+{
+	FProceduralLocomotionGroundHit Result;
+	Result.bServed = true;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProceduralFootIK), false, Query.IgnoredActor.Get());
+	FHitResult Hit;
+	if (GetWorld()->LineTraceSingleByChannel(Hit, Query.Start, Query.End, ECC_Visibility, QueryParams))
+	{
+		Result.bHit = true;
+		Result.Location = Hit.ImpactPoint;
+		Result.Normal = FVector3f(Hit.ImpactNormal);
+	}
+	return Result;
+}
+
+void UProceduralLocomotionGroundQuerySubsystem::LogReport() const
+{
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Ground queries: %d / %d served last frame, %d queued (peak %d), age %.1f ms average, %.1f ms max"),
+		Report.NumServed, Report.Budget, Report.QueueDepth, Report.PeakQueueDepth, Report.AverageAgeMs, Report.MaxAgeMs);
+}
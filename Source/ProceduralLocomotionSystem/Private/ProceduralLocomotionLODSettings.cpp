@@ -0,0 +1,30 @@
+#include "ProceduralLocomotionLODSettings.h"
+
+FProceduralLocomotionLayers FProceduralLocomotionLODConfig::GetLayersForDistance(float Distance) const
+{
+	FProceduralLocomotionLayers Layers;
+	Layers.bProceduralBone = Distance <= ReducedDistance;
+	Layers.bLeaning = Distance <= MinimalDistance;
+	Layers.bFootIK = Distance <= FootIKMaxDistance;
+	return Layers;
+}
+
+const FProceduralLocomotionLODConfig* UProceduralLocomotionLODSettings::FindConfigForErrorBudget(float ErrorBudget) const
+{
+	const FProceduralLocomotionLODConfig* Cheapest = nullptr;
+	const FProceduralLocomotionLODConfig* MostAccurate = nullptr;
+
+	for (const FProceduralLocomotionLODConfig& Config : Configs)
+	{
+		if (Config.MeasuredError <= ErrorBudget && (!Cheapest || Config.MeasuredCostMs < Cheapest->MeasuredCostMs))
+		{
+			Cheapest = &Config;
+		}
+		if (!MostAccurate || Config.MeasuredError < MostAccurate->MeasuredError)
+		{
+			MostAccurate = &Config;
+		}
+	}
+
+	return Cheapest ? Cheapest : MostAccurate;
+}
@@ -0,0 +1,308 @@
+#include "ProceduralLocomotionLODTuningCommandlet.h"
+
+#include "ProceduralCharacter.h"
+#include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionBenchmarkWorld.h"
+#include "ProceduralLocomotionCommandletUtils.h"
+#include "ProceduralLocomotionLODSettings.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace ProceduralLocomotionLODTuning
+{
+	struct FTuningSettings
+	{
+		int32 NumCharacters = 128;
+		int32 NumFrames = 450;
+		int32 NumWarmupFrames = 60;
+		int32 NumRuns = 3;
+		float DeltaSeconds = 1.0f / 30.0f;
+		float LeanWeight = 1.0f;
+		float FootWeight = 0.2f;
+		FVector Viewpoint = FVector(0.0f, 0.0f, 170.0f);
+	};
+
+	// Per-frame, per-character values the error proxy compares against the reference run.
+	struct FPoseSamples
+	{
+		TArray<float> Lean;
+		TArray<FVector> LeftFoot;
+		TArray<FVector> RightFoot;
+
+		void Record(const TArray<AProceduralCharacter*>& Characters)
+		{
+			for (const AProceduralCharacter* Character : Characters)
+			{
+				const USkeletalMeshComponent* MeshComp = Character->GetMesh();
+				const UProceduralLocomotionAnimInstance* AnimInstance = MeshComp ? Cast<UProceduralLocomotionAnimInstance>(MeshComp->GetAnimInstance()) : nullptr;
+				if (!AnimInstance)
+				{
+					Lean.Add(0.0f);
+					LeftFoot.Add(FVector::ZeroVector);
+					RightFoot.Add(FVector::ZeroVector);
+					continue;
+				}
+
+				// Where the IK would put each foot: the animated foot plus the blended ground offset.
+				const float Alpha = AnimInstance->GetFootIKAlpha();
+				Lean.Add(AnimInstance->GetLeanAngle());
+				LeftFoot.Add(MeshComp->GetSocketLocation(TEXT("foot_l")) + FVector(0.0f, 0.0f, AnimInstance->GetLeftFootOffset() * Alpha));
+				RightFoot.Add(MeshComp->GetSocketLocation(TEXT("foot_r")) + FVector(0.0f, 0.0f, AnimInstance->GetRightFootOffset() * Alpha));
+			}
+		}
+	};
+
+	static float ComputeError(const FPoseSamples& Reference, const FPoseSamples& Candidate, const FTuningSettings& Settings)
+	{
+		const int32 NumSamples = FMath::Min(Reference.Lean.Num(), Candidate.Lean.Num());
+		if (NumSamples == 0)
+		{
+			return 0.0f;
+		}
+
+		double LeanSq = 0.0;
+		double FootSq = 0.0;
+		for (int32 Index = 0; Index < NumSamples; ++Index)
+		{
+			LeanSq += FMath::Square(Reference.Lean[Index] - Candidate.Lean[Index]);
+			FootSq += 0.5 * (FVector::DistSquared(Reference.LeftFoot[Index], Candidate.LeftFoot[Index])
+				+ FVector::DistSquared(Reference.RightFoot[Index], Candidate.RightFoot[Index]));
+		}
+
+		return Settings.LeanWeight * FMath::Sqrt(LeanSq / NumSamples) + Settings.FootWeight * FMath::Sqrt(FootSq / NumSamples);
+	}
+
+	// Runs the crowd with one config; returns the median frame cost and optionally records samples.
+	static float MeasureConfig(const FProceduralLocomotionLODConfig& Config, const FTuningSettings& Settings, FPoseSamples* OutSamples)
+	{
+		TArray<float> RunCostsMs;
+		for (int32 RunIndex = 0; RunIndex < Settings.NumRuns; ++RunIndex)
+		{
+			{
+				FProceduralLocomotionBenchmarkWorld BenchWorld(TEXT("ProceduralLocomotionLODTuning"));
+				if (!BenchWorld.IsValid())
+				{
+					return 0.0f;
+				}
+
+				BenchWorld.SetViewpoint(Settings.Viewpoint);
+				for (int32 CharacterIndex = 0; CharacterIndex < Settings.NumCharacters; ++CharacterIndex)
+				{
+					if (AProceduralCharacter* Character = BenchWorld.SpawnCharacter(CharacterIndex))
+					{
+						Character->SetLODConfig(Config);
+					}
+				}
+
+				for (int32 Frame = 0; Frame < Settings.NumWarmupFrames; ++Frame)
+				{
+					BenchWorld.Step(Settings.DeltaSeconds);
+				}
+
+				// Movement is identical for every config, so samples line up frame by frame.
+				const bool bRecord = OutSamples && RunIndex == 0;
+				uint64 Cycles = 0;
+				for (int32 Frame = 0; Frame < Settings.NumFrames; ++Frame)
+				{
+					const uint64 StartCycles = FPlatformTime::Cycles64();
+					BenchWorld.Step(Settings.DeltaSeconds);
+					Cycles += FPlatformTime::Cycles64() - StartCycles;
+
+					if (bRecord)
+					{
+						OutSamples->Record(BenchWorld.GetCharacters());
+					}
+				}
+
+				RunCostsMs.Add(FPlatformTime::ToMilliseconds64(Cycles) / Settings.NumFrames);
+			}
+
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+
+		RunCostsMs.Sort();
+		return RunCostsMs.Num() > 0 ? RunCostsMs[RunCostsMs.Num() / 2] : 0.0f;
+	}
+
+	static TArray<float> ParseFloatList(const FString& Params, const TCHAR* Key, const TCHAR* Default)
+	{
+		FString Value = Default;
+		FParse::Value(*Params, Key, Value, false);
+
+		TArray<FString> Items;
+		Value.ParseIntoArray(Items, TEXT(","));
+
+		TArray<float> Values;
+		for (const FString& Item : Items)
+		{
+			Values.Add(FCString::Atof(*Item));
+		}
+		return Values;
+	}
+
+	// Keeps the configs no other config beats on both cost and error, cheapest first.
+	static TArray<FProceduralLocomotionLODConfig> ParetoFront(TArray<FProceduralLocomotionLODConfig> Configs)
+	{
+		Configs.Sort([](const FProceduralLocomotionLODConfig& A, const FProceduralLocomotionLODConfig& B)
+		{
+			return A.MeasuredCostMs != B.MeasuredCostMs ? A.MeasuredCostMs < B.MeasuredCostMs : A.MeasuredError < B.MeasuredError;
+		});
+
+		TArray<FProceduralLocomotionLODConfig> Front;
+		float BestError = TNumericLimits<float>::Max();
+		for (const FProceduralLocomotionLODConfig& Config : Configs)
+		{
+			if (Config.MeasuredError < BestError)
+			{
+				BestError = Config.MeasuredError;
+				Front.Add(Config);
+			}
+		}
+		return Front;
+	}
+
+	static FString ConfigToCsvRow(const FProceduralLocomotionLODConfig& Config, bool bPareto)
+	{
+		FString Thresholds;
+		for (const float Threshold : Config.UROVisibleDistanceFactorThresholds)
+		{
+			Thresholds += FString::Printf(TEXT("%s%.3f"), Thresholds.IsEmpty() ? TEXT("") : TEXT(" "), Threshold);
+		}
+
+		return FString::Printf(TEXT("%.0f,%.0f,%.0f,%d,%s,%.4f,%.4f,%d\n"),
+			Config.ReducedDistance, Config.MinimalDistance, Config.FootIKMaxDistance,
+			Config.bEnableUpdateRateOptimizations ? 1 : 0, *Thresholds,
+			Config.MeasuredCostMs, Config.MeasuredError, bPareto ? 1 : 0);
+	}
+
+	static bool SaveSettingsAsset(const FString& PackageName, const TArray<FProceduralLocomotionLODConfig>& Configs)
+	{
+#if WITH_EDITOR
+		UPackage* Package = CreatePackage(*PackageName);
+		const FString AssetName = FPackageName::GetLongPackageAssetName(PackageName);
+
+		UProceduralLocomotionLODSettings* Settings = NewObject<UProceduralLocomotionLODSettings>(Package, *AssetName, RF_Public | RF_Standalone);
+		Settings->Configs = Configs;
+		return ProceduralLocomotionCommandlet::SaveAssetPackage(Settings);
+#else
+		return false;
+#endif
+	}
+}
+
+UProceduralLocomotionLODTuningCommandlet::UProceduralLocomotionLODTuningCommandlet()
+{
+	LogToConsole = true;
+}
+
+int32 UProceduralLocomotionLODTuningCommandlet::Main(const FString& Params)
+{
+	using namespace ProceduralLocomotionLODTuning;
+
+	FTuningSettings Settings;
+	FParse::Value(*Params, TEXT("Characters="), Settings.NumCharacters);
+	FParse::Value(*Params, TEXT("Frames="), Settings.NumFrames);
+	FParse::Value(*Params, TEXT("Warmup="), Settings.NumWarmupFrames);
+	FParse::Value(*Params, TEXT("Runs="), Settings.NumRuns);
+	FParse::Value(*Params, TEXT("DeltaTime="), Settings.DeltaSeconds);
+	FParse::Value(*Params, TEXT("LeanWeight="), Settings.LeanWeight);
+	FParse::Value(*Params, TEXT("FootWeight="), Settings.FootWeight);
+	Settings.NumFrames = FMath::Max(Settings.NumFrames, 1);
+	Settings.NumRuns = FMath::Max(Settings.NumRuns, 1);
+
+	const TArray<float> ReducedDistances = ParseFloatList(Params, TEXT("ReducedDistances="), TEXT("1000,2000,4000"));
+	const TArray<float> MinimalDistances = ParseFloatList(Params, TEXT("MinimalDistances="), TEXT("3000,6000,10000"));
+	const TArray<float> FootIKDistances = ParseFloatList(Params, TEXT("FootIKDistances="), TEXT("1000,2000,4000"));
+	const TArray<float> UROScales = ParseFloatList(Params, TEXT("UROScales="), TEXT("0,0.5,1,2"));
+
+	FString OutputAsset = TEXT("/Game/Locomotion/DA_LocomotionLODSettings");
+	FString ReportFile = FPaths::ProjectSavedDir() / TEXT("Benchmarks/LODTuning.csv");
+	FParse::Value(*Params, TEXT("OutputAsset="), OutputAsset);
+	FParse::Value(*Params, TEXT("Report="), ReportFile);
+
+	// Reference: everything on at every distance, no update rate optimisations.
+	FProceduralLocomotionLODConfig Reference;
+	Reference.ReducedDistance = TNumericLimits<float>::Max();
+	Reference.MinimalDistance = TNumericLimits<float>::Max();
+	Reference.FootIKMaxDistance = TNumericLimits<float>::Max();
+	Reference.bEnableUpdateRateOptimizations = false;
+
+	FPoseSamples ReferenceSamples;
+	const float ReferenceCostMs = MeasureConfig(Reference, Settings, &ReferenceSamples);
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("LOD tuning: full quality reference costs %.3f ms/frame."), ReferenceCostMs);
+
+	const FProceduralLocomotionLODConfig DefaultConfig;
+	TArray<FProceduralLocomotionLODConfig> Candidates;
+	for (const float ReducedDistance : ReducedDistances)
+	{
+		for (const float MinimalDistance : MinimalDistances)
+		{
+			if (MinimalDistance < ReducedDistance)
+			{
+				continue;
+			}
+
+			for (const float FootIKDistance : FootIKDistances)
+			{
+				for (const float UROScale : UROScales)
+				{
+					FProceduralLocomotionLODConfig Config;
+					Config.ReducedDistance = ReducedDistance;
+					Config.MinimalDistance = MinimalDistance;
+					Config.FootIKMaxDistance = FootIKDistance;
+					Config.bEnableUpdateRateOptimizations = UROScale > 0.0f;
+
+					// Larger scale = higher screen-size thresholds = frame skipping starts closer.
+					Config.UROVisibleDistanceFactorThresholds.Reset();
+					for (const float Threshold : DefaultConfig.UROVisibleDistanceFactorThresholds)
+					{
+						Config.UROVisibleDistanceFactorThresholds.Add(Threshold * FMath::Max(UROScale, 0.0f));
+					}
+
+					Candidates.Add(Config);
+				}
+			}
+		}
+	}
+
+	for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+	{
+		FProceduralLocomotionLODConfig& Config = Candidates[Index];
+
+		FPoseSamples Samples;
+		Config.MeasuredCostMs = MeasureConfig(Config, Settings, &Samples);
+		Config.MeasuredError = ComputeError(ReferenceSamples, Samples, Settings);
+
+		UE_LOG(LogProceduralLocomotion, Display, TEXT("LOD tuning [%d/%d]: reduced %.0f, minimal %.0f, foot IK %.0f, URO %s -> %.3f ms, error %.3f"),
+			Index + 1, Candidates.Num(), Config.ReducedDistance, Config.MinimalDistance, Config.FootIKMaxDistance,
+			Config.bEnableUpdateRateOptimizations ? TEXT("on") : TEXT("off"), Config.MeasuredCostMs, Config.MeasuredError);
+	}
+
+	const TArray<FProceduralLocomotionLODConfig> Front = ParetoFront(Candidates);
+
+	FString Report = TEXT("ReducedDistance,MinimalDistance,FootIKMaxDistance,URO,UROThresholds,CostMs,Error,Pareto\n");
+	for (const FProceduralLocomotionLODConfig& Config : Candidates)
+	{
+		const bool bPareto = Front.ContainsByPredicate([&Config](const FProceduralLocomotionLODConfig& Other)
+		{
+			return Other.MeasuredCostMs == Config.MeasuredCostMs && Other.MeasuredError == Config.MeasuredError;
+		});
+		Report += ConfigToCsvRow(Config, bPareto);
+	}
+	FFileHelper::SaveStringToFile(Report, *ReportFile);
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("LOD tuning: %d of %d configs are Pareto-optimal; report at %s"), Front.Num(), Candidates.Num(), *ReportFile);
+
+	if (!SaveSettingsAsset(OutputAsset, Front))
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("LOD tuning: failed to save %s (requires an editor build)."), *OutputAsset);
+		return 1;
+	}
+
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("LOD tuning: wrote %s"), *OutputAsset);
+	return 0;
+}
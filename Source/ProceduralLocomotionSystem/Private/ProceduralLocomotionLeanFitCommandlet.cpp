@@ -0,0 +1,421 @@
+#include "ProceduralLocomotionLeanFitCommandlet.h"
+
+#include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionCommandletUtils.h"
+#include "ProceduralLocomotionMath.h"
+#include "ProceduralLocomotionProfile.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace ProceduralLocomotionLeanFit
+{
+	struct FFitSettings
+	{
+		FName LeanBone = TEXT("spine_01");
+		FName LeanTipBone = TEXT("neck_01");
+		// Character forward in component space; +Y for the UE5 mannequin.
+		FVector MeshForward = FVector::RightVector;
+		int32 SampleRate = 60;
+		// The model starts from zero lean; the first samples of each clip only settle it.
+		float WarmupSeconds = 0.5f;
+	};
+
+	// What UpdateProceduralLeaning would see for one clip, next to the lean the performer showed.
+	struct FClipSamples
+	{
+		FString Name;
+		float DeltaSeconds = 0.0f;
+		TArray<float> LocalAccelY;
+		TArray<float> YawRate;
+		TArray<float> Lean;
+	};
+
+	// Bones from the root down to the lean tip, so both bones' component transforms come out of one pass.
+	static TArray<int32> GetChainToRoot(const FReferenceSkeleton& RefSkeleton, int32 TipIndex)
+	{
+		TArray<int32> Chain;
+		for (int32 Bone = TipIndex; Bone != INDEX_NONE; Bone = RefSkeleton.GetParentIndex(Bone))
+		{
+			Chain.Insert(Bone, 0);
+		}
+		return Chain;
+	}
+
+	// Sideways tilt (degrees, positive to the character's right) of a vector in root space.
+	static float GetTiltDegrees(const FVector& Vector, const FVector& MeshForward)
+	{
+		const FVector Right = FVector::CrossProduct(FVector::UpVector, MeshForward);
+		return FMath::RadiansToDegrees(FMath::Atan2(FVector::DotProduct(Vector, Right), FVector::DotProduct(Vector, FVector::UpVector)));
+	}
+
+	static bool ExtractClip(const UAnimSequence* Clip, const FFitSettings& Settings, FClipSamples& OutSamples)
+	{
+		const USkeleton* Skeleton = Clip->GetSkeleton();
+		if (!Skeleton)
+		{
+			return false;
+		}
+
+		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+		const int32 LeanIndex = RefSkeleton.FindBoneIndex(Settings.LeanBone);
+		const int32 TipIndex = RefSkeleton.FindBoneIndex(Settings.LeanTipBone);
+		if (LeanIndex == INDEX_NONE || TipIndex == INDEX_NONE)
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("Lean fit: %s's skeleton lacks %s or %s; skipped."),
+				*Clip->GetName(), *Settings.LeanBone.ToString(), *Settings.LeanTipBone.ToString());
+			return false;
+		}
+
+		const TArray<int32> Chain = GetChainToRoot(RefSkeleton, TipIndex);
+		const int32 LeanChainIndex = Chain.Find(LeanIndex);
+		if (LeanChainIndex == INDEX_NONE)
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("Lean fit: %s is not a parent of %s; skipped."),
+				*Settings.LeanBone.ToString(), *Settings.LeanTipBone.ToString());
+			return false;
+		}
+
+		// Neutral tilt of the reference pose, so a spine that is not modelled upright reads as zero lean.
+		FTransform RefLean = FTransform::Identity;
+		FTransform RefTip = FTransform::Identity;
+		{
+			FTransform Component = FTransform::Identity;
+			for (int32 ChainIndex = 0; ChainIndex < Chain.Num(); ++ChainIndex)
+			{
+				Component = RefSkeleton.GetRefBonePose()[Chain[ChainIndex]] * Component;
+				if (ChainIndex == LeanChainIndex)
+				{
+					RefLean = Component;
+				}
+			}
+			RefTip = Component;
+		}
+		const FTransform& RefRoot = RefSkeleton.GetRefBonePose()[0];
+		const float NeutralTilt = GetTiltDegrees(RefRoot.InverseTransformVectorNoScale(RefTip.GetTranslation() - RefLean.GetTranslation()), Settings.MeshForward);
+
+		const int32 NumSamples = FMath::FloorToInt(Clip->GetPlayLength() * Settings.SampleRate) + 1;
+		const float Dt = 1.0f / Settings.SampleRate;
+		TArray<FVector> RootPositions;
+		TArray<FVector> Forwards;
+		TArray<float> Tilts;
+		RootPositions.Reserve(NumSamples);
+		Forwards.Reserve(NumSamples);
+		Tilts.Reserve(NumSamples);
+
+		for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+		{
+			const FAnimExtractContext Context((double)Sample * Dt);
+			FTransform Component = FTransform::Identity;
+			FTransform Root = FTransform::Identity;
+			FTransform Lean = FTransform::Identity;
+			for (int32 ChainIndex = 0; ChainIndex < Chain.Num(); ++ChainIndex)
+			{
+				FTransform Local;
+				Clip->GetBoneTransform(Local, FSkeletonPoseBoneIndex(Chain[ChainIndex]), Context, false);
+				Component = Local * Component;
+				if (ChainIndex == 0)
+				{
+					Root = Component;
+				}
+				if (ChainIndex == LeanChainIndex)
+				{
+					Lean = Component;
+				}
+			}
+
+			RootPositions.Add(Root.GetTranslation());
+			Forwards.Add(Root.TransformVectorNoScale(Settings.MeshForward).GetSafeNormal2D());
+			Tilts.Add(GetTiltDegrees(Root.InverseTransformVectorNoScale(Component.GetTranslation() - Lean.GetTranslation()), Settings.MeshForward) - NeutralTilt);
+		}
+
+		// In-place clips carry no acceleration or turning to learn from.
+		constexpr float MinRootTravel = 50.0f;
+		if (NumSamples < 5 || FVector::Dist2D(RootPositions[0], RootPositions.Last()) < MinRootTravel)
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("Lean fit: %s has no root motion; skipped."), *Clip->GetName());
+			return false;
+		}
+
+		OutSamples.Name = Clip->GetPathName();
+		OutSamples.DeltaSeconds = Dt;
+
+		// Central differences two samples wide, which smooths capture jitter without lagging the signal.
+		constexpr int32 Step = 2;
+		for (int32 Sample = Step; Sample < NumSamples - Step; ++Sample)
+		{
+			const FVector Accel = (RootPositions[Sample + Step] - 2.0 * RootPositions[Sample] + RootPositions[Sample - Step]) / FMath::Square(Step * Dt);
+			const FVector Right = FVector::CrossProduct(FVector::UpVector, Forwards[Sample]);
+			const float Yaw = Forwards[Sample].Rotation().Yaw;
+			const float LastYaw = Forwards[Sample - 1].Rotation().Yaw;
+
+			OutSamples.LocalAccelY.Add((float)FVector::DotProduct(Accel, Right));
+			OutSamples.YawRate.Add(ProceduralLocomotionMath::FindDeltaAngleDegrees(LastYaw, Yaw) / Dt);
+			OutSamples.Lean.Add(Tilts[Sample]);
+		}
+		return true;
+	}
+
+	// Lean the model produces for one clip; returns the summed squared error after warmup.
+	static double SimulateClip(const FClipSamples& Clip, const ProceduralLocomotionMath::FLeanParams& Params, int32 WarmupSamples, int32& OutNumSamples)
+	{
+		double ErrorSq = 0.0;
+		OutNumSamples = 0;
+
+		float Lean = 0.0f;
+		for (int32 Sample = 0; Sample < Clip.Lean.Num(); ++Sample)
+		{
+			const float Target = ProceduralLocomotionMath::ComputeTargetLean(Clip.LocalAccelY[Sample], Clip.YawRate[Sample], Params);
+			Lean = ProceduralLocomotionMath::InterpTo(Lean, Target, Clip.DeltaSeconds, Params.LeanInterpSpeed);
+			if (Sample >= WarmupSamples)
+			{
+				ErrorSq += FMath::Square(Lean - Clip.Lean[Sample]);
+				++OutNumSamples;
+			}
+		}
+		return ErrorSq;
+	}
+
+	static float ComputeRMSError(const TArray<FClipSamples>& Clips, const ProceduralLocomotionMath::FLeanParams& Params, int32 WarmupSamples)
+	{
+		double ErrorSq = 0.0;
+		int64 NumSamples = 0;
+		for (const FClipSamples& Clip : Clips)
+		{
+			int32 ClipSamples = 0;
+			ErrorSq += SimulateClip(Clip, Params, WarmupSamples, ClipSamples);
+			NumSamples += ClipSamples;
+		}
+		return NumSamples > 0 ? (float)FMath::Sqrt(ErrorSq / NumSamples) : 0.0f;
+	}
+
+	struct FCandidate
+	{
+		ProceduralLocomotionMath::FLeanParams Params;
+		float RMSErrorDegrees = TNumericLimits<float>::Max();
+	};
+
+	// Best multipliers and max angle for one interp speed. The lag filter is linear, so without the
+	// clamp lean = A * lag(accel) + B * lag(yaw rate): a 2x2 least-squares problem.
+	static FCandidate FitForInterpSpeed(const TArray<FClipSamples>& Clips, float InterpSpeed, const TArray<float>& MaxLeanCandidates, int32 WarmupSamples)
+	{
+		double XX = 0.0, XY = 0.0, YY = 0.0, XL = 0.0, YL = 0.0;
+		for (const FClipSamples& Clip : Clips)
+		{
+			const float Alpha = FMath::Clamp(Clip.DeltaSeconds * InterpSpeed, 0.0f, 1.0f);
+			double FilteredAccel = 0.0;
+			double FilteredYawRate = 0.0;
+			for (int32 Sample = 0; Sample < Clip.Lean.Num(); ++Sample)
+			{
+				FilteredAccel += Alpha * (Clip.LocalAccelY[Sample] - FilteredAccel);
+				FilteredYawRate += Alpha * (Clip.YawRate[Sample] - FilteredYawRate);
+				if (Sample >= WarmupSamples)
+				{
+					XX += FilteredAccel * FilteredAccel;
+					XY += FilteredAccel * FilteredYawRate;
+					YY += FilteredYawRate * FilteredYawRate;
+					XL += FilteredAccel * Clip.Lean[Sample];
+					YL += FilteredYawRate * Clip.Lean[Sample];
+				}
+			}
+		}
+
+		// A touch of ridge keeps the solve stable when the library never turns or never accelerates.
+		const double Ridge = 1.e-9 * (XX + YY) + UE_DOUBLE_SMALL_NUMBER;
+		XX += Ridge;
+		YY += Ridge;
+		const double Det = XX * YY - XY * XY;
+
+		FCandidate Best;
+		Best.Params.LeanInterpSpeed = InterpSpeed;
+		Best.Params.AccelerationLeanMultiplier = (float)((XL * YY - YL * XY) / Det);
+		Best.Params.YawRateLeanMultiplier = (float)((YL * XX - XL * XY) / Det);
+
+		for (const float MaxLean : MaxLeanCandidates)
+		{
+			ProceduralLocomotionMath::FLeanParams Params = Best.Params;
+			Params.MaxLeanAngle = MaxLean;
+			const float Error = ComputeRMSError(Clips, Params, WarmupSamples);
+			if (Error < Best.RMSErrorDegrees)
+			{
+				Best.Params = Params;
+				Best.RMSErrorDegrees = Error;
+			}
+		}
+		return Best;
+	}
+
+	static TArray<float> GetMaxLeanCandidates(const TArray<FClipSamples>& Clips)
+	{
+		TArray<float> AbsLean;
+		for (const FClipSamples& Clip : Clips)
+		{
+			for (const float Lean : Clip.Lean)
+			{
+				AbsLean.Add(FMath::Abs(Lean));
+			}
+		}
+		AbsLean.Sort();
+
+		TArray<float> Candidates;
+		for (const float Percentile : { 0.90f, 0.95f, 0.98f, 0.99f, 0.995f, 1.0f })
+		{
+			const int32 Index = FMath::Clamp(FMath::FloorToInt(Percentile * (AbsLean.Num() - 1)), 0, AbsLean.Num() - 1);
+			Candidates.AddUnique(FMath::Max(AbsLean[Index], 1.0f));
+		}
+		return Candidates;
+	}
+
+	static UProceduralLocomotionProfile* FindProfile(const FString& PackageName)
+	{
+		const FString ObjectPath = PackageName + TEXT(".") + FPackageName::GetLongPackageAssetName(PackageName);
+		return FPackageName::DoesPackageExist(PackageName)
+			? LoadObject<UProceduralLocomotionProfile>(nullptr, *ObjectPath)
+			: nullptr;
+	}
+
+	static bool SaveProfile(const FString& PackageName, const ProceduralLocomotionMath::FLeanParams& LeanParams, const FProceduralLocomotionLeanFit& Fit)
+	{
+#if WITH_EDITOR
+		UProceduralLocomotionProfile* Profile = FindProfile(PackageName);
+		UPackage* Package = Profile ? Profile->GetPackage() : CreatePackage(*PackageName);
+		if (!Profile)
+		{
+			const FString AssetName = FPackageName::GetLongPackageAssetName(PackageName);
+			Profile = NewObject<UProceduralLocomotionProfile>(Package, *AssetName, RF_Public | RF_Standalone);
+		}
+
+		// Only the leaning values are fitted; anything else in an existing profile is kept.
+		Profile->SetLeanParams(LeanParams);
+		Profile->LeanFit = Fit;
+		return ProceduralLocomotionCommandlet::SaveAssetPackage(Profile);
+#else
+		return false;
+#endif
+	}
+}
+
+UProceduralLocomotionLeanFitCommandlet::UProceduralLocomotionLeanFitCommandlet()
+{
+	LogToConsole = true;
+}
+
+int32 UProceduralLocomotionLeanFitCommandlet::Main(const FString& Params)
+{
+	using namespace ProceduralLocomotionLeanFit;
+
+	FFitSettings Settings;
+	FParse::Value(*Params, TEXT("LeanBone="), Settings.LeanBone);
+	FParse::Value(*Params, TEXT("LeanTipBone="), Settings.LeanTipBone);
+	FParse::Value(*Params, TEXT("SampleRate="), Settings.SampleRate);
+	Settings.SampleRate = FMath::Clamp(Settings.SampleRate, 10, 240);
+	FString ForwardAxis;
+	if (FParse::Value(*Params, TEXT("ForwardAxis="), ForwardAxis))
+	{
+		Settings.MeshForward = ForwardAxis.Equals(TEXT("X"), ESearchCase::IgnoreCase) ? FVector::ForwardVector : FVector::RightVector;
+	}
+
+	FString ProfilePath = TEXT("/Game/Locomotion/DA_LocomotionProfile");
+	FString ReportFile = FPaths::ProjectSavedDir() / TEXT("Benchmarks/LeanFit.csv");
+	FParse::Value(*Params, TEXT("Profile="), ProfilePath);
+	FParse::Value(*Params, TEXT("Report="), ReportFile);
+
+	const TArray<UAnimSequence*> SourceClips = ProceduralLocomotionCommandlet::LoadClips(Params);
+	if (SourceClips.Num() == 0)
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Lean fit: -Clips=<Folder or AnimSequence,...> matched no animation sequences."));
+		return 1;
+	}
+
+	// Clips are loaded on the game thread above; reading their tracks is safe from workers.
+	TArray<FClipSamples> Extracted;
+	Extracted.SetNum(SourceClips.Num());
+	TArray<bool> Valid;
+	Valid.Init(false, SourceClips.Num());
+	ParallelFor(SourceClips.Num(), [&](int32 ClipIndex)
+	{
+		Valid[ClipIndex] = ExtractClip(SourceClips[ClipIndex], Settings, Extracted[ClipIndex]);
+	});
+
+	TArray<FClipSamples> Clips;
+	int32 NumSamples = 0;
+	for (int32 ClipIndex = 0; ClipIndex < Extracted.Num(); ++ClipIndex)
+	{
+		if (Valid[ClipIndex])
+		{
+			NumSamples += Extracted[ClipIndex].Lean.Num();
+			Clips.Add(MoveTemp(Extracted[ClipIndex]));
+		}
+	}
+	if (Clips.Num() == 0)
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Lean fit: none of the %d clips could be used."), SourceClips.Num());
+		return 1;
+	}
+
+	const int32 WarmupSamples = FMath::RoundToInt(Settings.WarmupSeconds * Settings.SampleRate);
+	const TArray<float> MaxLeanCandidates = GetMaxLeanCandidates(Clips);
+
+	// Interp speeds from a slow 0.5/s to practically instant, evenly spaced in log.
+	constexpr int32 NumInterpSpeeds = 32;
+	TArray<FCandidate> Candidates;
+	Candidates.SetNum(NumInterpSpeeds);
+	ParallelFor(NumInterpSpeeds, [&](int32 Index)
+	{
+		const float InterpSpeed = 0.5f * FMath::Pow(120.0f, (float)Index / (NumInterpSpeeds - 1));
+		Candidates[Index] = FitForInterpSpeed(Clips, InterpSpeed, MaxLeanCandidates, WarmupSamples);
+	});
+
+	const FCandidate* Best = &Candidates[0];
+	for (const FCandidate& Candidate : Candidates)
+	{
+		if (Candidate.RMSErrorDegrees < Best->RMSErrorDegrees)
+		{
+			Best = &Candidate;
+		}
+	}
+
+	// Compare against what characters use today: the existing profile, else the anim instance defaults.
+	const UProceduralLocomotionProfile* ExistingProfile = FindProfile(ProfilePath);
+	const ProceduralLocomotionMath::FLeanParams PreviousParams = ExistingProfile
+		? ExistingProfile->GetLeanParams()
+		: GetDefault<UProceduralLocomotionAnimInstance>()->GetLeanParams();
+
+	FProceduralLocomotionLeanFit Fit;
+	Fit.RMSErrorDegrees = Best->RMSErrorDegrees;
+	Fit.PreviousRMSErrorDegrees = ComputeRMSError(Clips, PreviousParams, WarmupSamples);
+	Fit.NumClips = Clips.Num();
+	Fit.NumSamples = NumSamples;
+	Fit.FitTime = FDateTime::UtcNow();
+
+	FString Report = TEXT("Clip,Samples,RMSErrorDegrees,PreviousRMSErrorDegrees\n");
+	for (const FClipSamples& Clip : Clips)
+	{
+		int32 ClipSamples = 0;
+		const double ErrorSq = SimulateClip(Clip, Best->Params, WarmupSamples, ClipSamples);
+		const double PreviousErrorSq = SimulateClip(Clip, PreviousParams, WarmupSamples, ClipSamples);
+		Report += FString::Printf(TEXT("%s,%d,%.3f,%.3f\n"), *Clip.Name, ClipSamples,
+			FMath::Sqrt(ErrorSq / FMath::Max(ClipSamples, 1)), FMath::Sqrt(PreviousErrorSq / FMath::Max(ClipSamples, 1)));
+	}
+	FFileHelper::SaveStringToFile(Report, *ReportFile);
+
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Lean fit: %d clips, %d samples. MaxLeanAngle %.2f, AccelerationLeanMultiplier %.5f, YawRateLeanMultiplier %.5f, LeanInterpSpeed %.2f"),
+		Fit.NumClips, Fit.NumSamples, Best->Params.MaxLeanAngle, Best->Params.AccelerationLeanMultiplier, Best->Params.YawRateLeanMultiplier, Best->Params.LeanInterpSpeed);
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Lean fit: RMS error %.3f deg (previous parameters %.3f deg); per-clip report at %s"),
+		Fit.RMSErrorDegrees, Fit.PreviousRMSErrorDegrees, *ReportFile);
+
+	if (!SaveProfile(ProfilePath, Best->Params, Fit))
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Lean fit: failed to save %s (requires an editor build)."), *ProfilePath);
+		return 1;
+	}
+
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Lean fit: wrote %s"), *ProfilePath);
+	return 0;
+}
@@ -0,0 +1,171 @@
+#include "ProceduralLocomotionMarkerIndex.h"
+
+#include "Animation/AnimationAsset.h"
+
+const UProceduralLocomotionMarkerIndex* UProceduralLocomotionMarkerIndex::Find(const UAnimationAsset* Asset)
+{
+	const UProceduralLocomotionMarkerIndex* Index = Asset
+		? const_cast<UAnimationAsset*>(Asset)->GetAssetUserData<UProceduralLocomotionMarkerIndex>()
+		: nullptr;
+	return Index && Index->IsValid() ? Index : nullptr;
+}
+
+void UProceduralLocomotionMarkerIndex::Build(TArray<TPair<FName, float>> Markers, float InSequenceLength, const TMap<FName, float>& NamePhases)
+{
+	SequenceLength = InSequenceLength;
+	MarkerNames.Reset();
+	MarkerNamePhases.Reset();
+	Positions.Reset();
+	NameIndices.Reset();
+	Buckets.Reset();
+	BucketShift = 16;
+
+	if (SequenceLength <= 0.0f)
+	{
+		return;
+	}
+
+	Markers.Sort([](const TPair<FName, float>& A, const TPair<FName, float>& B) { return A.Value < B.Value; });
+	for (const TPair<FName, float>& Marker : Markers)
+	{
+		const float* Phase = NamePhases.Find(Marker.Key);
+		if (!Phase || Positions.Num() == MAX_uint16)
+		{
+			continue;
+		}
+
+		int32 NameIndex = MarkerNames.Find(Marker.Key);
+		if (NameIndex == INDEX_NONE)
+		{
+			if (MarkerNames.Num() == MAX_uint8)
+			{
+				continue;
+			}
+			NameIndex = MarkerNames.Add(Marker.Key);
+			MarkerNamePhases.Add(FMath::Frac(*Phase));
+		}
+
+		const float Normalized = FMath::Clamp(Marker.Value / SequenceLength, 0.0f, 1.0f);
+		Positions.Add((uint16)FMath::Min(FMath::RoundToInt(Normalized * PositionScale), (int32)MAX_uint16));
+		NameIndices.Add((uint8)NameIndex);
+	}
+
+	// About two buckets per marker keeps the forward scan in FindPreviousMarker to a step or two.
+	const int32 NumBuckets = FMath::Clamp((int32)FMath::RoundUpToPowerOfTwo(FMath::Max(Positions.Num() * 2, 16)), 16, 4096);
+	BucketShift = (uint8)(16 - FMath::FloorLog2(NumBuckets));
+	Buckets.SetNumUninitialized(NumBuckets);
+	int32 Marker = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		const int32 BucketStart = Bucket << BucketShift;
+		while (Marker < Positions.Num() && Positions[Marker] < BucketStart)
+		{
+			++Marker;
+		}
+		Buckets[Bucket] = (uint16)Marker;
+	}
+}
+
+float UProceduralLocomotionMarkerIndex::ToPosition(float Time) const
+{
+	return FMath::Frac(Time / SequenceLength) * PositionScale;
+}
+
+int32 UProceduralLocomotionMarkerIndex::FindPreviousMarker(float Position) const
+{
+	const int32 Quantized = FMath::Clamp((int32)Position, 0, (int32)MAX_uint16);
+	int32 Next = Buckets[Quantized >> BucketShift];
+	while (Next < Positions.Num() && Positions[Next] <= Position)
+	{
+		++Next;
+	}
+	return Next - 1;
+}
+
+float UProceduralLocomotionMarkerIndex::GetPhaseSpan(int32 Index) const
+{
+	const int32 NextIndex = (Index + 1) % Positions.Num();
+	const float Span = FMath::Frac(MarkerNamePhases[NameIndices[NextIndex]] - MarkerNamePhases[NameIndices[Index]]);
+	return Span > UE_KINDA_SMALL_NUMBER ? Span : 1.0f;
+}
+
+float UProceduralLocomotionMarkerIndex::GetNextPosition(int32 Index) const
+{
+	return Index + 1 < Positions.Num() ? (float)Positions[Index + 1] : Positions[0] + PositionScale;
+}
+
+float UProceduralLocomotionMarkerIndex::GetPhaseAtTime(float Time) const
+{
+	if (!IsValid())
+	{
+		return 0.0f;
+	}
+
+	float Position = ToPosition(Time);
+	int32 Index = FindPreviousMarker(Position);
+	if (Index == INDEX_NONE)
+	{
+		// Before the first marker: still in the interval that starts at the last one.
+		Index = Positions.Num() - 1;
+		Position += PositionScale;
+	}
+
+	const float Start = Positions[Index];
+	const float Alpha = (Position - Start) / FMath::Max(GetNextPosition(Index) - Start, 1.0f);
+	return FMath::Frac(MarkerNamePhases[NameIndices[Index]] + Alpha * GetPhaseSpan(Index));
+}
+
+float UProceduralLocomotionMarkerIndex::GetTimeAtPhase(float Phase, float HintTime) const
+{
+	if (!IsValid())
+	{
+		return HintTime;
+	}
+
+	int32 Index = FindPreviousMarker(ToPosition(HintTime));
+	if (Index == INDEX_NONE)
+	{
+		Index = Positions.Num() - 1;
+	}
+
+	// Every phase falls in some interval of a cycle, so this stops within one cycle's markers.
+	for (int32 Step = 0; Step < Positions.Num(); ++Step)
+	{
+		const float Span = GetPhaseSpan(Index);
+		const float Offset = FMath::Frac(Phase - MarkerNamePhases[NameIndices[Index]]);
+		if (Offset < Span)
+		{
+			const float Start = Positions[Index];
+			const float Position = Start + (Offset / Span) * (GetNextPosition(Index) - Start);
+			return FMath::Frac(Position / PositionScale) * SequenceLength;
+		}
+		Index = (Index + 1) % Positions.Num();
+	}
+	return HintTime;
+}
+
+float UProceduralLocomotionMarkerIndex::GetTimeUntilMarker(FName MarkerName, float Time) const
+{
+	const int32 NameIndex = MarkerNames.Find(MarkerName);
+	if (!IsValid() || NameIndex == INDEX_NONE)
+	{
+		return -1.0f;
+	}
+
+	const float Position = ToPosition(Time);
+	const int32 Previous = FindPreviousMarker(Position);
+	for (int32 Step = 1; Step <= Positions.Num(); ++Step)
+	{
+		const int32 Index = (Previous + Step) % Positions.Num();
+		if (NameIndices[Index] == NameIndex)
+		{
+			float Delta = Positions[Index] - Position;
+			if (Delta <= 0.0f)
+			{
+				Delta += PositionScale;
+			}
+			return Delta / PositionScale * SequenceLength;
+		}
+	}
+	return -1.0f;
+}
@@ -0,0 +1,195 @@
+#include "ProceduralLocomotionMoCapReceiver.h"
+
+#include "ProceduralLocomotionMoCapProtocol.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Common/UdpSocketBuilder.h"
+#include "HAL/RunnableThread.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "The MoCap stream is decoded in place as little-endian");
+
+namespace
+{
+	// Datagrams from a sender restarted at frame 0 would otherwise look stale until it caught up.
+	constexpr uint64 SenderRestartFrameGap = 600;
+}
+
+FProceduralLocomotionMoCapFrame::FProceduralLocomotionMoCapFrame()
+{
+	BoneTransforms.Init(FTransform::Identity, ProceduralLocomotionMoCap::MaxBones);
+}
+
+void FProceduralLocomotionMoCapFrame::CopyFrom(const FProceduralLocomotionMoCapFrame& Other)
+{
+	FrameNumber = Other.FrameNumber;
+	CaptureTimeSeconds = Other.CaptureTimeSeconds;
+	ReceiveTimeSeconds = Other.ReceiveTimeSeconds;
+	NumBones = Other.NumBones;
+	// Both sides hold MaxBones entries, so this never reallocates.
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		BoneTransforms[BoneIndex] = Other.BoneTransforms[BoneIndex];
+	}
+}
+
+FProceduralLocomotionMoCapReceiver::FProceduralLocomotionMoCapReceiver(int32 InPort, int32 InSubjectId)
+	: Port(InPort)
+	, SubjectId(InSubjectId)
+{
+	ReceiveBuffer.SetNumUninitialized(ProceduralLocomotionMoCap::MaxPacketSize);
+}
+
+FProceduralLocomotionMoCapReceiver::~FProceduralLocomotionMoCapReceiver()
+{
+	if (Thread)
+	{
+		// Kill calls Stop() and waits; the receive loop wakes at least every WaitTime.
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+bool FProceduralLocomotionMoCapReceiver::Start()
+{
+	check(!Thread);
+
+	Socket = FUdpSocketBuilder(TEXT("ProceduralLocomotionMoCap"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToPort(Port)
+		.WithReceiveBufferSize(ProceduralLocomotionMoCap::MaxPacketSize * 16)
+		.Build();
+	if (!Socket)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("MoCap: could not bind UDP port %d"), Port);
+		return false;
+	}
+
+	Thread = FRunnableThread::Create(this, *FString::Printf(TEXT("ProceduralLocomotionMoCap:%d"), Port), 0, TPri_AboveNormal);
+	if (!Thread)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("MoCap: could not start the receive thread for port %d"), Port);
+		return false;
+	}
+
+	UE_LOG(LogProceduralLocomotion, Log, TEXT("MoCap: listening on UDP port %d (subject %d)"), Port, SubjectId);
+	return true;
+}
+
+uint32 FProceduralLocomotionMoCapReceiver::Run()
+{
+	const FTimespan WaitTime = FTimespan::FromMilliseconds(100);
+
+	while (!bStopping.load(std::memory_order_relaxed))
+	{
+		// Blocks in the kernel until a datagram arrives, so frames are decoded as soon as they land.
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, WaitTime))
+		{
+			continue;
+		}
+
+		int32 NumBytes = 0;
+		while (Socket->Recv(ReceiveBuffer.GetData(), ReceiveBuffer.Num(), NumBytes) && NumBytes > 0)
+		{
+			HandleDatagram(NumBytes);
+		}
+	}
+
+	return 0;
+}
+
+void FProceduralLocomotionMoCapReceiver::Stop()
+{
+	bStopping.store(true, std::memory_order_relaxed);
+}
+
+void FProceduralLocomotionMoCapReceiver::HandleDatagram(int32 NumBytes)
+{
+	using namespace ProceduralLocomotionMoCap;
+
+	FPacketHeader Header;
+	if (NumBytes < (int32)sizeof(Header))
+	{
+		PacketsRejected.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	FMemory::Memcpy(&Header, ReceiveBuffer.GetData(), sizeof(Header));
+
+	if (Header.Magic != Magic || Header.Version != Version || Header.NumBones > MaxBones
+		|| NumBytes < (int32)(sizeof(Header) + Header.NumBones * sizeof(FBoneSample)))
+	{
+		PacketsRejected.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	if (SubjectId >= 0 && Header.SubjectId != (uint32)SubjectId)
+	{
+		return;
+	}
+
+	// UDP may reorder; never step the pose backwards unless the sender restarted.
+	if (bHasLastFrameNumber && Header.FrameNumber <= LastFrameNumber && LastFrameNumber - Header.FrameNumber < SenderRestartFrameGap)
+	{
+		FramesDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	LastFrameNumber = Header.FrameNumber;
+	bHasLastFrameNumber = true;
+	FramesReceived.fetch_add(1, std::memory_order_relaxed);
+
+	const uint32 Write = WriteIndex.load(std::memory_order_relaxed);
+	if (Write - ReadIndex.load(std::memory_order_acquire) == RingCapacity)
+	{
+		FramesDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	FProceduralLocomotionMoCapFrame& Frame = Ring[Write & (RingCapacity - 1)];
+	Frame.FrameNumber = Header.FrameNumber;
+	Frame.CaptureTimeSeconds = Header.CaptureTimeSeconds;
+	Frame.ReceiveTimeSeconds = FPlatformTime::Seconds();
+	Frame.NumBones = (int32)Header.NumBones;
+
+	const uint8* SampleData = ReceiveBuffer.GetData() + sizeof(Header);
+	for (uint32 BoneIndex = 0; BoneIndex < Header.NumBones; ++BoneIndex)
+	{
+		FBoneSample Sample;
+		FMemory::Memcpy(&Sample, SampleData + BoneIndex * sizeof(Sample), sizeof(Sample));
+
+		FQuat Rotation(Sample.Rotation[0], Sample.Rotation[1], Sample.Rotation[2], Sample.Rotation[3]);
+		Rotation.Normalize();
+		Frame.BoneTransforms[BoneIndex] = FTransform(Rotation, FVector(Sample.Translation[0], Sample.Translation[1], Sample.Translation[2]));
+	}
+
+	WriteIndex.store(Write + 1, std::memory_order_release);
+}
+
+bool FProceduralLocomotionMoCapReceiver::ConsumeLatest(FProceduralLocomotionMoCapFrame& OutFrame)
+{
+	const uint32 Read = ReadIndex.load(std::memory_order_relaxed);
+	const uint32 Write = WriteIndex.load(std::memory_order_acquire);
+	if (Write == Read)
+	{
+		return false;
+	}
+
+	if (Write - Read > 1)
+	{
+		FramesDropped.fetch_add(Write - Read - 1, std::memory_order_relaxed);
+	}
+
+	OutFrame.CopyFrom(Ring[(Write - 1) & (RingCapacity - 1)]);
+
+	// Hands every slot up to Write back to the receive thread.
+	ReadIndex.store(Write, std::memory_order_release);
+	return true;
+}
@@ -0,0 +1,263 @@
+#include "ProceduralLocomotionPerfGateCommandlet.h"
+
+#include "ProceduralLocomotionBenchmarkResult.h"
+#include "ProceduralLocomotionSystem.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace ProceduralLocomotionPerfGate
+{
+	struct FMedianSummary
+	{
+		double Median = 0.0;
+		double Lower = 0.0;
+		double Upper = 0.0;
+		int32 NumSamples = 0;
+	};
+
+	// Median with a distribution-free confidence interval from order statistics: the interval
+	// [x(l), x(n-1-l)] covers the true median with probability 1 - 2 * P(Binomial(n, 0.5) <= l).
+	// With too few samples for the requested confidence the full range is used.
+	static FMedianSummary Summarize(TArray<double> Samples, double Confidence)
+	{
+		FMedianSummary Summary;
+		Summary.NumSamples = Samples.Num();
+		if (Samples.Num() == 0)
+		{
+			return Summary;
+		}
+
+		Samples.Sort();
+		const int32 N = Samples.Num();
+		Summary.Median = (N % 2) ? Samples[N / 2] : 0.5 * (Samples[N / 2 - 1] + Samples[N / 2]);
+
+		const double Alpha = 1.0 - Confidence;
+		double Probability = FMath::Pow(0.5, (double)N);
+		double Cumulative = Probability;
+		int32 LowerIndex = 0;
+		for (int32 Index = 0; Index < N / 2; ++Index)
+		{
+			if (2.0 * Cumulative > Alpha)
+			{
+				break;
+			}
+			LowerIndex = Index;
+			Probability *= double(N - Index) / double(Index + 1);
+			Cumulative += Probability;
+		}
+
+		Summary.Lower = Samples[LowerIndex];
+		Summary.Upper = Samples[N - 1 - LowerIndex];
+		return Summary;
+	}
+
+	enum class EStageVerdict : uint8
+	{
+		Unchanged,
+		Improved,
+		Regressed,
+		Missing
+	};
+
+	static const TCHAR* VerdictToString(EStageVerdict Verdict)
+	{
+		switch (Verdict)
+		{
+		case EStageVerdict::Improved:
+			return TEXT("improved");
+		case EStageVerdict::Regressed:
+			return TEXT("REGRESSED");
+		case EStageVerdict::Missing:
+			return TEXT("no baseline");
+		default:
+			return TEXT("ok");
+		}
+	}
+
+	struct FGateSettings
+	{
+		double Threshold = 0.05;
+		double Confidence = 0.95;
+		double MinDeltaMs = 0.002;
+	};
+
+	static EStageVerdict CompareStage(const FMedianSummary& Baseline, const FMedianSummary& Current, const FGateSettings& Settings)
+	{
+		const double DeltaMs = Current.Median - Baseline.Median;
+		if (FMath::Abs(DeltaMs) < Settings.MinDeltaMs)
+		{
+			return EStageVerdict::Unchanged;
+		}
+
+		const double RelativeDelta = DeltaMs / FMath::Max(Baseline.Median, UE_DOUBLE_SMALL_NUMBER);
+		if (RelativeDelta > Settings.Threshold && Current.Lower > Baseline.Upper)
+		{
+			return EStageVerdict::Regressed;
+		}
+		if (RelativeDelta < -Settings.Threshold && Current.Upper < Baseline.Lower)
+		{
+			return EStageVerdict::Improved;
+		}
+		return EStageVerdict::Unchanged;
+	}
+
+	static FString FormatSummary(const FMedianSummary& Summary)
+	{
+		return FString::Printf(TEXT("%8.4f [%8.4f, %8.4f] n=%-3d"), Summary.Median, Summary.Lower, Summary.Upper, Summary.NumSamples);
+	}
+
+	// Returns the number of regressed stages.
+	static int32 ReportScenario(const FProceduralLocomotionBenchmarkResult& Current, const FProceduralLocomotionBenchmarkResult* Baseline, const FGateSettings& Settings)
+	{
+		UE_LOG(LogProceduralLocomotion, Display, TEXT(""));
+		UE_LOG(LogProceduralLocomotion, Display, TEXT("Scenario %s (%d characters, layers %s)"), *Current.Scenario, Current.NumCharacters, *Current.Layers);
+		UE_LOG(LogProceduralLocomotion, Display, TEXT("  %-16s %-36s %-36s %9s  %s"), TEXT("Stage"), TEXT("Baseline ms [CI]"), TEXT("Current ms [CI]"), TEXT("Delta"), TEXT("Status"));
+
+		int32 NumRegressed = 0;
+		for (const TPair<FString, TArray<double>>& Stage : Current.StageSamplesMs)
+		{
+			const FMedianSummary CurrentSummary = Summarize(Stage.Value, Settings.Confidence);
+			const TArray<double>* BaselineSamples = Baseline ? Baseline->StageSamplesMs.Find(Stage.Key) : nullptr;
+			if (!BaselineSamples || BaselineSamples->Num() == 0)
+			{
+				UE_LOG(LogProceduralLocomotion, Display, TEXT("  %-16s %-36s %s %9s  %s"), *Stage.Key, TEXT("-"), *FormatSummary(CurrentSummary), TEXT("-"), VerdictToString(EStageVerdict::Missing));
+				continue;
+			}
+
+			const FMedianSummary BaselineSummary = Summarize(*BaselineSamples, Settings.Confidence);
+			const EStageVerdict Verdict = CompareStage(BaselineSummary, CurrentSummary, Settings);
+			const double RelativeDelta = (CurrentSummary.Median - BaselineSummary.Median) / FMath::Max(BaselineSummary.Median, UE_DOUBLE_SMALL_NUMBER);
+
+			const FString Line = FString::Printf(TEXT("  %-16s %s %s %+8.1f%%  %s"),
+				*Stage.Key, *FormatSummary(BaselineSummary), *FormatSummary(CurrentSummary), RelativeDelta * 100.0, VerdictToString(Verdict));
+
+			if (Verdict == EStageVerdict::Regressed)
+			{
+				++NumRegressed;
+				UE_LOG(LogProceduralLocomotion, Error, TEXT("%s"), *Line);
+			}
+			else
+			{
+				UE_LOG(LogProceduralLocomotion, Display, TEXT("%s"), *Line);
+			}
+		}
+
+		return NumRegressed;
+	}
+}
+
+UProceduralLocomotionPerfGateCommandlet::UProceduralLocomotionPerfGateCommandlet()
+{
+	LogToConsole = true;
+	ShowErrorCount = false;
+}
+
+int32 UProceduralLocomotionPerfGateCommandlet::Main(const FString& Params)
+{
+	using namespace ProceduralLocomotionPerfGate;
+
+	FString ResultList;
+	if (!FParse::Value(*Params, TEXT("Result="), ResultList, false))
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Missing -Result=<Result.json>[,<Result2.json>...]"));
+		return 1;
+	}
+
+	FString BaselineDir = FPaths::ProjectDir() / TEXT("Benchmarks/Baselines");
+	FParse::Value(*Params, TEXT("BaselineDir="), BaselineDir);
+
+	FGateSettings Settings;
+	FParse::Value(*Params, TEXT("Threshold="), Settings.Threshold);
+	FParse::Value(*Params, TEXT("Confidence="), Settings.Confidence);
+	FParse::Value(*Params, TEXT("MinDeltaMs="), Settings.MinDeltaMs);
+	Settings.Confidence = FMath::Clamp(Settings.Confidence, 0.5, 0.999);
+
+	const bool bUpdateBaseline = FParse::Param(*Params, TEXT("UpdateBaseline"));
+
+	// Several result files (e.g. repeated benchmark invocations) are merged per scenario.
+	TArray<FString> ResultFiles;
+	ResultList.ParseIntoArray(ResultFiles, TEXT(","));
+
+	TArray<FProceduralLocomotionBenchmarkResult> Results;
+	for (const FString& ResultFile : ResultFiles)
+	{
+		TArray<FProceduralLocomotionBenchmarkResult> FileResults;
+		if (!FProceduralLocomotionBenchmarkResult::LoadFromFile(ResultFile, FileResults))
+		{
+			UE_LOG(LogProceduralLocomotion, Error, TEXT("Failed to read benchmark result %s"), *ResultFile);
+			return 1;
+		}
+
+		for (FProceduralLocomotionBenchmarkResult& FileResult : FileResults)
+		{
+			FProceduralLocomotionBenchmarkResult* Existing = Results.FindByPredicate([&FileResult](const FProceduralLocomotionBenchmarkResult& Result)
+			{
+				return Result.Scenario == FileResult.Scenario;
+			});
+
+			if (!Existing)
+			{
+				Results.Add(MoveTemp(FileResult));
+				continue;
+			}
+
+			for (const TPair<FString, TArray<double>>& Stage : FileResult.StageSamplesMs)
+			{
+				Existing->StageSamplesMs.FindOrAdd(Stage.Key).Append(Stage.Value);
+			}
+		}
+	}
+
+	int32 NumRegressed = 0;
+	int32 NumMissingBaselines = 0;
+	for (const FProceduralLocomotionBenchmarkResult& Result : Results)
+	{
+		// Baselines are only comparable on the platform they were recorded on.
+		const FString BaselineFile = BaselineDir / Result.Platform / (Result.Scenario + TEXT(".json"));
+
+		TArray<FProceduralLocomotionBenchmarkResult> Baselines;
+		const bool bHasBaseline = IFileManager::Get().FileExists(*BaselineFile)
+			&& FProceduralLocomotionBenchmarkResult::LoadFromFile(BaselineFile, Baselines)
+			&& Baselines.Num() > 0;
+
+		if (bHasBaseline && Baselines[0].BuildConfiguration != Result.BuildConfiguration)
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("%s: baseline was recorded in %s, result in %s."),
+				*Result.Scenario, *Baselines[0].BuildConfiguration, *Result.BuildConfiguration);
+		}
+
+		NumRegressed += ReportScenario(Result, bHasBaseline ? &Baselines[0] : nullptr, Settings);
+
+		if (bUpdateBaseline)
+		{
+			if (!FProceduralLocomotionBenchmarkResult::SaveToFile(BaselineFile, { Result }))
+			{
+				UE_LOG(LogProceduralLocomotion, Error, TEXT("Failed to write baseline %s"), *BaselineFile);
+				return 1;
+			}
+			UE_LOG(LogProceduralLocomotion, Display, TEXT("  Baseline updated: %s"), *BaselineFile);
+		}
+		else if (!bHasBaseline)
+		{
+			++NumMissingBaselines;
+			UE_LOG(LogProceduralLocomotion, Error, TEXT("  No baseline at %s; rerun with -UpdateBaseline to record one."), *BaselineFile);
+		}
+	}
+
+	UE_LOG(LogProceduralLocomotion, Display, TEXT(""));
+	if (bUpdateBaseline)
+	{
+		UE_LOG(LogProceduralLocomotion, Display, TEXT("Perf gate: baselines updated for %d scenario(s)."), Results.Num());
+		return 0;
+	}
+
+	if (NumRegressed > 0 || NumMissingBaselines > 0)
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Perf gate FAILED: %d stage regression(s), %d missing baseline(s) (threshold %.1f%%, %.0f%% confidence)."),
+			NumRegressed, NumMissingBaselines, Settings.Threshold * 100.0, Settings.Confidence * 100.0);
+		return 1;
+	}
+
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Perf gate passed for %d scenario(s)."), Results.Num());
+	return 0;
+}
@@ -0,0 +1,340 @@
+#include "ProceduralLocomotionPoseRecorder.h"
+
+#include "ProceduralLocomotionPoseRecordingFormat.h"
+#include "ProceduralLocomotionSystem.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Compression.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Pose recordings are written in place as little-endian");
+
+using namespace ProceduralLocomotionPoseRecording;
+
+namespace
+{
+	void AppendBytes(TArray<uint8>& Out, const void* Data, int32 Size)
+	{
+		Out.Append(static_cast<const uint8*>(Data), Size);
+	}
+
+	void AppendVarint(TArray<uint8>& Out, uint32 Value)
+	{
+		const int32 Start = Out.AddUninitialized(MaxVarintBytes);
+		uint8* End = WriteVarint(Out.GetData() + Start, Value);
+		Out.SetNum(UE_PTRDIFF_TO_INT32(End - Out.GetData()), EAllowShrinking::No);
+	}
+
+	void AppendString(TArray<uint8>& Out, const FString& String)
+	{
+		const FTCHARToUTF8 Utf8(*String);
+		const uint8 Length = (uint8)FMath::Min(Utf8.Length(), 255);
+		Out.Add(Length);
+		AppendBytes(Out, Utf8.Get(), Length);
+	}
+
+	void QuantizeTransform(const FTransform& Transform, int32* Out)
+	{
+		const FQuat Rotation = Transform.GetRotation();
+		QuantizeRotation(Rotation.X, Rotation.Y, Rotation.Z, Rotation.W, Out);
+		const FVector Translation = Transform.GetTranslation();
+		Out[3] = QuantizeDistance(Translation.X);
+		Out[4] = QuantizeDistance(Translation.Y);
+		Out[5] = QuantizeDistance(Translation.Z);
+	}
+}
+
+void FProceduralLocomotionPoseRecordingFrame::Reset()
+{
+	FrameNumber = 0;
+	WorldTimeSeconds = 0.0;
+	Characters.Reset();
+	BoneTransforms.Reset();
+	NewSkeletons.Reset();
+	NewCharacters.Reset();
+}
+
+FProceduralLocomotionPoseRecorder::FProceduralLocomotionPoseRecorder(const FString& InFilename, float InChunkSeconds)
+	: Filename(InFilename)
+	, ChunkSeconds(FMath::Max(InChunkSeconds, 0.1f))
+{
+}
+
+FProceduralLocomotionPoseRecorder::~FProceduralLocomotionPoseRecorder()
+{
+	if (Thread)
+	{
+		// Kill calls Stop() and waits; Run writes the frames still queued and the last chunk first.
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (FrameSubmitted)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(FrameSubmitted);
+		FrameSubmitted = nullptr;
+	}
+
+	File.Reset();
+}
+
+bool FProceduralLocomotionPoseRecorder::Start()
+{
+	check(!Thread);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+	File.Reset(PlatformFile.OpenWrite(*Filename));
+	if (!File)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Recording: could not create %s"), *Filename);
+		return false;
+	}
+
+	FFileHeader Header = {};
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.HeaderSize = sizeof(FFileHeader);
+	Header.RotationScale = RotationScale;
+	Header.DistanceScale = DistanceScale;
+	Header.StartUnixSeconds = (double)FDateTime::UtcNow().ToUnixTimestamp();
+	if (!File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header)))
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Recording: could not write to %s"), *Filename);
+		return false;
+	}
+	BytesWritten.store(sizeof(Header), std::memory_order_relaxed);
+
+	FrameSubmitted = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("ProceduralLocomotionPoseRecorder"), 0, TPri_BelowNormal);
+	if (!Thread)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Recording: could not start the writer thread"));
+		return false;
+	}
+
+	UE_LOG(LogProceduralLocomotion, Log, TEXT("Recording: writing poses to %s"), *Filename);
+	return true;
+}
+
+FProceduralLocomotionPoseRecordingFrame* FProceduralLocomotionPoseRecorder::BeginFrame()
+{
+	const uint32 Write = WriteIndex.load(std::memory_order_relaxed);
+	if (Write - ReadIndex.load(std::memory_order_acquire) == RingCapacity)
+	{
+		FramesDropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	FProceduralLocomotionPoseRecordingFrame& Frame = Ring[Write & (RingCapacity - 1)];
+	Frame.Reset();
+	return &Frame;
+}
+
+void FProceduralLocomotionPoseRecorder::SubmitFrame()
+{
+	WriteIndex.store(WriteIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	FrameSubmitted->Trigger();
+}
+
+uint32 FProceduralLocomotionPoseRecorder::Run()
+{
+	for (;;)
+	{
+		// Read the stop flag first so frames submitted before Stop() are still written.
+		const bool bStop = bStopping.load(std::memory_order_acquire);
+
+		const uint32 Write = WriteIndex.load(std::memory_order_acquire);
+		uint32 Read = ReadIndex.load(std::memory_order_relaxed);
+		for (; Read != Write; ++Read)
+		{
+			EncodeFrame(Ring[Read & (RingCapacity - 1)]);
+			// Hands the slot back to the game thread.
+			ReadIndex.store(Read + 1, std::memory_order_release);
+		}
+
+		if (bStop)
+		{
+			break;
+		}
+		FrameSubmitted->Wait(FTimespan::FromMilliseconds(100));
+	}
+
+	FlushChunk();
+	if (File)
+	{
+		File->Flush();
+	}
+	return 0;
+}
+
+void FProceduralLocomotionPoseRecorder::Stop()
+{
+	bStopping.store(true, std::memory_order_release);
+	if (FrameSubmitted)
+	{
+		FrameSubmitted->Trigger();
+	}
+}
+
+void FProceduralLocomotionPoseRecorder::EncodeFrame(const FProceduralLocomotionPoseRecordingFrame& Frame)
+{
+	TArray<uint8> Block;
+	for (const FProceduralLocomotionRecordedSkeleton& Skeleton : Frame.NewSkeletons)
+	{
+		Block.Reset();
+		const uint32 NumBones = (uint32)Skeleton.BoneNames.Num();
+		AppendBytes(Block, &Skeleton.SkeletonId, sizeof(uint32));
+		AppendBytes(Block, &NumBones, sizeof(uint32));
+		AppendBytes(Block, Skeleton.ParentIndices.GetData(), NumBones * sizeof(int32));
+		for (const FName BoneName : Skeleton.BoneNames)
+		{
+			AppendString(Block, BoneName.ToString());
+		}
+		WriteBlock(SkeletonBlock, nullptr, 0, Block.GetData(), Block.Num());
+	}
+	for (const TPair<uint32, FString>& Character : Frame.NewCharacters)
+	{
+		Block.Reset();
+		AppendBytes(Block, &Character.Key, sizeof(uint32));
+		AppendString(Block, Character.Value);
+		WriteBlock(CharacterBlock, nullptr, 0, Block.GetData(), Block.Num());
+	}
+
+	if (ChunkNumFrames > 0 && Frame.WorldTimeSeconds - ChunkStartTime >= ChunkSeconds)
+	{
+		FlushChunk();
+	}
+	if (ChunkNumFrames == 0)
+	{
+		ChunkFirstFrame = Frame.FrameNumber;
+		ChunkStartTime = Frame.WorldTimeSeconds;
+	}
+
+	ChunkTimes.Add(Frame.WorldTimeSeconds);
+	AppendVarint(ChunkStream, (uint32)(Frame.FrameNumber - ChunkFirstFrame));
+	AppendVarint(ChunkStream, (uint32)Frame.Characters.Num());
+	for (const FProceduralLocomotionPoseRecordingFrame::FCharacter& Character : Frame.Characters)
+	{
+		Channels.SetNumUninitialized(GetNumChannels(Character.NumBones), EAllowShrinking::No);
+		int32* Out = Channels.GetData();
+
+		const FVector Location = Character.ComponentTransform.GetLocation();
+		const FQuat Rotation = Character.ComponentTransform.GetRotation();
+		Out[ComponentLocationX] = QuantizeDistance(Location.X);
+		Out[ComponentLocationY] = QuantizeDistance(Location.Y);
+		Out[ComponentLocationZ] = QuantizeDistance(Location.Z);
+		QuantizeRotation(Rotation.X, Rotation.Y, Rotation.Z, Rotation.W, Out + ComponentRotationX);
+		Out[FloorZ] = QuantizeDistance(Character.FloorZ);
+		Out[FloorNormalX] = QuantizeUnit(Character.FloorNormal.X);
+		Out[FloorNormalY] = QuantizeUnit(Character.FloorNormal.Y);
+		Out[FloorNormalZ] = QuantizeUnit(Character.FloorNormal.Z);
+
+		for (int32 Bone = 0; Bone < Character.NumBones; ++Bone)
+		{
+			QuantizeTransform(Frame.BoneTransforms[Character.FirstBone + Bone], Out + NumCharacterChannels + Bone * NumBoneChannels);
+		}
+
+		AppendChannels(Character.CharacterId, Character.SkeletonId);
+	}
+
+	ChunkEndTime = Frame.WorldTimeSeconds;
+	++ChunkNumFrames;
+	FramesWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FProceduralLocomotionPoseRecorder::AppendChannels(uint32 CharacterId, uint32 SkeletonId)
+{
+	AppendVarint(ChunkStream, CharacterId);
+	AppendVarint(ChunkStream, SkeletonId);
+
+	FPreviousChannels& Previous = PreviousChannels.FindOrAdd(CharacterId);
+	if (Previous.SkeletonId != SkeletonId || Previous.Channels.Num() != Channels.Num())
+	{
+		Previous.SkeletonId = SkeletonId;
+		Previous.Channels.Reset();
+		Previous.Channels.SetNumZeroed(Channels.Num());
+		Previous.Deltas.Reset();
+		Previous.Deltas.SetNumZeroed(Channels.Num());
+		Previous.bHasFrame = false;
+	}
+
+	// Reserve the worst case once so the loop writes varints without growing the array.
+	const int32 Start = ChunkStream.AddUninitialized(Channels.Num() * MaxVarintBytes);
+	uint8* Out = ChunkStream.GetData() + Start;
+	for (int32 Index = 0; Index < Channels.Num(); ++Index)
+	{
+		// Wrapping arithmetic; readers wrap the running sums the same way.
+		const uint32 Value = (uint32)Channels[Index];
+		const uint32 PreviousValue = (uint32)Previous.Channels[Index];
+		const uint32 PreviousDelta = (uint32)Previous.Deltas[Index];
+		Out = WriteVarint(Out, ZigZag((int32)(Value - PreviousValue - PreviousDelta)));
+		Previous.Deltas[Index] = Previous.bHasFrame ? (int32)(Value - PreviousValue) : 0;
+		Previous.Channels[Index] = (int32)Value;
+	}
+	Previous.bHasFrame = true;
+	ChunkStream.SetNum(UE_PTRDIFF_TO_INT32(Out - ChunkStream.GetData()), EAllowShrinking::No);
+}
+
+void FProceduralLocomotionPoseRecorder::FlushChunk()
+{
+	if (ChunkNumFrames == 0)
+	{
+		return;
+	}
+
+	FChunkHeader Header = {};
+	Header.FirstFrame = ChunkFirstFrame;
+	Header.StartTimeSeconds = ChunkStartTime;
+	Header.EndTimeSeconds = ChunkEndTime;
+	Header.NumFrames = ChunkNumFrames;
+
+	// Frame times first, then the varints.
+	ChunkUncompressed.Reset();
+	AppendBytes(ChunkUncompressed, ChunkTimes.GetData(), ChunkTimes.Num() * sizeof(double));
+	ChunkUncompressed.Append(ChunkStream);
+	Header.UncompressedSize = (uint32)ChunkUncompressed.Num();
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, ChunkUncompressed.Num());
+	CompressedChunk.SetNumUninitialized(CompressedSize, EAllowShrinking::No);
+	if (FCompression::CompressMemory(NAME_Zlib, CompressedChunk.GetData(), CompressedSize, ChunkUncompressed.GetData(), ChunkUncompressed.Num()))
+	{
+		WriteBlock(ChunkBlock, &Header, sizeof(Header), CompressedChunk.GetData(), (uint32)CompressedSize);
+	}
+	else
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Recording: could not compress a %d-frame chunk; dropped"), ChunkNumFrames);
+	}
+
+	// Chunks decode on their own, so the next one starts from zero.
+	ChunkTimes.Reset();
+	ChunkStream.Reset();
+	PreviousChannels.Reset();
+	ChunkNumFrames = 0;
+}
+
+bool FProceduralLocomotionPoseRecorder::WriteBlock(uint32 Type, const void* Prefix, uint32 PrefixSize, const void* Payload, uint32 PayloadSize)
+{
+	if (!File || bWriteError.load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	const FBlockHeader Header = { Type, PrefixSize + PayloadSize };
+	const bool bWritten = File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header))
+		&& (PrefixSize == 0 || File->Write(static_cast<const uint8*>(Prefix), PrefixSize))
+		&& File->Write(static_cast<const uint8*>(Payload), PayloadSize);
+	if (!bWritten)
+	{
+		// Keep what is on disk readable; everything after the last complete block is lost.
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Recording: write to %s failed; recording stopped"), *Filename);
+		bWriteError.store(true, std::memory_order_relaxed);
+		return false;
+	}
+
+	BytesWritten.fetch_add(sizeof(Header) + PrefixSize + PayloadSize, std::memory_order_relaxed);
+	return true;
+}
@@ -0,0 +1,235 @@
+#include "ProceduralLocomotionPoseRecordingSubsystem.h"
+
+#include "ProceduralCharacter.h"
+#include "ProceduralLocomotionPoseRecorder.h"
+#include "ProceduralLocomotionStats.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<float> CVarRecordingRate(
+	TEXT("pls.Recording.Rate"),
+	60.0f,
+	TEXT("Pose recording frames per second; 0 captures every frame."));
+
+static TAutoConsoleVariable<int32> CVarRecordingMaxCharacters(
+	TEXT("pls.Recording.MaxCharacters"),
+	100,
+	TEXT("Characters captured per pose recording frame; the rest are skipped."));
+
+static TAutoConsoleVariable<float> CVarRecordingChunkSeconds(
+	TEXT("pls.Recording.ChunkSeconds"),
+	1.0f,
+	TEXT("Seconds of frames per compressed pose recording chunk. Applied when recording starts."));
+
+namespace
+{
+	FAutoConsoleCommandWithWorldAndArgs RecordingStartCommand(
+		TEXT("pls.Recording.Start"),
+		TEXT("Records procedural character poses to a file: pls.Recording.Start [File] [NameFilter]. Use - for the default file."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UProceduralLocomotionPoseRecordingSubsystem* Recording = World ? World->GetSubsystem<UProceduralLocomotionPoseRecordingSubsystem>() : nullptr)
+			{
+				const FString Filename = Args.Num() > 0 && Args[0] != TEXT("-") ? Args[0] : FString();
+				Recording->StartRecording(Filename, Args.Num() > 1 ? Args[1] : FString());
+			}
+		}));
+
+	FAutoConsoleCommandWithWorld RecordingStopCommand(
+		TEXT("pls.Recording.Stop"),
+		TEXT("Stops the pose recording and finishes writing its file."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UProceduralLocomotionPoseRecordingSubsystem* Recording = World ? World->GetSubsystem<UProceduralLocomotionPoseRecordingSubsystem>() : nullptr)
+			{
+				Recording->StopRecording();
+			}
+		}));
+}
+
+void UProceduralLocomotionPoseRecordingSubsystem::Deinitialize()
+{
+	StopRecording();
+	Characters.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UProceduralLocomotionPoseRecordingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UProceduralLocomotionPoseRecordingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProceduralLocomotionPoseRecordingSubsystem, STATGROUP_Tickables);
+}
+
+void UProceduralLocomotionPoseRecordingSubsystem::RegisterCharacter(AProceduralCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UProceduralLocomotionPoseRecordingSubsystem::UnregisterCharacter(AProceduralCharacter* Character)
+{
+	Characters.RemoveSingleSwap(Character);
+}
+
+bool UProceduralLocomotionPoseRecordingSubsystem::StartRecording(const FString& Filename, const FString& InNameFilter)
+{
+	StopRecording();
+
+	const FString File = !Filename.IsEmpty() ? Filename
+		: FPaths::ProjectSavedDir() / TEXT("PoseRecordings") / FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")) + TEXT(".plsrec");
+	Recorder = MakeUnique<FProceduralLocomotionPoseRecorder>(File, CVarRecordingChunkSeconds.GetValueOnGameThread());
+	if (!Recorder->Start())
+	{
+		Recorder.Reset();
+		return false;
+	}
+
+	NameFilter = InNameFilter;
+	SkeletonIds.Reset();
+	RecordedCharacters.Reset();
+	TimeUntilCapture = 0.0f;
+	return true;
+}
+
+void UProceduralLocomotionPoseRecordingSubsystem::StopRecording()
+{
+	if (!Recorder)
+	{
+		return;
+	}
+
+	const FString Filename = Recorder->GetFilename();
+	// Waits for the writer to encode the queued frames and write the last chunk.
+	Recorder.Reset();
+
+	const int64 Bytes = IFileManager::Get().FileSize(*Filename);
+	UE_LOG(LogProceduralLocomotion, Log, TEXT("Recording: stopped; %s is %.2f MB"), *Filename, Bytes / (1024.0 * 1024.0));
+	SET_FLOAT_STAT(STAT_PLS_PoseRecordingMB, 0.0f);
+	SET_DWORD_STAT(STAT_PLS_PoseRecordingFramesDropped, 0);
+}
+
+void UProceduralLocomotionPoseRecordingSubsystem::Tick(float DeltaTime)
+{
+	if (!Recorder)
+	{
+		return;
+	}
+
+	if (Recorder->HasWriteError())
+	{
+		StopRecording();
+		return;
+	}
+
+	TimeUntilCapture -= DeltaTime;
+	if (TimeUntilCapture > 0.0f)
+	{
+		return;
+	}
+	// Catch up at most one interval so a hitch does not cause a burst of captures.
+	const float Rate = CVarRecordingRate.GetValueOnGameThread();
+	const float Interval = Rate > 0.0f ? 1.0f / Rate : 0.0f;
+	TimeUntilCapture = FMath::Max(TimeUntilCapture + Interval, 0.0f);
+
+	if (FProceduralLocomotionPoseRecordingFrame* Frame = Recorder->BeginFrame())
+	{
+		SCOPE_CYCLE_COUNTER(STAT_PLS_PoseRecordingCapture);
+		CaptureFrame(*Frame);
+		Recorder->SubmitFrame();
+	}
+
+	SET_FLOAT_STAT(STAT_PLS_PoseRecordingMB, Recorder->GetBytesWritten() / (1024.0f * 1024.0f));
+	SET_DWORD_STAT(STAT_PLS_PoseRecordingFramesDropped, (uint32)Recorder->GetFramesDropped());
+}
+
+void UProceduralLocomotionPoseRecordingSubsystem::CaptureFrame(FProceduralLocomotionPoseRecordingFrame& Frame)
+{
+	Frame.FrameNumber = GFrameCounter;
+	Frame.WorldTimeSeconds = GetWorld()->GetTimeSeconds();
+
+	const int32 MaxCharacters = CVarRecordingMaxCharacters.GetValueOnGameThread();
+	for (int32 Index = Characters.Num() - 1; Index >= 0 && Frame.Characters.Num() < MaxCharacters; --Index)
+	{
+		AProceduralCharacter* Character = Characters[Index].Get();
+		if (!Character)
+		{
+			Characters.RemoveAtSwap(Index);
+			continue;
+		}
+		if (!NameFilter.IsEmpty() && !Character->GetName().Contains(NameFilter))
+		{
+			continue;
+		}
+
+		const USkeletalMeshComponent* MeshComp = Character->GetMesh();
+		const USkeletalMesh* Mesh = MeshComp ? MeshComp->GetSkeletalMeshAsset() : nullptr;
+		if (!Mesh)
+		{
+			continue;
+		}
+
+		// Last completed evaluation; the subsystem ticks after the frame's animation has finished.
+		// Readers take the bone count from the skeleton, so skip meshes not evaluated yet.
+		const TArray<FTransform>& BoneTransforms = MeshComp->GetBoneSpaceTransforms();
+		if (BoneTransforms.Num() != Mesh->GetRefSkeleton().GetNum())
+		{
+			continue;
+		}
+
+		FProceduralLocomotionPoseRecordingFrame::FCharacter& Record = Frame.Characters.AddDefaulted_GetRef();
+		Record.CharacterId = Character->GetUniqueID();
+		Record.SkeletonId = GetSkeletonId(Mesh, Frame);
+		Record.FirstBone = Frame.BoneTransforms.Num();
+		Record.NumBones = BoneTransforms.Num();
+		Record.ComponentTransform = MeshComp->GetComponentTransform();
+		Frame.BoneTransforms.Append(BoneTransforms.GetData(), Record.NumBones);
+
+		if (const UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+		{
+			if (Movement->CurrentFloor.IsWalkableFloor())
+			{
+				Record.FloorZ = Movement->CurrentFloor.HitResult.ImpactPoint.Z;
+				Record.FloorNormal = Movement->CurrentFloor.HitResult.ImpactNormal;
+			}
+		}
+
+		bool bAlreadyRecorded = false;
+		RecordedCharacters.Add(Record.CharacterId, &bAlreadyRecorded);
+		if (!bAlreadyRecorded)
+		{
+			Frame.NewCharacters.Emplace(Record.CharacterId, Character->GetName());
+		}
+	}
+}
+
+uint32 UProceduralLocomotionPoseRecordingSubsystem::GetSkeletonId(const USkeletalMesh* Mesh, FProceduralLocomotionPoseRecordingFrame& Frame)
+{
+	if (const uint32* SkeletonId = SkeletonIds.Find(Mesh))
+	{
+		return *SkeletonId;
+	}
+
+	const uint32 SkeletonId = (uint32)SkeletonIds.Num();
+	SkeletonIds.Add(Mesh, SkeletonId);
+
+	const FReferenceSkeleton& RefSkeleton = Mesh->GetRefSkeleton();
+	FProceduralLocomotionRecordedSkeleton& Skeleton = Frame.NewSkeletons.AddDefaulted_GetRef();
+	Skeleton.SkeletonId = SkeletonId;
+	for (int32 Bone = 0; Bone < RefSkeleton.GetNum(); ++Bone)
+	{
+		Skeleton.BoneNames.Add(RefSkeleton.GetBoneName(Bone));
+		Skeleton.ParentIndices.Add(RefSkeleton.GetParentIndex(Bone));
+	}
+	return SkeletonId;
+}
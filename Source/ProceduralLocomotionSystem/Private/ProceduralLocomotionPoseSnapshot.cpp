@@ -0,0 +1,89 @@
+#include "ProceduralLocomotionPoseSnapshot.h"
+
+#include "Components/SkeletalMeshComponent.h"
+
+void FProceduralLocomotionPoseSnapshot::Initialize(const TArray<FName>& InBoneNames, const USkeletalMeshComponent& MeshComp)
+{
+	check(IsInGameThread());
+
+	BoneNames = InBoneNames;
+	BoneIndices.Reset(BoneNames.Num());
+	for (const FName BoneName : BoneNames)
+	{
+		BoneIndices.Add(MeshComp.GetBoneIndex(BoneName));
+	}
+
+	for (FBuffer& Buffer : Buffers)
+	{
+		Buffer.ComponentSpace.Init(FTransform::Identity, BoneNames.Num());
+		Buffer.ComponentToWorld = MeshComp.GetComponentTransform();
+		Buffer.FrameNumber = 0;
+	}
+
+	Sequence.store(0, std::memory_order_release);
+}
+
+void FProceduralLocomotionPoseSnapshot::Reset()
+{
+	BoneNames.Reset();
+	BoneIndices.Reset();
+	for (FBuffer& Buffer : Buffers)
+	{
+		Buffer.ComponentSpace.Reset();
+	}
+	Sequence.store(0, std::memory_order_release);
+}
+
+void FProceduralLocomotionPoseSnapshot::Publish(const USkeletalMeshComponent& MeshComp, uint64 FrameNumber)
+{
+	check(IsInGameThread());
+
+	const TArray<FTransform>& ComponentSpaceTransforms = MeshComp.GetComponentSpaceTransforms();
+	const uint32 NextSequence = Sequence.load(std::memory_order_relaxed) + 1;
+
+	FBuffer& Back = Buffers[NextSequence & 1];
+	for (int32 Slot = 0; Slot < BoneIndices.Num(); ++Slot)
+	{
+		const int32 BoneIndex = BoneIndices[Slot];
+		Back.ComponentSpace[Slot] = ComponentSpaceTransforms.IsValidIndex(BoneIndex) ? ComponentSpaceTransforms[BoneIndex] : FTransform::Identity;
+	}
+	Back.ComponentToWorld = MeshComp.GetComponentTransform();
+	Back.FrameNumber = FrameNumber;
+
+	Sequence.store(NextSequence, std::memory_order_release);
+}
+
+bool FProceduralLocomotionPoseSnapshot::GetBoneTransform(int32 Slot, FTransform& OutTransform, bool bWorldSpace, uint64* OutFrameNumber) const
+{
+	if (!BoneIndices.IsValidIndex(Slot) || BoneIndices[Slot] == INDEX_NONE)
+	{
+		return false;
+	}
+
+	for (;;)
+	{
+		const uint32 ReadSequence = Sequence.load(std::memory_order_acquire);
+		if (ReadSequence == 0)
+		{
+			return false;
+		}
+
+		const FBuffer& Front = Buffers[ReadSequence & 1];
+		const FTransform ComponentSpace = Front.ComponentSpace[Slot];
+		const FTransform ComponentToWorld = Front.ComponentToWorld;
+		const uint64 FrameNumber = Front.FrameNumber;
+
+		// The next publish fills the other buffer, but the one after that starts overwriting this
+		// one before it bumps the sequence, so any change means the copy may be torn.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (Sequence.load(std::memory_order_relaxed) == ReadSequence)
+		{
+			OutTransform = bWorldSpace ? ComponentSpace * ComponentToWorld : ComponentSpace;
+			if (OutFrameNumber)
+			{
+				*OutFrameNumber = FrameNumber;
+			}
+			return true;
+		}
+	}
+}
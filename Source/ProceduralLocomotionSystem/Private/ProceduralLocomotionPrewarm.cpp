@@ -0,0 +1,277 @@
+#include "ProceduralLocomotionPrewarm.h"
+
+#include "ProceduralLocomotionSettings.h"
+#include "ProceduralLocomotionStats.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/Skeleton.h"
+#include "BoneContainer.h"
+#include "Engine/Engine.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Rendering/SkeletalMeshLODRenderData.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+	FProceduralLocomotionPrewarmer* GActivePrewarmer = nullptr;
+
+	FAutoConsoleCommand PrewarmRunCommand(
+		TEXT("pls.Prewarm.Run"),
+		TEXT("Re-runs the procedural locomotion prewarm with the current project settings."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			if (GActivePrewarmer)
+			{
+				GActivePrewarmer->Prewarm(TEXT("Console"));
+			}
+		}));
+
+	FAutoConsoleCommand PrewarmReportCommand(
+		TEXT("pls.Prewarm.Report"),
+		TEXT("Logs what the last procedural locomotion prewarm loaded and how long it took."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			if (GActivePrewarmer)
+			{
+				GActivePrewarmer->LogReport();
+			}
+		}));
+}
+
+FProceduralLocomotionPrewarmer::FProceduralLocomotionPrewarmer()
+{
+	GActivePrewarmer = this;
+
+	// Startup prewarm waits for the engine so the asset registry and streaming are up.
+	// Cook and benchmark commandlets manage their own loading, so they are left alone.
+	if (!IsRunningCommandlet())
+	{
+		if (GEngine && GEngine->IsInitialized())
+		{
+			HandlePostEngineInit();
+		}
+		else
+		{
+			PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddRaw(this, &FProceduralLocomotionPrewarmer::HandlePostEngineInit);
+		}
+	}
+
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FProceduralLocomotionPrewarmer::HandlePostLoadMap);
+}
+
+FProceduralLocomotionPrewarmer::~FProceduralLocomotionPrewarmer()
+{
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	if (Handle.IsValid())
+	{
+		Handle->CancelHandle();
+		Handle.Reset();
+	}
+
+	if (GActivePrewarmer == this)
+	{
+		GActivePrewarmer = nullptr;
+	}
+}
+
+void FProceduralLocomotionPrewarmer::HandlePostEngineInit()
+{
+	if (UProceduralLocomotionSettings::Get()->bPrewarmOnStartup)
+	{
+		Prewarm(TEXT("Startup"));
+	}
+}
+
+void FProceduralLocomotionPrewarmer::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+	if (LoadedWorld && LoadedWorld->IsGameWorld() && UProceduralLocomotionSettings::Get()->bPrewarmOnMapLoad)
+	{
+		Prewarm(FString::Printf(TEXT("MapLoad %s"), *LoadedWorld->GetMapName()));
+	}
+}
+
+void FProceduralLocomotionPrewarmer::Prewarm(const FString& Trigger)
+{
+	const UProceduralLocomotionSettings* Settings = UProceduralLocomotionSettings::Get();
+
+	TArray<FSoftObjectPath> Paths;
+	for (const TSoftClassPtr<UAnimInstance>& AnimClass : Settings->PrewarmAnimClasses)
+	{
+		if (!AnimClass.IsNull())
+		{
+			Paths.AddUnique(AnimClass.ToSoftObjectPath());
+		}
+	}
+	for (const TSoftObjectPtr<USkeletalMesh>& Mesh : Settings->PrewarmMeshes)
+	{
+		if (!Mesh.IsNull())
+		{
+			Paths.AddUnique(Mesh.ToSoftObjectPath());
+		}
+	}
+	if (!Settings->DefaultCharacterMesh.IsNull())
+	{
+		Paths.AddUnique(Settings->DefaultCharacterMesh.ToSoftObjectPath());
+	}
+	for (const FSoftObjectPath& DataAsset : Settings->PrewarmDataAssets)
+	{
+		if (DataAsset.IsValid())
+		{
+			Paths.AddUnique(DataAsset);
+		}
+	}
+
+	// A newer request supersedes one still in flight; replacing the handle afterwards releases
+	// only assets that are no longer listed, since shared paths stay referenced by the new one.
+	if (Handle.IsValid() && Handle->IsLoadingInProgress())
+	{
+		Handle->CancelHandle();
+	}
+
+	if (Paths.Num() == 0)
+	{
+		Handle.Reset();
+		return;
+	}
+
+	UE_LOG(LogProceduralLocomotion, Verbose, TEXT("Prewarm (%s): requesting %d assets"), *Trigger, Paths.Num());
+
+	Handle = StreamableManager.RequestAsyncLoad(
+		MoveTemp(Paths),
+		FStreamableDelegate::CreateRaw(this, &FProceduralLocomotionPrewarmer::HandleLoaded, Trigger, FPlatformTime::Seconds()),
+		FStreamableManager::AsyncLoadHighPriority,
+		/*bManageActiveHandle*/ false,
+		/*bStartStalled*/ false,
+		TEXT("ProceduralLocomotionPrewarm"));
+}
+
+void FProceduralLocomotionPrewarmer::HandleLoaded(FString Trigger, double RequestTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PLS_Prewarm);
+
+	const double BuildStart = FPlatformTime::Seconds();
+	const UProceduralLocomotionSettings* Settings = UProceduralLocomotionSettings::Get();
+
+	FProceduralLocomotionPrewarmReport Report;
+	Report.Trigger = MoveTemp(Trigger);
+	Report.LoadMs = (BuildStart - RequestTime) * 1000.0;
+
+	for (const TSoftClassPtr<UAnimInstance>& AnimClassPtr : Settings->PrewarmAnimClasses)
+	{
+		if (AnimClassPtr.IsNull())
+		{
+			continue;
+		}
+
+		UClass* AnimClass = AnimClassPtr.Get();
+		if (!AnimClass)
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("Prewarm: failed to load anim class %s"), *AnimClassPtr.ToString());
+			++Report.NumFailed;
+			continue;
+		}
+
+		// Creating the CDO runs the class's constructor-time setup (and, for anim blueprints,
+		// links the generated class) so the first instance only has to be duplicated from it.
+		AnimClass->GetDefaultObject();
+		Report.Items.Add(FString::Printf(TEXT("AnimClass %s"), *AnimClass->GetPathName()));
+		++Report.NumAnimClasses;
+	}
+
+	TArray<TSoftObjectPtr<USkeletalMesh>> Meshes = Settings->PrewarmMeshes;
+	if (!Settings->DefaultCharacterMesh.IsNull())
+	{
+		Meshes.AddUnique(Settings->DefaultCharacterMesh);
+	}
+
+	for (const TSoftObjectPtr<USkeletalMesh>& MeshPtr : Meshes)
+	{
+		if (MeshPtr.IsNull())
+		{
+			continue;
+		}
+
+		USkeletalMesh* Mesh = MeshPtr.Get();
+		USkeleton* Skeleton = Mesh ? Mesh->GetSkeleton() : nullptr;
+		if (!Skeleton)
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("Prewarm: failed to load mesh or skeleton %s"), *MeshPtr.ToString());
+			++Report.NumFailed;
+			continue;
+		}
+
+		// Initializing a bone container builds the skeleton-to-mesh linkup table, which the
+		// skeleton caches, plus the compact pose remapping for that LOD's required bones.
+		int32 NumContainers = 0;
+		if (const FSkeletalMeshRenderData* RenderData = Mesh->GetResourceForRendering())
+		{
+			for (const FSkeletalMeshLODRenderData& LODData : RenderData->LODRenderData)
+			{
+				FBoneContainer BoneContainer;
+				BoneContainer.InitializeTo(LODData.RequiredBones, UE::Anim::FCurveFilterSettings(), *Mesh);
+				++NumContainers;
+			}
+		}
+
+		Report.Items.Add(FString::Printf(TEXT("Mesh %s (%d LOD bone containers)"), *Mesh->GetPathName(), NumContainers));
+		Report.NumBoneContainers += NumContainers;
+		++Report.NumMeshes;
+	}
+
+	for (const FSoftObjectPath& DataAssetPath : Settings->PrewarmDataAssets)
+	{
+		if (!DataAssetPath.IsValid())
+		{
+			continue;
+		}
+
+		if (UObject* DataAsset = DataAssetPath.ResolveObject())
+		{
+			Report.Items.Add(FString::Printf(TEXT("Data %s"), *DataAsset->GetPathName()));
+			++Report.NumDataAssets;
+		}
+		else
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("Prewarm: failed to load data asset %s"), *DataAssetPath.ToString());
+			++Report.NumFailed;
+		}
+	}
+
+	Report.BuildMs = (FPlatformTime::Seconds() - BuildStart) * 1000.0;
+	Report.bComplete = true;
+
+	SET_FLOAT_STAT(STAT_PLS_PrewarmLoadMs, Report.LoadMs);
+	SET_FLOAT_STAT(STAT_PLS_PrewarmBuildMs, Report.BuildMs);
+	SET_DWORD_STAT(STAT_PLS_PrewarmAnimClasses, Report.NumAnimClasses);
+	SET_DWORD_STAT(STAT_PLS_PrewarmMeshes, Report.NumMeshes);
+	SET_DWORD_STAT(STAT_PLS_PrewarmBoneContainers, Report.NumBoneContainers);
+	SET_DWORD_STAT(STAT_PLS_PrewarmDataAssets, Report.NumDataAssets);
+
+	LastReport = MoveTemp(Report);
+
+	UE_LOG(LogProceduralLocomotion, Log, TEXT("Prewarm (%s): %d anim classes, %d meshes (%d bone containers), %d data assets, %d failed; load %.2f ms, build %.2f ms"),
+		*LastReport.Trigger, LastReport.NumAnimClasses, LastReport.NumMeshes, LastReport.NumBoneContainers,
+		LastReport.NumDataAssets, LastReport.NumFailed, LastReport.LoadMs, LastReport.BuildMs);
+}
+
+void FProceduralLocomotionPrewarmer::LogReport() const
+{
+	if (!LastReport.bComplete)
+	{
+		UE_LOG(LogProceduralLocomotion, Display, TEXT("Prewarm: no pass has completed yet%s"), IsPrewarming() ? TEXT(" (loading)") : TEXT(""));
+		return;
+	}
+
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Prewarm (%s): load %.2f ms, build %.2f ms, %d failed"),
+		*LastReport.Trigger, LastReport.LoadMs, LastReport.BuildMs, LastReport.NumFailed);
+	for (const FString& Item : LastReport.Items)
+	{
+		UE_LOG(LogProceduralLocomotion, Display, TEXT("  %s"), *Item);
+	}
+}
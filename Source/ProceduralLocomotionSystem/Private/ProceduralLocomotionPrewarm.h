@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+
+class UWorld;
+
+// What the last prewarm pass touched and what it cost. LoadMs is wall time from the async
+// request to completion; BuildMs is the game-thread time spent building bone mappings and
+// default objects once the assets were resident.
+struct FProceduralLocomotionPrewarmReport
+{
+	FString Trigger;
+	int32 NumAnimClasses = 0;
+	int32 NumMeshes = 0;
+	int32 NumBoneContainers = 0;
+	int32 NumDataAssets = 0;
+	int32 NumFailed = 0;
+	double LoadMs = 0.0;
+	double BuildMs = 0.0;
+	TArray<FString> Items;
+	bool bComplete = false;
+};
+
+// Loads the anim classes, meshes and locomotion data listed in UProceduralLocomotionSettings
+// ahead of the first character spawn, then builds the skeleton linkup and per-LOD bone
+// containers on the game thread. The streamable handle keeps everything resident afterwards.
+class FProceduralLocomotionPrewarmer
+{
+public:
+	FProceduralLocomotionPrewarmer();
+	~FProceduralLocomotionPrewarmer();
+
+	FProceduralLocomotionPrewarmer(const FProceduralLocomotionPrewarmer&) = delete;
+	FProceduralLocomotionPrewarmer& operator=(const FProceduralLocomotionPrewarmer&) = delete;
+
+	// Requests an async prewarm. A request made while another is in flight replaces it.
+	void Prewarm(const FString& Trigger);
+
+	bool IsPrewarming() const { return Handle.IsValid() && Handle->IsLoadingInProgress(); }
+	const FProceduralLocomotionPrewarmReport& GetLastReport() const { return LastReport; }
+
+	void LogReport() const;
+
+private:
+	void HandlePostEngineInit();
+	void HandlePostLoadMap(UWorld* LoadedWorld);
+	void HandleLoaded(FString Trigger, double RequestTime);
+
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> Handle;
+	FProceduralLocomotionPrewarmReport LastReport;
+
+	FDelegateHandle PostEngineInitHandle;
+	FDelegateHandle PostLoadMapHandle;
+};
@@ -0,0 +1,161 @@
+#include "ProceduralLocomotionProfile.h"
+
+#include "Curves/CurveFloat.h"
+
+void FProceduralLocomotionCurveTable::Bake(const UCurveFloat* Curve, int32 NumSamples, bool bFromZero)
+{
+	Values.Reset();
+	MinX = 0.0f;
+	InvStep = 0.0f;
+
+	if (!Curve || Curve->FloatCurve.GetNumKeys() == 0)
+	{
+		return;
+	}
+
+	float FirstKey = 0.0f;
+	float LastKey = 0.0f;
+	Curve->GetTimeRange(FirstKey, LastKey);
+	MinX = bFromZero ? 0.0f : FirstKey;
+	const float Range = LastKey - MinX;
+	if (Range <= UE_KINDA_SMALL_NUMBER)
+	{
+		// A single key or a curve entirely left of zero: a constant response.
+		Values.Init(Curve->GetFloatValue(LastKey), 2);
+		InvStep = 0.0f;
+		return;
+	}
+
+	NumSamples = FMath::Max(NumSamples, 2);
+	const float Step = Range / (NumSamples - 1);
+	Values.SetNumUninitialized(NumSamples);
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		Values[Index] = Curve->GetFloatValue(MinX + Step * Index);
+	}
+	InvStep = 1.0f / Step;
+}
+
+ProceduralLocomotionMath::FLookupTable FProceduralLocomotionCurveTable::GetTable() const
+{
+	ProceduralLocomotionMath::FLookupTable Table;
+	Table.Values = Values.GetData();
+	Table.NumValues = Values.Num();
+	Table.MinX = MinX;
+	Table.InvStep = InvStep;
+	return Table;
+}
+
+const FProceduralLocomotionClip* UProceduralLocomotionProfile::FindClipForSpeed(float Speed) const
+{
+	return LocomotionClips.FindByPredicate([Speed](const FProceduralLocomotionClip& Clip)
+	{
+		return Speed >= Clip.MinSpeed && Speed < Clip.MaxSpeed;
+	});
+}
+
+ProceduralLocomotionMath::FLeanParams UProceduralLocomotionProfile::GetLeanParams() const
+{
+	ProceduralLocomotionMath::FLeanParams Params;
+	Params.MaxLeanAngle = MaxLeanAngle;
+	Params.AccelerationLeanMultiplier = AccelerationLeanMultiplier;
+	Params.YawRateLeanMultiplier = YawRateLeanMultiplier;
+	Params.LeanInterpSpeed = LeanInterpSpeed;
+	return Params;
+}
+
+void UProceduralLocomotionProfile::SetLeanParams(const ProceduralLocomotionMath::FLeanParams& Params)
+{
+	MaxLeanAngle = Params.MaxLeanAngle;
+	AccelerationLeanMultiplier = Params.AccelerationLeanMultiplier;
+	YawRateLeanMultiplier = Params.YawRateLeanMultiplier;
+	LeanInterpSpeed = Params.LeanInterpSpeed;
+}
+
+ProceduralLocomotionMath::FLeanResponse UProceduralLocomotionProfile::GetLeanResponse() const
+{
+	ProceduralLocomotionMath::FLeanResponse Response;
+	Response.AccelerationLean = AccelerationLeanTable.GetTable();
+	Response.YawRateLean = YawRateLeanTable.GetTable();
+	Response.MaxLeanBySpeed = MaxLeanBySpeedTable.GetTable();
+	return Response;
+}
+
+void UProceduralLocomotionProfile::BakeLeanCurves()
+{
+#if WITH_EDITOR
+	UnbindCurveUpdates();
+	BindCurveUpdates();
+#endif
+	BakeTables();
+}
+
+void UProceduralLocomotionProfile::BakeTables()
+{
+	// Curves referenced by the profile may not have finished loading when the profile does.
+	for (UCurveFloat* Curve : { AccelerationLeanCurve.Get(), YawRateLeanCurve.Get(), MaxLeanBySpeedCurve.Get() })
+	{
+		if (Curve)
+		{
+			Curve->ConditionalPostLoad();
+		}
+	}
+
+	AccelerationLeanTable.Bake(AccelerationLeanCurve, LeanCurveSamples, true);
+	YawRateLeanTable.Bake(YawRateLeanCurve, LeanCurveSamples, true);
+	MaxLeanBySpeedTable.Bake(MaxLeanBySpeedCurve, LeanCurveSamples, false);
+}
+
+void UProceduralLocomotionProfile::PostLoad()
+{
+	Super::PostLoad();
+	BakeLeanCurves();
+}
+
+void UProceduralLocomotionProfile::BeginDestroy()
+{
+#if WITH_EDITOR
+	UnbindCurveUpdates();
+#endif
+	Super::BeginDestroy();
+}
+
+#if WITH_EDITOR
+void UProceduralLocomotionProfile::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Rebinds too, in case a curve property now points at another asset.
+	BakeLeanCurves();
+}
+
+void UProceduralLocomotionProfile::BindCurveUpdates()
+{
+	for (UCurveFloat* Curve : { AccelerationLeanCurve.Get(), YawRateLeanCurve.Get(), MaxLeanBySpeedCurve.Get() })
+	{
+		if (Curve && !BoundCurves.Contains(Curve))
+		{
+			Curve->OnUpdateCurve.AddUObject(this, &UProceduralLocomotionProfile::HandleCurveUpdated);
+			BoundCurves.Add(Curve);
+		}
+	}
+}
+
+void UProceduralLocomotionProfile::UnbindCurveUpdates()
+{
+	for (const TWeakObjectPtr<UCurveFloat>& Curve : BoundCurves)
+	{
+		if (UCurveFloat* BoundCurve = Curve.Get())
+		{
+			BoundCurve->OnUpdateCurve.RemoveAll(this);
+		}
+	}
+	BoundCurves.Reset();
+}
+
+void UProceduralLocomotionProfile::HandleCurveUpdated(UCurveBase* Curve, EPropertyChangeType::Type ChangeType)
+{
+	// Only the tables: rebinding here would change the delegate that is broadcasting.
+	BakeTables();
+}
+#endif
@@ -0,0 +1,191 @@
+#include "ProceduralLocomotionReplay.h"
+
+#include "ProceduralLocomotionSystem.h"
+#include "Algo/AllOf.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	enum ELayerBits : uint8
+	{
+		LayerLeaning = 1 << 0,
+		LayerProceduralBone = 1 << 1,
+		LayerFootIK = 1 << 2,
+	};
+
+	enum EGroundBits : uint8
+	{
+		GroundScheduled = 1 << 0,
+		GroundLeftServed = 1 << 1,
+		GroundLeftHit = 1 << 2,
+		GroundRightServed = 1 << 3,
+		GroundRightHit = 1 << 4,
+	};
+
+	// Compressed file: this header, then the archive.
+	struct FReplayFileHeader
+	{
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		int64 UncompressedSize = 0;
+	};
+}
+
+FArchive& operator<<(FArchive& Ar, FProceduralLocomotionAnimInput& Input)
+{
+	Ar << Input.DeltaSeconds << Input.Location << Input.Rotation << Input.AimYaw << Input.Velocity << Input.Acceleration;
+	Ar << Input.bIdle << Input.bTurnInPlace;
+	Ar << Input.LeftFootTrace << Input.RightFootTrace << Input.HitImpulse;
+
+	// Most characters stand on static ground, so the base transform is only stored with a base.
+	Ar << Input.BaseId;
+	if (Input.BaseId != 0)
+	{
+		Ar << Input.BaseLocation << Input.BaseRotation;
+	}
+
+	uint8 Layers = (Input.Layers.bLeaning ? LayerLeaning : 0)
+		| (Input.Layers.bProceduralBone ? LayerProceduralBone : 0)
+		| (Input.Layers.bFootIK ? LayerFootIK : 0);
+	Ar << Layers;
+	Input.Layers.bLeaning = (Layers & LayerLeaning) != 0;
+	Input.Layers.bProceduralBone = (Layers & LayerProceduralBone) != 0;
+	Input.Layers.bFootIK = (Layers & LayerFootIK) != 0;
+
+	// Served ground queries are stored so playback neither traces for them nor waits on the scheduler.
+	uint8 Ground = (Input.bScheduledGroundQueries ? GroundScheduled : 0)
+		| (Input.LeftFootGround.bServed ? GroundLeftServed : 0) | (Input.LeftFootGround.bHit ? GroundLeftHit : 0)
+		| (Input.RightFootGround.bServed ? GroundRightServed : 0) | (Input.RightFootGround.bHit ? GroundRightHit : 0);
+	Ar << Ground;
+	Input.bScheduledGroundQueries = (Ground & GroundScheduled) != 0;
+	Input.LeftFootGround.bServed = (Ground & GroundLeftServed) != 0;
+	Input.LeftFootGround.bHit = (Ground & GroundLeftHit) != 0;
+	Input.RightFootGround.bServed = (Ground & GroundRightServed) != 0;
+	Input.RightFootGround.bHit = (Ground & GroundRightHit) != 0;
+	if (Input.LeftFootGround.bHit)
+	{
+		Ar << Input.LeftFootGround.Location << Input.LeftFootGround.Normal;
+	}
+	if (Input.RightFootGround.bHit)
+	{
+		Ar << Input.RightFootGround.Location << Input.RightFootGround.Normal;
+	}
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FProceduralLocomotionFootPlant& Plant)
+{
+	Ar << Plant.Location << Plant.Normal << Plant.BaseId << Plant.bValid;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FProceduralLocomotionAnimState& State)
+{
+	Ar << State.LocomotionPhase << State.LeanAngle << State.LastYawDegrees << State.ProceduralTime;
+	Ar << State.LeftFootOffset << State.RightFootOffset << State.PelvisOffset << State.FootIKAlpha;
+	Ar << State.RootYawOffset << State.LastActorYaw << State.TurnInPlaceYaw << State.bTurningInPlace << State.bWasIdle;
+	Ar << State.LeftFootRotation << State.RightFootRotation << State.LeftFootPlant << State.RightFootPlant;
+	Ar << State.HitSprings;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FProceduralLocomotionReplayTrack& Track)
+{
+	Ar << Track.CharacterName << Track.CharacterClass << Track.InitialState;
+	Ar << Track.Frames << Track.Inputs;
+	Ar << Track.VerifyBoneNames << Track.VerifyPoses << Track.VerifyStates;
+	return Ar;
+}
+
+void FProceduralLocomotionReplay::Reset()
+{
+	NumFrames = 0;
+	Tracks.Reset();
+}
+
+void FProceduralLocomotionReplay::Serialize(FArchive& Ar)
+{
+	Ar << NumFrames << Tracks;
+}
+
+bool FProceduralLocomotionReplay::SaveToFile(const FString& Filename) const
+{
+	TArray<uint8> Uncompressed;
+	FMemoryWriter Writer(Uncompressed);
+	const_cast<FProceduralLocomotionReplay*>(this)->Serialize(Writer);
+
+	FReplayFileHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.UncompressedSize = Uncompressed.Num();
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Uncompressed.Num());
+	TArray<uint8> Data;
+	Data.SetNumUninitialized(sizeof(Header) + CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, Data.GetData() + sizeof(Header), CompressedSize, Uncompressed.GetData(), Uncompressed.Num()))
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: could not compress %s"), *Filename);
+		return false;
+	}
+	FMemory::Memcpy(Data.GetData(), &Header, sizeof(Header));
+	Data.SetNum(sizeof(Header) + CompressedSize);
+
+	if (!FFileHelper::SaveArrayToFile(Data, *Filename))
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: could not write %s"), *Filename);
+		return false;
+	}
+	return true;
+}
+
+bool FProceduralLocomotionReplay::LoadFromFile(const FString& Filename)
+{
+	Reset();
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: could not read %s"), *Filename);
+		return false;
+	}
+
+	FReplayFileHeader Header;
+	if (Data.Num() < (int32)sizeof(Header))
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: %s is not a replay"), *Filename);
+		return false;
+	}
+	FMemory::Memcpy(&Header, Data.GetData(), sizeof(Header));
+	if (Header.Magic != Magic || Header.Version != Version || Header.UncompressedSize < 0 || Header.UncompressedSize > MAX_int32)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: %s is not a version %u replay"), *Filename, Version);
+		return false;
+	}
+
+	TArray<uint8> Uncompressed;
+	Uncompressed.SetNumUninitialized((int32)Header.UncompressedSize);
+	if (!FCompression::UncompressMemory(NAME_Zlib, Uncompressed.GetData(), Uncompressed.Num(), Data.GetData() + sizeof(Header), Data.Num() - sizeof(Header)))
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: %s is corrupt"), *Filename);
+		return false;
+	}
+
+	FMemoryReader Reader(Uncompressed);
+	Serialize(Reader);
+	const bool bConsistent = Algo::AllOf(Tracks, [](const FProceduralLocomotionReplayTrack& Track)
+	{
+		const bool bVerification = Track.VerifyStates.Num() > 0 || Track.VerifyPoses.Num() > 0;
+		return Track.Frames.Num() == Track.Inputs.Num()
+			&& (!bVerification || (Track.VerifyStates.Num() == Track.Inputs.Num() && Track.VerifyPoses.Num() == Track.VerifyBoneNames.Num() * Track.Inputs.Num()));
+	});
+	if (Reader.IsError() || !bConsistent)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: %s is corrupt"), *Filename);
+		Reset();
+		return false;
+	}
+	return true;
+}
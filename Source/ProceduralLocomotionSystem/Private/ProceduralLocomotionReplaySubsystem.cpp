@@ -0,0 +1,428 @@
+#include "ProceduralLocomotionReplaySubsystem.h"
+
+#include "ProceduralCharacter.h"
+#include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<bool> CVarReplayVerify(
+	TEXT("pls.Replay.Verify"),
+	false,
+	TEXT("Also records poses and layer state so playback can check that re-simulation matches. Applied when recording starts."));
+
+static TAutoConsoleVariable<float> CVarReplayVerifyTolerance(
+	TEXT("pls.Replay.VerifyTolerance"),
+	0.1f,
+	TEXT("Largest snapshot bone position difference (cm) accepted when verifying a replay."));
+
+namespace
+{
+	FAutoConsoleCommandWithWorldAndArgs ReplayRecordCommand(
+		TEXT("pls.Replay.Record"),
+		TEXT("Records an input-only replay of procedural characters: pls.Replay.Record [File]."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UProceduralLocomotionReplaySubsystem* Replays = World ? World->GetSubsystem<UProceduralLocomotionReplaySubsystem>() : nullptr)
+			{
+				Replays->StartRecording(Args.Num() > 0 ? Args[0] : FString());
+			}
+		}));
+
+	FAutoConsoleCommandWithWorldAndArgs ReplayPlayCommand(
+		TEXT("pls.Replay.Play"),
+		TEXT("Plays an input-only replay by re-simulating its characters: pls.Replay.Play File."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UProceduralLocomotionReplaySubsystem* Replays = World ? World->GetSubsystem<UProceduralLocomotionReplaySubsystem>() : nullptr;
+			if (Replays && Args.Num() > 0)
+			{
+				Replays->StartPlayback(Args[0]);
+			}
+		}));
+
+	FAutoConsoleCommandWithWorld ReplayStopCommand(
+		TEXT("pls.Replay.Stop"),
+		TEXT("Stops replay recording (saving the file) or playback."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UProceduralLocomotionReplaySubsystem* Replays = World ? World->GetSubsystem<UProceduralLocomotionReplaySubsystem>() : nullptr)
+			{
+				Replays->Stop();
+			}
+		}));
+
+	// Invalid plants match whatever stale values they still hold.
+	bool IsSamePlant(const FProceduralLocomotionFootPlant& A, const FProceduralLocomotionFootPlant& B)
+	{
+		return A.bValid == B.bValid
+			&& (!A.bValid || (A.Location == B.Location && A.Normal == B.Normal && A.BaseId == B.BaseId));
+	}
+
+	// Layer state must match exactly; any difference means an input reached the layers some other way.
+	const TCHAR* FindStateDifference(const FProceduralLocomotionAnimState& A, const FProceduralLocomotionAnimState& B)
+	{
+		if (A.LocomotionPhase != B.LocomotionPhase) { return TEXT("LocomotionPhase"); }
+		if (A.RootYawOffset != B.RootYawOffset || A.LastActorYaw != B.LastActorYaw || A.TurnInPlaceYaw != B.TurnInPlaceYaw
+			|| A.bTurningInPlace != B.bTurningInPlace || A.bWasIdle != B.bWasIdle)
+		{
+			return TEXT("TurnInPlace");
+		}
+		if (A.LeanAngle != B.LeanAngle || A.LastYawDegrees != B.LastYawDegrees) { return TEXT("LeanAngle"); }
+		if (A.ProceduralTime != B.ProceduralTime) { return TEXT("ProceduralTime"); }
+		if (A.LeftFootOffset != B.LeftFootOffset || A.RightFootOffset != B.RightFootOffset || A.PelvisOffset != B.PelvisOffset
+			|| A.LeftFootRotation != B.LeftFootRotation || A.RightFootRotation != B.RightFootRotation)
+		{
+			return TEXT("FootIK");
+		}
+		if (!IsSamePlant(A.LeftFootPlant, B.LeftFootPlant) || !IsSamePlant(A.RightFootPlant, B.RightFootPlant)) { return TEXT("FootPlant"); }
+		if (A.FootIKAlpha != B.FootIKAlpha) { return TEXT("FootIKAlpha"); }
+		if (A.HitSprings != B.HitSprings) { return TEXT("HitReaction"); }
+		return nullptr;
+	}
+}
+
+void UProceduralLocomotionReplaySubsystem::Deinitialize()
+{
+	Stop();
+	Characters.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UProceduralLocomotionReplaySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UProceduralLocomotionReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProceduralLocomotionReplaySubsystem, STATGROUP_Tickables);
+}
+
+void UProceduralLocomotionReplaySubsystem::RegisterCharacter(AProceduralCharacter* Character)
+{
+	Characters.AddUnique(Character);
+	if (bRecording)
+	{
+		BeginRecordingCharacter(Character);
+	}
+}
+
+void UProceduralLocomotionReplaySubsystem::UnregisterCharacter(AProceduralCharacter* Character)
+{
+	Characters.RemoveSingleSwap(Character);
+}
+
+UProceduralLocomotionAnimInstance* UProceduralLocomotionReplaySubsystem::GetAnimInstance(const AProceduralCharacter* Character)
+{
+	const USkeletalMeshComponent* MeshComp = Character ? Character->GetMesh() : nullptr;
+	return MeshComp ? Cast<UProceduralLocomotionAnimInstance>(MeshComp->GetAnimInstance()) : nullptr;
+}
+
+bool UProceduralLocomotionReplaySubsystem::StartRecording(const FString& Filename)
+{
+	Stop();
+
+	Replay.Reset();
+	ReplayFilename = !Filename.IsEmpty() ? Filename
+		: FPaths::ProjectSavedDir() / TEXT("Replays") / FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")) + TEXT(".plsreplay");
+	bVerifyRecording = CVarReplayVerify.GetValueOnGameThread();
+	Frame = 0;
+	bRecording = true;
+
+	for (const TWeakObjectPtr<AProceduralCharacter>& Character : Characters)
+	{
+		BeginRecordingCharacter(Character.Get());
+	}
+
+	UE_LOG(LogProceduralLocomotion, Log, TEXT("Replay: recording %d characters to %s%s"), Recorded.Num(), *ReplayFilename,
+		bVerifyRecording ? TEXT(" with verification") : TEXT(""));
+	return true;
+}
+
+void UProceduralLocomotionReplaySubsystem::BeginRecordingCharacter(AProceduralCharacter* Character)
+{
+	const UProceduralLocomotionAnimInstance* AnimInstance = GetAnimInstance(Character);
+	if (!AnimInstance || AnimInstance->IsReplayControlled())
+	{
+		return;
+	}
+
+	FProceduralLocomotionReplayTrack& Track = Replay.Tracks.AddDefaulted_GetRef();
+	Track.CharacterName = Character->GetName();
+	Track.CharacterClass = FSoftClassPath(Character->GetClass());
+	// Everything the layers carry between updates; the recorded inputs take it from here.
+	Track.InitialState = AnimInstance->GetLayerState();
+	if (bVerifyRecording)
+	{
+		const FProceduralLocomotionPoseSnapshot& Snapshot = AnimInstance->GetPoseSnapshot();
+		for (int32 Slot = 0; Slot < Snapshot.GetNumSlots(); ++Slot)
+		{
+			Track.VerifyBoneNames.Add(Snapshot.GetBoneName(Slot));
+		}
+	}
+
+	FRecordedCharacter& Record = Recorded.AddDefaulted_GetRef();
+	Record.Character = Character;
+	Record.TrackIndex = Replay.Tracks.Num() - 1;
+	Record.LastUpdateCount = AnimInstance->GetUpdateCount();
+}
+
+bool UProceduralLocomotionReplaySubsystem::StartPlayback(const FString& Filename)
+{
+	Stop();
+
+	if (!Replay.LoadFromFile(Filename))
+	{
+		return false;
+	}
+
+	ReplayFilename = Filename;
+	Frame = 0;
+	bPlaying = true;
+	Playbacks.Reset();
+	Playbacks.SetNum(Replay.Tracks.Num());
+	VerifiedUpdates = 0;
+	DivergedTracks = 0;
+	MaxPoseError = 0.0f;
+
+	UE_LOG(LogProceduralLocomotion, Log, TEXT("Replay: playing %s, %d characters over %d frames"), *Filename, Replay.Tracks.Num(), Replay.NumFrames);
+
+	// Inputs for the first frame go in now so the coming update consumes them.
+	TickPlayback();
+	return true;
+}
+
+void UProceduralLocomotionReplaySubsystem::Stop()
+{
+	if (bRecording)
+	{
+		bRecording = false;
+		Recorded.Reset();
+
+		int32 NumUpdates = 0;
+		for (const FProceduralLocomotionReplayTrack& Track : Replay.Tracks)
+		{
+			NumUpdates += Track.Inputs.Num();
+		}
+		if (Replay.SaveToFile(ReplayFilename))
+		{
+			const int64 Bytes = IFileManager::Get().FileSize(*ReplayFilename);
+			UE_LOG(LogProceduralLocomotion, Log, TEXT("Replay: saved %s; %d characters, %d frames, %d updates, %.1f KB (%.1f bytes per update)"),
+				*ReplayFilename, Replay.Tracks.Num(), Replay.NumFrames, NumUpdates, Bytes / 1024.0, NumUpdates > 0 ? (double)Bytes / NumUpdates : 0.0);
+		}
+		Replay.Reset();
+	}
+
+	if (bPlaying)
+	{
+		bPlaying = false;
+		for (FPlaybackCharacter& Playback : Playbacks)
+		{
+			if (AProceduralCharacter* Character = Playback.Character.Get())
+			{
+				Character->Destroy();
+			}
+		}
+		Playbacks.Reset();
+
+		if (VerifiedUpdates > 0)
+		{
+			UE_LOG(LogProceduralLocomotion, Log, TEXT("Replay: verified %d updates; %d of %d characters diverged, largest pose error %.3f cm"),
+				VerifiedUpdates, DivergedTracks, Replay.Tracks.Num(), MaxPoseError);
+		}
+		Replay.Reset();
+	}
+}
+
+void UProceduralLocomotionReplaySubsystem::Tick(float DeltaTime)
+{
+	if (bRecording)
+	{
+		TickRecording();
+	}
+	else if (bPlaying)
+	{
+		// The updates of the frame just finished were fed last tick; check them, then feed the next frame.
+		for (int32 Index = 0; Index < Playbacks.Num(); ++Index)
+		{
+			if (Playbacks[Index].bPendingVerify)
+			{
+				VerifyUpdate(Playbacks[Index], Replay.Tracks[Index]);
+			}
+		}
+
+		++Frame;
+		if (Frame >= Replay.NumFrames)
+		{
+			UE_LOG(LogProceduralLocomotion, Log, TEXT("Replay: %s finished"), *ReplayFilename);
+			Stop();
+			return;
+		}
+		TickPlayback();
+	}
+}
+
+void UProceduralLocomotionReplaySubsystem::TickRecording()
+{
+	// Runs after the frame's animation has finished, so each changed update count is one update this frame.
+	for (FRecordedCharacter& Record : Recorded)
+	{
+		const UProceduralLocomotionAnimInstance* AnimInstance = GetAnimInstance(Record.Character.Get());
+		if (!AnimInstance || AnimInstance->GetUpdateCount() == Record.LastUpdateCount)
+		{
+			continue;
+		}
+		Record.LastUpdateCount = AnimInstance->GetUpdateCount();
+
+		FProceduralLocomotionReplayTrack& Track = Replay.Tracks[Record.TrackIndex];
+		Track.Frames.Add(Frame);
+		Track.Inputs.Add(AnimInstance->GetLastInput());
+
+		if (bVerifyRecording)
+		{
+			const FProceduralLocomotionPoseSnapshot& Snapshot = AnimInstance->GetPoseSnapshot();
+			for (int32 Slot = 0; Slot < Track.VerifyBoneNames.Num(); ++Slot)
+			{
+				FTransform& Pose = Track.VerifyPoses.Add_GetRef(FTransform::Identity);
+				Snapshot.GetBoneTransform(Slot, Pose, false);
+			}
+			Track.VerifyStates.Add(AnimInstance->GetLayerState());
+		}
+	}
+
+	++Frame;
+	Replay.NumFrames = Frame;
+}
+
+void UProceduralLocomotionReplaySubsystem::TickPlayback()
+{
+	for (int32 Index = 0; Index < Playbacks.Num(); ++Index)
+	{
+		FPlaybackCharacter& Playback = Playbacks[Index];
+		const FProceduralLocomotionReplayTrack& Track = Replay.Tracks[Index];
+		if (Track.GetFirstFrame() == Frame && !Playback.Character.IsValid())
+		{
+			Playback.Character = SpawnPlaybackCharacter(Track);
+		}
+		if (Playback.Character.IsValid() && Track.Frames.IsValidIndex(Playback.NextInput) && Track.Frames[Playback.NextInput] == Frame)
+		{
+			PushNextInput(Playback, Track);
+		}
+	}
+}
+
+AProceduralCharacter* UProceduralLocomotionReplaySubsystem::SpawnPlaybackCharacter(const FProceduralLocomotionReplayTrack& Track)
+{
+	UClass* Class = Track.CharacterClass.TryLoadClass<AProceduralCharacter>();
+	if (!Class)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: class %s of %s not found, using AProceduralCharacter"), *Track.CharacterClass.ToString(), *Track.CharacterName);
+		Class = AProceduralCharacter::StaticClass();
+	}
+
+	const FProceduralLocomotionAnimInput& First = Track.Inputs[0];
+	const FTransform SpawnTransform(FRotator(First.Rotation), First.Location);
+	AProceduralCharacter* Character = GetWorld()->SpawnActorDeferred<AProceduralCharacter>(Class, SpawnTransform, nullptr, nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Character)
+	{
+		return nullptr;
+	}
+	// Moved by the replay only: no controller, no movement, and nothing for live characters or traces to hit.
+	Character->AutoPossessAI = EAutoPossessAI::Disabled;
+	Character->FinishSpawning(SpawnTransform);
+	Character->SetActorEnableCollision(false);
+	if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+	{
+		Movement->DisableMovement();
+		Movement->SetComponentTickEnabled(false);
+	}
+
+	// Every recorded update has to run, on or off screen.
+	USkeletalMeshComponent* MeshComp = Character->GetMesh();
+	UProceduralLocomotionAnimInstance* AnimInstance = GetAnimInstance(Character);
+	if (!MeshComp || !AnimInstance)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: %s has no procedural anim instance; skipped"), *Track.CharacterName);
+		Character->Destroy();
+		return nullptr;
+	}
+	MeshComp->bEnableUpdateRateOptimizations = false;
+	MeshComp->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+	AnimInstance->SetReplayControlled(true);
+	AnimInstance->SetLayerState(Track.InitialState);
+	return Character;
+}
+
+void UProceduralLocomotionReplaySubsystem::PushNextInput(FPlaybackCharacter& Playback, const FProceduralLocomotionReplayTrack& Track)
+{
+	AProceduralCharacter* Character = Playback.Character.Get();
+	UProceduralLocomotionAnimInstance* AnimInstance = GetAnimInstance(Character);
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	const FProceduralLocomotionAnimInput& Input = Track.Inputs[Playback.NextInput];
+	Character->SetActorLocationAndRotation(Input.Location, FRotator(Input.Rotation), false, nullptr, ETeleportType::TeleportPhysics);
+	AnimInstance->PushReplayInput(Input);
+
+	Playback.ExpectedUpdateCount = AnimInstance->GetUpdateCount() + 1;
+	Playback.bPendingVerify = Track.HasVerification() && !Playback.bDiverged;
+	++Playback.NextInput;
+}
+
+void UProceduralLocomotionReplaySubsystem::VerifyUpdate(FPlaybackCharacter& Playback, const FProceduralLocomotionReplayTrack& Track)
+{
+	Playback.bPendingVerify = false;
+	const UProceduralLocomotionAnimInstance* AnimInstance = GetAnimInstance(Playback.Character.Get());
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	const int32 Update = Playback.NextInput - 1;
+	FString Divergence;
+	if (AnimInstance->GetUpdateCount() != Playback.ExpectedUpdateCount)
+	{
+		Divergence = TEXT("the recorded update did not run");
+	}
+	else if (const TCHAR* Field = FindStateDifference(AnimInstance->GetLayerState(), Track.VerifyStates[Update]))
+	{
+		Divergence = FString::Printf(TEXT("%s differs"), Field);
+	}
+	else
+	{
+		const FProceduralLocomotionPoseSnapshot& Snapshot = AnimInstance->GetPoseSnapshot();
+		const int32 NumBones = Track.VerifyBoneNames.Num();
+		for (int32 Slot = 0; Slot < NumBones; ++Slot)
+		{
+			FTransform Pose = FTransform::Identity;
+			Snapshot.GetBoneTransform(Slot, Pose, false);
+			const float Error = (float)FVector::Dist(Pose.GetLocation(), Track.VerifyPoses[Update * NumBones + Slot].GetLocation());
+			MaxPoseError = FMath::Max(MaxPoseError, Error);
+			if (Error > CVarReplayVerifyTolerance.GetValueOnGameThread() && Divergence.IsEmpty())
+			{
+				Divergence = FString::Printf(TEXT("%s is %.3f cm off"), *Track.VerifyBoneNames[Slot].ToString(), Error);
+			}
+		}
+	}
+	++VerifiedUpdates;
+
+	if (!Divergence.IsEmpty())
+	{
+		// Later updates build on the diverged state, so only the first one is worth reporting.
+		Playback.bDiverged = true;
+		++DivergedTracks;
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Replay: %s diverged at frame %d (update %d): %s"),
+			*Track.CharacterName, Track.Frames[Update], Update, *Divergence);
+	}
+}
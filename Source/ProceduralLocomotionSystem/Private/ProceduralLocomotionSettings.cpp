@@ -0,0 +1,12 @@
+#include "ProceduralLocomotionSettings.h"
+
+#include "ProceduralLocomotionAnimInstance.h"
+#include "Engine/SkeletalMesh.h"
+
+UProceduralLocomotionSettings::UProceduralLocomotionSettings()
+{
+	DefaultCharacterMesh = TSoftObjectPtr<USkeletalMesh>(FSoftObjectPath(TEXT("/Engine/EngineMeshes/SkeletalCube.SkeletalCube")));
+
+	PrewarmAnimClasses.Add(UProceduralLocomotionAnimInstance::StaticClass());
+	PrewarmMeshes.Add(DefaultCharacterMesh);
+}
@@ -0,0 +1,405 @@
+#include "ProceduralLocomotionSoakCommandlet.h"
+
+#include "ProceduralCharacter.h"
+#include "ProceduralLocomotionBenchmarkWorld.h"
+#include "ProceduralLocomotionStats.h"
+#include "ProceduralLocomotionSystem.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Math/RandomStream.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace ProceduralLocomotionSoak
+{
+	struct FSoakSettings
+	{
+		float DurationMinutes = 240.0f;
+		int32 NumCharacters = 128;
+		float DeltaSeconds = 1.0f / 30.0f;
+		float ChurnPerSecond = 8.0f;
+		float PoolFraction = 0.5f;
+		float DormancyFraction = 0.1f;
+		FString StreamingLevel;
+		float StreamingIntervalSeconds = 120.0f;
+		int32 StreamedCharacters = 32;
+		float SampleSeconds = 60.0f;
+		float GCIntervalSeconds = 30.0f;
+		int32 WarmupWindows = 3;
+		double MaxMemoryGrowthMBPerHour = 32.0;
+		double MaxObjectGrowthPerHour = 2000.0;
+		double MaxTailGrowth = 1.25;
+	};
+
+	// One row of the time series.
+	struct FSoakWindow
+	{
+		double WallMinutes = 0.0;
+		int32 Frames = 0;
+		double UsedPhysicalMB = 0.0;
+		int32 NumObjects = 0;
+		int32 NumCharacters = 0;
+		int32 NumPooled = 0;
+		int32 NumGCs = 0;
+		double GCMaxMs = 0.0;
+		double GCTotalMs = 0.0;
+		double FrameP50Ms = 0.0;
+		double FrameP99Ms = 0.0;
+		double FrameP999Ms = 0.0;
+		double LocomotionMeanMs = 0.0;
+		double LocomotionP99Ms = 0.0;
+
+		static const TCHAR* CsvHeader()
+		{
+			return TEXT("WallMinutes,Frames,UsedPhysicalMB,UObjects,Characters,Pooled,GCs,GCMaxMs,GCTotalMs,FrameP50Ms,FrameP99Ms,FrameP999Ms,LocomotionMeanMs,LocomotionP99Ms\n");
+		}
+
+		FString ToCsvRow() const
+		{
+			return FString::Printf(TEXT("%.2f,%d,%.1f,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.4f,%.4f\n"),
+				WallMinutes, Frames, UsedPhysicalMB, NumObjects, NumCharacters, NumPooled, NumGCs, GCMaxMs, GCTotalMs,
+				FrameP50Ms, FrameP99Ms, FrameP999Ms, LocomotionMeanMs, LocomotionP99Ms);
+		}
+	};
+
+	static double Percentile(TArray<double>& Samples, double Fraction)
+	{
+		if (Samples.Num() == 0)
+		{
+			return 0.0;
+		}
+
+		Samples.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Samples.Num()) - 1, 0, Samples.Num() - 1);
+		return Samples[Index];
+	}
+
+	// Least-squares slope of Values over Minutes, scaled to units per hour.
+	static double SlopePerHour(const TArray<double>& Minutes, const TArray<double>& Values)
+	{
+		const int32 N = Values.Num();
+		if (N < 2)
+		{
+			return 0.0;
+		}
+
+		double MeanX = 0.0;
+		double MeanY = 0.0;
+		for (int32 Index = 0; Index < N; ++Index)
+		{
+			MeanX += Minutes[Index];
+			MeanY += Values[Index];
+		}
+		MeanX /= N;
+		MeanY /= N;
+
+		double Covariance = 0.0;
+		double Variance = 0.0;
+		for (int32 Index = 0; Index < N; ++Index)
+		{
+			Covariance += (Minutes[Index] - MeanX) * (Values[Index] - MeanY);
+			Variance += FMath::Square(Minutes[Index] - MeanX);
+		}
+
+		return Variance > 0.0 ? (Covariance / Variance) * 60.0 : 0.0;
+	}
+
+	// Fraction of consecutive windows where the value went up; close to 1 means monotonic growth.
+	static double IncreasingFraction(const TArray<double>& Values)
+	{
+		if (Values.Num() < 2)
+		{
+			return 0.0;
+		}
+
+		int32 NumIncreasing = 0;
+		for (int32 Index = 1; Index < Values.Num(); ++Index)
+		{
+			NumIncreasing += Values[Index] > Values[Index - 1] ? 1 : 0;
+		}
+		return double(NumIncreasing) / double(Values.Num() - 1);
+	}
+
+	static double MedianOf(TArray<double> Values)
+	{
+		return Percentile(Values, 0.5);
+	}
+
+	// Compares the first and last few windows of a tail-latency series.
+	static double TailGrowth(const TArray<double>& Values, int32 NumEdgeWindows)
+	{
+		if (Values.Num() < NumEdgeWindows * 2)
+		{
+			return 1.0;
+		}
+
+		const double Early = MedianOf(TArray<double>(Values.GetData(), NumEdgeWindows));
+		const double Late = MedianOf(TArray<double>(Values.GetData() + Values.Num() - NumEdgeWindows, NumEdgeWindows));
+		return Early > 0.0 ? Late / Early : 1.0;
+	}
+
+	// Returns the number of flagged problems.
+	static int32 Analyze(const TArray<FSoakWindow>& Windows, const FSoakSettings& Settings)
+	{
+		constexpr double MonotonicFraction = 0.7;
+		constexpr int32 EdgeWindows = 3;
+
+		TArray<double> Minutes;
+		TArray<double> MemoryMB;
+		TArray<double> Objects;
+		TArray<double> FrameP99;
+		TArray<double> FrameP999;
+		TArray<double> LocomotionP99;
+		for (int32 Index = Settings.WarmupWindows; Index < Windows.Num(); ++Index)
+		{
+			const FSoakWindow& Window = Windows[Index];
+			Minutes.Add(Window.WallMinutes);
+			MemoryMB.Add(Window.UsedPhysicalMB);
+			Objects.Add(Window.NumObjects);
+			FrameP99.Add(Window.FrameP99Ms);
+			FrameP999.Add(Window.FrameP999Ms);
+			LocomotionP99.Add(Window.LocomotionP99Ms);
+		}
+
+		if (Minutes.Num() < 2)
+		{
+			UE_LOG(LogProceduralLocomotion, Warning, TEXT("Soak: not enough windows after warmup to analyze."));
+			return 0;
+		}
+
+		int32 NumFlags = 0;
+
+		const double MemorySlope = SlopePerHour(Minutes, MemoryMB);
+		const double MemoryIncreasing = IncreasingFraction(MemoryMB);
+		UE_LOG(LogProceduralLocomotion, Display, TEXT("Soak: resident memory %+.1f MB/h (%.0f%% of windows increasing)"), MemorySlope, MemoryIncreasing * 100.0);
+		if (MemorySlope > Settings.MaxMemoryGrowthMBPerHour && MemoryIncreasing >= MonotonicFraction)
+		{
+			++NumFlags;
+			UE_LOG(LogProceduralLocomotion, Error, TEXT("Soak: monotonic memory growth above %.1f MB/h."), Settings.MaxMemoryGrowthMBPerHour);
+		}
+
+		const double ObjectSlope = SlopePerHour(Minutes, Objects);
+		const double ObjectsIncreasing = IncreasingFraction(Objects);
+		UE_LOG(LogProceduralLocomotion, Display, TEXT("Soak: UObjects %+.0f/h (%.0f%% of windows increasing)"), ObjectSlope, ObjectsIncreasing * 100.0);
+		if (ObjectSlope > Settings.MaxObjectGrowthPerHour && ObjectsIncreasing >= MonotonicFraction)
+		{
+			++NumFlags;
+			UE_LOG(LogProceduralLocomotion, Error, TEXT("Soak: monotonic UObject growth above %.0f/h."), Settings.MaxObjectGrowthPerHour);
+		}
+
+		const struct
+		{
+			const TCHAR* Name;
+			const TArray<double>& Series;
+		} TailSeries[] =
+		{
+			{ TEXT("frame p99"), FrameP99 },
+			{ TEXT("frame p99.9"), FrameP999 },
+			{ TEXT("locomotion p99"), LocomotionP99 },
+		};
+
+		for (const auto& Tail : TailSeries)
+		{
+			const double Growth = TailGrowth(Tail.Series, EdgeWindows);
+			UE_LOG(LogProceduralLocomotion, Display, TEXT("Soak: %s late/early ratio %.2f"), Tail.Name, Growth);
+			if (Growth > Settings.MaxTailGrowth)
+			{
+				++NumFlags;
+				UE_LOG(LogProceduralLocomotion, Error, TEXT("Soak: %s worsened by more than %.0f%%."), Tail.Name, (Settings.MaxTailGrowth - 1.0) * 100.0);
+			}
+		}
+
+		return NumFlags;
+	}
+}
+
+UProceduralLocomotionSoakCommandlet::UProceduralLocomotionSoakCommandlet()
+{
+	LogToConsole = true;
+}
+
+int32 UProceduralLocomotionSoakCommandlet::Main(const FString& Params)
+{
+	using namespace ProceduralLocomotionSoak;
+
+	FSoakSettings Settings;
+	FParse::Value(*Params, TEXT("DurationMinutes="), Settings.DurationMinutes);
+	FParse::Value(*Params, TEXT("Characters="), Settings.NumCharacters);
+	FParse::Value(*Params, TEXT("DeltaTime="), Settings.DeltaSeconds);
+	FParse::Value(*Params, TEXT("ChurnPerSecond="), Settings.ChurnPerSecond);
+	FParse::Value(*Params, TEXT("PoolFraction="), Settings.PoolFraction);
+	FParse::Value(*Params, TEXT("DormancyFraction="), Settings.DormancyFraction);
+	FParse::Value(*Params, TEXT("StreamingLevel="), Settings.StreamingLevel);
+	FParse::Value(*Params, TEXT("StreamingIntervalSeconds="), Settings.StreamingIntervalSeconds);
+	FParse::Value(*Params, TEXT("StreamedCharacters="), Settings.StreamedCharacters);
+	FParse::Value(*Params, TEXT("SampleSeconds="), Settings.SampleSeconds);
+	FParse::Value(*Params, TEXT("GCIntervalSeconds="), Settings.GCIntervalSeconds);
+	FParse::Value(*Params, TEXT("WarmupWindows="), Settings.WarmupWindows);
+	FParse::Value(*Params, TEXT("MaxMemoryGrowthMBPerHour="), Settings.MaxMemoryGrowthMBPerHour);
+	FParse::Value(*Params, TEXT("MaxObjectGrowthPerHour="), Settings.MaxObjectGrowthPerHour);
+	FParse::Value(*Params, TEXT("MaxTailGrowth="), Settings.MaxTailGrowth);
+
+	FString OutputDir = FPaths::ProjectSavedDir() / TEXT("Soak") / FDateTime::Now().ToString();
+	FParse::Value(*Params, TEXT("OutputDir="), OutputDir);
+	const FString CsvFile = OutputDir / TEXT("SoakTimeline.csv");
+
+	if (!FFileHelper::SaveStringToFile(FSoakWindow::CsvHeader(), *CsvFile))
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Soak: cannot write %s"), *CsvFile);
+		return 1;
+	}
+
+	FProceduralLocomotionBenchmarkWorld BenchWorld(TEXT("ProceduralLocomotionSoak"));
+	if (!BenchWorld.IsValid())
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Soak: failed to create world."));
+		return 1;
+	}
+
+	FRandomStream Random(0x50AC);
+	int32 NextSeed = 0;
+	for (int32 Index = 0; Index < Settings.NumCharacters; ++Index)
+	{
+		BenchWorld.SpawnCharacter(NextSeed++);
+	}
+
+	ProceduralLocomotionStageTiming::SetCaptureEnabled(true);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + Settings.DurationMinutes * 60.0;
+	double WindowStartTime = StartTime;
+
+	float ChurnBudget = 0.0f;
+	float SecondsSinceGC = 0.0f;
+	float SecondsSinceStreaming = 0.0f;
+
+	TArray<FSoakWindow> Windows;
+	FSoakWindow Window;
+	TArray<double> FrameMs;
+	TArray<double> LocomotionMs;
+
+	while (FPlatformTime::Seconds() < EndTime && !IsEngineExitRequested())
+	{
+		// --- Churn: replace characters through the pool or a full destroy/spawn cycle ---
+		ChurnBudget += Settings.ChurnPerSecond * Settings.DeltaSeconds;
+		while (ChurnBudget >= 1.0f && BenchWorld.GetNumCharacters() > 0)
+		{
+			ChurnBudget -= 1.0f;
+
+			const TArray<AProceduralCharacter*>& Characters = BenchWorld.GetCharacters();
+			AProceduralCharacter* Victim = Characters[Random.RandHelper(Characters.Num())];
+			if (Random.FRand() < Settings.PoolFraction)
+			{
+				BenchWorld.ReleaseToPool(Victim);
+				BenchWorld.AcquireFromPool(NextSeed++);
+			}
+			else
+			{
+				BenchWorld.DespawnCharacter(Victim);
+				BenchWorld.SpawnCharacter(NextSeed++);
+			}
+
+			const TArray<AProceduralCharacter*>& Survivors = BenchWorld.GetCharacters();
+			if (Survivors.Num() > 0)
+			{
+				BenchWorld.SetCharacterDormant(Survivors[Random.RandHelper(Survivors.Num())], Random.FRand() < Settings.DormancyFraction);
+			}
+		}
+
+		// --- Level streaming: alternate loading a level populated with its own characters ---
+		SecondsSinceStreaming += Settings.DeltaSeconds;
+		if (!Settings.StreamingLevel.IsEmpty() && SecondsSinceStreaming >= Settings.StreamingIntervalSeconds)
+		{
+			SecondsSinceStreaming = 0.0f;
+			if (BenchWorld.GetStreamedLevel())
+			{
+				BenchWorld.UnloadStreamingLevel();
+			}
+			else if (BenchWorld.LoadStreamingLevel(Settings.StreamingLevel))
+			{
+				for (int32 Index = 0; Index < Settings.StreamedCharacters; ++Index)
+				{
+					BenchWorld.SpawnCharacter(NextSeed++, BenchWorld.GetStreamedLevel());
+				}
+			}
+		}
+
+		// --- Frame ---
+		ProceduralLocomotionStageTiming::Reset();
+		const uint64 FrameStart = FPlatformTime::Cycles64();
+		BenchWorld.Step(Settings.DeltaSeconds);
+		FrameMs.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - FrameStart));
+
+		uint64 LocomotionCycles = 0;
+		for (int32 StageIndex = 0; StageIndex < (int32)EProceduralLocomotionStage::Num; ++StageIndex)
+		{
+			LocomotionCycles += ProceduralLocomotionStageTiming::GetCycles((EProceduralLocomotionStage)StageIndex);
+		}
+		LocomotionMs.Add(FPlatformTime::ToMilliseconds64(LocomotionCycles));
+
+		// --- GC: a commandlet has no engine loop collecting for it ---
+		SecondsSinceGC += Settings.DeltaSeconds;
+		if (SecondsSinceGC >= Settings.GCIntervalSeconds)
+		{
+			SecondsSinceGC = 0.0f;
+			const double GCStart = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			const double GCMs = (FPlatformTime::Seconds() - GCStart) * 1000.0;
+
+			++Window.NumGCs;
+			Window.GCTotalMs += GCMs;
+			Window.GCMaxMs = FMath::Max(Window.GCMaxMs, GCMs);
+		}
+
+		// --- Sample window ---
+		const double Now = FPlatformTime::Seconds();
+		if (Now - WindowStartTime >= Settings.SampleSeconds)
+		{
+			const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+			Window.WallMinutes = (Now - StartTime) / 60.0;
+			Window.Frames = FrameMs.Num();
+			Window.UsedPhysicalMB = double(MemoryStats.UsedPhysical) / (1024.0 * 1024.0);
+			Window.NumObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+			Window.NumCharacters = BenchWorld.GetNumCharacters();
+			Window.NumPooled = BenchWorld.GetNumPooled();
+
+			double LocomotionTotalMs = 0.0;
+			for (const double Sample : LocomotionMs)
+			{
+				LocomotionTotalMs += Sample;
+			}
+			Window.LocomotionMeanMs = LocomotionMs.Num() > 0 ? LocomotionTotalMs / LocomotionMs.Num() : 0.0;
+			Window.LocomotionP99Ms = Percentile(LocomotionMs, 0.99);
+			Window.FrameP50Ms = Percentile(FrameMs, 0.5);
+			Window.FrameP99Ms = Percentile(FrameMs, 0.99);
+			Window.FrameP999Ms = Percentile(FrameMs, 0.999);
+
+			FFileHelper::SaveStringToFile(Window.ToCsvRow(), *CsvFile, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+			UE_LOG(LogProceduralLocomotion, Display, TEXT("Soak %.1f min: %.0f MB, %d objects, frame p99 %.2f ms, p99.9 %.2f ms, locomotion p99 %.3f ms"),
+				Window.WallMinutes, Window.UsedPhysicalMB, Window.NumObjects, Window.FrameP99Ms, Window.FrameP999Ms, Window.LocomotionP99Ms);
+
+			Windows.Add(Window);
+			Window = FSoakWindow();
+			FrameMs.Reset();
+			LocomotionMs.Reset();
+			WindowStartTime = Now;
+		}
+	}
+
+	ProceduralLocomotionStageTiming::SetCaptureEnabled(false);
+
+	const int32 NumFlags = Analyze(Windows, Settings);
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Soak timeline written to %s"), *CsvFile);
+	if (NumFlags > 0)
+	{
+		UE_LOG(LogProceduralLocomotion, Error, TEXT("Soak FAILED with %d flagged trend(s)."), NumFlags);
+		return 1;
+	}
+
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Soak passed (%d windows)."), Windows.Num());
+	return 0;
+}
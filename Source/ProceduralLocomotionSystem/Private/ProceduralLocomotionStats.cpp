@@ -0,0 +1,88 @@
+#include "ProceduralLocomotionStats.h"
+
+#include <atomic>
+
+DEFINE_STAT(STAT_PLS_Locomotion);
+DEFINE_STAT(STAT_PLS_Leaning);
+DEFINE_STAT(STAT_PLS_FootIK);
+DEFINE_STAT(STAT_PLS_ProceduralBone);
+DEFINE_STAT(STAT_PLS_MarkerSync);
+DEFINE_STAT(STAT_PLS_StreamingResidentMB);
+DEFINE_STAT(STAT_PLS_StreamingBudgetMB);
+DEFINE_STAT(STAT_PLS_StreamingResidentClips);
+DEFINE_STAT(STAT_PLS_StreamingPendingLoads);
+DEFINE_STAT(STAT_PLS_StreamingEvictions);
+DEFINE_STAT(STAT_PLS_Prewarm);
+DEFINE_STAT(STAT_PLS_PrewarmLoadMs);
+DEFINE_STAT(STAT_PLS_PrewarmBuildMs);
+DEFINE_STAT(STAT_PLS_PrewarmAnimClasses);
+DEFINE_STAT(STAT_PLS_PrewarmMeshes);
+DEFINE_STAT(STAT_PLS_PrewarmBoneContainers);
+DEFINE_STAT(STAT_PLS_PrewarmDataAssets);
+DEFINE_STAT(STAT_PLS_PoseRecordingCapture);
+DEFINE_STAT(STAT_PLS_PoseRecordingMB);
+DEFINE_STAT(STAT_PLS_PoseRecordingFramesDropped);
+DEFINE_STAT(STAT_PLS_IdleRotationsHeld);
+DEFINE_STAT(STAT_PLS_TurnInPlaceSteps);
+DEFINE_STAT(STAT_PLS_FootTraces);
+DEFINE_STAT(STAT_PLS_FootPlantsReused);
+DEFINE_STAT(STAT_PLS_GroundQueryQueueDepth);
+DEFINE_STAT(STAT_PLS_GroundQueriesServed);
+DEFINE_STAT(STAT_PLS_GroundQueryBudgetUsed);
+DEFINE_STAT(STAT_PLS_GroundQueryAverageAgeMs);
+DEFINE_STAT(STAT_PLS_GroundQueryMaxAgeMs);
+DEFINE_STAT(STAT_PLS_FootPlantsExtrapolated);
+DEFINE_STAT(STAT_PLS_MoCapLatencyMs);
+
+namespace ProceduralLocomotionStageTiming
+{
+	static std::atomic<bool> bCaptureEnabled{ false };
+	static std::atomic<uint64> StageCycles[(int32)EProceduralLocomotionStage::Num];
+
+	const TCHAR* GetStageName(EProceduralLocomotionStage Stage)
+	{
+		switch (Stage)
+		{
+		case EProceduralLocomotionStage::Locomotion:
+			return TEXT("Locomotion");
+		case EProceduralLocomotionStage::Leaning:
+			return TEXT("Leaning");
+		case EProceduralLocomotionStage::FootIK:
+			return TEXT("FootIK");
+		case EProceduralLocomotionStage::ProceduralBone:
+			return TEXT("ProceduralBone");
+		case EProceduralLocomotionStage::MarkerSync:
+			return TEXT("MarkerSync");
+		default:
+			return TEXT("Unknown");
+		}
+	}
+
+	bool IsCaptureEnabled()
+	{
+		return bCaptureEnabled.load(std::memory_order_relaxed);
+	}
+
+	void SetCaptureEnabled(bool bEnabled)
+	{
+		bCaptureEnabled.store(bEnabled, std::memory_order_relaxed);
+	}
+
+	void Reset()
+	{
+		for (std::atomic<uint64>& Cycles : StageCycles)
+		{
+			Cycles.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void Accumulate(EProceduralLocomotionStage Stage, uint64 Cycles)
+	{
+		StageCycles[(int32)Stage].fetch_add(Cycles, std::memory_order_relaxed);
+	}
+
+	uint64 GetCycles(EProceduralLocomotionStage Stage)
+	{
+		return StageCycles[(int32)Stage].load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,388 @@
+#include "ProceduralLocomotionStreamingSubsystem.h"
+
+#include "ProceduralCharacter.h"
+#include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionProfile.h"
+#include "ProceduralLocomotionSettings.h"
+#include "ProceduralLocomotionStats.h"
+#include "ProceduralLocomotionSystem.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	// Size assumed for a clip that has not loaded yet, until resident clips give an average.
+	constexpr int64 DefaultClipBytes = 1024 * 1024;
+
+	FAutoConsoleCommandWithWorld StreamingReportCommand(
+		TEXT("pls.Streaming.Report"),
+		TEXT("Logs the procedural locomotion clip cache: resident memory against the budget, pending loads and evictions."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UProceduralLocomotionStreamingSubsystem* Streaming = World ? World->GetSubsystem<UProceduralLocomotionStreamingSubsystem>() : nullptr)
+			{
+				Streaming->LogReport();
+			}
+		}));
+
+	double ToMB(int64 Bytes)
+	{
+		return Bytes / (1024.0 * 1024.0);
+	}
+}
+
+void UProceduralLocomotionStreamingSubsystem::Deinitialize()
+{
+	ReleaseAll();
+	Characters.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UProceduralLocomotionStreamingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UProceduralLocomotionStreamingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProceduralLocomotionStreamingSubsystem, STATGROUP_Tickables);
+}
+
+void UProceduralLocomotionStreamingSubsystem::RegisterCharacter(AProceduralCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UProceduralLocomotionStreamingSubsystem::UnregisterCharacter(AProceduralCharacter* Character)
+{
+	Characters.RemoveSingleSwap(Character);
+}
+
+UAnimSequenceBase* UProceduralLocomotionStreamingSubsystem::GetResidentClip(const TSoftObjectPtr<UAnimSequenceBase>& Clip) const
+{
+	const FClipEntry* Entry = Clips.Find(Clip.ToSoftObjectPath());
+	return Entry ? Entry->Sequence : nullptr;
+}
+
+void UProceduralLocomotionStreamingSubsystem::Tick(float DeltaTime)
+{
+	const UProceduralLocomotionSettings* Settings = UProceduralLocomotionSettings::Get();
+	if (!Settings->bStreamLocomotionClips)
+	{
+		if (Clips.Num() > 0)
+		{
+			ReleaseAll();
+			UpdateReport();
+		}
+		return;
+	}
+
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.0f)
+	{
+		return;
+	}
+	TimeUntilUpdate = Settings->StreamUpdateInterval;
+
+	Report.BudgetBytes = (int64)(Settings->StreamingBudgetMB * 1024.0 * 1024.0);
+	UpdateWantedClips(FPlatformTime::Seconds());
+	RequestLoads();
+	UpdateReport();
+}
+
+void UProceduralLocomotionStreamingSubsystem::UpdateWantedClips(double Now)
+{
+	const UProceduralLocomotionSettings* Settings = UProceduralLocomotionSettings::Get();
+	const float PredictionSeconds = Settings->StreamPredictionSeconds;
+	const float StreamInDistance = Settings->StreamInDistance;
+
+	for (TPair<FSoftObjectPath, FClipEntry>& Pair : Clips)
+	{
+		Pair.Value.bWanted = false;
+		Pair.Value.Priority = 0.0f;
+	}
+
+	auto Want = [this, Now](const FSoftObjectPath& Path, float Priority)
+	{
+		FClipEntry& Entry = Clips.FindOrAdd(Path);
+		Entry.bWanted = true;
+		Entry.LastWantedTime = Now;
+		Entry.Priority = FMath::Max(Entry.Priority, Priority);
+	};
+
+	// Same views as the LOD tiers: with none (a dedicated server) every character counts as near.
+	const TArray<FVector>& ViewLocations = GetWorld()->ViewLocationsRenderedLastFrame;
+
+	Characters.RemoveAllSwap([](const TWeakObjectPtr<AProceduralCharacter>& Character) { return !Character.IsValid(); });
+	for (const TWeakObjectPtr<AProceduralCharacter>& WeakCharacter : Characters)
+	{
+		const AProceduralCharacter* Character = WeakCharacter.Get();
+		const USkeletalMeshComponent* MeshComp = Character->GetMesh();
+		const UProceduralLocomotionAnimInstance* AnimInstance = MeshComp ? Cast<UProceduralLocomotionAnimInstance>(MeshComp->GetAnimInstance()) : nullptr;
+		const UProceduralLocomotionProfile* Profile = AnimInstance ? AnimInstance->GetProfile() : nullptr;
+		if (!Profile || Profile->LocomotionClips.Num() == 0)
+		{
+			continue;
+		}
+
+		const FVector Location = Character->GetActorLocation();
+		const FVector Velocity = Character->GetVelocity();
+		const FVector PredictedLocation = Location + Velocity * PredictionSeconds;
+		float Distance = 0.0f;
+		if (ViewLocations.Num() > 0)
+		{
+			Distance = TNumericLimits<float>::Max();
+			for (const FVector& ViewLocation : ViewLocations)
+			{
+				Distance = FMath::Min(Distance, (float)FMath::Min(FVector::Dist(Location, ViewLocation), FVector::Dist(PredictedLocation, ViewLocation)));
+			}
+		}
+		if (Distance > StreamInDistance)
+		{
+			continue;
+		}
+
+		const float Priority = StreamInDistance > 0.0f ? 1.0f - Distance / StreamInDistance : 1.0f;
+		const float Speed = Velocity.Size2D();
+		float PredictedSpeed = Speed;
+		if (const UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+		{
+			PredictedSpeed = FMath::Min((float)(Velocity + Movement->GetCurrentAcceleration() * PredictionSeconds).Size2D(), Movement->GetMaxSpeed());
+		}
+		const float LowSpeed = FMath::Min(Speed, PredictedSpeed);
+		const float HighSpeed = FMath::Max(Speed, PredictedSpeed);
+
+		for (const FProceduralLocomotionClip& Clip : Profile->LocomotionClips)
+		{
+			if (Clip.Sequence.IsNull())
+			{
+				continue;
+			}
+
+			// The clip playing now outranks the ones the character is heading towards.
+			const bool bCurrent = Speed >= Clip.MinSpeed && Speed < Clip.MaxSpeed;
+			const bool bAhead = Clip.MaxSpeed > LowSpeed && Clip.MinSpeed <= HighSpeed;
+			if (bCurrent || bAhead)
+			{
+				Want(Clip.Sequence.ToSoftObjectPath(), bCurrent ? Priority : 0.5f * Priority);
+			}
+		}
+	}
+
+	// Loads nobody is waiting for any more are cancelled; resident clips stay cached until evicted.
+	TArray<FSoftObjectPath> Dropped;
+	for (const TPair<FSoftObjectPath, FClipEntry>& Pair : Clips)
+	{
+		if (!Pair.Value.bWanted && !Pair.Value.Sequence)
+		{
+			Dropped.Add(Pair.Key);
+		}
+	}
+	for (const FSoftObjectPath& Path : Dropped)
+	{
+		Release(Path);
+	}
+}
+
+void UProceduralLocomotionStreamingSubsystem::RequestLoads()
+{
+	TArray<TPair<FSoftObjectPath, float>> ToLoad;
+	int64 ResidentBytes = 0;
+	int32 NumResident = 0;
+	int32 NumPending = 0;
+	for (const TPair<FSoftObjectPath, FClipEntry>& Pair : Clips)
+	{
+		if (Pair.Value.Sequence)
+		{
+			ResidentBytes += Pair.Value.Bytes;
+			++NumResident;
+		}
+		else if (Pair.Value.Handle.IsValid())
+		{
+			++NumPending;
+		}
+		else if (Pair.Value.bWanted)
+		{
+			ToLoad.Emplace(Pair.Key, Pair.Value.Priority);
+		}
+	}
+	ToLoad.Sort([](const TPair<FSoftObjectPath, float>& A, const TPair<FSoftObjectPath, float>& B) { return A.Value > B.Value; });
+
+	// Sizes are only known once loaded, so pending loads are charged at the resident average.
+	const int64 EstimatedBytes = NumResident > 0 ? ResidentBytes / NumResident : DefaultClipBytes;
+	int64 CommittedBytes = ResidentBytes + NumPending * EstimatedBytes;
+	Report.NumDenied = 0;
+	for (const TPair<FSoftObjectPath, float>& Load : ToLoad)
+	{
+		int64 FreedBytes = 0;
+		while (CommittedBytes + EstimatedBytes > Report.BudgetBytes && EvictOne(FreedBytes))
+		{
+			CommittedBytes -= FreedBytes;
+		}
+		if (CommittedBytes + EstimatedBytes > Report.BudgetBytes)
+		{
+			++Report.NumDenied;
+			continue;
+		}
+		CommittedBytes += EstimatedBytes;
+
+		const FSoftObjectPath& Path = Load.Key;
+		const TAsyncLoadPriority LoadPriority = FStreamableManager::DefaultAsyncLoadPriority + FMath::RoundToInt(Load.Value * 10.0f);
+		TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(Path,
+			FStreamableDelegate::CreateUObject(this, &UProceduralLocomotionStreamingSubsystem::HandleLoaded, Path), LoadPriority);
+
+		// An already loaded clip completes inside the request; its entry just needs the handle.
+		if (FClipEntry* Entry = Clips.Find(Path))
+		{
+			Entry->Handle = Handle;
+		}
+	}
+}
+
+void UProceduralLocomotionStreamingSubsystem::HandleLoaded(FSoftObjectPath Path)
+{
+	FClipEntry* Entry = Clips.Find(Path);
+	if (!Entry)
+	{
+		return;
+	}
+
+	Entry->Sequence = Cast<UAnimSequenceBase>(Path.ResolveObject());
+	if (!Entry->Sequence)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Streaming: %s did not load as an animation sequence."), *Path.ToString());
+		Release(Path);
+		return;
+	}
+	Entry->Bytes = Entry->Sequence->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+
+	// The estimate may have been low; the ceiling holds once the real size is known.
+	int64 ResidentBytes = GetResidentBytes();
+	int64 FreedBytes = 0;
+	while (ResidentBytes > Report.BudgetBytes && EvictOne(FreedBytes))
+	{
+		ResidentBytes -= FreedBytes;
+	}
+	UpdateReport();
+}
+
+bool UProceduralLocomotionStreamingSubsystem::EvictOne(int64& OutFreedBytes)
+{
+	const FSoftObjectPath* Oldest = nullptr;
+	double OldestTime = TNumericLimits<double>::Max();
+	for (const TPair<FSoftObjectPath, FClipEntry>& Pair : Clips)
+	{
+		if (!Pair.Value.bWanted && Pair.Value.Sequence && Pair.Value.LastWantedTime < OldestTime)
+		{
+			Oldest = &Pair.Key;
+			OldestTime = Pair.Value.LastWantedTime;
+		}
+	}
+	if (!Oldest)
+	{
+		return false;
+	}
+
+	++Report.NumEvicted;
+	OutFreedBytes = Clips[*Oldest].Bytes;
+	Release(FSoftObjectPath(*Oldest));
+	return true;
+}
+
+void UProceduralLocomotionStreamingSubsystem::Release(const FSoftObjectPath& Path)
+{
+	FClipEntry Entry;
+	if (!Clips.RemoveAndCopyValue(Path, Entry))
+	{
+		return;
+	}
+
+	// Dropping the handle lets garbage collection free the clip once no anim instance plays it.
+	if (Entry.Handle.IsValid())
+	{
+		if (Entry.Handle->IsLoadingInProgress())
+		{
+			Entry.Handle->CancelHandle();
+		}
+		else
+		{
+			Entry.Handle->ReleaseHandle();
+		}
+	}
+}
+
+void UProceduralLocomotionStreamingSubsystem::ReleaseAll()
+{
+	TArray<FSoftObjectPath> Paths;
+	Clips.GetKeys(Paths);
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		Release(Path);
+	}
+}
+
+int64 UProceduralLocomotionStreamingSubsystem::GetResidentBytes() const
+{
+	int64 ResidentBytes = 0;
+	for (const TPair<FSoftObjectPath, FClipEntry>& Pair : Clips)
+	{
+		ResidentBytes += Pair.Value.Sequence ? Pair.Value.Bytes : 0;
+	}
+	return ResidentBytes;
+}
+
+void UProceduralLocomotionStreamingSubsystem::UpdateReport()
+{
+	const bool bWasOverBudget = Report.bOverBudget;
+
+	Report.ResidentBytes = 0;
+	Report.NumResident = 0;
+	Report.NumWanted = 0;
+	Report.NumPending = 0;
+	int64 WantedBytes = 0;
+	for (const TPair<FSoftObjectPath, FClipEntry>& Pair : Clips)
+	{
+		Report.NumWanted += Pair.Value.bWanted ? 1 : 0;
+		if (Pair.Value.Sequence)
+		{
+			Report.ResidentBytes += Pair.Value.Bytes;
+			WantedBytes += Pair.Value.bWanted ? Pair.Value.Bytes : 0;
+			++Report.NumResident;
+		}
+		else if (Pair.Value.Handle.IsValid())
+		{
+			++Report.NumPending;
+		}
+	}
+	Report.PeakResidentBytes = FMath::Max(Report.PeakResidentBytes, Report.ResidentBytes);
+	Report.bOverBudget = WantedBytes > Report.BudgetBytes || Report.NumDenied > 0;
+
+	if (Report.bOverBudget && !bWasOverBudget)
+	{
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Streaming: nearby characters want more clips than the %.1f MB budget holds; %d clips fall back to the procedural walk cycle."),
+			ToMB(Report.BudgetBytes), Report.NumDenied);
+	}
+
+	SET_FLOAT_STAT(STAT_PLS_StreamingResidentMB, (float)ToMB(Report.ResidentBytes));
+	SET_FLOAT_STAT(STAT_PLS_StreamingBudgetMB, (float)ToMB(Report.BudgetBytes));
+	SET_DWORD_STAT(STAT_PLS_StreamingResidentClips, Report.NumResident);
+	SET_DWORD_STAT(STAT_PLS_StreamingPendingLoads, Report.NumPending);
+	SET_DWORD_STAT(STAT_PLS_StreamingEvictions, Report.NumEvicted);
+}
+
+void UProceduralLocomotionStreamingSubsystem::LogReport() const
+{
+	UE_LOG(LogProceduralLocomotion, Display, TEXT("Streaming: %.1f / %.1f MB resident (peak %.1f MB), %d clips resident, %d wanted, %d loading, %d denied, %d evicted%s"),
+		ToMB(Report.ResidentBytes), ToMB(Report.BudgetBytes), ToMB(Report.PeakResidentBytes), Report.NumResident, Report.NumWanted,
+		Report.NumPending, Report.NumDenied, Report.NumEvicted, Report.bOverBudget ? TEXT(" - OVER BUDGET") : TEXT(""));
+
+	for (const TPair<FSoftObjectPath, FClipEntry>& Pair : Clips)
+	{
+		UE_LOG(LogProceduralLocomotion, Display, TEXT("  %-60s %8.2f MB %s"), *Pair.Key.ToString(), ToMB(Pair.Value.Bytes),
+			Pair.Value.Sequence ? (Pair.Value.bWanted ? TEXT("in use") : TEXT("cached")) : TEXT("loading"));
+	}
+}
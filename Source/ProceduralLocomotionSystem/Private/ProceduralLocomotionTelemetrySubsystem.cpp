@@ -0,0 +1,223 @@
+#include "ProceduralLocomotionTelemetrySubsystem.h"
+
+#include "ProceduralCharacter.h"
+#include "ProceduralLocomotionAnimInstance.h"
+#include "ProceduralLocomotionSystem.h"
+#include "ProceduralLocomotionTelemetryLayout.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+
+static TAutoConsoleVariable<bool> CVarTelemetryEnabled(
+	TEXT("pls.Telemetry.Enable"),
+	false,
+	TEXT("Publishes procedural character locomotion state into a shared-memory ring for external tools."));
+
+static TAutoConsoleVariable<FString> CVarTelemetryName(
+	TEXT("pls.Telemetry.Name"),
+	TEXT("PLSTelemetry"),
+	TEXT("Name of the telemetry shared-memory region (/dev/shm/<Name> on Linux). Applied when publishing starts."));
+
+static TAutoConsoleVariable<int32> CVarTelemetryMaxCharacters(
+	TEXT("pls.Telemetry.MaxCharacters"),
+	256,
+	TEXT("Characters per telemetry frame; extra characters are counted as dropped. Applied when publishing starts."));
+
+static TAutoConsoleVariable<int32> CVarTelemetryFrames(
+	TEXT("pls.Telemetry.Frames"),
+	64,
+	TEXT("Depth of the telemetry frame ring. Applied when publishing starts."));
+
+namespace
+{
+	using namespace ProceduralLocomotionTelemetry;
+
+	FRegionHeader* GetHeader(FPlatformMemory::FSharedMemoryRegion* Region)
+	{
+		return static_cast<FRegionHeader*>(Region->GetAddress());
+	}
+
+	uint8* GetFrameSlot(FPlatformMemory::FSharedMemoryRegion* Region, uint64 FrameIndex)
+	{
+		const FRegionHeader* Header = GetHeader(Region);
+		return static_cast<uint8*>(Region->GetAddress()) + Header->HeaderSize + (FrameIndex % Header->FrameCapacity) * Header->FrameSlotSize;
+	}
+
+	void PublishU64(uint64_t& Target, uint64 Value)
+	{
+		FPlatformAtomics::AtomicStore(reinterpret_cast<volatile int64*>(&Target), static_cast<int64>(Value));
+	}
+}
+
+void UProceduralLocomotionTelemetrySubsystem::Deinitialize()
+{
+	UnmapRegion();
+	Characters.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UProceduralLocomotionTelemetrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UProceduralLocomotionTelemetrySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProceduralLocomotionTelemetrySubsystem, STATGROUP_Tickables);
+}
+
+void UProceduralLocomotionTelemetrySubsystem::RegisterCharacter(AProceduralCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UProceduralLocomotionTelemetrySubsystem::UnregisterCharacter(AProceduralCharacter* Character)
+{
+	Characters.RemoveSingleSwap(Character);
+}
+
+void UProceduralLocomotionTelemetrySubsystem::Tick(float DeltaTime)
+{
+	if (!CVarTelemetryEnabled.GetValueOnGameThread())
+	{
+		UnmapRegion();
+		return;
+	}
+
+	if (Region || MapRegion())
+	{
+		PublishFrame();
+	}
+}
+
+bool UProceduralLocomotionTelemetrySubsystem::MapRegion()
+{
+	FrameCapacity = (uint32)FMath::Clamp(CVarTelemetryFrames.GetValueOnGameThread(), 2, 4096);
+	RecordCapacity = (uint32)FMath::Clamp(CVarTelemetryMaxCharacters.GetValueOnGameThread(), 1, 65536);
+	RegionName = CVarTelemetryName.GetValueOnGameThread();
+
+	const uint32 FrameSlotSize = sizeof(FFrameHeader) + RecordCapacity * sizeof(FCharacterRecord);
+	const SIZE_T RegionSize = sizeof(FRegionHeader) + (SIZE_T)FrameCapacity * FrameSlotSize;
+
+	Region = FPlatformMemory::MapNamedSharedMemoryRegion(RegionName, true,
+		FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write, RegionSize);
+	if (!Region)
+	{
+		// Avoid retrying (and logging) every frame; re-enable to try again.
+		UE_LOG(LogProceduralLocomotion, Warning, TEXT("Telemetry: could not map shared memory region '%s' (%llu bytes); disabling"),
+			*RegionName, (uint64)RegionSize);
+		CVarTelemetryEnabled->Set(false, ECVF_SetByCode);
+		return false;
+	}
+
+	// Readers check Magic last, so initialize everything else first.
+	FMemory::Memzero(Region->GetAddress(), RegionSize);
+	FRegionHeader* Header = GetHeader(Region);
+	Header->Version = Version;
+	Header->HeaderSize = sizeof(FRegionHeader);
+	Header->FrameSlotSize = FrameSlotSize;
+	Header->FrameCapacity = FrameCapacity;
+	Header->RecordCapacity = RecordCapacity;
+	Header->RecordSize = sizeof(FCharacterRecord);
+	Header->WriterProcessId = FPlatformProcess::GetCurrentProcessId();
+	FPlatformMisc::MemoryBarrier();
+	Header->Magic = Magic;
+
+	FramesWritten = 0;
+	RecordsDropped = 0;
+
+	UE_LOG(LogProceduralLocomotion, Log, TEXT("Telemetry: publishing to '%s' (%u frames x %u characters, %llu bytes)"),
+		*RegionName, FrameCapacity, RecordCapacity, (uint64)RegionSize);
+	return true;
+}
+
+void UProceduralLocomotionTelemetrySubsystem::UnmapRegion()
+{
+	if (!Region)
+	{
+		return;
+	}
+
+	// Clearing the magic tells attached readers the writer has gone.
+	GetHeader(Region)->Magic = 0;
+	FPlatformMisc::MemoryBarrier();
+
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+	Region = nullptr;
+
+	UE_LOG(LogProceduralLocomotion, Log, TEXT("Telemetry: stopped publishing to '%s' after %llu frames"), *RegionName, FramesWritten);
+}
+
+void UProceduralLocomotionTelemetrySubsystem::PublishFrame()
+{
+	uint8* Slot = GetFrameSlot(Region, FramesWritten);
+	FFrameHeader* Frame = reinterpret_cast<FFrameHeader*>(Slot);
+	FCharacterRecord* Records = reinterpret_cast<FCharacterRecord*>(Slot + sizeof(FFrameHeader));
+
+	// Odd sequence: readers that copy this slot now will discard the copy.
+	PublishU64(Frame->Sequence, 2 * FramesWritten + 1);
+
+	uint32 NumRecords = 0;
+	for (int32 Index = Characters.Num() - 1; Index >= 0; --Index)
+	{
+		AProceduralCharacter* Character = Characters[Index].Get();
+		if (!Character)
+		{
+			Characters.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (NumRecords == RecordCapacity)
+		{
+			++RecordsDropped;
+			continue;
+		}
+
+		const USkeletalMeshComponent* MeshComp = Character->GetMesh();
+		const UProceduralLocomotionAnimInstance* AnimInstance = MeshComp ? Cast<UProceduralLocomotionAnimInstance>(MeshComp->GetAnimInstance()) : nullptr;
+		const FVector Location = Character->GetActorLocation();
+		const FVector Velocity = Character->GetVelocity();
+
+		FCharacterRecord& Record = Records[NumRecords++];
+		Record = FCharacterRecord{};
+		Record.CharacterId = Character->GetUniqueID();
+		Record.Position[0] = (float)Location.X;
+		Record.Position[1] = (float)Location.Y;
+		Record.Position[2] = (float)Location.Z;
+		Record.Velocity[0] = (float)Velocity.X;
+		Record.Velocity[1] = (float)Velocity.Y;
+		Record.Velocity[2] = (float)Velocity.Z;
+		Record.Yaw = (float)Character->GetActorRotation().Yaw;
+
+		if (AnimInstance)
+		{
+			const FProceduralLocomotionLayers& Layers = AnimInstance->GetLODLayers();
+			Record.Flags = (AnimInstance->IsAccelerating() ? ECharacterFlags::Accelerating : 0u)
+				| (Layers.bLeaning ? ECharacterFlags::LeaningLayer : 0u)
+				| (Layers.bFootIK ? ECharacterFlags::FootIKLayer : 0u)
+				| (Layers.bProceduralBone ? ECharacterFlags::ProceduralBoneLayer : 0u);
+			Record.GroundSpeed = AnimInstance->GetGroundSpeed();
+			Record.Direction = AnimInstance->GetDirection();
+			Record.LeanAngle = AnimInstance->GetLeanAngle();
+			Record.LocomotionPhase = AnimInstance->GetLocomotionPhase();
+			Record.LeftFootOffset = AnimInstance->GetLeftFootOffset();
+			Record.RightFootOffset = AnimInstance->GetRightFootOffset();
+			Record.PelvisOffset = AnimInstance->GetPelvisOffset();
+			Record.FootIKAlpha = AnimInstance->GetFootIKAlpha();
+		}
+	}
+
+	Frame->FrameNumber = GFrameCounter;
+	Frame->WorldTimeSeconds = GetWorld()->GetTimeSeconds();
+	Frame->NumRecords = NumRecords;
+
+	// AtomicStore is a full barrier, so the records are visible before the even sequence.
+	PublishU64(Frame->Sequence, 2 * FramesWritten + 2);
+
+	++FramesWritten;
+	FRegionHeader* Header = GetHeader(Region);
+	Header->RecordsDropped = RecordsDropped;
+	PublishU64(Header->FramesWritten, FramesWritten);
+}
@@ -13,7 +13,8 @@ public class ProceduralLocomotionSystem : ModuleRules
 				"CoreUObject",
 				"Engine",
 				"AnimGraphRuntime",
-				"GameplayTasks"
+				"GameplayTasks",
+				"DeveloperSettings"
 			}
 		);
 
@@ -21,7 +22,11 @@ public class ProceduralLocomotionSystem : ModuleRules
 			new string[]
 			{
 				"Slate",
-				"SlateCore"
+				"SlateCore",
+				"AssetRegistry",
+				"Json",
+				"Sockets",
+				"Networking"
 			}
 		);
 	}
@@ -1,13 +1,20 @@
 #include "ProceduralLocomotionSystem.h"
 
+#include "ProceduralLocomotionPrewarm.h"
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE(FProceduralLocomotionSystemModule, ProceduralLocomotionSystem, "ProceduralLocomotionSystem");
 
+DEFINE_LOG_CATEGORY(LogProceduralLocomotion);
+
 void FProceduralLocomotionSystemModule::StartupModule()
 {
+	// Loads anim classes, meshes and locomotion data from UProceduralLocomotionSettings
+	// asynchronously once the engine is up and on map load, ahead of the first spawn.
+	Prewarmer = MakeUnique<FProceduralLocomotionPrewarmer>();
 }
 
 void FProceduralLocomotionSystemModule::ShutdownModule()
 {
+	Prewarmer.Reset();
 }
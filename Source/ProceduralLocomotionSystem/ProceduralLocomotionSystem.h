@@ -1,10 +1,18 @@
 #pragma once
 
+#include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+PROCEDURALLOCOMOTIONSYSTEM_API DECLARE_LOG_CATEGORY_EXTERN(LogProceduralLocomotion, Log, All);
+
+class FProceduralLocomotionPrewarmer;
+
 class FProceduralLocomotionSystemModule final : public IModuleInterface
 {
 public:
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	TUniquePtr<FProceduralLocomotionPrewarmer> Prewarmer;
 };
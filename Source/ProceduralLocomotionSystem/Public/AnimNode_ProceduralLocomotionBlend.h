@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNodeBase.h"
+#include "AnimNode_ProceduralLocomotionBlend.generated.h"
+
+class UBlendSpace;
+struct FProceduralLocomotionBlendGrid;
+
+/**
+ * Plays a locomotion blend space from speed and direction through a weight grid precomputed at
+ * load, instead of triangulating and weighting samples every frame.
+ *
+ * When the anim instance initializes, the blend space's sample weights are evaluated once at
+ * every point of a GridResolution x GridResolution grid over its two axes. The grid is shared by
+ * every node playing the same blend space at the same resolution, so a crowd pays for it once.
+ * Each update is then one grid fetch and a bilinear blend of the four surrounding cells.
+ *
+ * With bSyncToLocomotionPhase, every sample plays at the owning anim instance's LocomotionPhase
+ * through its baked marker index (see UProceduralLocomotionFootstepModifier), or at the same
+ * fraction of its length without one. Samples of all characters then stay foot-aligned without
+ * sync groups. Root motion is not extracted; the capsule drives locomotion.
+ */
+USTRUCT(BlueprintInternalUseOnly)
+struct PROCEDURALLOCOMOTIONSYSTEM_API FAnimNode_ProceduralLocomotionBlend : public FAnimNode_Base
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Settings)
+	TObjectPtr<UBlendSpace> BlendSpace;
+
+	// Read GroundSpeed and Direction from the owning UProceduralLocomotionAnimInstance instead of the pins.
+	UPROPERTY(EditAnywhere, Category = Settings)
+	bool bUseAnimInstanceInputs = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
+	float Speed = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
+	float Direction = 0.0f;
+
+	// Direction on the blend space's horizontal axis and speed on the vertical one, as in the
+	// UE5 mannequin blend spaces. Clear for blend spaces laid out the other way round.
+	UPROPERTY(EditAnywhere, Category = Settings)
+	bool bDirectionOnHorizontalAxis = true;
+
+	// Grid points per axis. The bilinear blend matches the blend space exactly at grid points.
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (ClampMin = "2", ClampMax = "256"))
+	int32 GridResolution = 65;
+
+	UPROPERTY(EditAnywhere, Category = Settings)
+	bool bSyncToLocomotionPhase = true;
+
+	// Used without bSyncToLocomotionPhase; scales the weighted sample length.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault, ClampMin = "0"))
+	float PlayRate = 1.0f;
+
+	// FAnimNode_Base
+	virtual bool NeedsOnInitializeAnimInstance() const override { return true; }
+	virtual void OnInitializeAnimInstance(const FAnimInstanceProxy* InProxy, const UAnimInstance* InAnimInstance) override;
+	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
+	virtual void Update_AnyThread(const FAnimationUpdateContext& Context) override;
+	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
+
+private:
+	struct FActiveSample
+	{
+		int32 SampleIndex = INDEX_NONE;
+		float Weight = 0.0f;
+		float Time = 0.0f;
+	};
+
+	// Shared with every node playing the same blend space; immutable once built.
+	TSharedPtr<const FProceduralLocomotionBlendGrid> Grid;
+
+	// Last playback time of each blend space sample; the hint that keeps multi-cycle clips in their cycle.
+	TArray<float> SampleTimes;
+
+	// Samples with weight this frame, filled in Update and read in Evaluate.
+	TArray<FActiveSample, TInlineAllocator<16>> ActiveSamples;
+
+	// Playback position without bSyncToLocomotionPhase, as a fraction of each sample's length.
+	float NormalizedTime = 0.0f;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNodeBase.h"
+#include "ProceduralLocomotionMoCapReceiver.h"
+#include "AnimNode_ProceduralMoCapPose.generated.h"
+
+/**
+ * Applies the newest live MoCap frame from the owning UProceduralLocomotionAnimInstance's
+ * receiver over the Source pose. Bones missing from the stream keep the Source pose. Place it
+ * before the leaning and foot IK nodes so those layer on top of the performer.
+ *
+ * Frames are pulled from the receiver's lock-free ring in Update on the anim worker, so a
+ * frame that lands before the update is shown that same frame. If the stream stops for
+ * StaleTimeout seconds the node blends back to Source.
+ */
+USTRUCT(BlueprintInternalUseOnly)
+struct PROCEDURALLOCOMOTIONSYSTEM_API FAnimNode_ProceduralMoCapPose : public FAnimNode_Base
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Links)
+	FPoseLink Source;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault, ClampMin = "0", ClampMax = "1"))
+	float Alpha = 1.0f;
+
+	// Take streamed translations for every bone. Off by default: only the first stream bone
+	// (the pelvis) moves, the rest take rotation only, keeping the mesh's proportions.
+	UPROPERTY(EditAnywhere, Category = Settings)
+	bool bApplyBoneTranslations = false;
+
+	// Seconds without a new frame before the stream is considered lost.
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (ClampMin = "0"))
+	float StaleTimeout = 0.5f;
+
+	// Time to blend in when the stream starts and back out when it is lost.
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (ClampMin = "0"))
+	float BlendTime = 0.2f;
+
+	// FAnimNode_Base
+	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
+	virtual void CacheBones_AnyThread(const FAnimationCacheBonesContext& Context) override;
+	virtual void Update_AnyThread(const FAnimationUpdateContext& Context) override;
+	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
+
+private:
+	// Newest consumed frame; preallocated so consuming never allocates.
+	FProceduralLocomotionMoCapFrame Frame;
+	bool bHasFrame = false;
+
+	// Stream bone index -> compact pose bone index (INDEX_NONE if the mesh lacks the bone).
+	TArray<FCompactPoseBoneIndex> CompactBoneIndices;
+
+	float StreamWeight = 0.0f;
+};
@@ -2,8 +2,12 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "ProceduralLocomotionLODSettings.h"
 #include "ProceduralCharacter.generated.h"
 
+class FProceduralLocomotionPoseSnapshot;
+struct FAnimUpdateRateParameters;
+
 UCLASS()
 class PROCEDURALLOCOMOTIONSYSTEM_API AProceduralCharacter : public ACharacter
 {
@@ -14,13 +18,68 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
 	virtual void Tick(float DeltaTime) override;
 
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	// While idle on the ground, holds the actor's yaw until the control rotation is more than
+	// TurnInPlaceThreshold away and then turns it there in one step; the anim instance keeps the
+	// mesh facing through a root yaw offset and plays the turn.
+	virtual void FaceRotation(FRotator NewControlRotation, float DeltaTime = 0.0f) override;
+
+	// Switches LOD settings at runtime, e.g. to apply a freshly tuned asset.
+	UFUNCTION(BlueprintCallable, Category = "Locomotion|LOD")
+	void SetLODSettings(UProceduralLocomotionLODSettings* InSettings, float InErrorBudget);
+
+	// Applies a config directly, bypassing the settings asset (used by the tuning tool).
+	void SetLODConfig(const FProceduralLocomotionLODConfig& InConfig);
+
+	const FProceduralLocomotionLODConfig& GetActiveLODConfig() const { return ActiveLODConfig; }
+
+	// Slot of a bone in the anim instance's pose snapshot, or INDEX_NONE. Resolve once and cache it.
+	UFUNCTION(BlueprintPure, Category = "Locomotion|Snapshot")
+	int32 GetPoseSnapshotSlot(FName BoneName) const;
+
+	// World-space transform of a snapshot slot from the last completed animation frame. Never
+	// waits on parallel evaluation; returns false before the first frame or for unknown bones.
+	UFUNCTION(BlueprintCallable, Category = "Locomotion|Snapshot")
+	bool GetPoseSnapshotTransform(int32 Slot, FTransform& OutTransform) const;
+
+	// Convenience lookup by name; prefer the slot overload on hot paths.
+	UFUNCTION(BlueprintCallable, Category = "Locomotion|Snapshot")
+	bool GetPoseSnapshotTransformByName(FName BoneName, FTransform& OutTransform) const;
+
+	// Forwards to the anim instance's spring hit reaction; no physics bodies are involved.
+	UFUNCTION(BlueprintCallable, Category = "Locomotion|HitReaction")
+	void AddHitReaction(const FVector& WorldDirection, float Strength);
+
+protected:
+	// Tuned quality tiers; without an asset the built-in config defaults are used.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|LOD")
+	TObjectPtr<UProceduralLocomotionLODSettings> LODSettings;
+
+	// Largest acceptable error proxy when choosing among the tuned configs.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|LOD")
+	float LODErrorBudget = 1.0f;
+
+	// Degrees between the control yaw and the actor's before an idle character turns.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|TurnInPlace", meta = (ClampMin = "0", ClampMax = "180"))
+	float TurnInPlaceThreshold = 90.0f;
+
 private:
 	// Helper to set up a default skeletal mesh and anim instance if none set in editor
 	void SetupDefaultMeshAndAnimation();
+
+	void ApplyUpdateRateOptimizations();
+	void OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params);
+
+	// Picks the procedural layers for the current distance to the nearest rendered view.
+	void UpdateLODLayers();
+
+	const FProceduralLocomotionPoseSnapshot* GetPoseSnapshot() const;
+
+	FProceduralLocomotionLODConfig ActiveLODConfig;
 };
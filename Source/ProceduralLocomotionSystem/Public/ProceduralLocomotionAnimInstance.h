@@ -2,8 +2,114 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "ProceduralLocomotionGroundQuerySubsystem.h"
+#include "ProceduralLocomotionLODSettings.h"
+#include "ProceduralLocomotionMath.h"
+#include "ProceduralLocomotionMoCapReceiver.h"
+#include "ProceduralLocomotionPoseSnapshot.h"
+#include "ProceduralLocomotionProfile.h"
 #include "ProceduralLocomotionAnimInstance.generated.h"
 
+class ACharacter;
+class UAnimSequenceBase;
+
+// Everything one update reads from the owning character, gathered once at its start. The layers
+// only see these values, in these types, so feeding a recorded input back in reproduces the update
+// exactly (see UProceduralLocomotionReplaySubsystem).
+struct FProceduralLocomotionAnimInput
+{
+	float DeltaSeconds = 0.0f;
+	FVector Location = FVector::ZeroVector;
+	FRotator3f Rotation = FRotator3f::ZeroRotator;
+	// Control rotation yaw, or the actor's without a controller.
+	float AimYaw = 0.0f;
+	FVector3f Velocity = FVector3f::ZeroVector;
+	FVector3f Acceleration = FVector3f::ZeroVector;
+	// On the ground with no velocity or input acceleration (IsCharacterIdle).
+	bool bIdle = false;
+	// bEnableTurnInPlace with pls.TurnInPlace.Enable applied.
+	bool bTurnInPlace = false;
+	// World XY of the feet in the last evaluated pose, where foot IK traces. The only value read
+	// from the pose, which a replay could not otherwise reproduce from a fresh anim graph.
+	FVector2f LeftFootTrace = FVector2f::ZeroVector;
+	FVector2f RightFootTrace = FVector2f::ZeroVector;
+	// Movement base the character stands on (its UniqueID, 0 for none) and the base's transform.
+	uint32 BaseId = 0;
+	FVector BaseLocation = FVector::ZeroVector;
+	FQuat4f BaseRotation = FQuat4f::Identity;
+	// Set when foot ground comes from UProceduralLocomotionGroundQuerySubsystem instead of direct
+	// traces, with the results it served since the last update.
+	bool bScheduledGroundQueries = false;
+	FProceduralLocomotionGroundHit LeftFootGround;
+	FProceduralLocomotionGroundHit RightFootGround;
+	// Hit impulses added since the last update, in actor space (deg/s of bend, see AddHitReaction).
+	FVector2f HitImpulse = FVector2f::ZeroVector;
+	// LOD layers with the pls.*.Enable toggles already applied.
+	FProceduralLocomotionLayers Layers;
+};
+
+// Ground found under one foot, kept in the space of the movement base it was traced on so it
+// rides along with the base without tracing again.
+struct FProceduralLocomotionFootPlant
+{
+	FVector Location = FVector::ZeroVector;
+	FVector3f Normal = FVector3f::UpVector;
+	uint32 BaseId = 0;
+	bool bValid = false;
+};
+
+// Procedural layer state carried from one update to the next.
+struct FProceduralLocomotionAnimState
+{
+	float LocomotionPhase = 0.0f;
+	float LeanAngle = 0.0f;
+	float LastYawDegrees = 0.0f;
+	float ProceduralTime = 0.0f;
+	float LeftFootOffset = 0.0f;
+	float RightFootOffset = 0.0f;
+	float PelvisOffset = 0.0f;
+	float FootIKAlpha = 1.0f;
+	float RootYawOffset = 0.0f;
+	float LastActorYaw = 0.0f;
+	float TurnInPlaceYaw = 0.0f;
+	bool bTurningInPlace = false;
+	bool bWasIdle = false;
+	FRotator LeftFootRotation = FRotator::ZeroRotator;
+	FRotator RightFootRotation = FRotator::ZeroRotator;
+	FProceduralLocomotionFootPlant LeftFootPlant;
+	FProceduralLocomotionFootPlant RightFootPlant;
+	// Per HitReactionBones entry: bend (degrees) towards actor X/Y and its velocity.
+	TArray<FVector4f> HitSprings;
+};
+
+// One bone bent by hit reactions, with its own spring.
+USTRUCT(BlueprintType)
+struct FProceduralLocomotionHitReactionBone
+{
+	GENERATED_BODY()
+
+	FProceduralLocomotionHitReactionBone() = default;
+	FProceduralLocomotionHitReactionBone(FName InBoneName, float InWeight, float InStiffness = 120.0f, float InDampingRatio = 0.5f)
+		: BoneName(InBoneName), Weight(InWeight), Stiffness(InStiffness), DampingRatio(InDampingRatio)
+	{
+	}
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|HitReaction")
+	FName BoneName;
+
+	// Share of each impulse this bone takes; the head usually takes the most.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|HitReaction", meta = (ClampMin = "0"))
+	float Weight = 1.0f;
+
+	// Angular frequency squared (1/s^2); lower is slower and floppier.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|HitReaction", meta = (ClampMin = "1"))
+	float Stiffness = 120.0f;
+
+	// 1 settles without overshoot; lower values wobble back.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|HitReaction", meta = (ClampMin = "0"))
+	float DampingRatio = 0.5f;
+};
+
 UCLASS(Blueprintable, BlueprintType)
 class UProceduralLocomotionAnimInstance : public UAnimInstance
 {
@@ -14,6 +120,66 @@ public:
 
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+	virtual void NativePostEvaluateAnimation() override;
+	virtual void NativeUninitializeAnimation() override;
+
+	// Set by AProceduralCharacter from its distance to the viewer.
+	void SetLODLayers(const FProceduralLocomotionLayers& InLayers) { LODLayers = InLayers; }
+	const FProceduralLocomotionLayers& GetLODLayers() const { return LODLayers; }
+
+	float GetGroundSpeed() const { return GroundSpeed; }
+	float GetDirection() const { return Direction; }
+	bool IsAccelerating() const { return bIsAccelerating; }
+	float GetLocomotionPhase() const { return LocomotionPhase; }
+	float GetLeanAngle() const { return LeanAngle; }
+	float GetLeftFootOffset() const { return LeftFootOffset; }
+	float GetRightFootOffset() const { return RightFootOffset; }
+	float GetFootIKAlpha() const { return FootIKAlpha; }
+	float GetPelvisOffset() const { return PelvisOffset; }
+	float GetRootYawOffset() const { return RootYawOffset; }
+	bool IsTurningInPlace() const { return bTurningInPlace; }
+
+	// The one definition of idle, shared by the turn-in-place layer and AProceduralCharacter::FaceRotation.
+	static bool IsCharacterIdle(const ACharacter& Character);
+	// pls.TurnInPlace.Enable, which also stops AProceduralCharacter holding its yaw.
+	static bool IsTurnInPlaceEnabled();
+
+	// Layer tuning as plain math parameters, shared with offline tools such as the bake commandlet.
+	ProceduralLocomotionMath::FLeanParams GetLeanParams() const;
+	ProceduralLocomotionMath::FBoneOscillationParams GetProceduralBoneParams() const;
+	FName GetProceduralBoneName() const { return ProceduralBoneName; }
+	float GetStrideLength() const { return StrideLength; }
+	const UProceduralLocomotionProfile* GetProfile() const { return Profile; }
+
+	// Last completed frame of the SnapshotBoneNames transforms; safe to read without waiting on evaluation.
+	const FProceduralLocomotionPoseSnapshot& GetPoseSnapshot() const { return PoseSnapshot; }
+
+	// Live MoCap stream consumed by FAnimNode_ProceduralMoCapPose; null unless bEnableMoCap is set in a game world.
+	FProceduralLocomotionMoCapReceiver* GetMoCapReceiver() const { return MoCapReceiver.Get(); }
+	const TArray<FName>& GetMoCapBoneNames() const { return MoCapBoneNames; }
+
+	// Replaces MarkerSyncSequences at runtime (the crowd benchmark uses this).
+	void SetMarkerSyncSequences(const TArray<UAnimSequenceBase*>& Sequences);
+
+	// Input of the last update, and how many updates have run; skipped frames (update rate
+	// optimization) leave both unchanged.
+	const FProceduralLocomotionAnimInput& GetLastInput() const { return LastInput; }
+	uint32 GetUpdateCount() const { return UpdateCount; }
+
+	FProceduralLocomotionAnimState GetLayerState() const;
+	void SetLayerState(const FProceduralLocomotionAnimState& State);
+
+	// Under replay control, updates use the input pushed since the last update instead of reading
+	// the character, and frames without one don't update at all.
+	void SetReplayControlled(bool bInReplayControlled);
+	bool IsReplayControlled() const { return bReplayControlled; }
+	void PushReplayInput(const FProceduralLocomotionAnimInput& Input);
+
+	// Knocks the hit reaction bones along the horizontal part of WorldDirection, the way the hit
+	// travels. Strength is the initial bend speed in deg/s of a bone with weight 1; impulses
+	// between two updates add up.
+	UFUNCTION(BlueprintCallable, Category = "Locomotion|HitReaction")
+	void AddHitReaction(const FVector& WorldDirection, float Strength);
 
 protected:
 	// --- Locomotion ---
@@ -26,6 +192,52 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
 	bool bIsAccelerating = false;
 
+	// Distance (cm) covered by one full stride cycle; drives LocomotionPhase.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion")
+	float StrideLength = 150.0f;
+
+	// Stride phase in [0, 1), advanced by distance travelled. Marker-synced sequences treat it as
+	// gait phase: 0 at the left foot plant, 0.5 at the right one.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	float LocomotionPhase = 0.0f;
+
+	// Shared tuning; when set, its values replace the leaning settings below.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion")
+	TObjectPtr<UProceduralLocomotionProfile> Profile;
+
+	// --- Turn in place (the ABP applies RootYawOffset with Rotate Root Bone) ---
+	// Plays turns for idle characters instead of following every actor rotation; see
+	// AProceduralCharacter::FaceRotation, which holds the actor's yaw to match.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|TurnInPlace")
+	bool bEnableTurnInPlace = true;
+
+	// Smallest root yaw offset (degrees) that plays a turn; smaller ones are held.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|TurnInPlace", meta = (ClampMin = "0", ClampMax = "180"))
+	float TurnInPlaceMinAngle = 60.0f;
+
+	// Degrees/sec the mesh turns during a turn; match the turn animations (90 degrees in 0.5 s is 180).
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|TurnInPlace", meta = (ClampMin = "1"))
+	float TurnInPlaceRate = 180.0f;
+
+	// How quickly a held offset blends out once the character moves.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|TurnInPlace")
+	float RootYawOffsetInterpSpeed = 10.0f;
+
+	// Mesh yaw minus actor yaw (degrees): while idle the mesh keeps its facing as the actor turns under it.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|TurnInPlace")
+	float RootYawOffset = 0.0f;
+
+	// Aim yaw relative to the mesh facing, for aim offsets.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|TurnInPlace")
+	float AimYawOffset = 0.0f;
+
+	// Set while a turn plays; TurnInPlaceYaw is its signed size (positive turns right) to pick the animation.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|TurnInPlace")
+	bool bTurningInPlace = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|TurnInPlace")
+	float TurnInPlaceYaw = 0.0f;
+
 	// --- Procedural Leaning ---
 	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|Leaning")
 	float LeanAngle = 0.0f;
@@ -44,7 +256,7 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|Leaning")
 	float LeanInterpSpeed = 6.0f;
 
-	// --- Foot IK (header definitions; traces/offsets are commonly implemented in ABP or a component) ---
+	// --- Foot IK (ground traces here; the ABP applies the offsets with Two Bone IK) ---
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|FootIK")
 	float LeftFootTraceDistance = 55.0f;
 
@@ -63,8 +275,144 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|FootIK")
 	FName RightFootBoneName = TEXT("foot_r");
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|FootIK")
+	float FootIKInterpSpeed = 15.0f;
+
+	// Each foot's ground is cached in the movement base's space and reused while the foot stays
+	// within this distance (cm) of it; moving further counts as a step and traces again.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|FootIK", meta = (ClampMin = "0"))
+	float FootPlantTolerance = 3.0f;
+
+	// Vertical foot offsets (cm) from the capsule bottom to the traced ground.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|FootIK")
+	float LeftFootOffset = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|FootIK")
+	float RightFootOffset = 0.0f;
+
+	// Pelvis drops to the lower foot so the other leg can bend to reach its ground.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|FootIK")
+	float PelvisOffset = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|FootIK")
+	FRotator LeftFootRotation = FRotator::ZeroRotator;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|FootIK")
+	FRotator RightFootRotation = FRotator::ZeroRotator;
+
+	// Blends out when foot IK is dropped by LOD so feet don't pop.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|FootIK")
+	float FootIKAlpha = 1.0f;
+
+	// --- Hit reaction (springs here; the ABP adds HitReactionRotations with Transform (Modify) Bone,
+	// component space, Add to Existing) ---
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|HitReaction")
+	TArray<FProceduralLocomotionHitReactionBone> HitReactionBones = {
+		FProceduralLocomotionHitReactionBone(TEXT("spine_01"), 0.4f),
+		FProceduralLocomotionHitReactionBone(TEXT("spine_03"), 0.8f),
+		FProceduralLocomotionHitReactionBone(TEXT("head"), 1.0f, 90.0f, 0.4f),
+		FProceduralLocomotionHitReactionBone(TEXT("upperarm_l"), 0.6f, 60.0f, 0.35f),
+		FProceduralLocomotionHitReactionBone(TEXT("upperarm_r"), 0.6f, 60.0f, 0.35f) };
+
+	// Largest bend (degrees) of any bone, however hard the hits.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|HitReaction", meta = (ClampMin = "0"))
+	float HitReactionMaxAngle = 30.0f;
+
+	// Component-space rotation to add to each HitReactionBones entry, in the same order.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|HitReaction")
+	TArray<FRotator> HitReactionRotations;
+
+	// --- Pose snapshot ---
+	// Bones copied into the pose snapshot after each evaluation, in slot order.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|Snapshot")
+	TArray<FName> SnapshotBoneNames = { TEXT("pelvis"), TEXT("foot_l"), TEXT("foot_r"), TEXT("head") };
+
+	// --- Live MoCap ---
+	// Listens for the MoCap stream while in a game world; the ABP applies it with the Procedural MoCap Pose node.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|MoCap")
+	bool bEnableMoCap = false;
+
+	// UDP port of this character's stream; give each live-driven character its own port.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|MoCap", meta = (ClampMin = "1", ClampMax = "65535"))
+	int32 MoCapPort = 54321;
+
+	// Subject id to accept on the port, or -1 for any.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|MoCap")
+	int32 MoCapSubjectId = -1;
+
+	// Bones carried by the stream, in packet order.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|MoCap")
+	TArray<FName> MoCapBoneNames = {
+		TEXT("pelvis"), TEXT("spine_01"), TEXT("spine_02"), TEXT("spine_03"), TEXT("neck_01"), TEXT("head"),
+		TEXT("thigh_l"), TEXT("calf_l"), TEXT("foot_l"), TEXT("thigh_r"), TEXT("calf_r"), TEXT("foot_r"),
+		TEXT("upperarm_l"), TEXT("lowerarm_l"), TEXT("upperarm_r"), TEXT("lowerarm_r") };
+
+	// --- Marker sync ---
+	// Clips kept phase-locked to LocomotionPhase through the marker index the footstep modifier
+	// bakes onto them. Feed MarkerSyncTimes[i] to a Sequence Evaluator's Explicit Time.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|Sync")
+	TArray<TObjectPtr<UAnimSequenceBase>> MarkerSyncSequences;
+
+	// Playback time of each MarkerSyncSequences entry this frame.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|Sync")
+	TArray<float> MarkerSyncTimes;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|Sync")
+	FName LeftFootMarkerName = TEXT("Foot_L");
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Locomotion|Sync")
+	FName RightFootMarkerName = TEXT("Foot_R");
+
+	// Seconds until each foot next plants at the current ground speed, from the first synced clip;
+	// -1 when unknown. Lets foot IK blend in ahead of contact instead of reacting to traces.
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|Sync")
+	float TimeToLeftFootPlant = -1.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|Sync")
+	float TimeToRightFootPlant = -1.0f;
+
+	// --- Clip streaming ---
+	// Profile clip for the current ground speed, once resident. While it streams in this is null
+	// and the AnimGraph should keep playing the procedural walk cycle (branch on bLocomotionClipReady).
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Locomotion|Clips")
+	TObjectPtr<UAnimSequenceBase> LocomotionClip;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|Clips")
+	FName LocomotionClipState;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion|Clips")
+	bool bLocomotionClipReady = false;
+
 private:
-	void UpdateProceduralLeaning(float DeltaSeconds);
+	void GatherInput(const ACharacter& Character, float DeltaSeconds, FProceduralLocomotionAnimInput& OutInput) const;
+
+	void UpdateTurnInPlace(const FProceduralLocomotionAnimInput& Input);
+
+	void UpdateProceduralLeaning(const FProceduralLocomotionAnimInput& Input);
+
+	void UpdateFootIK(const FProceduralLocomotionAnimInput& Input);
+
+	void UpdateHitReaction(const FProceduralLocomotionAnimInput& Input);
+
+	void UpdateLocomotionClip();
+
+	void CacheMarkerSyncIndices();
+	void UpdateMarkerSync();
+	float GetTimeToFootPlant(const class UProceduralLocomotionMarkerIndex& Index, FName MarkerName) const;
+
+	// Ground offset of one foot (slot 0 left, 1 right) from the capsule bottom, 0 when there is no
+	// ground. Comes from its plant when the foot hasn't stepped off it, and otherwise from a new
+	// trace, or with scheduled ground queries from a served result or, while the query waits, the
+	// plant's surface extended under the foot.
+	float UpdateFootPlant(FProceduralLocomotionFootPlant& Plant, int32 FootSlot, const FVector2f& FootLocation, float TraceDistance,
+		float CapsuleBottomZ, const FProceduralLocomotionAnimInput& Input, const FTransform& BaseTransform, FRotator& OutFootRotation) const;
+
+	float ExtrapolateFootPlant(const FProceduralLocomotionFootPlant& Plant, const FVector2f& FootLocation, float TraceDistance, float CapsuleBottomZ,
+		const FTransform& BaseTransform, FRotator& OutFootRotation) const;
+
+	void RequestFootGround(int32 FootSlot, const FVector2f& FootLocation, float TraceDistance, float CapsuleBottomZ) const;
+
+	bool TraceFootGround(const FVector2f& FootLocation, float TraceDistance, float CapsuleBottomZ, FVector& OutLocation, FVector& OutNormal) const;
 
 	// --- Simple procedural bone animation (optional demo) ---
 	void UpdateProceduralBone(float DeltaSeconds);
@@ -86,5 +434,39 @@ private:
 	float ProceduralTime = 0.0f;
 
 	TWeakObjectPtr<class ACharacter> CachedCharacter;
+	// Mesh yaw (actor yaw plus RootYawOffset) at the last leaning update.
 	float LastYawDegrees = 0.0f;
+	float LastActorYaw = 0.0f;
+	// Input.bIdle of the last update, to find the first moving frame.
+	bool bWasIdle = false;
+
+	FProceduralLocomotionLayers LODLayers;
+
+	FProceduralLocomotionAnimInput LastInput;
+	uint32 UpdateCount = 0;
+
+	bool bReplayControlled = false;
+	bool bHasReplayInput = false;
+	FProceduralLocomotionAnimInput ReplayInput;
+
+	// Accumulated by AddHitReaction until the next update reads it.
+	FVector2f PendingHitImpulse = FVector2f::ZeroVector;
+	FProceduralLocomotionFootPlant LeftFootPlant;
+	FProceduralLocomotionFootPlant RightFootPlant;
+
+	// Bend and velocity per HitReactionBones entry, as in FProceduralLocomotionAnimState::HitSprings.
+	TArray<FVector4f> HitSprings;
+	bool bHitReactionActive = false;
+
+	FProceduralLocomotionPoseSnapshot PoseSnapshot;
+	TWeakObjectPtr<const class USkeletalMesh> PoseSnapshotMesh;
+
+	TUniquePtr<FProceduralLocomotionMoCapReceiver> MoCapReceiver;
+
+	TWeakObjectPtr<const class UProceduralLocomotionStreamingSubsystem> ClipStreaming;
+
+	TWeakObjectPtr<UProceduralLocomotionGroundQuerySubsystem> GroundQueries;
+
+	// Baked index per MarkerSyncSequences entry (null without one); owned by the sequences.
+	TArray<const class UProceduralLocomotionMarkerIndex*> MarkerSyncIndices;
 };
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ProceduralLocomotionBakeCommandlet.generated.h"
+
+/**
+ * Bakes the procedural layers into animation sequences for far LODs and cinematics, where
+ * running UpdateProceduralLeaning and the procedural bone every frame is not worth it.
+ *
+ * For each scripted path preset the commandlet drives the same math as
+ * UProceduralLocomotionAnimInstance (leaning from yaw rate and lateral acceleration, head
+ * oscillation, stride phase from distance) at -SampleRate, and layers it on -WalkAnim played
+ * back by stride phase. The presets are composed in parallel; each result is saved as a
+ * compressed UAnimSequence named AS_Baked_<Preset>. With -LeanPoses an additive lean pose set
+ * (AS_Baked_LeanPoses, full left lean to full right lean over its length) is saved as well,
+ * to be driven by a Sequence Evaluator from the lean angle.
+ *
+ * Layer tuning comes from the default object of -AnimClass.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=ProceduralLocomotionBake
+ *       -WalkAnim=/Game/Characters/Mannequins/Animations/MM_Walk_Fwd
+ *       [-Presets=Straight,Circle,Slalom,Figure8|All] [-Speed=300] [-Duration=8] [-SampleRate=30]
+ *       [-AnimClass=/Game/Locomotion/ABP_Procedural.ABP_Procedural_C]
+ *       [-LeanBone=spine_01] [-ForwardAxis=Y|X] [-LeanPoses] [-OutputPath=/Game/Locomotion/Baked]
+ */
+UCLASS()
+class UProceduralLocomotionBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UProceduralLocomotionBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
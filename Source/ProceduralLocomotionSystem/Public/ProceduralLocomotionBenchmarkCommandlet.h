@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ProceduralLocomotionBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless crowd benchmark for UProceduralLocomotionAnimInstance.
+ *
+ * Spawns N procedural characters in a transient world, steers them along figure-8 paths and
+ * records the per-frame cost of each anim instance stage over several independent runs.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=ProceduralLocomotionBenchmark
+ *       -Characters=16,64,256 -Layers=None,Lean,Lean+FootIK+Bone
+ *       -Runs=7 -Frames=600 -Warmup=60 -DeltaTime=0.0333 -Output=<Result.json>
+ *       [-SyncClips=<AnimSequence>,...]
+ *
+ * The Sync layer keeps every -SyncClips clip phase-locked through its baked marker index.
+ */
+UCLASS()
+class UProceduralLocomotionBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UProceduralLocomotionBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimSequence;
+class UObject;
+
+// Helpers shared by the commandlets in this module and the editor module, so they read their
+// arguments and save their assets the same way.
+namespace ProceduralLocomotionCommandlet
+{
+	// Loads the animation sequences named by -Clips=<Folder or AnimSequence,...>; folders are
+	// searched recursively. Each clip appears once.
+	PROCEDURALLOCOMOTIONSYSTEM_API TArray<UAnimSequence*> LoadClips(const FString& Params);
+
+	// Marks the asset's package dirty and saves it to its content file, logging an error if that
+	// fails. Saving needs an editor build; elsewhere this only logs.
+	PROCEDURALLOCOMOTIONSYSTEM_API bool SaveAssetPackage(UObject* Asset);
+}
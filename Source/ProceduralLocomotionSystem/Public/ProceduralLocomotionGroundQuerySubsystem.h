@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProceduralLocomotionGroundQuerySubsystem.generated.h"
+
+// Ground found (or not) by a served query.
+struct FProceduralLocomotionGroundHit
+{
+	bool bServed = false;
+	bool bHit = false;
+	FVector Location = FVector::ZeroVector;
+	FVector3f Normal = FVector3f::UpVector;
+};
+
+// One ground line trace a character wants, with what it knows about how much it matters.
+struct FProceduralLocomotionGroundQuery
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	// 1 for a foot planted or about to plant, lower for one in the air.
+	float Urgency = 0.5f;
+	// Mesh bounds, for the screen size estimate; unrendered meshes count as zero size.
+	float BoundsRadius = 0.0f;
+	bool bRecentlyRendered = true;
+	TWeakObjectPtr<const AActor> IgnoredActor;
+};
+
+// Scheduler state after the last pass.
+struct FProceduralLocomotionGroundQueryReport
+{
+	int32 Budget = 0;
+	int32 NumServed = 0;
+	// Queries still waiting after the pass.
+	int32 QueueDepth = 0;
+	int32 PeakQueueDepth = 0;
+	// Request-to-serve age of the queries served in the pass.
+	float AverageAgeMs = 0.0f;
+	float MaxAgeMs = 0.0f;
+};
+
+/**
+ * Runs foot IK ground traces under a per-frame budget, so wave spawns, mass landings and terrain
+ * edges don't all trace in the same frame.
+ *
+ * A character that needs ground for a foot queues a query, and renews it on each update until it
+ * is served. Once per frame, after the anim updates, the queue is ordered by priority and the
+ * first GroundQueryBudget queries are traced. Priority adds up the character's screen size, its
+ * nearness to a viewer, the foot's urgency, and how long the query has waited, so every query is
+ * eventually served. Results are picked up on the character's next update; until then it
+ * extrapolates from its last ground (see UProceduralLocomotionAnimInstance).
+ */
+UCLASS()
+class PROCEDURALLOCOMOTIONSYSTEM_API UProceduralLocomotionGroundQuerySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Whether queries are scheduled at all (UProceduralLocomotionSettings::bScheduleGroundQueries).
+	static bool IsEnabled();
+
+	// Queues a query for one slot (foot) of Requester, or refreshes the one already queued
+	// without resetting how long it has waited.
+	void RequestQuery(const UObject* Requester, int32 Slot, const FProceduralLocomotionGroundQuery& Query);
+
+	// Takes the result served for the slot since the last call; false if there is none.
+	bool ConsumeResult(const UObject* Requester, int32 Slot, FProceduralLocomotionGroundHit& OutHit);
+
+	const FProceduralLocomotionGroundQueryReport& GetReport() const { return Report; }
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FPendingQuery
+	{
+		FProceduralLocomotionGroundQuery Query;
+		double FirstRequestTime = 0.0;
+		double LastRequestTime = 0.0;
+	};
+
+	struct FServedQuery
+	{
+		FProceduralLocomotionGroundHit Hit;
+		double ServedTime = 0.0;
+	};
+
+	static uint64 MakeKey(const UObject* Requester, int32 Slot);
+
+	float GetPriority(const FPendingQuery& Pending, const TArray<FVector>& ViewLocations, double Now) const;
+	FProceduralLocomotionGroundHit Trace(const FProceduralLocomotionGroundQuery& Query) const;
+	void RemoveAbandoned(double Now);
+
+	TMap<uint64, FPendingQuery> Pending;
+	TMap<uint64, FServedQuery> Served;
+	FProceduralLocomotionGroundQueryReport Report;
+};
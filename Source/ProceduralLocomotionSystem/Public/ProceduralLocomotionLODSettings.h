@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ProceduralLocomotionLODSettings.generated.h"
+
+// Which procedural layers a character runs at its current distance from the viewer.
+USTRUCT(BlueprintType)
+struct FProceduralLocomotionLayers
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Locomotion|LOD")
+	bool bLeaning = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Locomotion|LOD")
+	bool bProceduralBone = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Locomotion|LOD")
+	bool bFootIK = true;
+};
+
+// One distance/URO configuration, plus what it measured when the tuning tool produced it.
+USTRUCT(BlueprintType)
+struct FProceduralLocomotionLODConfig
+{
+	GENERATED_BODY()
+
+	// Beyond this distance (cm) the procedural bone oscillation is dropped.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|LOD")
+	float ReducedDistance = 1500.0f;
+
+	// Beyond this distance (cm) leaning is dropped as well.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|LOD")
+	float MinimalDistance = 4000.0f;
+
+	// Foot IK traces only run inside this distance (cm).
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|LOD")
+	float FootIKMaxDistance = 2000.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|URO")
+	bool bEnableUpdateRateOptimizations = true;
+
+	// Screen-size thresholds; a mesh below threshold N skips N + 1 frames between updates.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|URO", meta = (EditCondition = "bEnableUpdateRateOptimizations"))
+	TArray<float> UROVisibleDistanceFactorThresholds = { 0.24f, 0.12f };
+
+	// Locomotion game-thread cost per frame (ms) and error proxy measured by the tuning tool.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Locomotion|Tuning")
+	float MeasuredCostMs = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Locomotion|Tuning")
+	float MeasuredError = 0.0f;
+
+	FProceduralLocomotionLayers GetLayersForDistance(float Distance) const;
+};
+
+/**
+ * Quality tier and update-rate settings for AProceduralCharacter.
+ *
+ * Normally generated by the ProceduralLocomotionLODTuning commandlet, which stores the
+ * Pareto-optimal configurations (cheapest first). Characters pick the cheapest config whose
+ * measured error fits their error budget.
+ */
+UCLASS(BlueprintType)
+class PROCEDURALLOCOMOTIONSYSTEM_API UProceduralLocomotionLODSettings : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|LOD")
+	TArray<FProceduralLocomotionLODConfig> Configs;
+
+	// Cheapest config with MeasuredError <= ErrorBudget, or the most accurate one if none fits.
+	const FProceduralLocomotionLODConfig* FindConfigForErrorBudget(float ErrorBudget) const;
+};
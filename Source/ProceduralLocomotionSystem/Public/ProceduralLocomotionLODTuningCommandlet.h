@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ProceduralLocomotionLODTuningCommandlet.generated.h"
+
+/**
+ * Profile-guided tuning of quality tier distances, URO thresholds and the foot IK cutoff.
+ *
+ * Runs the headless crowd benchmark once at full quality as the reference, then once per
+ * config in a grid of settings. Each config is scored by frame cost and by an error proxy:
+ * the RMS deviation of lean angle (degrees) and IK'd foot positions (cm) from the reference,
+ * weighted by -LeanWeight and -FootWeight. The Pareto-optimal configs are written to a
+ * UProceduralLocomotionLODSettings asset that AProceduralCharacter can use directly.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=ProceduralLocomotionLODTuning
+ *       -ReducedDistances=1000,2000,4000 -MinimalDistances=3000,6000,10000
+ *       -FootIKDistances=1000,2000,4000 -UROScales=0,0.5,1,2
+ *       [-Characters=128] [-Frames=450] [-Warmup=60] [-Runs=3]
+ *       [-LeanWeight=1.0] [-FootWeight=0.2]
+ *       [-OutputAsset=/Game/Locomotion/DA_LocomotionLODSettings] [-Report=<File.csv>]
+ */
+UCLASS()
+class UProceduralLocomotionLODTuningCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UProceduralLocomotionLODTuningCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
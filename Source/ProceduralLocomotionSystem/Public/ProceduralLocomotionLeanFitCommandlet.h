@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ProceduralLocomotionLeanFitCommandlet.generated.h"
+
+/**
+ * Fits the leaning model (MaxLeanAngle, AccelerationLeanMultiplier, YawRateLeanMultiplier,
+ * LeanInterpSpeed) to retargeted MoCap clips that carry root motion.
+ *
+ * Every clip is sampled in parallel into root lateral acceleration, yaw rate and measured lean:
+ * the sideways tilt of -LeanBone -> -LeanTipBone relative to the reference pose. For each
+ * candidate interp speed on a log grid, the two multipliers are solved by linear least squares
+ * on the lag-filtered inputs; MaxLeanAngle is then picked from percentiles of the measured lean.
+ * The candidate with the lowest RMS error of the full model wins and is written into a
+ * UProceduralLocomotionProfile together with its fit error.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=ProceduralLocomotionLeanFit
+ *       -Clips=/Game/MoCap/Retargeted[,<Folder or AnimSequence>...]
+ *       [-LeanBone=spine_01] [-LeanTipBone=neck_01] [-ForwardAxis=Y|X] [-SampleRate=60]
+ *       [-Profile=/Game/Locomotion/DA_LocomotionProfile] [-Report=<File.csv>]
+ */
+UCLASS()
+class UProceduralLocomotionLeanFitCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UProceduralLocomotionLeanFitCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
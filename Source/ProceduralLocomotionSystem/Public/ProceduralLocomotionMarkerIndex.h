@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "ProceduralLocomotionMarkerIndex.generated.h"
+
+class UAnimationAsset;
+
+/**
+ * Sync marker index baked onto an animation sequence by the footstep modifier, so marker-based
+ * sync never searches the marker list at runtime.
+ *
+ * Markers are stored sorted, as 16-bit fractions of the sequence length, with a bucket table that
+ * maps any time to its preceding marker in constant time. Each marker name carries a gait phase
+ * (by default Foot_L = 0, Foot_R = 0.5); the phase between two markers is interpolated linearly,
+ * so clips of any speed or stride count map onto one shared [0, 1) gait phase and back. The
+ * sequence is treated as a loop.
+ *
+ * Immutable after Build, so it can be read from any thread.
+ */
+UCLASS()
+class PROCEDURALLOCOMOTIONSYSTEM_API UProceduralLocomotionMarkerIndex : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	// Index baked onto Asset, or null if the footstep modifier has not been applied to it.
+	static const UProceduralLocomotionMarkerIndex* Find(const UAnimationAsset* Asset);
+
+	// Replaces the index with Markers (name, time in seconds). Markers whose name has no entry in
+	// NamePhases are left out.
+	void Build(TArray<TPair<FName, float>> Markers, float InSequenceLength, const TMap<FName, float>& NamePhases);
+
+	bool IsValid() const { return Positions.Num() > 0 && SequenceLength > 0.0f; }
+	int32 GetNumMarkers() const { return Positions.Num(); }
+	float GetSequenceLength() const { return SequenceLength; }
+
+	// Gait phase in [0, 1) at Time seconds into the sequence.
+	float GetPhaseAtTime(float Time) const;
+
+	// Time in the sequence at gait phase Phase, taking the first match at or after the marker
+	// preceding HintTime (pass the current playback time to stay in the same cycle).
+	float GetTimeAtPhase(float Phase, float HintTime) const;
+
+	// Seconds from Time until the next marker called MarkerName, wrapping at the end; -1 if there is none.
+	float GetTimeUntilMarker(FName MarkerName, float Time) const;
+
+private:
+	// Position in 1/65536ths of the sequence length.
+	static constexpr float PositionScale = 65536.0f;
+
+	float ToPosition(float Time) const;
+
+	// Last marker at or before Position, or INDEX_NONE when Position precedes every marker.
+	int32 FindPreviousMarker(float Position) const;
+
+	// Gait phase span from marker Index to the next one; a full cycle when both share a phase.
+	float GetPhaseSpan(int32 Index) const;
+
+	// Position of the marker after Index, unwrapped past the end of the loop.
+	float GetNextPosition(int32 Index) const;
+
+	UPROPERTY()
+	float SequenceLength = 0.0f;
+
+	UPROPERTY()
+	TArray<FName> MarkerNames;
+
+	// Gait phase of each entry of MarkerNames.
+	UPROPERTY()
+	TArray<float> MarkerNamePhases;
+
+	// Sorted marker positions and, per marker, its index into MarkerNames.
+	UPROPERTY()
+	TArray<uint16> Positions;
+
+	UPROPERTY()
+	TArray<uint8> NameIndices;
+
+	// Number of markers before the start of each bucket; a power-of-two count of equal buckets.
+	UPROPERTY()
+	TArray<uint16> Buckets;
+
+	UPROPERTY()
+	uint8 BucketShift = 16;
+};
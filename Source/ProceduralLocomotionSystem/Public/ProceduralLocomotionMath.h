@@ -0,0 +1,186 @@
+#pragma once
+
+// Engine-independent locomotion math shared by UProceduralLocomotionAnimInstance and the native
+// tools under Tools/ (Python backend, offline renderer). Only the standard library is used so
+// the tools build without the engine; the helpers reproduce the FMath functions they replace
+// operation for operation, so float results match the anim instance exactly.
+
+#include <cmath>
+
+namespace ProceduralLocomotionMath
+{
+	// Mirrors KINDA_SMALL_NUMBER and SMALL_NUMBER.
+	constexpr float KindaSmallNumber = 1.e-4f;
+	constexpr float SmallNumber = 1.e-8f;
+
+	template <typename T>
+	constexpr T Clamp(T X, T Min, T Max)
+	{
+		return X < Min ? Min : (X < Max ? X : Max);
+	}
+
+	template <typename T>
+	constexpr T Max(T A, T B)
+	{
+		return A >= B ? A : B;
+	}
+
+	// FMath::FInterpTo: moves towards Target by a fraction DeltaTime * InterpSpeed of the remaining distance.
+	inline float InterpTo(float Current, float Target, float DeltaTime, float InterpSpeed)
+	{
+		if (InterpSpeed <= 0.f)
+		{
+			return Target;
+		}
+
+		const float Dist = Target - Current;
+		if (Dist * Dist < SmallNumber)
+		{
+			return Target;
+		}
+
+		const float DeltaMove = Dist * Clamp<float>(DeltaTime * InterpSpeed, 0.f, 1.f);
+		return Current + DeltaMove;
+	}
+
+	// FMath::FindDeltaAngleDegrees: shortest signed difference A2 - A1, in [-180, 180].
+	inline float FindDeltaAngleDegrees(float A1, float A2)
+	{
+		float Delta = A2 - A1;
+		if (Delta > 180.0f)
+		{
+			Delta = Delta - 360.0f;
+		}
+		else if (Delta < -180.0f)
+		{
+			Delta = Delta + 360.0f;
+		}
+		return Delta;
+	}
+
+	struct FLeanParams
+	{
+		float MaxLeanAngle = 20.0f;
+		// Acceleration is in cm/s^2; multipliers are tuned to produce degrees.
+		float AccelerationLeanMultiplier = 0.02f;
+		// Yaw rate is degrees/sec.
+		float YawRateLeanMultiplier = 0.02f;
+		float LeanInterpSpeed = 6.0f;
+	};
+
+	// Lean target from sideways acceleration (local +Y, cm/s^2) and yaw rate (deg/s), clamped to the max angle.
+	inline float ComputeTargetLean(float LocalAccelY, float YawRateDegPerSec, const FLeanParams& Params)
+	{
+		const float TargetLeanAngle = (LocalAccelY * Params.AccelerationLeanMultiplier) + (YawRateDegPerSec * Params.YawRateLeanMultiplier);
+		return Clamp(TargetLeanAngle, -Params.MaxLeanAngle, Params.MaxLeanAngle);
+	}
+
+	// One leaning update: derives the yaw rate from the last yaw, stores the current yaw and
+	// returns the new lean angle.
+	inline float StepLean(float LeanAngle, float& LastYawDegrees, float CurrentYawDegrees, float LocalAccelY, float DeltaSeconds, const FLeanParams& Params)
+	{
+		const float YawDelta = FindDeltaAngleDegrees(LastYawDegrees, CurrentYawDegrees);
+		const float YawRateDegPerSec = YawDelta / Max(DeltaSeconds, KindaSmallNumber);
+		LastYawDegrees = CurrentYawDegrees;
+
+		const float TargetLeanAngle = ComputeTargetLean(LocalAccelY, YawRateDegPerSec, Params);
+		return InterpTo(LeanAngle, TargetLeanAngle, DeltaSeconds, Params.LeanInterpSpeed);
+	}
+
+	// Uniformly sampled curve with linear interpolation, clamped at both ends. Only views the
+	// samples, which stay owned by whoever baked them (a locomotion profile); empty means no curve.
+	struct FLookupTable
+	{
+		const float* Values = nullptr;
+		int NumValues = 0;
+		float MinX = 0.0f;
+		float InvStep = 0.0f;
+
+		bool IsValid() const { return NumValues >= 2; }
+
+		// No branches beyond the clamps, so loops over many inputs vectorize.
+		float Evaluate(float X) const
+		{
+			const float Position = Clamp((X - MinX) * InvStep, 0.0f, (float)(NumValues - 1));
+			const int Index = Clamp((int)Position, 0, NumValues - 2);
+			const float Alpha = Position - (float)Index;
+			return Values[Index] + Alpha * (Values[Index + 1] - Values[Index]);
+		}
+
+		// Response to a signed input from a table authored for its magnitude.
+		float EvaluateMirrored(float X) const
+		{
+			return std::copysign(Evaluate(std::fabs(X)), X);
+		}
+	};
+
+	// Optional curve-shaped replacements for the linear leaning terms; an invalid table keeps the
+	// matching FLeanParams value.
+	struct FLeanResponse
+	{
+		// |Lateral acceleration| (cm/s^2) -> lean (degrees), mirrored for negative input.
+		FLookupTable AccelerationLean;
+		// |Yaw rate| (degrees/sec) -> lean (degrees), mirrored for negative input.
+		FLookupTable YawRateLean;
+		// Ground speed (cm/s) -> maximum lean (degrees).
+		FLookupTable MaxLeanBySpeed;
+	};
+
+	inline float ComputeTargetLean(float LocalAccelY, float YawRateDegPerSec, float GroundSpeed, const FLeanParams& Params, const FLeanResponse& Response)
+	{
+		const float AccelerationLean = Response.AccelerationLean.IsValid()
+			? Response.AccelerationLean.EvaluateMirrored(LocalAccelY)
+			: LocalAccelY * Params.AccelerationLeanMultiplier;
+		const float YawRateLean = Response.YawRateLean.IsValid()
+			? Response.YawRateLean.EvaluateMirrored(YawRateDegPerSec)
+			: YawRateDegPerSec * Params.YawRateLeanMultiplier;
+		const float MaxLeanAngle = Response.MaxLeanBySpeed.IsValid()
+			? Response.MaxLeanBySpeed.Evaluate(GroundSpeed)
+			: Params.MaxLeanAngle;
+		return Clamp(AccelerationLean + YawRateLean, -MaxLeanAngle, MaxLeanAngle);
+	}
+
+	// StepLean with the curve-shaped response.
+	inline float StepLean(float LeanAngle, float& LastYawDegrees, float CurrentYawDegrees, float LocalAccelY, float GroundSpeed, float DeltaSeconds,
+		const FLeanParams& Params, const FLeanResponse& Response)
+	{
+		const float YawDelta = FindDeltaAngleDegrees(LastYawDegrees, CurrentYawDegrees);
+		const float YawRateDegPerSec = YawDelta / Max(DeltaSeconds, KindaSmallNumber);
+		LastYawDegrees = CurrentYawDegrees;
+
+		const float TargetLeanAngle = ComputeTargetLean(LocalAccelY, YawRateDegPerSec, GroundSpeed, Params, Response);
+		return InterpTo(LeanAngle, TargetLeanAngle, DeltaSeconds, Params.LeanInterpSpeed);
+	}
+
+	struct FBoneOscillationParams
+	{
+		float PitchAmplitude = 10.0f;
+		float YawAmplitude = 10.0f;
+		float Speed = 1.5f;
+	};
+
+	// Procedural bone (head) rotation in degrees at accumulated time Time.
+	inline void ComputeBoneOscillation(float Time, const FBoneOscillationParams& Params, float& OutPitch, float& OutYaw)
+	{
+		OutPitch = std::sin(Time * Params.Speed) * Params.PitchAmplitude;
+		OutYaw = std::cos(Time * Params.Speed) * Params.YawAmplitude;
+	}
+
+	struct FSpringParams
+	{
+		// Angular frequency squared (1/s^2); 120 swings back and forth in about 0.6 s.
+		float Stiffness = 120.0f;
+		// 1 is critically damped; below it the spring overshoots and wobbles back.
+		float DampingRatio = 0.5f;
+	};
+
+	// One implicit Euler step of a damped spring pulling Position back to zero. Stable for any
+	// DeltaSeconds, so a character updated at a low rate settles instead of blowing up.
+	inline void StepSpring(float& Position, float& Velocity, float DeltaSeconds, const FSpringParams& Params)
+	{
+		const float Damping = 2.0f * Params.DampingRatio * std::sqrt(Params.Stiffness);
+		Velocity = (Velocity - DeltaSeconds * Params.Stiffness * Position)
+			/ (1.0f + DeltaSeconds * Damping + DeltaSeconds * DeltaSeconds * Params.Stiffness);
+		Position += DeltaSeconds * Velocity;
+	}
+}
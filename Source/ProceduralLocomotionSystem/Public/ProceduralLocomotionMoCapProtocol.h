@@ -0,0 +1,42 @@
+#pragma once
+
+// Wire format of the live MoCap stream read by FProceduralLocomotionMoCapReceiver. One UDP
+// datagram carries one complete frame for one subject: a packet header followed by NumBones
+// bone samples, little-endian. Bones are parent-relative and in the order of the receiving
+// anim instance's MoCapBoneNames; the sender and the anim instance agree on that list. Units
+// follow the engine: cm, and rotations as unit quaternions (X, Y, Z, W).
+//
+// Frames are self-contained, so a lost datagram costs one frame and never stalls the stream.
+// Tools/MoCapSender/mocap_sender.py is the reference sender. Any incompatible change must bump
+// Version.
+
+#include <cstdint>
+
+namespace ProceduralLocomotionMoCap
+{
+	constexpr uint32_t Magic = 0x4D534C50; // "PLSM" little-endian
+	constexpr uint32_t Version = 1;
+
+	// Keeps a full frame well inside a single unfragmented-on-loopback UDP datagram.
+	constexpr uint32_t MaxBones = 256;
+
+	struct FPacketHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t SubjectId;       // lets one sender drive several characters on different ports
+		uint32_t NumBones;
+		uint64_t FrameNumber;     // sender frame counter; older frames than the last applied are dropped
+		double CaptureTimeSeconds; // sender clock, for diagnostics only
+	};
+	static_assert(sizeof(FPacketHeader) == 32, "MoCap packet header changed; bump Version");
+
+	struct FBoneSample
+	{
+		float Translation[3];
+		float Rotation[4];
+	};
+	static_assert(sizeof(FBoneSample) == 28, "MoCap bone sample changed; bump Version");
+
+	constexpr uint32_t MaxPacketSize = sizeof(FPacketHeader) + MaxBones * sizeof(FBoneSample);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+
+#include <atomic>
+
+class FRunnableThread;
+class FSocket;
+
+// One decoded MoCap frame. BoneTransforms is sized once for the protocol's bone limit and
+// reused, so receiving and consuming frames never allocates.
+struct PROCEDURALLOCOMOTIONSYSTEM_API FProceduralLocomotionMoCapFrame
+{
+	FProceduralLocomotionMoCapFrame();
+
+	uint64 FrameNumber = 0;
+	double CaptureTimeSeconds = 0.0;
+	// FPlatformTime::Seconds() when the datagram was read, for latency measurement.
+	double ReceiveTimeSeconds = 0.0;
+	// Only the first NumBones entries of BoneTransforms are valid, in MoCapBoneNames order.
+	int32 NumBones = 0;
+	TArray<FTransform> BoneTransforms;
+
+	void CopyFrom(const FProceduralLocomotionMoCapFrame& Other);
+};
+
+/**
+ * Receives the live MoCap stream (see ProceduralLocomotionMoCapProtocol.h) on a dedicated
+ * thread and hands decoded frames to a single consumer, the anim worker evaluating
+ * FAnimNode_ProceduralMoCapPose, through a fixed-size single-producer/single-consumer ring.
+ *
+ * Neither side locks or allocates per frame. When the consumer falls behind and the ring is
+ * full, incoming frames are dropped rather than overwriting slots the consumer may be reading;
+ * the consumer always skips to the newest queued frame, so a stall costs at most one stale frame.
+ */
+class PROCEDURALLOCOMOTIONSYSTEM_API FProceduralLocomotionMoCapReceiver final : public FRunnable
+{
+public:
+	// SubjectId < 0 accepts any subject on the port.
+	FProceduralLocomotionMoCapReceiver(int32 InPort, int32 InSubjectId);
+	virtual ~FProceduralLocomotionMoCapReceiver() override;
+
+	// Binds the UDP port and starts the receive thread. Returns false if the port can't be bound.
+	bool Start();
+
+	// Consumer side; call from one thread at a time. Copies the newest frame received since the
+	// last call into OutFrame and returns true, or returns false if nothing new has arrived.
+	bool ConsumeLatest(FProceduralLocomotionMoCapFrame& OutFrame);
+
+	int32 GetPort() const { return Port; }
+	uint64 GetFramesReceived() const { return FramesReceived.load(std::memory_order_relaxed); }
+	// Frames lost to a full ring, or superseded by a newer frame before the consumer ran.
+	uint64 GetFramesDropped() const { return FramesDropped.load(std::memory_order_relaxed); }
+	uint64 GetPacketsRejected() const { return PacketsRejected.load(std::memory_order_relaxed); }
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	// Validates and decodes one datagram into the next free ring slot.
+	void HandleDatagram(int32 NumBytes);
+
+	static constexpr uint32 RingCapacity = 4;
+	static_assert((RingCapacity & (RingCapacity - 1)) == 0, "RingCapacity must be a power of two");
+
+	const int32 Port;
+	const int32 SubjectId;
+
+	FSocket* Socket = nullptr;
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bStopping{ false };
+
+	// Receive thread only.
+	TArray<uint8> ReceiveBuffer;
+	uint64 LastFrameNumber = 0;
+	bool bHasLastFrameNumber = false;
+
+	FProceduralLocomotionMoCapFrame Ring[RingCapacity];
+	// Free-running indices; WriteIndex is owned by the receive thread, ReadIndex by the consumer.
+	std::atomic<uint32> WriteIndex{ 0 };
+	std::atomic<uint32> ReadIndex{ 0 };
+
+	std::atomic<uint64> FramesReceived{ 0 };
+	std::atomic<uint64> FramesDropped{ 0 };
+	std::atomic<uint64> PacketsRejected{ 0 };
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ProceduralLocomotionPerfGateCommandlet.generated.h"
+
+/**
+ * Compares benchmark results from UProceduralLocomotionBenchmarkCommandlet against checked-in
+ * per-scenario baselines and fails when any stage regresses.
+ *
+ * A stage regresses when its median is more than -Threshold slower than the baseline median
+ * and the two distribution-free confidence intervals of the medians do not overlap, so a
+ * single noisy run cannot fail the gate on its own.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=ProceduralLocomotionPerfGate
+ *       -Result=<Result.json>[,<Result2.json>...] [-BaselineDir=<Dir>]
+ *       [-Threshold=0.05] [-Confidence=0.95] [-MinDeltaMs=0.002] [-UpdateBaseline]
+ */
+UCLASS()
+class UProceduralLocomotionPerfGateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UProceduralLocomotionPerfGateCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
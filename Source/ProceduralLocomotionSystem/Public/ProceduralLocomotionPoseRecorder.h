@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+
+#include <atomic>
+
+class FEvent;
+class FRunnableThread;
+class IFileHandle;
+
+// Bone hierarchy of a recorded mesh, sent once before the first frame that uses it.
+struct FProceduralLocomotionRecordedSkeleton
+{
+	uint32 SkeletonId = 0;
+	TArray<FName> BoneNames;
+	TArray<int32> ParentIndices;
+};
+
+// One captured frame, filled on the game thread. The arrays are reset rather than freed
+// between uses, so once the ring has warmed up capturing does not allocate.
+struct PROCEDURALLOCOMOTIONSYSTEM_API FProceduralLocomotionPoseRecordingFrame
+{
+	struct FCharacter
+	{
+		uint32 CharacterId = 0;
+		uint32 SkeletonId = 0;
+		// Range of this character's bones in BoneTransforms.
+		int32 FirstBone = 0;
+		int32 NumBones = 0;
+		FTransform ComponentTransform;
+		double FloorZ = 0.0;
+		// Zero while the character has no floor.
+		FVector FloorNormal = FVector::ZeroVector;
+	};
+
+	uint64 FrameNumber = 0;
+	double WorldTimeSeconds = 0.0;
+	TArray<FCharacter> Characters;
+	TArray<FTransform> BoneTransforms;
+	TArray<FProceduralLocomotionRecordedSkeleton> NewSkeletons;
+	TArray<TPair<uint32, FString>> NewCharacters;
+
+	void Reset();
+};
+
+/**
+ * Writes evaluated poses to a pose recording file (see ProceduralLocomotionPoseRecordingFormat.h)
+ * on a dedicated thread. The game thread fills frames from a fixed-size single-producer,
+ * single-consumer ring and never waits for the disk. The writer thread quantizes each frame,
+ * delta-encodes it against a prediction from the previous two and compresses about a second of
+ * frames per chunk.
+ *
+ * When the writer falls behind and the ring is full, BeginFrame returns null and the frame is
+ * counted as dropped; the recording stays valid, with a gap.
+ */
+class PROCEDURALLOCOMOTIONSYSTEM_API FProceduralLocomotionPoseRecorder final : public FRunnable
+{
+public:
+	FProceduralLocomotionPoseRecorder(const FString& InFilename, float InChunkSeconds);
+	virtual ~FProceduralLocomotionPoseRecorder() override;
+
+	// Creates the file and starts the writer thread. Returns false if either fails.
+	bool Start();
+
+	// Producer side, game thread only. BeginFrame returns the next free frame, reset, or null if
+	// the ring is full; SubmitFrame hands it to the writer.
+	FProceduralLocomotionPoseRecordingFrame* BeginFrame();
+	void SubmitFrame();
+
+	const FString& GetFilename() const { return Filename; }
+	uint64 GetFramesWritten() const { return FramesWritten.load(std::memory_order_relaxed); }
+	uint64 GetFramesDropped() const { return FramesDropped.load(std::memory_order_relaxed); }
+	uint64 GetBytesWritten() const { return BytesWritten.load(std::memory_order_relaxed); }
+	bool HasWriteError() const { return bWriteError.load(std::memory_order_relaxed); }
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	void EncodeFrame(const FProceduralLocomotionPoseRecordingFrame& Frame);
+	void AppendChannels(uint32 CharacterId, uint32 SkeletonId);
+	void FlushChunk();
+	bool WriteBlock(uint32 Type, const void* Prefix, uint32 PrefixSize, const void* Payload, uint32 PayloadSize);
+
+	static constexpr uint32 RingCapacity = 8;
+	static_assert((RingCapacity & (RingCapacity - 1)) == 0, "RingCapacity must be a power of two");
+
+	const FString Filename;
+	const float ChunkSeconds;
+
+	FRunnableThread* Thread = nullptr;
+	FEvent* FrameSubmitted = nullptr;
+	std::atomic<bool> bStopping{ false };
+
+	FProceduralLocomotionPoseRecordingFrame Ring[RingCapacity];
+	// Free-running indices; WriteIndex is owned by the game thread, ReadIndex by the writer.
+	std::atomic<uint32> WriteIndex{ 0 };
+	std::atomic<uint32> ReadIndex{ 0 };
+
+	std::atomic<uint64> FramesWritten{ 0 };
+	std::atomic<uint64> FramesDropped{ 0 };
+	std::atomic<uint64> BytesWritten{ 0 };
+	std::atomic<bool> bWriteError{ false };
+
+	// Writer thread only.
+	struct FPreviousChannels
+	{
+		uint32 SkeletonId = 0;
+		// Last frame's channels and their change from the frame before, for the prediction.
+		TArray<int32> Channels;
+		TArray<int32> Deltas;
+		bool bHasFrame = false;
+	};
+
+	TUniquePtr<IFileHandle> File;
+	TArray<double> ChunkTimes;
+	TArray<uint8> ChunkStream;
+	TArray<uint8> ChunkUncompressed;
+	TArray<uint8> CompressedChunk;
+	TArray<int32> Channels;
+	TMap<uint32, FPreviousChannels> PreviousChannels;
+	uint64 ChunkFirstFrame = 0;
+	double ChunkStartTime = 0.0;
+	double ChunkEndTime = 0.0;
+	uint32 ChunkNumFrames = 0;
+};
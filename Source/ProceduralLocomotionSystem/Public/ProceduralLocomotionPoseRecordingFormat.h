@@ -0,0 +1,162 @@
+#pragma once
+
+// File format of pose recordings written by FProceduralLocomotionPoseRecorder and read by
+// offline analysis tools (Tools/PoseRecording). Only fixed-size standard types are used so
+// other programs can include this header, or mirror it (as the Python reader does), without
+// the engine. All values are little-endian.
+//
+// A file is an FFileHeader followed by blocks, each an FBlockHeader and Size bytes of payload:
+//
+//  - Skeleton (before the first chunk that uses it): uint32 SkeletonId, uint32 NumBones,
+//    NumBones int32 parent indices (-1 for the root), then NumBones names, each a uint8 length
+//    and that many UTF-8 bytes.
+//  - Character (before the first chunk that records it): uint32 CharacterId, then a uint8
+//    length and that many UTF-8 bytes of actor name.
+//  - Chunk: an FChunkHeader followed by the zlib-compressed frame stream of the chunk.
+//
+// Chunks hold about a second of frames each and can be decoded on their own, so a reader
+// seeks by skipping from block header to block header and decompresses only the chunks it
+// needs. A recording cut short (crash, full disk) loses at most its last chunk.
+//
+// The frame stream of a chunk starts with NumFrames doubles, the world time of each frame.
+// Everything after them is varints, so readers can decode a chunk's values in one pass. Per
+// frame: the frame number minus the chunk's FirstFrame, NumCharacters, then per character its
+// CharacterId, SkeletonId and channels. Channels are quantized integers (see
+// ECharacterChannel and EBoneChannel), each stored as a zigzag varint of its residual against
+// a linear prediction from the same channel in that character's previous two frames of the
+// chunk: Predicted = Previous + (Previous - BeforePrevious). Smooth motion leaves residuals
+// near zero and still bones exactly zero, which the compressor then all but removes. The
+// first frame of a character in a chunk, or after its skeleton changed, is predicted as zero
+// and the second as a repeat of the first. All arithmetic wraps at 32 bits.
+//
+// Any incompatible change must bump Version.
+
+#include <cmath>
+#include <cstdint>
+
+namespace ProceduralLocomotionPoseRecording
+{
+	constexpr uint32_t Magic = 0x52534C50; // "PLSR" little-endian
+	constexpr uint32_t Version = 1;
+
+	constexpr uint32_t SkeletonBlock = 0x4B534C50;  // "PLSK"
+	constexpr uint32_t CharacterBlock = 0x41534C50; // "PLSA"
+	constexpr uint32_t ChunkBlock = 0x43534C50;     // "PLSC"
+
+	// Quantization steps: unit quaternion and normal components in 1/16383, distances in 0.01 cm.
+	constexpr float RotationScale = 16383.0f;
+	constexpr float DistanceScale = 100.0f;
+
+	struct FFileHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t HeaderSize;       // sizeof(FFileHeader); the first block starts here
+		uint32_t Reserved;
+		float RotationScale;
+		float DistanceScale;
+		double StartUnixSeconds;   // wall clock when recording started
+	};
+	static_assert(sizeof(FFileHeader) == 32, "Pose recording header changed; bump Version");
+
+	struct FBlockHeader
+	{
+		uint32_t Type;             // SkeletonBlock, CharacterBlock or ChunkBlock; skip unknown types
+		uint32_t Size;             // payload bytes following this header
+	};
+	static_assert(sizeof(FBlockHeader) == 8, "Pose recording block header changed; bump Version");
+
+	struct FChunkHeader
+	{
+		uint64_t FirstFrame;       // engine frame counter of the chunk's first frame
+		double StartTimeSeconds;   // world time of the first and last frames
+		double EndTimeSeconds;
+		uint32_t NumFrames;
+		uint32_t UncompressedSize; // bytes of the frame stream once decompressed
+	};
+	static_assert(sizeof(FChunkHeader) == 32, "Pose recording chunk header changed; bump Version");
+
+	// Per character, in world space. FloorNormal is zero while the character has no floor.
+	enum ECharacterChannel : uint32_t
+	{
+		ComponentLocationX, ComponentLocationY, ComponentLocationZ,
+		ComponentRotationX, ComponentRotationY, ComponentRotationZ,
+		FloorZ,
+		FloorNormalX, FloorNormalY, FloorNormalZ,
+		NumCharacterChannels
+	};
+
+	// Per bone, parent-relative as evaluated. Scale is not recorded.
+	enum EBoneChannel : uint32_t
+	{
+		RotationX, RotationY, RotationZ,
+		TranslationX, TranslationY, TranslationZ,
+		NumBoneChannels
+	};
+
+	inline uint32_t GetNumChannels(uint32_t NumBones)
+	{
+		return NumCharacterChannels + NumBones * NumBoneChannels;
+	}
+
+	inline int32_t QuantizeDistance(double Centimeters)
+	{
+		const double Scaled = std::round(Centimeters * DistanceScale);
+		return (int32_t)(Scaled < -2147483647.0 ? -2147483647.0 : (Scaled > 2147483647.0 ? 2147483647.0 : Scaled));
+	}
+
+	inline int32_t QuantizeUnit(double Value)
+	{
+		return (int32_t)std::round((Value < -1.0 ? -1.0 : (Value > 1.0 ? 1.0 : Value)) * RotationScale);
+	}
+
+	// Stores X, Y and Z of the quaternion with W made non-negative; readers rebuild W from them.
+	inline void QuantizeRotation(double X, double Y, double Z, double W, int32_t* Out)
+	{
+		const double Length = std::sqrt(X * X + Y * Y + Z * Z + W * W);
+		const double Sign = W < 0.0 ? -1.0 : 1.0;
+		const double Scale = Length > 0.0 ? Sign / Length : 0.0;
+		Out[0] = QuantizeUnit(X * Scale);
+		Out[1] = QuantizeUnit(Y * Scale);
+		Out[2] = QuantizeUnit(Z * Scale);
+	}
+
+	inline uint32_t ZigZag(int32_t Value)
+	{
+		return ((uint32_t)Value << 1) ^ (uint32_t)(Value >> 31);
+	}
+
+	inline int32_t UnZigZag(uint32_t Value)
+	{
+		return (int32_t)(Value >> 1) ^ -(int32_t)(Value & 1);
+	}
+
+	// Writes up to MaxVarintBytes bytes at Out; returns the byte after the last written.
+	constexpr uint32_t MaxVarintBytes = 5;
+	inline uint8_t* WriteVarint(uint8_t* Out, uint32_t Value)
+	{
+		while (Value >= 0x80)
+		{
+			*Out++ = (uint8_t)(Value | 0x80);
+			Value >>= 7;
+		}
+		*Out++ = (uint8_t)Value;
+		return Out;
+	}
+
+	// Returns the byte after the varint, or nullptr if it runs past End or is too long.
+	inline const uint8_t* ReadVarint(const uint8_t* In, const uint8_t* End, uint32_t& OutValue)
+	{
+		OutValue = 0;
+		for (uint32_t Shift = 0; Shift < 7 * MaxVarintBytes && In < End; Shift += 7)
+		{
+			const uint8_t Byte = *In++;
+			OutValue |= (uint32_t)(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				return In;
+			}
+		}
+		return nullptr;
+	}
+}
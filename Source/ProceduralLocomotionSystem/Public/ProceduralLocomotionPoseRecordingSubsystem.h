@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ProceduralLocomotionPoseRecordingSubsystem.generated.h"
+
+class AProceduralCharacter;
+class FProceduralLocomotionPoseRecorder;
+class USkeletalMesh;
+struct FProceduralLocomotionPoseRecordingFrame;
+
+/**
+ * Records the evaluated poses of selected procedural characters to a file for offline analysis
+ * of foot sliding, lean and ground penetration (Tools/PoseRecording reads it). Each captured
+ * frame holds, per character, the mesh component's world transform, the floor under the
+ * character, and every bone's parent-relative transform.
+ *
+ * Start with `pls.Recording.Start [File] [NameFilter]` and stop with `pls.Recording.Stop`.
+ * Capture runs on the game thread at `pls.Recording.Rate` and only copies transforms;
+ * quantization, delta encoding, compression and disk writes happen on the recorder's thread.
+ */
+UCLASS()
+class PROCEDURALLOCOMOTIONSYSTEM_API UProceduralLocomotionPoseRecordingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(AProceduralCharacter* Character);
+	void UnregisterCharacter(AProceduralCharacter* Character);
+
+	// Records registered characters whose name contains NameFilter, or all of them if it is empty,
+	// up to pls.Recording.MaxCharacters. An empty Filename writes a timestamped file under
+	// Saved/PoseRecordings.
+	bool StartRecording(const FString& Filename, const FString& NameFilter);
+	void StopRecording();
+	bool IsRecording() const { return Recorder.IsValid(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void CaptureFrame(FProceduralLocomotionPoseRecordingFrame& Frame);
+	uint32 GetSkeletonId(const USkeletalMesh* Mesh, FProceduralLocomotionPoseRecordingFrame& Frame);
+
+	TArray<TWeakObjectPtr<AProceduralCharacter>> Characters;
+
+	TUniquePtr<FProceduralLocomotionPoseRecorder> Recorder;
+	FString NameFilter;
+	// Skeletons and characters already written to the current recording.
+	TMap<TObjectKey<USkeletalMesh>, uint32> SkeletonIds;
+	TSet<uint32> RecordedCharacters;
+	float TimeUntilCapture = 0.0f;
+};
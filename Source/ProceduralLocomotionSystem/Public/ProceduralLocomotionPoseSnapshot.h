@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+class USkeletalMeshComponent;
+
+/**
+ * Double-buffered copy of a few bone transforms, published once per evaluation.
+ *
+ * The anim instance writes the back buffer after evaluation has completed and then bumps the
+ * sequence number, so readers always see the last finished frame and never wait on the
+ * parallel anim task. Reads are plain array indexing by slot; resolve a slot from a bone name
+ * once with FindSlot() and keep it.
+ *
+ * Reads from the game thread are always consistent. Reads from other threads copy the slot
+ * and retry if a publish happened mid-copy; the retry lands on the freshly completed buffer.
+ */
+class PROCEDURALLOCOMOTIONSYSTEM_API FProceduralLocomotionPoseSnapshot
+{
+public:
+	// Maps the bone names to mesh bone indices. Names missing from the mesh keep a slot that reads as invalid.
+	void Initialize(const TArray<FName>& InBoneNames, const USkeletalMeshComponent& MeshComp);
+	void Reset();
+
+	// Copies the component's current component-space pose into the back buffer and publishes it. Game thread only.
+	void Publish(const USkeletalMeshComponent& MeshComp, uint64 FrameNumber);
+
+	int32 FindSlot(FName BoneName) const { return BoneNames.IndexOfByKey(BoneName); }
+	int32 GetNumSlots() const { return BoneNames.Num(); }
+	FName GetBoneName(int32 Slot) const { return BoneNames.IsValidIndex(Slot) ? BoneNames[Slot] : NAME_None; }
+
+	// Number of frames published so far; 0 until the first evaluation has completed.
+	uint32 GetSequence() const { return Sequence.load(std::memory_order_acquire); }
+
+	// World-space (or component-space) transform of the slot in the last published frame.
+	bool GetBoneTransform(int32 Slot, FTransform& OutTransform, bool bWorldSpace = true, uint64* OutFrameNumber = nullptr) const;
+
+private:
+	struct FBuffer
+	{
+		TArray<FTransform> ComponentSpace;
+		FTransform ComponentToWorld;
+		uint64 FrameNumber = 0;
+	};
+
+	TArray<FName> BoneNames;
+	TArray<int32> BoneIndices;
+	FBuffer Buffers[2];
+	std::atomic<uint32> Sequence{ 0 };
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ProceduralLocomotionMath.h"
+#include "ProceduralLocomotionProfile.generated.h"
+
+class UAnimSequenceBase;
+class UCurveBase;
+class UCurveFloat;
+
+// A curve baked into uniform samples; immutable between bakes, so any thread may read it.
+struct FProceduralLocomotionCurveTable
+{
+	TArray<float> Values;
+	float MinX = 0.0f;
+	float InvStep = 0.0f;
+
+	// Samples Curve at NumSamples points from MinX (or the curve's first key if bFromZero is false) to its last key.
+	void Bake(const UCurveFloat* Curve, int32 NumSamples, bool bFromZero);
+
+	ProceduralLocomotionMath::FLookupTable GetTable() const;
+};
+
+// How well the lean parameters reproduce the reference clips they were fitted to.
+USTRUCT(BlueprintType)
+struct FProceduralLocomotionLeanFit
+{
+	GENERATED_BODY()
+
+	// RMS difference (degrees) between the simulated and the measured spine lean.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	float RMSErrorDegrees = 0.0f;
+
+	// Same error for the parameters the fit started from, for comparison.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	float PreviousRMSErrorDegrees = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	int32 NumClips = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	int32 NumSamples = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	FDateTime FitTime;
+};
+
+// A locomotion clip and the ground speeds it covers. Referenced softly: the streaming subsystem
+// loads it when a character using the profile is near a viewer.
+USTRUCT(BlueprintType)
+struct FProceduralLocomotionClip
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Clips")
+	FName State;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Clips")
+	TSoftObjectPtr<UAnimSequenceBase> Sequence;
+
+	// Ground speed range (cm/s) in which this clip plays; the upper bound is exclusive.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Clips", meta = (ClampMin = "0"))
+	float MinSpeed = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Clips", meta = (ClampMin = "0"))
+	float MaxSpeed = 0.0f;
+};
+
+/**
+ * Shared tuning for UProceduralLocomotionAnimInstance. When an anim instance has a profile, its
+ * values replace the anim instance's own defaults, so one asset can retune every character.
+ *
+ * The leaning values are normally fitted to MoCap by the ProceduralLocomotionLeanFit commandlet.
+ */
+UCLASS(BlueprintType)
+class PROCEDURALLOCOMOTIONSYSTEM_API UProceduralLocomotionProfile : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	float MaxLeanAngle = 20.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	float AccelerationLeanMultiplier = 0.02f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	float YawRateLeanMultiplier = 0.02f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	float LeanInterpSpeed = 6.0f;
+
+	// Optional response curves replacing the linear terms above. The acceleration (cm/s^2) and
+	// yaw rate (degrees/sec) curves map input magnitude to lean and are mirrored for negative input.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	TObjectPtr<UCurveFloat> AccelerationLeanCurve;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	TObjectPtr<UCurveFloat> YawRateLeanCurve;
+
+	// Ground speed (cm/s) -> maximum lean (degrees); replaces MaxLeanAngle.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	TObjectPtr<UCurveFloat> MaxLeanBySpeedCurve;
+
+	// Samples per curve when baking; inputs between samples are interpolated linearly.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning", meta = (ClampMin = "2", ClampMax = "4096"))
+	int32 LeanCurveSamples = 128;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Locomotion|Leaning")
+	FProceduralLocomotionLeanFit LeanFit;
+
+	// Clips of this archetype by speed. Until a clip is resident the procedural walk cycle plays.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion|Clips")
+	TArray<FProceduralLocomotionClip> LocomotionClips;
+
+	// Clip whose speed range contains Speed, or null.
+	const FProceduralLocomotionClip* FindClipForSpeed(float Speed) const;
+
+	ProceduralLocomotionMath::FLeanParams GetLeanParams() const;
+	void SetLeanParams(const ProceduralLocomotionMath::FLeanParams& Params);
+
+	// Views of the baked curves; valid until the profile is rebaked or destroyed.
+	ProceduralLocomotionMath::FLeanResponse GetLeanResponse() const;
+
+	// Rebuilds the lookup tables from the curves. Runs on load, after edits to the profile and,
+	// in the editor, after edits to the curve assets themselves. A profile made with NewObject
+	// never loads, so whoever sets its curves calls this.
+	void BakeLeanCurves();
+
+	virtual void PostLoad() override;
+	virtual void BeginDestroy() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	void BakeTables();
+
+#if WITH_EDITOR
+	// Follows the curve assets' OnUpdateCurve, so editing a curve rebakes without touching the profile.
+	void BindCurveUpdates();
+	void UnbindCurveUpdates();
+	void HandleCurveUpdated(UCurveBase* Curve, EPropertyChangeType::Type ChangeType);
+
+	TArray<TWeakObjectPtr<UCurveFloat>> BoundCurves;
+#endif
+
+	FProceduralLocomotionCurveTable AccelerationLeanTable;
+	FProceduralLocomotionCurveTable YawRateLeanTable;
+	FProceduralLocomotionCurveTable MaxLeanBySpeedTable;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralLocomotionAnimInstance.h"
+#include "UObject/SoftObjectPath.h"
+
+// One recorded character: where its layers started and the input of every update after that.
+struct PROCEDURALLOCOMOTIONSYSTEM_API FProceduralLocomotionReplayTrack
+{
+	FString CharacterName;
+	FSoftClassPath CharacterClass;
+	FProceduralLocomotionAnimState InitialState;
+
+	// Replay frame of each update; frames a character skipped (update rate optimization) are absent.
+	TArray<int32> Frames;
+	TArray<FProceduralLocomotionAnimInput> Inputs;
+
+	// Recorded with pls.Replay.Verify only: the pose snapshot bones in component space
+	// (VerifyBoneNames.Num() per update) and the layer state after each update.
+	TArray<FName> VerifyBoneNames;
+	TArray<FTransform> VerifyPoses;
+	TArray<FProceduralLocomotionAnimState> VerifyStates;
+
+	bool HasVerification() const { return VerifyStates.Num() > 0; }
+	int32 GetFirstFrame() const { return Frames.Num() > 0 ? Frames[0] : INDEX_NONE; }
+};
+
+/**
+ * Input-only replay of procedural characters. Instead of bone transforms it stores each
+ * character's layer state when recording began and the few values every anim update reads
+ * (FProceduralLocomotionAnimInput); playback re-runs leaning, hit reactions, the bone oscillator
+ * and foot IK from them. Saved as one zlib-compressed archive.
+ */
+struct PROCEDURALLOCOMOTIONSYSTEM_API FProceduralLocomotionReplay
+{
+	static constexpr uint32 Magic = 0x52504C50; // "PLPR"
+	static constexpr uint32 Version = 6;
+
+	int32 NumFrames = 0;
+	TArray<FProceduralLocomotionReplayTrack> Tracks;
+
+	void Reset();
+
+	bool SaveToFile(const FString& Filename) const;
+	// Rejects files whose per-track arrays disagree in length.
+	bool LoadFromFile(const FString& Filename);
+
+	void Serialize(FArchive& Ar);
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralLocomotionReplay.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProceduralLocomotionReplaySubsystem.generated.h"
+
+class AProceduralCharacter;
+class UProceduralLocomotionAnimInstance;
+
+/**
+ * Records input-only replays of procedural characters and plays them back by re-simulating
+ * their procedural layers.
+ *
+ * Recording stores, per character, the layer state when it was first seen and the input of each
+ * anim update (see FProceduralLocomotionReplay). Playback spawns a copy of every recorded
+ * character, puts its anim instance under replay control, and each frame moves it to the
+ * recorded transform and pushes the recorded input, so leaning, hit reactions, the bone
+ * oscillator and foot IK run again from the same values. Playback advances one recorded frame
+ * per game frame.
+ *
+ * With `pls.Replay.Verify 1` while recording, the pose snapshot bones and layer state after
+ * every update are stored too, and playback compares the re-simulated ones against them and logs
+ * the first divergence per character. Anything that reaches the layers without going through
+ * FProceduralLocomotionAnimInput shows up there.
+ *
+ *   pls.Replay.Record [File] / pls.Replay.Stop / pls.Replay.Play File
+ */
+UCLASS()
+class PROCEDURALLOCOMOTIONSYSTEM_API UProceduralLocomotionReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(AProceduralCharacter* Character);
+	void UnregisterCharacter(AProceduralCharacter* Character);
+
+	// An empty Filename writes a timestamped file under Saved/Replays.
+	bool StartRecording(const FString& Filename);
+	bool StartPlayback(const FString& Filename);
+	// Ends recording (and saves) or playback.
+	void Stop();
+
+	bool IsRecording() const { return bRecording; }
+	bool IsPlaying() const { return bPlaying; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FRecordedCharacter
+	{
+		TWeakObjectPtr<AProceduralCharacter> Character;
+		int32 TrackIndex = INDEX_NONE;
+		uint32 LastUpdateCount = 0;
+	};
+
+	struct FPlaybackCharacter
+	{
+		TWeakObjectPtr<AProceduralCharacter> Character;
+		int32 NextInput = 0;
+		// Update count after the last pushed input, to tell whether it was consumed.
+		uint32 ExpectedUpdateCount = 0;
+		bool bPendingVerify = false;
+		bool bDiverged = false;
+	};
+
+	void BeginRecordingCharacter(AProceduralCharacter* Character);
+	void TickRecording();
+	void TickPlayback();
+
+	AProceduralCharacter* SpawnPlaybackCharacter(const FProceduralLocomotionReplayTrack& Track);
+	void PushNextInput(FPlaybackCharacter& Playback, const FProceduralLocomotionReplayTrack& Track);
+	void VerifyUpdate(FPlaybackCharacter& Playback, const FProceduralLocomotionReplayTrack& Track);
+
+	static UProceduralLocomotionAnimInstance* GetAnimInstance(const AProceduralCharacter* Character);
+
+	TArray<TWeakObjectPtr<AProceduralCharacter>> Characters;
+
+	FProceduralLocomotionReplay Replay;
+	FString ReplayFilename;
+	int32 Frame = 0;
+
+	bool bRecording = false;
+	bool bVerifyRecording = false;
+	TArray<FRecordedCharacter> Recorded;
+
+	bool bPlaying = false;
+	TArray<FPlaybackCharacter> Playbacks;
+	int32 VerifiedUpdates = 0;
+	int32 DivergedTracks = 0;
+	float MaxPoseError = 0.0f;
+};
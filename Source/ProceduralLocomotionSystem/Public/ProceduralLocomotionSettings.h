@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "ProceduralLocomotionSettings.generated.h"
+
+class UAnimInstance;
+class USkeletalMesh;
+
+/**
+ * Project settings for the procedural locomotion module (Project Settings > Game > Procedural Locomotion).
+ *
+ * The prewarm lists are loaded asynchronously once the engine is up and again on every map
+ * load, and their skeleton/mesh bone mappings are built ahead of the first spawn. The streaming
+ * values govern the profile clips that UProceduralLocomotionStreamingSubsystem loads on demand,
+ * and the ground query values the foot IK traces UProceduralLocomotionGroundQuerySubsystem runs.
+ */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "Procedural Locomotion"))
+class PROCEDURALLOCOMOTIONSYSTEM_API UProceduralLocomotionSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UProceduralLocomotionSettings();
+
+	virtual FName GetCategoryName() const override { return TEXT("Game"); }
+
+	static const UProceduralLocomotionSettings* Get() { return GetDefault<UProceduralLocomotionSettings>(); }
+
+	// Mesh given to AProceduralCharacter instances that have none assigned.
+	UPROPERTY(config, EditAnywhere, Category = "Defaults")
+	TSoftObjectPtr<USkeletalMesh> DefaultCharacterMesh;
+
+	UPROPERTY(config, EditAnywhere, Category = "Prewarm")
+	bool bPrewarmOnStartup = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "Prewarm")
+	bool bPrewarmOnMapLoad = true;
+
+	// Anim classes (native or Anim Blueprints) whose class default objects are created up front.
+	UPROPERTY(config, EditAnywhere, Category = "Prewarm")
+	TArray<TSoftClassPtr<UAnimInstance>> PrewarmAnimClasses;
+
+	// Meshes whose skeleton linkup and per-LOD required-bone containers are built up front.
+	UPROPERTY(config, EditAnywhere, Category = "Prewarm")
+	TArray<TSoftObjectPtr<USkeletalMesh>> PrewarmMeshes;
+
+	// Other locomotion data (LOD settings, profiles, tables) to have resident before the first spawn.
+	UPROPERTY(config, EditAnywhere, Category = "Prewarm", meta = (AllowedClasses = "/Script/Engine.DataAsset"))
+	TArray<FSoftObjectPath> PrewarmDataAssets;
+
+	// Load profile locomotion clips on demand. When off, clips play only if something else loaded them.
+	UPROPERTY(config, EditAnywhere, Category = "Streaming")
+	bool bStreamLocomotionClips = true;
+
+	// Ceiling on streamed clip memory. Clips no character wants are evicted least recently used first.
+	UPROPERTY(config, EditAnywhere, Category = "Streaming", meta = (ClampMin = "1", Units = "Megabytes"))
+	float StreamingBudgetMB = 256.0f;
+
+	// Characters within this distance of a viewer, now or after StreamPredictionSeconds at their
+	// current velocity, stream their clips.
+	UPROPERTY(config, EditAnywhere, Category = "Streaming", meta = (ClampMin = "0", Units = "Centimeters"))
+	float StreamInDistance = 6000.0f;
+
+	// How far ahead position and speed are extrapolated, so clips load before they are needed.
+	UPROPERTY(config, EditAnywhere, Category = "Streaming", meta = (ClampMin = "0", Units = "Seconds"))
+	float StreamPredictionSeconds = 2.0f;
+
+	// Seconds between passes over the characters.
+	UPROPERTY(config, EditAnywhere, Category = "Streaming", meta = (ClampMin = "0", Units = "Seconds"))
+	float StreamUpdateInterval = 0.25f;
+
+	// Run foot IK ground traces through the budgeted scheduler. When off, each foot traces as soon as it needs ground.
+	UPROPERTY(config, EditAnywhere, Category = "Ground Queries")
+	bool bScheduleGroundQueries = true;
+
+	// Ground traces run per frame at most; the rest wait, highest priority first.
+	UPROPERTY(config, EditAnywhere, Category = "Ground Queries", meta = (ClampMin = "1"))
+	int32 GroundQueryBudget = 64;
+
+	// Priority is the sum of these weights times screen size (0-1), nearness to a viewer (1 at the
+	// viewer, 0 from GroundQueryFarDistance on), foot urgency (0-1) and seconds waited.
+	UPROPERTY(config, EditAnywhere, Category = "Ground Queries", meta = (ClampMin = "0"))
+	float GroundQueryScreenSizeWeight = 2.0f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Ground Queries", meta = (ClampMin = "0"))
+	float GroundQueryDistanceWeight = 1.0f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Ground Queries", meta = (ClampMin = "0"))
+	float GroundQueryUrgencyWeight = 2.0f;
+
+	// Per second waited, so every query is eventually served.
+	UPROPERTY(config, EditAnywhere, Category = "Ground Queries", meta = (ClampMin = "0"))
+	float GroundQueryStalenessWeight = 10.0f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Ground Queries", meta = (ClampMin = "1", Units = "Centimeters"))
+	float GroundQueryFarDistance = 5000.0f;
+};
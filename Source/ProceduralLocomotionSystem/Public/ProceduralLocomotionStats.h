@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("ProceduralLocomotion"), STATGROUP_ProceduralLocomotion, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Locomotion"), STAT_PLS_Locomotion, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leaning"), STAT_PLS_Leaning, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Foot IK"), STAT_PLS_FootIK, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Procedural Bone"), STAT_PLS_ProceduralBone, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Marker Sync"), STAT_PLS_MarkerSync, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+
+// Prewarm results persist until the next pass, so they are accumulators rather than per-frame counters.
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Prewarm"), STAT_PLS_Prewarm, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Prewarm Load (ms)"), STAT_PLS_PrewarmLoadMs, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Prewarm Build (ms)"), STAT_PLS_PrewarmBuildMs, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Prewarmed Anim Classes"), STAT_PLS_PrewarmAnimClasses, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Prewarmed Meshes"), STAT_PLS_PrewarmMeshes, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Prewarmed Bone Containers"), STAT_PLS_PrewarmBoneContainers, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Prewarmed Data Assets"), STAT_PLS_PrewarmDataAssets, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+
+// Streamed clips are resident across frames, so these are accumulators set by each streaming pass.
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Streamed Clips Resident (MB)"), STAT_PLS_StreamingResidentMB, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Streamed Clips Budget (MB)"), STAT_PLS_StreamingBudgetMB, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Streamed Clips Resident"), STAT_PLS_StreamingResidentClips, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Streamed Clip Loads Pending"), STAT_PLS_StreamingPendingLoads, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Streamed Clip Evictions"), STAT_PLS_StreamingEvictions, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+
+// Game-thread cost of copying poses into the recorder; encoding and writing run on its own thread.
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pose Recording Capture"), STAT_PLS_PoseRecordingCapture, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+// Totals for the current recording, so these are accumulators.
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Pose Recording (MB)"), STAT_PLS_PoseRecordingMB, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pose Recording Frames Dropped"), STAT_PLS_PoseRecordingFramesDropped, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+
+// Idle characters whose aim changed this frame: rotations held back for turn-in-place, and the
+// discrete actor turns taken once the aim got past the threshold.
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Idle Rotations Held"), STAT_PLS_IdleRotationsHeld, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Turn In Place Steps"), STAT_PLS_TurnInPlaceSteps, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+
+// Foot IK ground lookups this frame: line traces, and plants reused because the foot hadn't stepped.
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Foot IK Traces"), STAT_PLS_FootTraces, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Foot Plants Reused"), STAT_PLS_FootPlantsReused, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+
+// Set by each ground query scheduler pass, so these are accumulators.
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Ground Query Queue Depth"), STAT_PLS_GroundQueryQueueDepth, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Ground Queries Served"), STAT_PLS_GroundQueriesServed, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Ground Query Budget Used (%)"), STAT_PLS_GroundQueryBudgetUsed, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Ground Query Average Age (ms)"), STAT_PLS_GroundQueryAverageAgeMs, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Ground Query Max Age (ms)"), STAT_PLS_GroundQueryMaxAgeMs, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+// Feet waiting on a scheduled query this frame, placed on their last plant's surface instead.
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Foot Plants Extrapolated"), STAT_PLS_FootPlantsExtrapolated, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+
+// Receive-to-consume age of the newest live MoCap frame applied this frame.
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("MoCap Latency (ms)"), STAT_PLS_MoCapLatencyMs, STATGROUP_ProceduralLocomotion, PROCEDURALLOCOMOTIONSYSTEM_API);
+
+// Stages of the anim instance update that the benchmark and perf gate report on individually.
+enum class EProceduralLocomotionStage : uint8
+{
+	Locomotion,
+	Leaning,
+	FootIK,
+	ProceduralBone,
+	MarkerSync,
+	Num
+};
+
+// Lightweight per-stage cycle accumulator. Unlike the stat system this can be read back
+// programmatically, so headless benchmarks can attribute cost to each stage. It is off by
+// default and costs a single relaxed load per scope when disabled.
+namespace ProceduralLocomotionStageTiming
+{
+	PROCEDURALLOCOMOTIONSYSTEM_API const TCHAR* GetStageName(EProceduralLocomotionStage Stage);
+
+	PROCEDURALLOCOMOTIONSYSTEM_API bool IsCaptureEnabled();
+	PROCEDURALLOCOMOTIONSYSTEM_API void SetCaptureEnabled(bool bEnabled);
+
+	PROCEDURALLOCOMOTIONSYSTEM_API void Reset();
+	PROCEDURALLOCOMOTIONSYSTEM_API void Accumulate(EProceduralLocomotionStage Stage, uint64 Cycles);
+
+	// Total cycles recorded for the stage since the last Reset().
+	PROCEDURALLOCOMOTIONSYSTEM_API uint64 GetCycles(EProceduralLocomotionStage Stage);
+}
+
+struct FProceduralLocomotionStageScope
+{
+	explicit FProceduralLocomotionStageScope(EProceduralLocomotionStage InStage)
+		: Stage(InStage)
+		, StartCycles(ProceduralLocomotionStageTiming::IsCaptureEnabled() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FProceduralLocomotionStageScope()
+	{
+		if (StartCycles != 0)
+		{
+			ProceduralLocomotionStageTiming::Accumulate(Stage, FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+
+private:
+	EProceduralLocomotionStage Stage;
+	uint64 StartCycles;
+};
+
+// Times a stage for both `stat ProceduralLocomotion` and the benchmark accumulator.
+#define PLS_SCOPE_STAGE(StageName) \
+	SCOPE_CYCLE_COUNTER(STAT_PLS_##StageName); \
+	FProceduralLocomotionStageScope PREPROCESSOR_JOIN(PLSStageScope_, __LINE__)(EProceduralLocomotionStage::StageName)
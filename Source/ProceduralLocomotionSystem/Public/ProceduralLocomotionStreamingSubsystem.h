@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProceduralLocomotionStreamingSubsystem.generated.h"
+
+class AProceduralCharacter;
+class UAnimSequenceBase;
+
+// State of the clip cache after the last streaming pass.
+struct FProceduralLocomotionStreamingReport
+{
+	int64 BudgetBytes = 0;
+	int64 ResidentBytes = 0;
+	int64 PeakResidentBytes = 0;
+	int32 NumResident = 0;
+	int32 NumWanted = 0;
+	int32 NumPending = 0;
+	// Wanted clips not requested because the budget was full of wanted clips.
+	int32 NumDenied = 0;
+	int32 NumEvicted = 0;
+	// Wanted clips alone exceed the budget.
+	bool bOverBudget = false;
+};
+
+/**
+ * Streams the locomotion clips of UProceduralLocomotionProfile assets in and out based on which
+ * characters are near a viewer.
+ *
+ * Every StreamUpdateInterval, each registered character within StreamInDistance of a rendered
+ * view wants the clip for its current ground speed. The check runs on its position now and on
+ * its position after StreamPredictionSeconds at its current velocity. The character also wants
+ * every clip between its current speed and the speed its acceleration leads to. Missing clips are
+ * requested asynchronously, nearest characters first. Clips nobody wants stay cached until room
+ * is needed, then are released least recently wanted first. Loads are refused rather than going
+ * over StreamingBudgetMB. Until its clip is resident a character plays the procedural walk cycle.
+ */
+UCLASS()
+class PROCEDURALLOCOMOTIONSYSTEM_API UProceduralLocomotionStreamingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(AProceduralCharacter* Character);
+	void UnregisterCharacter(AProceduralCharacter* Character);
+
+	// The clip if this subsystem holds it resident, otherwise null.
+	UAnimSequenceBase* GetResidentClip(const TSoftObjectPtr<UAnimSequenceBase>& Clip) const;
+
+	const FProceduralLocomotionStreamingReport& GetReport() const { return Report; }
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FClipEntry
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		// Set once the load completes; kept alive by Handle.
+		UAnimSequenceBase* Sequence = nullptr;
+		int64 Bytes = 0;
+		double LastWantedTime = 0.0;
+		float Priority = 0.0f;
+		bool bWanted = false;
+	};
+
+	void UpdateWantedClips(double Now);
+	void RequestLoads();
+	void HandleLoaded(FSoftObjectPath Path);
+
+	// Releases the least recently wanted clip nobody wants now; false if there is none.
+	bool EvictOne(int64& OutFreedBytes);
+	void Release(const FSoftObjectPath& Path);
+	void ReleaseAll();
+	int64 GetResidentBytes() const;
+	void UpdateReport();
+
+	TArray<TWeakObjectPtr<AProceduralCharacter>> Characters;
+	TMap<FSoftObjectPath, FClipEntry> Clips;
+	FStreamableManager StreamableManager;
+	FProceduralLocomotionStreamingReport Report;
+	float TimeUntilUpdate = 0.0f;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+// Shared-memory layout of the live locomotion telemetry ring, written by
+// UProceduralLocomotionTelemetrySubsystem and mapped read-only by external tools
+// (Tools/TelemetryViewer). Only fixed-size standard types are used so other processes can
+// include this header, or mirror it (as the Python viewer does), without the engine.
+//
+// The region is a header followed by FrameCapacity frame slots. Each slot holds a frame
+// header and RecordCapacity records. The writer fills slot (FrameIndex % FrameCapacity):
+// it makes the slot's Sequence odd, writes the frame, makes Sequence even again
+// (2 * FrameIndex + 2) and only then advances the header's FramesWritten. Readers copy a
+// slot and keep it only if Sequence was the same even value before and after the copy. The
+// writer never waits for readers; a reader that falls FrameCapacity frames behind simply
+// sees newer data.
+//
+// Any incompatible change to these structs must bump Version.
+
+#include <cstdint>
+
+namespace ProceduralLocomotionTelemetry
+{
+	constexpr uint32_t Magic = 0x54534C50; // "PLST" little-endian
+	constexpr uint32_t Version = 1;
+
+	struct FRegionHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t HeaderSize;     // sizeof(FRegionHeader); frame slots start here
+		uint32_t FrameSlotSize;  // sizeof(FFrameHeader) + RecordCapacity * sizeof(FCharacterRecord)
+		uint32_t FrameCapacity;
+		uint32_t RecordCapacity;
+		uint32_t RecordSize;     // sizeof(FCharacterRecord)
+		uint32_t WriterProcessId;
+		uint64_t FramesWritten;  // frames fully published; the newest is FramesWritten - 1
+		uint64_t RecordsDropped; // characters beyond RecordCapacity, summed over all frames
+		uint8_t Reserved[16];
+	};
+	static_assert(sizeof(FRegionHeader) == 64, "Telemetry header layout changed; bump Version");
+
+	struct FFrameHeader
+	{
+		uint64_t Sequence;       // odd while being written
+		uint64_t FrameNumber;    // engine frame counter
+		double WorldTimeSeconds;
+		uint32_t NumRecords;
+		uint32_t Reserved;
+	};
+	static_assert(sizeof(FFrameHeader) == 32, "Telemetry frame layout changed; bump Version");
+
+	enum ECharacterFlags : uint32_t
+	{
+		Accelerating = 1u << 0,
+		LeaningLayer = 1u << 1,
+		FootIKLayer = 1u << 2,
+		ProceduralBoneLayer = 1u << 3,
+	};
+
+	// One character in one frame. Units follow the engine: cm, cm/s, degrees.
+	struct FCharacterRecord
+	{
+		uint32_t CharacterId;    // stable for the character's lifetime (actor unique id)
+		uint32_t Flags;          // ECharacterFlags
+		float Position[3];
+		float Velocity[3];
+		float Yaw;
+		float GroundSpeed;
+		float Direction;
+		float LeanAngle;
+		float LocomotionPhase;   // stride phase in [0, 1)
+		float LeftFootOffset;
+		float RightFootOffset;
+		float PelvisOffset;
+		float FootIKAlpha;
+		float Reserved;
+	};
+	static_assert(sizeof(FCharacterRecord) == 72, "Telemetry record layout changed; bump Version");
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProceduralLocomotionTelemetrySubsystem.generated.h"
+
+class AProceduralCharacter;
+
+/**
+ * Publishes per-character locomotion state into a named shared-memory ring every frame, for
+ * external analysis tools such as Tools/TelemetryViewer. See ProceduralLocomotionTelemetryLayout.h
+ * for the layout and the reader protocol.
+ *
+ * Off by default; enable with `pls.Telemetry.Enable 1`. The writer only ever writes into its
+ * own mapping on the game thread, so it never blocks on readers or on the network.
+ */
+UCLASS()
+class PROCEDURALLOCOMOTIONSYSTEM_API UProceduralLocomotionTelemetrySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(AProceduralCharacter* Character);
+	void UnregisterCharacter(AProceduralCharacter* Character);
+
+	bool IsPublishing() const { return Region != nullptr; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	bool MapRegion();
+	void UnmapRegion();
+	void PublishFrame();
+
+	TArray<TWeakObjectPtr<AProceduralCharacter>> Characters;
+
+	FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+	FString RegionName;
+	uint32 FrameCapacity = 0;
+	uint32 RecordCapacity = 0;
+	uint64 FramesWritten = 0;
+	uint64 RecordsDropped = 0;
+};
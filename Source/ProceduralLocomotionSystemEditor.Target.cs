@@ -8,6 +8,6 @@ public class ProceduralLocomotionSystemEditorTarget : TargetRules
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V5;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_0;
-		ExtraModuleNames.AddRange(new string[] { "ProceduralLocomotionSystem" });
+		ExtraModuleNames.AddRange(new string[] { "ProceduralLocomotionSystem", "ProceduralLocomotionSystemEditor" });
 	}
 }
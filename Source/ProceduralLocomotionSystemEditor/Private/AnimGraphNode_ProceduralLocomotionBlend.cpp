@@ -0,0 +1,51 @@
+#include "AnimGraphNode_ProceduralLocomotionBlend.h"
+
+#include "Animation/BlendSpace.h"
+#include "Kismet2/CompilerResultsLog.h"
+
+#define LOCTEXT_NAMESPACE "ProceduralLocomotionSystemEditor"
+
+FText UAnimGraphNode_ProceduralLocomotionBlend::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+	if (Node.BlendSpace && TitleType != ENodeTitleType::ListView && TitleType != ENodeTitleType::MenuTitle)
+	{
+		return FText::Format(LOCTEXT("ProceduralLocomotionBlend_TitleWithAsset", "Procedural Locomotion Blend\n{0}"),
+			FText::FromString(Node.BlendSpace->GetName()));
+	}
+	return LOCTEXT("ProceduralLocomotionBlend_Title", "Procedural Locomotion Blend");
+}
+
+FText UAnimGraphNode_ProceduralLocomotionBlend::GetTooltipText() const
+{
+	return LOCTEXT("ProceduralLocomotionBlend_Tooltip",
+		"Plays a locomotion blend space from speed and direction through a weight grid precomputed at load "
+		"and shared across characters. Samples follow the anim instance's locomotion phase.");
+}
+
+FLinearColor UAnimGraphNode_ProceduralLocomotionBlend::GetNodeTitleColor() const
+{
+	return FLinearColor(0.2f, 0.8f, 0.2f);
+}
+
+FString UAnimGraphNode_ProceduralLocomotionBlend::GetNodeCategory() const
+{
+	return TEXT("Procedural Locomotion");
+}
+
+void UAnimGraphNode_ProceduralLocomotionBlend::ValidateAnimNodeDuringCompilation(USkeleton* ForSkeleton, FCompilerResultsLog& MessageLog)
+{
+	Super::ValidateAnimNodeDuringCompilation(ForSkeleton, MessageLog);
+
+	if (!Node.BlendSpace)
+	{
+		MessageLog.Warning(*LOCTEXT("ProceduralLocomotionBlend_NoBlendSpace", "@@ has no blend space and outputs the reference pose.").ToString(), this);
+	}
+}
+
+void UAnimGraphNode_ProceduralLocomotionBlend::PreloadRequiredAssets()
+{
+	PreloadObject(Node.BlendSpace);
+	Super::PreloadRequiredAssets();
+}
+
+#undef LOCTEXT_NAMESPACE
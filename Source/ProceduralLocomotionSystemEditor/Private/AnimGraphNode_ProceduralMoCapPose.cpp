@@ -0,0 +1,27 @@
+#include "AnimGraphNode_ProceduralMoCapPose.h"
+
+#define LOCTEXT_NAMESPACE "ProceduralLocomotionSystemEditor"
+
+FText UAnimGraphNode_ProceduralMoCapPose::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+	return LOCTEXT("ProceduralMoCapPose_Title", "Procedural MoCap Pose");
+}
+
+FText UAnimGraphNode_ProceduralMoCapPose::GetTooltipText() const
+{
+	return LOCTEXT("ProceduralMoCapPose_Tooltip",
+		"Applies the live MoCap stream received by the Procedural Locomotion anim instance over the input pose. "
+		"Place before leaning and foot IK so they layer on top.");
+}
+
+FLinearColor UAnimGraphNode_ProceduralMoCapPose::GetNodeTitleColor() const
+{
+	return FLinearColor(0.7f, 0.2f, 0.9f);
+}
+
+FString UAnimGraphNode_ProceduralMoCapPose::GetNodeCategory() const
+{
+	return TEXT("Procedural Locomotion");
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,417 @@
+#include "ProceduralLocomotionCompressionCommandlet.h"
+
+#include "ProceduralLocomotionCommandletUtils.h"
+#include "Animation/AnimBoneCompressionSettings.h"
+#include "Animation/AnimCompress_BitwiseCompressOnly.h"
+#include "Animation/AnimCompress_PerTrackCompression.h"
+#include "Animation/AnimCompress_RemoveLinearKeys.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProceduralLocomotionCompression, Log, All);
+
+namespace ProceduralLocomotionCompression
+{
+	struct FCandidate
+	{
+		FString Name;
+		// Null for the clip's own settings.
+		UAnimBoneCompressionSettings* Settings = nullptr;
+		// Transient until chosen with -Apply; asset candidates are applied as they are.
+		bool bBuiltIn = false;
+	};
+
+	struct FTrial
+	{
+		int64 Bytes = 0;
+		float MaxErrorCm = 0.0f;
+		FName WorstEffector;
+		double DecodeMicroseconds = 0.0;
+	};
+
+	struct FClipResult
+	{
+		UAnimSequence* Clip = nullptr;
+		UAnimBoneCompressionSettings* OriginalSettings = nullptr;
+
+		// Root-to-effector bone chains for the clip's skeleton.
+		TArray<FName> EffectorNames;
+		TArray<TArray<int32>> EffectorChains;
+		int32 NumBones = 0;
+		int32 NumSamples = 0;
+		float SampleInterval = 0.0f;
+
+		// Component-space effector positions from the raw data, [Sample * NumEffectors + Effector].
+		TArray<FVector> RawPositions;
+
+		TArray<FTrial> Trials;
+		int32 Chosen = INDEX_NONE;
+	};
+
+	static UAnimBoneCompressionSettings* MakeSettings(const TCHAR* Name, UAnimBoneCompressionCodec* (*MakeCodec)(UObject*))
+	{
+		UAnimBoneCompressionSettings* Settings = NewObject<UAnimBoneCompressionSettings>(GetTransientPackage(), *FString::Printf(TEXT("ABC_PLS_%s"), Name));
+		Settings->Codecs.Add(MakeCodec(Settings));
+		return Settings;
+	}
+
+	static TArray<FCandidate> MakeBuiltInCandidates()
+	{
+		TArray<FCandidate> Candidates;
+		auto Add = [&Candidates](const TCHAR* Name, UAnimBoneCompressionCodec* (*MakeCodec)(UObject*))
+		{
+			Candidates.Add({ Name, MakeSettings(Name, MakeCodec), true });
+		};
+
+		Add(TEXT("Bitwise_Float96"), [](UObject* Outer) -> UAnimBoneCompressionCodec*
+		{
+			UAnimCompress_BitwiseCompressOnly* Codec = NewObject<UAnimCompress_BitwiseCompressOnly>(Outer);
+			Codec->RotationCompressionFormat = ACF_Float96NoW;
+			Codec->TranslationCompressionFormat = ACF_Float96NoW;
+			return Codec;
+		});
+		Add(TEXT("Bitwise_Fixed48"), [](UObject* Outer) -> UAnimBoneCompressionCodec*
+		{
+			UAnimCompress_BitwiseCompressOnly* Codec = NewObject<UAnimCompress_BitwiseCompressOnly>(Outer);
+			Codec->RotationCompressionFormat = ACF_Fixed48NoW;
+			Codec->TranslationCompressionFormat = ACF_Float96NoW;
+			return Codec;
+		});
+		Add(TEXT("Bitwise_Interval32"), [](UObject* Outer) -> UAnimBoneCompressionCodec*
+		{
+			UAnimCompress_BitwiseCompressOnly* Codec = NewObject<UAnimCompress_BitwiseCompressOnly>(Outer);
+			Codec->RotationCompressionFormat = ACF_IntervalFixed32NoW;
+			Codec->TranslationCompressionFormat = ACF_IntervalFixed32NoW;
+			return Codec;
+		});
+		Add(TEXT("RemoveLinear_Tight"), [](UObject* Outer) -> UAnimBoneCompressionCodec*
+		{
+			UAnimCompress_RemoveLinearKeys* Codec = NewObject<UAnimCompress_RemoveLinearKeys>(Outer);
+			Codec->RotationCompressionFormat = ACF_Fixed48NoW;
+			Codec->MaxPosDiff = 0.02f;
+			Codec->MaxAngleDiff = 0.001f;
+			return Codec;
+		});
+		Add(TEXT("RemoveLinear_Loose"), [](UObject* Outer) -> UAnimBoneCompressionCodec*
+		{
+			UAnimCompress_RemoveLinearKeys* Codec = NewObject<UAnimCompress_RemoveLinearKeys>(Outer);
+			Codec->RotationCompressionFormat = ACF_Fixed48NoW;
+			Codec->MaxPosDiff = 0.1f;
+			Codec->MaxAngleDiff = 0.005f;
+			return Codec;
+		});
+		Add(TEXT("PerTrack"), [](UObject* Outer) -> UAnimBoneCompressionCodec*
+		{
+			return NewObject<UAnimCompress_PerTrackCompression>(Outer);
+		});
+		return Candidates;
+	}
+
+	static bool PrepareClip(UAnimSequence* Clip, const TArray<FName>& Effectors, int32 SampleRate, FClipResult& OutResult)
+	{
+		const USkeleton* Skeleton = Clip->GetSkeleton();
+		if (!Skeleton)
+		{
+			return false;
+		}
+
+		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+		for (const FName Effector : Effectors)
+		{
+			const int32 EffectorIndex = RefSkeleton.FindBoneIndex(Effector);
+			if (EffectorIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			TArray<int32>& Chain = OutResult.EffectorChains.AddDefaulted_GetRef();
+			for (int32 Bone = EffectorIndex; Bone != INDEX_NONE; Bone = RefSkeleton.GetParentIndex(Bone))
+			{
+				Chain.Insert(Bone, 0);
+			}
+			OutResult.EffectorNames.Add(Effector);
+		}
+
+		if (OutResult.EffectorNames.Num() == 0)
+		{
+			UE_LOG(LogProceduralLocomotionCompression, Warning, TEXT("Compression: %s's skeleton has none of the effectors; skipped."), *Clip->GetName());
+			return false;
+		}
+
+		OutResult.Clip = Clip;
+		OutResult.OriginalSettings = Clip->BoneCompressionSettings;
+		OutResult.NumBones = RefSkeleton.GetNum();
+		OutResult.NumSamples = FMath::Max(FMath::FloorToInt(Clip->GetPlayLength() * SampleRate) + 1, 2);
+		OutResult.SampleInterval = Clip->GetPlayLength() / (OutResult.NumSamples - 1);
+		return true;
+	}
+
+	// Component-space effector positions at every sample, from raw or compressed data.
+	static void SampleEffectors(const FClipResult& Result, bool bUseRawData, TArray<FVector>& OutPositions)
+	{
+		const int32 NumEffectors = Result.EffectorChains.Num();
+		OutPositions.SetNumUninitialized(Result.NumSamples * NumEffectors);
+		for (int32 Sample = 0; Sample < Result.NumSamples; ++Sample)
+		{
+			const FAnimExtractContext Context((double)Sample * Result.SampleInterval);
+			for (int32 Effector = 0; Effector < NumEffectors; ++Effector)
+			{
+				FTransform Component = FTransform::Identity;
+				for (const int32 Bone : Result.EffectorChains[Effector])
+				{
+					FTransform Local;
+					Result.Clip->GetBoneTransform(Local, FSkeletonPoseBoneIndex(Bone), Context, bUseRawData);
+					Component = Local * Component;
+				}
+				OutPositions[Sample * NumEffectors + Effector] = Component.GetTranslation();
+			}
+		}
+	}
+
+	static FTrial MeasureTrial(const FClipResult& Result)
+	{
+		FTrial Trial;
+		Trial.Bytes = Result.Clip->GetApproxCompressedSize();
+
+		TArray<FVector> Positions;
+		SampleEffectors(Result, false, Positions);
+		const int32 NumEffectors = Result.EffectorNames.Num();
+		for (int32 Index = 0; Index < Positions.Num(); ++Index)
+		{
+			const float Error = (float)FVector::Dist(Positions[Index], Result.RawPositions[Index]);
+			if (Error > Trial.MaxErrorCm)
+			{
+				Trial.MaxErrorCm = Error;
+				Trial.WorstEffector = Result.EffectorNames[Index % NumEffectors];
+			}
+		}
+
+		// Every bone of every sample, as a pose evaluation would decode them.
+		const double StartSeconds = FPlatformTime::Seconds();
+		FTransform Local;
+		for (int32 Sample = 0; Sample < Result.NumSamples; ++Sample)
+		{
+			const FAnimExtractContext Context((double)Sample * Result.SampleInterval);
+			for (int32 Bone = 0; Bone < Result.NumBones; ++Bone)
+			{
+				Result.Clip->GetBoneTransform(Local, FSkeletonPoseBoneIndex(Bone), Context, false);
+			}
+		}
+		Trial.DecodeMicroseconds = (FPlatformTime::Seconds() - StartSeconds) * 1.0e6 / Result.NumSamples;
+		return Trial;
+	}
+
+	// Compresses the whole library with one candidate: every clip is queued before any is waited on.
+	static void CompressAll(TArray<FClipResult>& Results, const FCandidate& Candidate)
+	{
+		for (FClipResult& Result : Results)
+		{
+			Result.Clip->BoneCompressionSettings = Candidate.Settings ? Candidate.Settings : Result.OriginalSettings;
+			Result.Clip->BeginCacheDerivedDataForCurrentPlatform();
+		}
+		for (FClipResult& Result : Results)
+		{
+			Result.Clip->CacheDerivedDataForCurrentPlatform();
+		}
+	}
+
+	// Saves a built-in candidate as an asset the clips can reference, once. Built-in names encode
+	// their settings, so an asset left by an earlier run is reused.
+	static UAnimBoneCompressionSettings* SaveBuiltInSettings(FCandidate& Candidate, const FString& SettingsPath)
+	{
+		const FString AssetName = Candidate.Settings->GetName();
+		const FString PackageName = SettingsPath / AssetName;
+		UAnimBoneCompressionSettings* Asset = FPackageName::DoesPackageExist(PackageName)
+			? LoadObject<UAnimBoneCompressionSettings>(nullptr, *(PackageName + TEXT(".") + AssetName))
+			: nullptr;
+		if (!Asset)
+		{
+			UPackage* Package = CreatePackage(*PackageName);
+			Asset = DuplicateObject<UAnimBoneCompressionSettings>(Candidate.Settings, Package, *AssetName);
+			Asset->SetFlags(RF_Public | RF_Standalone);
+			if (!ProceduralLocomotionCommandlet::SaveAssetPackage(Asset))
+			{
+				return nullptr;
+			}
+		}
+
+		Candidate.Settings = Asset;
+		Candidate.bBuiltIn = false;
+		return Asset;
+	}
+}
+
+UProceduralLocomotionCompressionCommandlet::UProceduralLocomotionCompressionCommandlet()
+{
+	LogToConsole = true;
+}
+
+int32 UProceduralLocomotionCompressionCommandlet::Main(const FString& Params)
+{
+	using namespace ProceduralLocomotionCompression;
+
+	float ErrorBudgetCm = 0.1f;
+	int32 SampleRate = 30;
+	FString EffectorList = TEXT("foot_l,foot_r,hand_l,hand_r");
+	FString SettingsList;
+	FString SettingsPath = TEXT("/Game/Locomotion/Compression");
+	FString ReportFile = FPaths::ProjectSavedDir() / TEXT("Benchmarks/Compression.csv");
+	FParse::Value(*Params, TEXT("ErrorBudget="), ErrorBudgetCm);
+	FParse::Value(*Params, TEXT("SampleRate="), SampleRate);
+	FParse::Value(*Params, TEXT("Effectors="), EffectorList, false);
+	FParse::Value(*Params, TEXT("Settings="), SettingsList, false);
+	FParse::Value(*Params, TEXT("SettingsPath="), SettingsPath);
+	FParse::Value(*Params, TEXT("Report="), ReportFile);
+	const bool bApply = FParse::Param(*Params, TEXT("Apply"));
+	SampleRate = FMath::Max(SampleRate, 1);
+
+	TArray<FString> EffectorStrings;
+	EffectorList.ParseIntoArray(EffectorStrings, TEXT(","));
+	TArray<FName> Effectors;
+	for (const FString& Effector : EffectorStrings)
+	{
+		Effectors.Add(FName(*Effector));
+	}
+
+	TArray<FCandidate> Candidates;
+	Candidates.Add({ TEXT("Original"), nullptr, false });
+	Candidates.Append(MakeBuiltInCandidates());
+	TArray<FString> SettingsPaths;
+	SettingsList.ParseIntoArray(SettingsPaths, TEXT(","));
+	for (const FString& Path : SettingsPaths)
+	{
+		if (UAnimBoneCompressionSettings* Settings = LoadObject<UAnimBoneCompressionSettings>(nullptr, *Path))
+		{
+			Candidates.Add({ Settings->GetName(), Settings, false });
+		}
+		else
+		{
+			UE_LOG(LogProceduralLocomotionCompression, Warning, TEXT("Compression: could not load settings %s."), *Path);
+		}
+	}
+
+	TArray<FClipResult> Results;
+	for (UAnimSequence* Clip : ProceduralLocomotionCommandlet::LoadClips(Params))
+	{
+		FClipResult Result;
+		if (PrepareClip(Clip, Effectors, SampleRate, Result))
+		{
+			Results.Add(MoveTemp(Result));
+		}
+	}
+	if (Results.Num() == 0)
+	{
+		UE_LOG(LogProceduralLocomotionCompression, Error, TEXT("Compression: -Clips=<Folder or AnimSequence,...> matched no usable animation sequences."));
+		return 1;
+	}
+
+	ParallelFor(Results.Num(), [&Results](int32 Index)
+	{
+		SampleEffectors(Results[Index], true, Results[Index].RawPositions);
+	});
+
+	for (const FCandidate& Candidate : Candidates)
+	{
+		UE_LOG(LogProceduralLocomotionCompression, Display, TEXT("Compression: trying %s on %d clips..."), *Candidate.Name, Results.Num());
+		CompressAll(Results, Candidate);
+		ParallelFor(Results.Num(), [&Results](int32 Index)
+		{
+			Results[Index].Trials.Add(MeasureTrial(Results[Index]));
+		});
+	}
+
+	// Smallest candidate under the budget; the clip keeps its settings if none is.
+	int64 TotalOriginalBytes = 0;
+	int64 TotalChosenBytes = 0;
+	for (FClipResult& Result : Results)
+	{
+		for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+		{
+			const FTrial& Trial = Result.Trials[CandidateIndex];
+			if (Trial.MaxErrorCm <= ErrorBudgetCm && (Result.Chosen == INDEX_NONE || Trial.Bytes < Result.Trials[Result.Chosen].Bytes))
+			{
+				Result.Chosen = CandidateIndex;
+			}
+		}
+
+		const int64 OriginalBytes = Result.Trials[0].Bytes;
+		const int64 ChosenBytes = Result.Trials[Result.Chosen != INDEX_NONE ? Result.Chosen : 0].Bytes;
+		TotalOriginalBytes += OriginalBytes;
+		TotalChosenBytes += ChosenBytes;
+		if (Result.Chosen == INDEX_NONE)
+		{
+			UE_LOG(LogProceduralLocomotionCompression, Warning, TEXT("Compression: %s: no candidate within %.3f cm (original %.3f cm on %s); kept."),
+				*Result.Clip->GetName(), ErrorBudgetCm, Result.Trials[0].MaxErrorCm, *Result.Trials[0].WorstEffector.ToString());
+		}
+		else
+		{
+			UE_LOG(LogProceduralLocomotionCompression, Display, TEXT("Compression: %s: %s, %lld -> %lld bytes (%lld saved), %.3f cm"),
+				*Result.Clip->GetName(), *Candidates[Result.Chosen].Name, OriginalBytes, ChosenBytes, OriginalBytes - ChosenBytes,
+				Result.Trials[Result.Chosen].MaxErrorCm);
+		}
+	}
+
+	FString Report = TEXT("Clip,Candidate,Bytes,MaxErrorCm,WorstEffector,DecodeUsPerPose,Chosen\n");
+	for (const FClipResult& Result : Results)
+	{
+		for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+		{
+			const FTrial& Trial = Result.Trials[CandidateIndex];
+			Report += FString::Printf(TEXT("%s,%s,%lld,%.4f,%s,%.2f,%d\n"), *Result.Clip->GetPathName(), *Candidates[CandidateIndex].Name,
+				Trial.Bytes, Trial.MaxErrorCm, *Trial.WorstEffector.ToString(), Trial.DecodeMicroseconds, CandidateIndex == Result.Chosen ? 1 : 0);
+		}
+	}
+	FFileHelper::SaveStringToFile(Report, *ReportFile);
+
+	for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+	{
+		double DecodeMicroseconds = 0.0;
+		int32 NumChosen = 0;
+		for (const FClipResult& Result : Results)
+		{
+			DecodeMicroseconds += Result.Trials[CandidateIndex].DecodeMicroseconds;
+			NumChosen += Result.Chosen == CandidateIndex ? 1 : 0;
+		}
+		UE_LOG(LogProceduralLocomotionCompression, Display, TEXT("Compression: %-20s chosen for %4d clips, decode %.2f us/pose on average"),
+			*Candidates[CandidateIndex].Name, NumChosen, DecodeMicroseconds / Results.Num());
+	}
+	UE_LOG(LogProceduralLocomotionCompression, Display, TEXT("Compression: %d clips, %.2f MB -> %.2f MB (%.1f%% saved); report at %s"),
+		Results.Num(), TotalOriginalBytes / (1024.0 * 1024.0), TotalChosenBytes / (1024.0 * 1024.0),
+		TotalOriginalBytes > 0 ? 100.0 * (TotalOriginalBytes - TotalChosenBytes) / TotalOriginalBytes : 0.0, *ReportFile);
+
+	int32 NumFailed = 0;
+	for (FClipResult& Result : Results)
+	{
+		FCandidate* Chosen = bApply && Result.Chosen > 0 ? &Candidates[Result.Chosen] : nullptr;
+		UAnimBoneCompressionSettings* Settings = Result.OriginalSettings;
+		if (Chosen)
+		{
+			Settings = Chosen->bBuiltIn ? SaveBuiltInSettings(*Chosen, SettingsPath) : Chosen->Settings;
+			NumFailed += Settings ? 0 : 1;
+		}
+
+		Result.Clip->BoneCompressionSettings = Settings ? Settings : Result.OriginalSettings;
+		if (Chosen && Settings)
+		{
+			Result.Clip->CacheDerivedDataForCurrentPlatform();
+			NumFailed += ProceduralLocomotionCommandlet::SaveAssetPackage(Result.Clip) ? 0 : 1;
+		}
+		else
+		{
+			Result.Clip->BeginCacheDerivedDataForCurrentPlatform();
+		}
+	}
+
+	if (NumFailed > 0)
+	{
+		UE_LOG(LogProceduralLocomotionCompression, Error, TEXT("Compression: %d assets failed to save."), NumFailed);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,491 @@
+#include "ProceduralLocomotionDuplicatesCommandlet.h"
+
+#include "ProceduralLocomotionCommandletUtils.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProceduralLocomotionDuplicates, Log, All);
+
+namespace ProceduralLocomotionDuplicates
+{
+	static constexpr int32 NumSignatureBits = 64;
+
+	struct FClip
+	{
+		UAnimSequence* Sequence = nullptr;
+		float Length = 0.0f;
+		int64 Bytes = 0;
+		int32 NumReferencers = 0;
+
+		// Unit length; empty if the clip's skeleton has none of the joints.
+		TArray<float> Fingerprint;
+		uint64 Signature = 0;
+	};
+
+	static void Normalize(TArrayView<float> Values)
+	{
+		double SumSquares = 0.0;
+		for (const float Value : Values)
+		{
+			SumSquares += (double)Value * Value;
+		}
+		const float Scale = SumSquares > UE_SMALL_NUMBER ? (float)(1.0 / FMath::Sqrt(SumSquares)) : 0.0f;
+		for (float& Value : Values)
+		{
+			Value *= Scale;
+		}
+	}
+
+	// Pelvis-relative positions then velocities of every joint at every sample, each half normalized
+	// so held poses and motion weigh the same.
+	static void BuildFingerprint(FClip& Clip, const TArray<FName>& Joints, int32 NumSamples)
+	{
+		const USkeleton* Skeleton = Clip.Sequence->GetSkeleton();
+		if (!Skeleton)
+		{
+			return;
+		}
+
+		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+		TArray<TArray<int32>> Chains;
+		int32 PelvisChain = INDEX_NONE;
+		for (const FName Joint : Joints)
+		{
+			const int32 JointIndex = RefSkeleton.FindBoneIndex(Joint);
+			if (JointIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			TArray<int32>& Chain = Chains.AddDefaulted_GetRef();
+			for (int32 Bone = JointIndex; Bone != INDEX_NONE; Bone = RefSkeleton.GetParentIndex(Bone))
+			{
+				Chain.Insert(Bone, 0);
+			}
+			PelvisChain = PelvisChain == INDEX_NONE && Joint == TEXT("pelvis") ? Chains.Num() - 1 : PelvisChain;
+		}
+		if (Chains.Num() == 0)
+		{
+			return;
+		}
+
+		auto SamplePositions = [&Clip, &Chains](double Time, TArray<FVector>& OutPositions)
+		{
+			const FAnimExtractContext Context(FMath::Clamp(Time, 0.0, (double)Clip.Length));
+			OutPositions.SetNumUninitialized(Chains.Num());
+			for (int32 Joint = 0; Joint < Chains.Num(); ++Joint)
+			{
+				FTransform Component = FTransform::Identity;
+				for (const int32 Bone : Chains[Joint])
+				{
+					FTransform Local;
+					Clip.Sequence->GetBoneTransform(Local, FSkeletonPoseBoneIndex(Bone), Context, true);
+					Component = Local * Component;
+				}
+				OutPositions[Joint] = Component.GetTranslation();
+			}
+		};
+
+		// Velocities by central difference over one 30 Hz frame, independent of the clip's own rate.
+		const double HalfStep = 0.5 / 30.0;
+		const int32 BlockSize = NumSamples * Chains.Num() * 3;
+		Clip.Fingerprint.SetNumZeroed(BlockSize * 2);
+		TArray<FVector> Now, Before, After;
+		for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+		{
+			const double Time = Clip.Length * Sample / FMath::Max(NumSamples - 1, 1);
+			SamplePositions(Time, Now);
+			SamplePositions(Time - HalfStep, Before);
+			SamplePositions(Time + HalfStep, After);
+
+			const FVector Pelvis = PelvisChain != INDEX_NONE ? Now[PelvisChain] : FVector::ZeroVector;
+			for (int32 Joint = 0; Joint < Chains.Num(); ++Joint)
+			{
+				const FVector Position = Now[Joint] - Pelvis;
+				const FVector Velocity = (After[Joint] - Before[Joint]) / (2.0 * HalfStep);
+				const int32 Offset = (Sample * Chains.Num() + Joint) * 3;
+				for (int32 Axis = 0; Axis < 3; ++Axis)
+				{
+					Clip.Fingerprint[Offset + Axis] = (float)Position[Axis];
+					Clip.Fingerprint[BlockSize + Offset + Axis] = (float)Velocity[Axis];
+				}
+			}
+		}
+
+		Normalize(TArrayView<float>(Clip.Fingerprint.GetData(), BlockSize));
+		Normalize(TArrayView<float>(Clip.Fingerprint.GetData() + BlockSize, BlockSize));
+		Normalize(Clip.Fingerprint);
+	}
+
+	// Every clip on a skeleton shares its rest offsets from the pelvis, which point all fingerprints
+	// the same way: hyperplanes through the origin then give them the same bits, and clips that only
+	// share a skeleton clear the similarity bar. Subtracting the library's mean fingerprint leaves
+	// what sets clips apart.
+	static void CenterFingerprints(TArray<FClip>& Clips, int32 Dimensions)
+	{
+		TArray<double> Mean;
+		Mean.SetNumZeroed(Dimensions);
+		int32 NumCentered = 0;
+		for (const FClip& Clip : Clips)
+		{
+			if (Clip.Fingerprint.Num() == Dimensions)
+			{
+				for (int32 Index = 0; Index < Dimensions; ++Index)
+				{
+					Mean[Index] += Clip.Fingerprint[Index];
+				}
+				++NumCentered;
+			}
+		}
+
+		// Two clips centered on their mean always point in opposite directions.
+		if (NumCentered < 3)
+		{
+			return;
+		}
+
+		for (FClip& Clip : Clips)
+		{
+			if (Clip.Fingerprint.Num() == Dimensions)
+			{
+				for (int32 Index = 0; Index < Dimensions; ++Index)
+				{
+					Clip.Fingerprint[Index] -= (float)(Mean[Index] / NumCentered);
+				}
+				Normalize(Clip.Fingerprint);
+			}
+		}
+	}
+
+	static float Similarity(const FClip& A, const FClip& B)
+	{
+		if (A.Fingerprint.Num() != B.Fingerprint.Num())
+		{
+			return 0.0f;
+		}
+
+		double Dot = 0.0;
+		for (int32 Index = 0; Index < A.Fingerprint.Num(); ++Index)
+		{
+			Dot += (double)A.Fingerprint[Index] * B.Fingerprint[Index];
+		}
+		return (float)Dot;
+	}
+
+	// Random hyperplanes for SimHash, one per signature bit, with a fixed seed so runs are repeatable.
+	static TArray<float> MakeHyperplanes(int32 Dimensions)
+	{
+		FRandomStream Random(0x504C53);
+		TArray<float> Planes;
+		Planes.SetNumUninitialized(NumSignatureBits * Dimensions);
+		for (float& Value : Planes)
+		{
+			// Box-Muller: Gaussian components make the plane directions uniform on the sphere.
+			const float U = FMath::Max(Random.GetFraction(), UE_SMALL_NUMBER);
+			Value = FMath::Sqrt(-2.0f * FMath::Loge(U)) * FMath::Cos(UE_TWO_PI * Random.GetFraction());
+		}
+		return Planes;
+	}
+
+	static uint64 ComputeSignature(const TArray<float>& Fingerprint, const TArray<float>& Planes)
+	{
+		const int32 Dimensions = Fingerprint.Num();
+		uint64 Signature = 0;
+		for (int32 Bit = 0; Bit < NumSignatureBits; ++Bit)
+		{
+			const float* Plane = Planes.GetData() + Bit * Dimensions;
+			float Dot = 0.0f;
+			for (int32 Index = 0; Index < Dimensions; ++Index)
+			{
+				Dot += Plane[Index] * Fingerprint[Index];
+			}
+			Signature |= Dot >= 0.0f ? (uint64(1) << Bit) : 0;
+		}
+		return Signature;
+	}
+
+	static bool ShareBand(const FClip& A, const FClip& B, int32 NumBands, int32 BitsPerBand)
+	{
+		const uint64 BandMask = BitsPerBand == 64 ? ~uint64(0) : (uint64(1) << BitsPerBand) - 1;
+		for (int32 Band = 0; Band < NumBands; ++Band)
+		{
+			if (((A.Signature >> (Band * BitsPerBand)) & BandMask) == ((B.Signature >> (Band * BitsPerBand)) & BandMask))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static int32 FindClip(const TArray<FClip>& Clips, const FString& Name)
+	{
+		return Clips.IndexOfByPredicate([&Name](const FClip& Clip)
+		{
+			return Clip.Sequence->GetName() == Name || Clip.Sequence->GetPackage()->GetName() == Name;
+		});
+	}
+
+	static int32 FindRoot(TArray<int32>& Parents, int32 Index)
+	{
+		while (Parents[Index] != Index)
+		{
+			Parents[Index] = Parents[Parents[Index]];
+			Index = Parents[Index];
+		}
+		return Index;
+	}
+}
+
+UProceduralLocomotionDuplicatesCommandlet::UProceduralLocomotionDuplicatesCommandlet()
+{
+	LogToConsole = true;
+}
+
+int32 UProceduralLocomotionDuplicatesCommandlet::Main(const FString& Params)
+{
+	using namespace ProceduralLocomotionDuplicates;
+
+	FString JointList = TEXT("pelvis,foot_l,foot_r,hand_l,hand_r,head");
+	int32 NumSamples = 32;
+	float MinSimilarity = 0.97f;
+	float LengthTolerance = 0.1f;
+	int32 NumBands = 8;
+	FString ReportFile = FPaths::ProjectSavedDir() / TEXT("Benchmarks/Duplicates.csv");
+	FParse::Value(*Params, TEXT("Joints="), JointList, false);
+	FParse::Value(*Params, TEXT("Samples="), NumSamples);
+	FParse::Value(*Params, TEXT("Similarity="), MinSimilarity);
+	FParse::Value(*Params, TEXT("LengthTolerance="), LengthTolerance);
+	FParse::Value(*Params, TEXT("Bands="), NumBands);
+	FParse::Value(*Params, TEXT("Report="), ReportFile);
+	// Pairs of clips known to differ, such as a walk and a run: the run fails if any of them share
+	// a band, because then the bands no longer separate unrelated motion.
+	FString DistinctList;
+	FParse::Value(*Params, TEXT("Distinct="), DistinctList, false);
+	NumSamples = FMath::Max(NumSamples, 2);
+	// Bands must divide the signature evenly.
+	NumBands = FMath::Clamp(FMath::RoundUpToPowerOfTwo(FMath::Max(NumBands, 1)), 1u, (uint32)NumSignatureBits);
+	const int32 BitsPerBand = NumSignatureBits / NumBands;
+
+	TArray<FString> JointStrings;
+	JointList.ParseIntoArray(JointStrings, TEXT(","));
+	TArray<FName> Joints;
+	for (const FString& Joint : JointStrings)
+	{
+		Joints.Add(FName(*Joint));
+	}
+
+	TArray<FClip> Clips;
+	for (UAnimSequence* Sequence : ProceduralLocomotionCommandlet::LoadClips(Params))
+	{
+		FClip& Clip = Clips.AddDefaulted_GetRef();
+		Clip.Sequence = Sequence;
+		Clip.Length = Sequence->GetPlayLength();
+		Sequence->BeginCacheDerivedDataForCurrentPlatform();
+	}
+	if (Clips.Num() < 2)
+	{
+		UE_LOG(LogProceduralLocomotionDuplicates, Error, TEXT("Duplicates: -Clips=<Folder or AnimSequence,...> needs at least two animation sequences."));
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	for (FClip& Clip : Clips)
+	{
+		Clip.Sequence->CacheDerivedDataForCurrentPlatform();
+		Clip.Bytes = Clip.Sequence->GetApproxCompressedSize();
+		TArray<FName> Referencers;
+		AssetRegistry.GetReferencers(Clip.Sequence->GetPackage()->GetFName(), Referencers);
+		Clip.NumReferencers = Referencers.Num();
+	}
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	ParallelFor(Clips.Num(), [&Clips, &Joints, NumSamples](int32 Index)
+	{
+		BuildFingerprint(Clips[Index], Joints, NumSamples);
+	});
+
+	// Clips on skeletons with a different subset of the joints can't be compared; hash the most
+	// common fingerprint size and leave the rest out.
+	TMap<int32, int32> SizeCounts;
+	for (const FClip& Clip : Clips)
+	{
+		SizeCounts.FindOrAdd(Clip.Fingerprint.Num())++;
+	}
+	SizeCounts.Remove(0);
+	int32 Dimensions = 0;
+	int32 MostCommon = 0;
+	for (const TPair<int32, int32>& Pair : SizeCounts)
+	{
+		if (Pair.Value > MostCommon)
+		{
+			Dimensions = Pair.Key;
+			MostCommon = Pair.Value;
+		}
+	}
+	int32 NumSkipped = 0;
+	for (const FClip& Clip : Clips)
+	{
+		if (Clip.Fingerprint.Num() != Dimensions)
+		{
+			UE_LOG(LogProceduralLocomotionDuplicates, Warning, TEXT("Duplicates: %s's skeleton lacks some of the joints; skipped."), *Clip.Sequence->GetName());
+			++NumSkipped;
+		}
+	}
+
+	CenterFingerprints(Clips, Dimensions);
+
+	const TArray<float> Planes = MakeHyperplanes(Dimensions);
+	ParallelFor(Clips.Num(), [&Clips, &Planes, Dimensions](int32 Index)
+	{
+		if (Clips[Index].Fingerprint.Num() == Dimensions)
+		{
+			Clips[Index].Signature = ComputeSignature(Clips[Index].Fingerprint, Planes);
+		}
+	});
+
+	// Clips sharing any band's bits are candidates; similar fingerprints agree on most bits, so
+	// they share at least one band with high probability.
+	TSet<uint64> CandidatePairs;
+	const uint64 BandMask = BitsPerBand == 64 ? ~uint64(0) : (uint64(1) << BitsPerBand) - 1;
+	for (int32 Band = 0; Band < NumBands; ++Band)
+	{
+		TMap<uint64, TArray<int32>> Buckets;
+		for (int32 Index = 0; Index < Clips.Num(); ++Index)
+		{
+			if (Clips[Index].Fingerprint.Num() == Dimensions)
+			{
+				Buckets.FindOrAdd((Clips[Index].Signature >> (Band * BitsPerBand)) & BandMask).Add(Index);
+			}
+		}
+		for (const TPair<uint64, TArray<int32>>& Bucket : Buckets)
+		{
+			for (int32 First = 0; First < Bucket.Value.Num(); ++First)
+			{
+				for (int32 Second = First + 1; Second < Bucket.Value.Num(); ++Second)
+				{
+					CandidatePairs.Add((uint64)Bucket.Value[First] << 32 | (uint32)Bucket.Value[Second]);
+				}
+			}
+		}
+	}
+
+	TArray<FString> DistinctPairs;
+	DistinctList.ParseIntoArray(DistinctPairs, TEXT(","));
+	int32 NumDistinctFailed = 0;
+	for (const FString& DistinctPair : DistinctPairs)
+	{
+		FString NameA, NameB;
+		if (!DistinctPair.Split(TEXT("+"), &NameA, &NameB))
+		{
+			UE_LOG(LogProceduralLocomotionDuplicates, Error, TEXT("Duplicates: -Distinct entry '%s' is not ClipA+ClipB."), *DistinctPair);
+			++NumDistinctFailed;
+			continue;
+		}
+
+		const int32 A = FindClip(Clips, NameA);
+		const int32 B = FindClip(Clips, NameB);
+		if (A == INDEX_NONE || B == INDEX_NONE || Clips[A].Fingerprint.Num() != Dimensions || Clips[B].Fingerprint.Num() != Dimensions)
+		{
+			UE_LOG(LogProceduralLocomotionDuplicates, Error, TEXT("Duplicates: -Distinct pair %s is not among the hashed clips."), *DistinctPair);
+			++NumDistinctFailed;
+		}
+		else if (ShareBand(Clips[A], Clips[B], NumBands, BitsPerBand))
+		{
+			UE_LOG(LogProceduralLocomotionDuplicates, Error, TEXT("Duplicates: distinct clips %s and %s share a band bucket (similarity %.3f)."),
+				*NameA, *NameB, Similarity(Clips[A], Clips[B]));
+			++NumDistinctFailed;
+		}
+	}
+
+	const TArray<uint64> Pairs = CandidatePairs.Array();
+	TArray<float> PairSimilarity;
+	PairSimilarity.SetNumZeroed(Pairs.Num());
+	ParallelFor(Pairs.Num(), [&](int32 Index)
+	{
+		const FClip& A = Clips[(int32)(Pairs[Index] >> 32)];
+		const FClip& B = Clips[(int32)(Pairs[Index] & 0xFFFFFFFF)];
+		const bool bSimilarLength = FMath::Abs(A.Length - B.Length) <= LengthTolerance * FMath::Max(A.Length, B.Length);
+		PairSimilarity[Index] = bSimilarLength ? Similarity(A, B) : 0.0f;
+	});
+
+	TArray<int32> Parents;
+	TArray<float> BestSimilarity;
+	Parents.SetNumUninitialized(Clips.Num());
+	BestSimilarity.SetNumZeroed(Clips.Num());
+	for (int32 Index = 0; Index < Clips.Num(); ++Index)
+	{
+		Parents[Index] = Index;
+	}
+	int32 NumDuplicatePairs = 0;
+	for (int32 Index = 0; Index < Pairs.Num(); ++Index)
+	{
+		if (PairSimilarity[Index] >= MinSimilarity)
+		{
+			const int32 A = (int32)(Pairs[Index] >> 32);
+			const int32 B = (int32)(Pairs[Index] & 0xFFFFFFFF);
+			Parents[FindRoot(Parents, A)] = FindRoot(Parents, B);
+			BestSimilarity[A] = FMath::Max(BestSimilarity[A], PairSimilarity[Index]);
+			BestSimilarity[B] = FMath::Max(BestSimilarity[B], PairSimilarity[Index]);
+			++NumDuplicatePairs;
+		}
+	}
+
+	TMap<int32, TArray<int32>> Groups;
+	for (int32 Index = 0; Index < Clips.Num(); ++Index)
+	{
+		Groups.FindOrAdd(FindRoot(Parents, Index)).Add(Index);
+	}
+	Groups = Groups.FilterByPredicate([](const TPair<int32, TArray<int32>>& Group) { return Group.Value.Num() > 1; });
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+	FString Report = TEXT("Group,Clip,Keep,Similarity,LengthSeconds,Bytes,Referencers\n");
+	int32 GroupNumber = 0;
+	int32 NumRedundant = 0;
+	int64 RedundantBytes = 0;
+	for (TPair<int32, TArray<int32>>& Group : Groups)
+	{
+		// The most referenced clip is kept, then the first by path, so the choice is stable across runs.
+		Group.Value.Sort([&Clips](int32 A, int32 B)
+		{
+			if (Clips[A].NumReferencers != Clips[B].NumReferencers)
+			{
+				return Clips[A].NumReferencers > Clips[B].NumReferencers;
+			}
+			return Clips[A].Sequence->GetPathName() < Clips[B].Sequence->GetPathName();
+		});
+
+		const FClip& Kept = Clips[Group.Value[0]];
+		int64 GroupBytes = 0;
+		for (int32 Member = 0; Member < Group.Value.Num(); ++Member)
+		{
+			const FClip& Clip = Clips[Group.Value[Member]];
+			Report += FString::Printf(TEXT("%d,%s,%d,%.4f,%.3f,%lld,%d\n"), GroupNumber, *Clip.Sequence->GetPathName(), Member == 0 ? 1 : 0,
+				BestSimilarity[Group.Value[Member]], Clip.Length, Clip.Bytes, Clip.NumReferencers);
+			GroupBytes += Member > 0 ? Clip.Bytes : 0;
+		}
+
+		UE_LOG(LogProceduralLocomotionDuplicates, Display, TEXT("Duplicates: group %d keeps %s; %d redundant, %.1f KB"),
+			GroupNumber, *Kept.Sequence->GetName(), Group.Value.Num() - 1, GroupBytes / 1024.0);
+		NumRedundant += Group.Value.Num() - 1;
+		RedundantBytes += GroupBytes;
+		++GroupNumber;
+	}
+	FFileHelper::SaveStringToFile(Report, *ReportFile);
+
+	int64 TotalBytes = 0;
+	for (const FClip& Clip : Clips)
+	{
+		TotalBytes += Clip.Bytes;
+	}
+	UE_LOG(LogProceduralLocomotionDuplicates, Display, TEXT("Duplicates: %d clips (%d skipped), %d candidate pairs of %lld, %d duplicate pairs in %.2f s"),
+		Clips.Num(), NumSkipped, Pairs.Num(), (int64)Clips.Num() * (Clips.Num() - 1) / 2, NumDuplicatePairs, ElapsedSeconds);
+	UE_LOG(LogProceduralLocomotionDuplicates, Display, TEXT("Duplicates: %d groups, %d redundant clips, %.2f MB of %.2f MB (%.1f%%); report at %s"),
+		Groups.Num(), NumRedundant, RedundantBytes / (1024.0 * 1024.0), TotalBytes / (1024.0 * 1024.0),
+		TotalBytes > 0 ? 100.0 * RedundantBytes / TotalBytes : 0.0, *ReportFile);
+	return NumDistinctFailed > 0 ? 1 : 0;
+}
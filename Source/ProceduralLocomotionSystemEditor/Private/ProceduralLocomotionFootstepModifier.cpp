@@ -0,0 +1,131 @@
+#include "ProceduralLocomotionFootstepModifier.h"
+
+#include "AnimationBlueprintLibrary.h"
+#include "ProceduralLocomotionMarkerIndex.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+
+void UProceduralLocomotionFootstepModifier::OnApply_Implementation(UAnimSequence* Animation)
+{
+	if (!Animation)
+	{
+		return;
+	}
+
+	// Idempotent: markers from an earlier application are replaced, not duplicated.
+	OnRevert_Implementation(Animation);
+
+	if (!UAnimationBlueprintLibrary::IsValidAnimNotifyTrackName(Animation, MarkerTrackName))
+	{
+		UAnimationBlueprintLibrary::AddAnimationNotifyTrack(Animation, MarkerTrackName);
+	}
+
+	TArray<TPair<FName, float>> Markers;
+	for (const float Time : DetectPlants(Animation, LeftFootBone))
+	{
+		UAnimationBlueprintLibrary::AddAnimationSyncMarker(Animation, LeftMarkerName, Time, MarkerTrackName);
+		Markers.Emplace(LeftMarkerName, Time);
+	}
+	for (const float Time : DetectPlants(Animation, RightFootBone))
+	{
+		UAnimationBlueprintLibrary::AddAnimationSyncMarker(Animation, RightMarkerName, Time, MarkerTrackName);
+		Markers.Emplace(RightMarkerName, Time);
+	}
+
+	if (Markers.Num() == 0)
+	{
+		UE_LOG(LogAnimation, Warning, TEXT("Footstep modifier: no foot plants found in %s."), *Animation->GetName());
+		return;
+	}
+
+	TMap<FName, float> NamePhases;
+	NamePhases.Add(LeftMarkerName, LeftPlantPhase);
+	NamePhases.Add(RightMarkerName, RightPlantPhase);
+
+	UProceduralLocomotionMarkerIndex* Index = NewObject<UProceduralLocomotionMarkerIndex>(Animation, NAME_None, RF_Transactional);
+	Index->Build(MoveTemp(Markers), Animation->GetPlayLength(), NamePhases);
+	Animation->AddAssetUserData(Index);
+}
+
+void UProceduralLocomotionFootstepModifier::OnRevert_Implementation(UAnimSequence* Animation)
+{
+	if (!Animation)
+	{
+		return;
+	}
+
+	UAnimationBlueprintLibrary::RemoveAnimationSyncMarkersByName(Animation, LeftMarkerName);
+	UAnimationBlueprintLibrary::RemoveAnimationSyncMarkersByName(Animation, RightMarkerName);
+	Animation->RemoveUserDataOfClass(UProceduralLocomotionMarkerIndex::StaticClass());
+}
+
+TArray<float> UProceduralLocomotionFootstepModifier::DetectPlants(const UAnimSequence* Animation, FName FootBone) const
+{
+	TArray<float> Plants;
+
+	const USkeleton* Skeleton = Animation->GetSkeleton();
+	const int32 FootIndex = Skeleton ? Skeleton->GetReferenceSkeleton().FindBoneIndex(FootBone) : INDEX_NONE;
+	if (FootIndex == INDEX_NONE)
+	{
+		UE_LOG(LogAnimation, Warning, TEXT("Footstep modifier: %s has no bone %s."), *Animation->GetName(), *FootBone.ToString());
+		return Plants;
+	}
+
+	// Root-to-foot chain, so each sample builds the foot's component transform in one pass.
+	const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+	TArray<int32> Chain;
+	for (int32 Bone = FootIndex; Bone != INDEX_NONE; Bone = RefSkeleton.GetParentIndex(Bone))
+	{
+		Chain.Insert(Bone, 0);
+	}
+
+	const float Length = Animation->GetPlayLength();
+	const int32 NumSamples = FMath::Max(FMath::FloorToInt(Length * SampleRate) + 1, 2);
+	const float Dt = Length / (NumSamples - 1);
+
+	TArray<float> Heights;
+	Heights.Reserve(NumSamples);
+	for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+	{
+		const FAnimExtractContext Context((double)Sample * Dt);
+		FTransform Root = FTransform::Identity;
+		FTransform Component = FTransform::Identity;
+		for (int32 ChainIndex = 0; ChainIndex < Chain.Num(); ++ChainIndex)
+		{
+			FTransform Local;
+			Animation->GetBoneTransform(Local, FSkeletonPoseBoneIndex(Chain[ChainIndex]), Context, false);
+			Component = Local * Component;
+			if (ChainIndex == 0)
+			{
+				Root = Component;
+			}
+		}
+		Heights.Add((float)Root.InverseTransformPositionNoScale(Component.GetTranslation()).Z);
+	}
+
+	const float Lowest = FMath::Min(Heights);
+
+	// A loop can start mid-stance. Starting from the state at the end of the clip keeps that stance
+	// from being reported as a plant at frame 0.
+	bool bPlanted = Heights.Last() <= Lowest + ReleaseHeightTolerance;
+	float LastPlant = -MinTimeBetweenSteps;
+	for (int32 Sample = 0; Sample < NumSamples - 1; ++Sample)
+	{
+		const float Height = Heights[Sample];
+		if (!bPlanted && Height <= Lowest + PlantHeightTolerance)
+		{
+			bPlanted = true;
+			const float Time = Sample * Dt;
+			if (Time - LastPlant >= MinTimeBetweenSteps)
+			{
+				Plants.Add(Time);
+				LastPlant = Time;
+			}
+		}
+		else if (bPlanted && Height > Lowest + ReleaseHeightTolerance)
+		{
+			bPlanted = false;
+		}
+	}
+	return Plants;
+}
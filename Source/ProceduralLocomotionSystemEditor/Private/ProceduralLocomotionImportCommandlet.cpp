@@ -0,0 +1,505 @@
+#include "ProceduralLocomotionImportCommandlet.h"
+
+#include "ProceduralLocomotionCommandletUtils.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimSequenceHelpers.h"
+#include "Animation/Skeleton.h"
+#include "AssetImportTask.h"
+#include "AssetToolsModule.h"
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "Factories/FbxAnimSequenceImportData.h"
+#include "Factories/FbxImportUI.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "ObjectTools.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProceduralLocomotionImport, Log, All);
+
+namespace ProceduralLocomotionImport
+{
+	// Bump when the import or trim logic changes so every file is imported again.
+	static const TCHAR* ImportVersion = TEXT("1");
+
+	struct FOptions
+	{
+		FString SourceDir;
+		FString SkeletonPath;
+		FString Destination = TEXT("/Game/MoCap/Raw");
+		int32 FrameRate = 30;
+		float Scale = 1.0f;
+		bool bForceFrontXAxis = false;
+		float TrimSpeed = 2.0f;
+
+		// Combined with each file's contents; any change here re-imports every file.
+		FString SettingsKey() const
+		{
+			return FString::Printf(TEXT("v%s|%s|%s|%d|%g|%d|%g"), ImportVersion, *SkeletonPath, *Destination, FrameRate, Scale, bForceFrontXAxis ? 1 : 0, TrimSpeed);
+		}
+
+		// Forwarded to child processes.
+		FString ToParams() const
+		{
+			return FString::Printf(TEXT("-Source=\"%s\" -Skeleton=%s -Destination=%s -FrameRate=%d -Scale=%g -TrimSpeed=%g%s"),
+				*SourceDir, *SkeletonPath, *Destination, FrameRate, Scale, TrimSpeed, bForceFrontXAxis ? TEXT(" -ForceFrontXAxis") : TEXT(""));
+		}
+	};
+
+	struct FManifestEntry
+	{
+		FString Hash;
+		FString Asset;
+		int32 NumFrames = 0;
+		int32 TrimmedHead = 0;
+		int32 TrimmedTail = 0;
+	};
+
+	// Keyed by path relative to the source directory.
+	using FManifest = TMap<FString, FManifestEntry>;
+
+	static bool LoadManifest(const FString& File, FManifest& OutManifest)
+	{
+		FString Text;
+		if (!FFileHelper::LoadFileToString(Text, *File))
+		{
+			return false;
+		}
+
+		TSharedPtr<FJsonObject> Root;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Root) || !Root.IsValid())
+		{
+			UE_LOG(LogProceduralLocomotionImport, Warning, TEXT("Import: could not parse manifest %s; importing everything."), *File);
+			return false;
+		}
+
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Root->Values)
+		{
+			const TSharedPtr<FJsonObject>* Object = nullptr;
+			if (Pair.Value->TryGetObject(Object))
+			{
+				FManifestEntry& Entry = OutManifest.Add(Pair.Key);
+				Entry.Hash = (*Object)->GetStringField(TEXT("Hash"));
+				Entry.Asset = (*Object)->GetStringField(TEXT("Asset"));
+				Entry.NumFrames = (int32)(*Object)->GetNumberField(TEXT("Frames"));
+				Entry.TrimmedHead = (int32)(*Object)->GetNumberField(TEXT("TrimmedHead"));
+				Entry.TrimmedTail = (int32)(*Object)->GetNumberField(TEXT("TrimmedTail"));
+			}
+		}
+		return true;
+	}
+
+	static bool SaveManifest(const FString& File, const FManifest& Manifest)
+	{
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		for (const TPair<FString, FManifestEntry>& Pair : Manifest)
+		{
+			TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+			Object->SetStringField(TEXT("Hash"), Pair.Value.Hash);
+			Object->SetStringField(TEXT("Asset"), Pair.Value.Asset);
+			Object->SetNumberField(TEXT("Frames"), Pair.Value.NumFrames);
+			Object->SetNumberField(TEXT("TrimmedHead"), Pair.Value.TrimmedHead);
+			Object->SetNumberField(TEXT("TrimmedTail"), Pair.Value.TrimmedTail);
+			Root->SetObjectField(Pair.Key, Object);
+		}
+
+		FString Text;
+		FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Text));
+		return FFileHelper::SaveStringToFile(Text, *File);
+	}
+
+	static FString HashFile(const FString& File, const FString& SettingsKey)
+	{
+		const FMD5Hash FileHash = FMD5Hash::HashFile(*File);
+		if (!FileHash.IsValid())
+		{
+			return FString();
+		}
+
+		FMD5 Md5;
+		Md5.Update(FileHash.GetBytes(), FileHash.GetSize());
+		const FTCHARToUTF8 Key(*SettingsKey);
+		Md5.Update((const uint8*)Key.Get(), Key.Length());
+		FMD5Hash Hash;
+		Hash.Set(Md5);
+		return LexToString(Hash);
+	}
+
+	static FString AssetNameFor(const FString& RelativeFile)
+	{
+		FString Name = ObjectTools::SanitizeObjectName(FPaths::GetBaseFilename(RelativeFile));
+		return Name.StartsWith(TEXT("AN_")) ? Name : TEXT("AN_") + Name;
+	}
+
+	// Package path mirrors the file's subfolder under the source directory.
+	static FString PackagePathFor(const FOptions& Options, const FString& RelativeFile)
+	{
+		const FString SubDir = FPaths::GetPath(RelativeFile);
+		return SubDir.IsEmpty() ? Options.Destination : Options.Destination / ObjectTools::SanitizeObjectPath(SubDir);
+	}
+
+	static UFbxImportUI* MakeImportUI(const FOptions& Options, USkeleton* Skeleton)
+	{
+		UFbxImportUI* ImportUI = NewObject<UFbxImportUI>();
+		ImportUI->bAutomatedImportShouldDetectType = false;
+		ImportUI->MeshTypeToImport = FBXIT_Animation;
+		ImportUI->OriginalImportType = FBXIT_SkeletalMesh;
+		ImportUI->bImportMesh = false;
+		ImportUI->bImportAnimations = true;
+		ImportUI->bImportMaterials = false;
+		ImportUI->bImportTextures = false;
+		ImportUI->Skeleton = Skeleton;
+
+		UFbxAnimSequenceImportData* AnimData = ImportUI->AnimSequenceImportData;
+		AnimData->bConvertScene = true;
+		AnimData->bConvertSceneUnit = true;
+		AnimData->bForceFrontXAxis = Options.bForceFrontXAxis;
+		AnimData->ImportUniformScale = Options.Scale;
+		AnimData->AnimationLength = FBXALIT_ExportedTime;
+		AnimData->bUseDefaultSampleRate = false;
+		AnimData->CustomSampleRate = Options.FrameRate;
+		AnimData->bSnapToClosestFrameBoundary = true;
+		AnimData->bImportBoneTracks = true;
+		return ImportUI;
+	}
+
+	// Dead frames at each end: frames where no bone moves faster than TrimSpeed, keeping one still
+	// frame before the first motion and after the last. A clip that never moves is left whole.
+	static void FindDeadFrames(const UAnimSequence* Clip, float TrimSpeed, int32& OutHead, int32& OutTail)
+	{
+		OutHead = 0;
+		OutTail = 0;
+
+		const USkeleton* Skeleton = Clip->GetSkeleton();
+		const int32 NumFrames = Clip->GetNumberOfSampledKeys();
+		if (!Skeleton || NumFrames < 3)
+		{
+			return;
+		}
+
+		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+		const int32 NumBones = RefSkeleton.GetNum();
+		const FFrameRate FrameRate = Clip->GetSamplingFrameRate();
+		const double Threshold = TrimSpeed * FrameRate.AsInterval();
+
+		// Component-space bone positions per frame; parents come before children in the reference skeleton.
+		TArray<FVector> Positions;
+		Positions.SetNumUninitialized(NumFrames * NumBones);
+		ParallelFor(NumFrames, [&](int32 Frame)
+		{
+			const FAnimExtractContext Context(FrameRate.AsSeconds(Frame));
+			TArray<FTransform> Component;
+			Component.SetNumUninitialized(NumBones);
+			for (int32 Bone = 0; Bone < NumBones; ++Bone)
+			{
+				FTransform Local;
+				Clip->GetBoneTransform(Local, FSkeletonPoseBoneIndex(Bone), Context, true);
+				const int32 Parent = RefSkeleton.GetParentIndex(Bone);
+				Component[Bone] = Parent != INDEX_NONE ? Local * Component[Parent] : Local;
+				Positions[Frame * NumBones + Bone] = Component[Bone].GetTranslation();
+			}
+		});
+
+		auto Moves = [&](int32 Frame)
+		{
+			for (int32 Bone = 0; Bone < NumBones; ++Bone)
+			{
+				if (FVector::DistSquared(Positions[Frame * NumBones + Bone], Positions[(Frame - 1) * NumBones + Bone]) > Threshold * Threshold)
+				{
+					return true;
+				}
+			}
+			return false;
+		};
+
+		int32 FirstMoving = INDEX_NONE;
+		for (int32 Frame = 1; Frame < NumFrames && FirstMoving == INDEX_NONE; ++Frame)
+		{
+			FirstMoving = Moves(Frame) ? Frame : INDEX_NONE;
+		}
+		if (FirstMoving == INDEX_NONE)
+		{
+			return;
+		}
+
+		int32 LastMoving = FirstMoving;
+		for (int32 Frame = NumFrames - 1; Frame > FirstMoving; --Frame)
+		{
+			if (Moves(Frame))
+			{
+				LastMoving = Frame;
+				break;
+			}
+		}
+
+		OutHead = FirstMoving - 1;
+		OutTail = NumFrames - 1 - LastMoving;
+	}
+
+	static bool ImportFile(const FOptions& Options, USkeleton* Skeleton, const FString& RelativeFile, FManifestEntry& InOutEntry)
+	{
+		UAssetImportTask* Task = NewObject<UAssetImportTask>();
+		Task->Filename = FPaths::Combine(Options.SourceDir, RelativeFile);
+		Task->DestinationPath = PackagePathFor(Options, RelativeFile);
+		Task->DestinationName = AssetNameFor(RelativeFile);
+		Task->bAutomated = true;
+		Task->bReplaceExisting = true;
+		Task->bSave = false;
+		Task->Options = MakeImportUI(Options, Skeleton);
+
+		IAssetTools& AssetTools = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools").Get();
+		AssetTools.ImportAssetTasks({ Task });
+
+		UAnimSequence* Clip = nullptr;
+		for (UObject* Object : Task->GetObjects())
+		{
+			Clip = Clip ? Clip : Cast<UAnimSequence>(Object);
+		}
+		if (!Clip)
+		{
+			UE_LOG(LogProceduralLocomotionImport, Error, TEXT("Import: %s produced no animation sequence."), *RelativeFile);
+			return false;
+		}
+
+		int32 Head = 0;
+		int32 Tail = 0;
+		FindDeadFrames(Clip, Options.TrimSpeed, Head, Tail);
+		const FFrameRate FrameRate = Clip->GetSamplingFrameRate();
+		const int32 NumFrames = Clip->GetNumberOfSampledKeys();
+		if (Tail > 0)
+		{
+			UE::Anim::AnimationData::Trim(Clip, FrameRate.AsSeconds(NumFrames - Tail), Clip->GetPlayLength(), true);
+		}
+		if (Head > 0)
+		{
+			UE::Anim::AnimationData::Trim(Clip, 0.0f, FrameRate.AsSeconds(Head));
+		}
+
+		if (!ProceduralLocomotionCommandlet::SaveAssetPackage(Clip))
+		{
+			return false;
+		}
+
+		InOutEntry.Asset = Clip->GetPathName();
+		InOutEntry.NumFrames = NumFrames - Head - Tail;
+		InOutEntry.TrimmedHead = Head;
+		InOutEntry.TrimmedTail = Tail;
+		UE_LOG(LogProceduralLocomotionImport, Display, TEXT("Import: %s -> %s, %d frames at %d fps (trimmed %d head, %d tail)"),
+			*RelativeFile, *InOutEntry.Asset, InOutEntry.NumFrames, Options.FrameRate, Head, Tail);
+		return true;
+	}
+
+	// Imports Files into this process's manifest; returns the number that failed.
+	static int32 ImportFiles(const FOptions& Options, const TArray<FString>& Files, const TMap<FString, FString>& Hashes, FManifest& InOutManifest)
+	{
+		USkeleton* Skeleton = LoadObject<USkeleton>(nullptr, *Options.SkeletonPath);
+		if (!Skeleton)
+		{
+			UE_LOG(LogProceduralLocomotionImport, Error, TEXT("Import: could not load skeleton %s."), *Options.SkeletonPath);
+			return Files.Num();
+		}
+
+		int32 NumFailed = 0;
+		for (const FString& File : Files)
+		{
+			FManifestEntry Entry;
+			Entry.Hash = Hashes.FindRef(File);
+			if (ImportFile(Options, Skeleton, File, Entry))
+			{
+				InOutManifest.Add(File, Entry);
+			}
+			else
+			{
+				++NumFailed;
+			}
+		}
+		return NumFailed;
+	}
+
+	// Splits Files round-robin over NumJobs child commandlets, waits for them and merges their
+	// manifests; returns the number of files that failed.
+	static int32 ImportInChildren(const FOptions& Options, const TArray<FString>& Files, const TMap<FString, FString>& Hashes, int32 NumJobs, FManifest& InOutManifest)
+	{
+		const FString WorkDir = FPaths::ProjectSavedDir() / TEXT("MoCapImport");
+		const FString Executable = FPlatformProcess::ExecutablePath();
+		const FString Project = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+
+		TArray<FProcHandle> Processes;
+		TArray<FString> ShardManifests;
+		for (int32 Job = 0; Job < NumJobs; ++Job)
+		{
+			FManifest Shard;
+			for (int32 Index = Job; Index < Files.Num(); Index += NumJobs)
+			{
+				Shard.Add(Files[Index], { Hashes.FindRef(Files[Index]) });
+			}
+
+			const FString ShardFile = WorkDir / FString::Printf(TEXT("Shard_%d.json"), Job);
+			SaveManifest(ShardFile, Shard);
+			ShardManifests.Add(ShardFile);
+
+			const FString Args = FString::Printf(TEXT("\"%s\" -run=ProceduralLocomotionImport %s -Shard=\"%s\" -abslog=\"%s\" -unattended -nullrhi -nosplash -nopause"),
+				*Project, *Options.ToParams(), *ShardFile, *(WorkDir / FString::Printf(TEXT("Shard_%d.log"), Job)));
+			Processes.Add(FPlatformProcess::CreateProc(*Executable, *Args, false, true, true, nullptr, 0, nullptr, nullptr));
+			if (!Processes.Last().IsValid())
+			{
+				UE_LOG(LogProceduralLocomotionImport, Error, TEXT("Import: could not start job %d."), Job);
+			}
+		}
+		UE_LOG(LogProceduralLocomotionImport, Display, TEXT("Import: %d files across %d jobs; logs in %s"), Files.Num(), NumJobs, *WorkDir);
+
+		int32 NumFailed = 0;
+		for (int32 Job = 0; Job < NumJobs; ++Job)
+		{
+			if (Processes[Job].IsValid())
+			{
+				FPlatformProcess::WaitForProc(Processes[Job]);
+				FPlatformProcess::CloseProc(Processes[Job]);
+			}
+
+			// A child rewrites its shard with the entries it imported; the rest failed.
+			FManifest Shard;
+			LoadManifest(ShardManifests[Job], Shard);
+			for (int32 Index = Job; Index < Files.Num(); Index += NumJobs)
+			{
+				const FManifestEntry* Entry = Shard.Find(Files[Index]);
+				if (Entry && !Entry->Asset.IsEmpty())
+				{
+					InOutManifest.Add(Files[Index], *Entry);
+				}
+				else
+				{
+					++NumFailed;
+				}
+			}
+			IFileManager::Get().Delete(*ShardManifests[Job]);
+		}
+		return NumFailed;
+	}
+}
+
+UProceduralLocomotionImportCommandlet::UProceduralLocomotionImportCommandlet()
+{
+	LogToConsole = true;
+}
+
+int32 UProceduralLocomotionImportCommandlet::Main(const FString& Params)
+{
+	using namespace ProceduralLocomotionImport;
+
+	FOptions Options;
+	int32 NumJobs = FMath::Max(FPlatformMisc::NumberOfCores() / 2, 1);
+	FString ManifestFile;
+	FString ShardFile;
+	FParse::Value(*Params, TEXT("Source="), Options.SourceDir);
+	FParse::Value(*Params, TEXT("Skeleton="), Options.SkeletonPath);
+	FParse::Value(*Params, TEXT("Destination="), Options.Destination);
+	FParse::Value(*Params, TEXT("FrameRate="), Options.FrameRate);
+	FParse::Value(*Params, TEXT("Scale="), Options.Scale);
+	FParse::Value(*Params, TEXT("TrimSpeed="), Options.TrimSpeed);
+	FParse::Value(*Params, TEXT("Jobs="), NumJobs);
+	FParse::Value(*Params, TEXT("Manifest="), ManifestFile);
+	FParse::Value(*Params, TEXT("Shard="), ShardFile);
+	Options.bForceFrontXAxis = FParse::Param(*Params, TEXT("ForceFrontXAxis"));
+	const bool bForce = FParse::Param(*Params, TEXT("Force"));
+	Options.SourceDir = FPaths::ConvertRelativePathToFull(Options.SourceDir);
+	Options.FrameRate = FMath::Max(Options.FrameRate, 1);
+
+	if (Options.SkeletonPath.IsEmpty() || !IFileManager::Get().DirectoryExists(*Options.SourceDir))
+	{
+		UE_LOG(LogProceduralLocomotionImport, Error, TEXT("Import: needs -Source=<Directory of .fbx> and -Skeleton=<Skeleton>."));
+		return 1;
+	}
+
+	// Child of a -Jobs run: import the shard's files and write back what was imported.
+	if (!ShardFile.IsEmpty())
+	{
+		FManifest Shard;
+		if (!LoadManifest(ShardFile, Shard))
+		{
+			return 1;
+		}
+
+		TArray<FString> Files;
+		TMap<FString, FString> Hashes;
+		for (const TPair<FString, FManifestEntry>& Pair : Shard)
+		{
+			Files.Add(Pair.Key);
+			Hashes.Add(Pair.Key, Pair.Value.Hash);
+		}
+
+		FManifest Imported;
+		const int32 NumFailed = ImportFiles(Options, Files, Hashes, Imported);
+		SaveManifest(ShardFile, Imported);
+		return NumFailed > 0 ? 1 : 0;
+	}
+
+	if (ManifestFile.IsEmpty())
+	{
+		ManifestFile = FPaths::ProjectSavedDir() / TEXT("MoCapImport") / ObjectTools::SanitizeObjectName(Options.Destination) + TEXT(".json");
+	}
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFilesRecursive(Files, *Options.SourceDir, TEXT("*.fbx"), true, false);
+	for (FString& File : Files)
+	{
+		FPaths::MakePathRelativeTo(File, *(Options.SourceDir / TEXT("")));
+	}
+	Files.Sort();
+
+	// Hashing reads every file, so it runs in parallel; only the import itself needs the FBX SDK.
+	const FString SettingsKey = Options.SettingsKey();
+	TArray<FString> FileHashes;
+	FileHashes.SetNum(Files.Num());
+	ParallelFor(Files.Num(), [&](int32 Index)
+	{
+		FileHashes[Index] = HashFile(FPaths::Combine(Options.SourceDir, Files[Index]), SettingsKey);
+	});
+
+	FManifest Manifest;
+	if (!bForce)
+	{
+		LoadManifest(ManifestFile, Manifest);
+	}
+
+	TArray<FString> Changed;
+	TMap<FString, FString> Hashes;
+	for (int32 Index = 0; Index < Files.Num(); ++Index)
+	{
+		const FManifestEntry* Entry = Manifest.Find(Files[Index]);
+		const bool bUpToDate = Entry && Entry->Hash == FileHashes[Index]
+			&& FPackageName::DoesPackageExist(FPackageName::ObjectPathToPackageName(Entry->Asset));
+		if (!bUpToDate)
+		{
+			Changed.Add(Files[Index]);
+			Hashes.Add(Files[Index], FileHashes[Index]);
+		}
+	}
+	UE_LOG(LogProceduralLocomotionImport, Display, TEXT("Import: %d files in %s, %d changed."), Files.Num(), *Options.SourceDir, Changed.Num());
+
+	NumJobs = FMath::Clamp(NumJobs, 1, FMath::Max(Changed.Num(), 1));
+	const int32 NumFailed = NumJobs > 1
+		? ImportInChildren(Options, Changed, Hashes, NumJobs, Manifest)
+		: ImportFiles(Options, Changed, Hashes, Manifest);
+
+	// Files no longer in the source keep their assets; they are only dropped from the manifest.
+	for (auto It = Manifest.CreateIterator(); It; ++It)
+	{
+		if (!Files.Contains(It.Key()))
+		{
+			UE_LOG(LogProceduralLocomotionImport, Display, TEXT("Import: %s is gone from the source; %s left in place."), *It.Key(), *It.Value().Asset);
+			It.RemoveCurrent();
+		}
+	}
+	SaveManifest(ManifestFile, Manifest);
+
+	UE_LOG(LogProceduralLocomotionImport, Display, TEXT("Import: %d imported, %d unchanged, %d failed; manifest at %s"),
+		Changed.Num() - NumFailed, Files.Num() - Changed.Num(), NumFailed, *ManifestFile);
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#include "Modules/ModuleManager.h"
+
+// Anim graph nodes for the runtime module's anim nodes and the footstep modifier; only loaded
+// where Blueprints compile.
+IMPLEMENT_MODULE(FDefaultModuleImpl, ProceduralLocomotionSystemEditor);
@@ -0,0 +1,33 @@
+using UnrealBuildTool;
+
+public class ProceduralLocomotionSystemEditor : ModuleRules
+{
+	public ProceduralLocomotionSystemEditor(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"AnimGraph",
+				"ProceduralLocomotionSystem"
+			}
+		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"BlueprintGraph",
+				"UnrealEd",
+				"AssetRegistry",
+				"AnimationModifiers",
+				"AnimationBlueprintLibrary",
+				"AssetTools",
+				"Json"
+			}
+		);
+	}
+}
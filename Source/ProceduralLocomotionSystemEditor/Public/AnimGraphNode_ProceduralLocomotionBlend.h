@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimGraphNode_Base.h"
+#include "AnimNode_ProceduralLocomotionBlend.h"
+#include "AnimGraphNode_ProceduralLocomotionBlend.generated.h"
+
+UCLASS()
+class PROCEDURALLOCOMOTIONSYSTEMEDITOR_API UAnimGraphNode_ProceduralLocomotionBlend : public UAnimGraphNode_Base
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = Settings)
+	FAnimNode_ProceduralLocomotionBlend Node;
+
+	// UEdGraphNode
+	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
+	virtual FText GetTooltipText() const override;
+	virtual FLinearColor GetNodeTitleColor() const override;
+
+	// UAnimGraphNode_Base
+	virtual FString GetNodeCategory() const override;
+	virtual void ValidateAnimNodeDuringCompilation(USkeleton* ForSkeleton, FCompilerResultsLog& MessageLog) override;
+	virtual void PreloadRequiredAssets() override;
+};
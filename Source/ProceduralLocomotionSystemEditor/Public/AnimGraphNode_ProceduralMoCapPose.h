@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimGraphNode_Base.h"
+#include "AnimNode_ProceduralMoCapPose.h"
+#include "AnimGraphNode_ProceduralMoCapPose.generated.h"
+
+UCLASS()
+class PROCEDURALLOCOMOTIONSYSTEMEDITOR_API UAnimGraphNode_ProceduralMoCapPose : public UAnimGraphNode_Base
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = Settings)
+	FAnimNode_ProceduralMoCapPose Node;
+
+	// UEdGraphNode
+	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
+	virtual FText GetTooltipText() const override;
+	virtual FLinearColor GetNodeTitleColor() const override;
+
+	// UAnimGraphNode_Base
+	virtual FString GetNodeCategory() const override;
+};
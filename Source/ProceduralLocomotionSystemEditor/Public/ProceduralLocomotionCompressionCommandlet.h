@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ProceduralLocomotionCompressionCommandlet.generated.h"
+
+/**
+ * Picks bone compression per clip for a MoCap library: the smallest candidate whose end-effector
+ * error stays under -ErrorBudget.
+ *
+ * Every clip is compressed with each candidate. The built-in candidates are bitwise, linear key
+ * reduction and per-track codecs at several settings; -Settings adds existing
+ * UAnimBoneCompressionSettings assets, such as ACL ones. Compression runs through the engine's
+ * async derived data tasks, one candidate at a time for the whole library. The clips are then
+ * measured in parallel against their raw data: worst component-space position error of the
+ * -Effectors (feet and hands by default, since foot IK relies on them), and the time taken to
+ * decode every bone of a pose.
+ *
+ * The report lists every clip and candidate with its size, error and decode cost, and logs the
+ * memory saved per clip and overall. With -Apply the choices are written: chosen built-in
+ * candidates are saved as settings assets under -SettingsPath, then the clips are saved.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=ProceduralLocomotionCompression
+ *       -Clips=/Game/MoCap/Retargeted[,<Folder or AnimSequence>...]
+ *       [-ErrorBudget=0.1] [-Effectors=foot_l,foot_r,hand_l,hand_r] [-SampleRate=30]
+ *       [-Settings=<AnimBoneCompressionSettings>,...] [-Report=<File.csv>]
+ *       [-Apply] [-SettingsPath=/Game/Locomotion/Compression]
+ */
+UCLASS()
+class UProceduralLocomotionCompressionCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UProceduralLocomotionCompressionCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ProceduralLocomotionDuplicatesCommandlet.generated.h"
+
+/**
+ * Finds near-duplicate takes in a MoCap library so redundant clips can be pruned.
+ *
+ * Each clip is reduced to a fingerprint: the -Joints' pelvis-relative positions and component-space
+ * velocities at -Samples points spread evenly over the clip. Fingerprints are hashed into 64-bit
+ * SimHash signatures (random hyperplanes), split into -Bands bands. Only clips sharing a band are
+ * compared exactly, instead of every pair. A pair is a duplicate when its fingerprints' cosine
+ * similarity reaches -Similarity and its lengths differ by at most -LengthTolerance. Duplicates
+ * are grouped transitively.
+ *
+ * Each group keeps the clip with the most referencers. The others are reported as redundant
+ * with their compressed size, so the report shows what pruning them would save.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=ProceduralLocomotionDuplicates
+ *       -Clips=/Game/MoCap/Retargeted[,<Folder or AnimSequence>...]
+ *       [-Joints=pelvis,foot_l,foot_r,hand_l,hand_r,head] [-Samples=32] [-Similarity=0.97]
+ *       [-LengthTolerance=0.1] [-Bands=8] [-Report=<File.csv>]
+ */
+UCLASS()
+class UProceduralLocomotionDuplicatesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UProceduralLocomotionDuplicatesCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
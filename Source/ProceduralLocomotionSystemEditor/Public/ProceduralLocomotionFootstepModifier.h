@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationModifier.h"
+#include "ProceduralLocomotionFootstepModifier.generated.h"
+
+/**
+ * Detects foot plants and writes them as sync markers (Foot_L, Foot_R by default), then bakes a
+ * UProceduralLocomotionMarkerIndex onto the sequence for UProceduralLocomotionAnimInstance's
+ * marker sync. Applying it again replaces both; reverting removes both.
+ *
+ * A foot plants on the first frame its height above the root drops within PlantHeightTolerance
+ * of its lowest point in the clip, and must rise above ReleaseHeightTolerance before it can
+ * plant again. That works for in-place and root motion clips alike.
+ */
+UCLASS()
+class PROCEDURALLOCOMOTIONSYSTEMEDITOR_API UProceduralLocomotionFootstepModifier : public UAnimationModifier
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Footsteps")
+	FName LeftFootBone = TEXT("foot_l");
+
+	UPROPERTY(EditAnywhere, Category = "Footsteps")
+	FName RightFootBone = TEXT("foot_r");
+
+	UPROPERTY(EditAnywhere, Category = "Footsteps")
+	FName LeftMarkerName = TEXT("Foot_L");
+
+	UPROPERTY(EditAnywhere, Category = "Footsteps")
+	FName RightMarkerName = TEXT("Foot_R");
+
+	UPROPERTY(EditAnywhere, Category = "Footsteps")
+	FName MarkerTrackName = TEXT("Footsteps");
+
+	// Gait phase of each plant in the baked index; the anim instance's LocomotionPhase uses the same scale.
+	UPROPERTY(EditAnywhere, Category = "Footsteps", meta = (ClampMin = "0", ClampMax = "1"))
+	float LeftPlantPhase = 0.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Footsteps", meta = (ClampMin = "0", ClampMax = "1"))
+	float RightPlantPhase = 0.5f;
+
+	// cm above the foot's lowest point that still counts as planted.
+	UPROPERTY(EditAnywhere, Category = "Footsteps", meta = (ClampMin = "0"))
+	float PlantHeightTolerance = 3.0f;
+
+	// cm above the lowest point the foot has to lift before it can plant again.
+	UPROPERTY(EditAnywhere, Category = "Footsteps", meta = (ClampMin = "0"))
+	float ReleaseHeightTolerance = 6.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Footsteps", meta = (ClampMin = "0"))
+	float MinTimeBetweenSteps = 0.18f;
+
+	UPROPERTY(EditAnywhere, Category = "Footsteps", meta = (ClampMin = "10"))
+	int32 SampleRate = 60;
+
+	// UAnimationModifier
+	virtual void OnApply_Implementation(UAnimSequence* Animation) override;
+	virtual void OnRevert_Implementation(UAnimSequence* Animation) override;
+
+private:
+	// Plant times (seconds) of one foot.
+	TArray<float> DetectPlants(const UAnimSequence* Animation, FName FootBone) const;
+};
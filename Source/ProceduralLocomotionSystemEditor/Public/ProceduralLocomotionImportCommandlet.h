@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ProceduralLocomotionImportCommandlet.generated.h"
+
+/**
+ * Imports a directory of MoCap FBX captures as UAnimSequence assets on -Skeleton, replacing the
+ * one-file-at-a-time import of MoCap_Workflow.md section 1.
+ *
+ * Every clip is brought in the same way: scene axes converted to UE's Z-up, X-forward (or
+ * -ForceFrontXAxis), units converted to centimetres (times -Scale), and resampled to -FrameRate.
+ * Dead frames are then trimmed from the head and tail, keeping one still frame at each end. A
+ * frame is dead when no bone moves faster than -TrimSpeed (cm/s).
+ *
+ * A manifest records a hash of each file's contents combined with the import settings, so a
+ * re-run only imports files that changed (or whose asset is missing); -Force imports everything.
+ * The FBX SDK is not thread-safe, so with -Jobs above 1 the changed files are split across that
+ * many child commandlet processes, each importing its share in parallel. The parent merges
+ * their manifests.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=ProceduralLocomotionImport
+ *       -Source=/mnt/mocap/session_04 -Skeleton=/Game/MoCap/Source/SK_Source_Skeleton
+ *       [-Destination=/Game/MoCap/Raw] [-FrameRate=30] [-Scale=1] [-ForceFrontXAxis]
+ *       [-TrimSpeed=2] [-Jobs=4] [-Force] [-Manifest=<File.json>]
+ */
+UCLASS()
+class UProceduralLocomotionImportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UProceduralLocomotionImportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
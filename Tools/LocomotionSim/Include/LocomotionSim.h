@@ -0,0 +1,170 @@
+#pragma once
+
+// Batch simulation of the Python demo characters, built on the same ProceduralLocomotionMath
+// the UE anim instance uses. Characters are rows of a float state table addressed through
+// element strides, so callers (the pybind11 module, the offline renderer) can hand in numpy
+// arrays or slices of them without copying.
+
+#include "ProceduralLocomotionMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace LocomotionSim
+{
+	// Columns of the state table. Positions are metres in the demo's 2D plane, rotation is
+	// radians counter-clockwise, lean is degrees (positive leans right, as in UE).
+	enum EStateField : int32_t
+	{
+		PosX,
+		PosY,
+		VelX,
+		VelY,
+		Rotation,
+		LeanAngle,
+		GroundSpeed,
+		Time,
+		LastYaw,      // UE-convention yaw (degrees, clockwise) seen by the previous lean step
+		InputForward, // Input driver: -1..1
+		InputTurn,    // Input driver: -1..1, positive turns counter-clockwise
+		PathPhase,    // Path driver: phase offset of the figure-8 (radians)
+		PathCenterX,
+		PathCenterY,
+		NumStateFields
+	};
+
+	enum ESkeletonPoint : int32_t
+	{
+		Hip,
+		SpineTop,
+		Head,
+		LeftFoot,
+		RightFoot,
+		LeftHand,
+		RightHand,
+		NumSkeletonPoints
+	};
+
+	enum class EDriver : int32_t
+	{
+		// Steers towards a point moving along a figure-8 (standalone_animation_demo.py).
+		Path,
+		// Accelerates from InputForward/InputTurn (interactive_animation_demo.py).
+		Input
+	};
+
+	struct FSimParams
+	{
+		ProceduralLocomotionMath::FLeanParams Lean;
+		ProceduralLocomotionMath::FBoneOscillationParams HeadOscillation;
+
+		// Path driver
+		float PathAngularSpeed = 0.3f;
+		float PathRadiusX = 3.0f;
+		float PathRadiusY = 1.5f;
+		float WalkSpeed = 2.0f;
+		float TurnSmoothing = 5.0f;
+
+		// Input driver
+		float MaxSpeed = 3.0f;
+		float Acceleration = 8.0f;
+		float TurnSpeed = 2.5f;
+		float Friction = 0.85f;
+
+		// Rig proportions (metres)
+		float BodyHeight = 1.8f;
+		float HeadSize = 0.2f;
+		float LegLength = 0.9f;
+		// The stride never slows below this speed, so idle characters keep stepping (interactive demo uses 0.5).
+		float MinStrideSpeed = 0.0f;
+
+		// Separation from neighbours closer than AvoidanceRadius metres, up to AvoidanceStrength m/s
+		// at contact. Only UpdateRows with a neighbour grid applies it.
+		float AvoidanceRadius = 0.0f;
+		float AvoidanceStrength = 1.5f;
+	};
+
+	// View of a state table: element Row * RowStride + Field * FieldStride holds a field.
+	struct FStateView
+	{
+		float* Data = nullptr;
+		int64_t Count = 0;
+		int64_t RowStride = NumStateFields;
+		int64_t FieldStride = 1;
+
+		float& At(int64_t Row, int32_t Field) const { return Data[Row * RowStride + Field * FieldStride]; }
+	};
+
+	// Zeroes the rows and spreads the characters over a square grid with Spacing metres between
+	// path centres; each starts on its figure-8 at a phase derived from Seed.
+	void InitializeStates(const FStateView& States, float Spacing, uint32_t Seed, const FSimParams& Params);
+
+	// Advances every character by DeltaSeconds: moves it with the driver, then runs the UE lean step.
+	void Update(const FStateView& States, float DeltaSeconds, EDriver Driver, const FSimParams& Params);
+
+	// Uniform grid over a subset of a state table's rows, for avoidance queries. Rows are kept
+	// sorted by (cell, row), so neighbours are always visited in the same order whichever other
+	// rows the grid holds; sharded and single-process updates therefore sum identically.
+	class FNeighbourGrid
+	{
+	public:
+		// Indexes Rows of Neighbours by position. Storage is reused across builds.
+		void Build(const FStateView& InNeighbours, const int64_t* Rows, int64_t NumRows, float InCellSize);
+
+		const FStateView& GetNeighbours() const { return Neighbours; }
+
+		// Calls Visit(Row) for every indexed row in the 3x3 cells around (X, Y).
+		template <typename FunctorType>
+		void ForEachNearby(float X, float Y, FunctorType&& Visit) const;
+
+	private:
+		uint64_t CellKey(int32_t CellX, int32_t CellY) const;
+		int32_t CellCoord(float Value) const;
+
+		FStateView Neighbours;
+		float CellSize = 1.0f;
+		std::vector<std::pair<uint64_t, int64_t>> Entries;
+	};
+
+	// Advances Rows of States like Update. With a grid, each character also steers away from the
+	// grid's neighbours, read from the grid's (previous frame) view rather than States, so the
+	// result doesn't depend on update order.
+	void UpdateRows(const FStateView& States, const int64_t* Rows, int64_t NumRows, float DeltaSeconds, EDriver Driver,
+		const FSimParams& Params, const FNeighbourGrid* Avoidance);
+
+	// Writes Count * NumSkeletonPoints (x, y) pairs, contiguous per character.
+	void ComputeSkeletonPoints(const FStateView& States, const FSimParams& Params, float* OutPoints);
+
+	inline uint64_t FNeighbourGrid::CellKey(int32_t CellX, int32_t CellY) const
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(CellX)) << 32) | static_cast<uint32_t>(CellY);
+	}
+
+	inline int32_t FNeighbourGrid::CellCoord(float Value) const
+	{
+		return static_cast<int32_t>(std::floor(Value / CellSize));
+	}
+
+	template <typename FunctorType>
+	void FNeighbourGrid::ForEachNearby(float X, float Y, FunctorType&& Visit) const
+	{
+		const int32_t CenterX = CellCoord(X);
+		const int32_t CenterY = CellCoord(Y);
+		for (int32_t CellX = CenterX - 1; CellX <= CenterX + 1; ++CellX)
+		{
+			for (int32_t CellY = CenterY - 1; CellY <= CenterY + 1; ++CellY)
+			{
+				const uint64_t Key = CellKey(CellX, CellY);
+				auto It = std::lower_bound(Entries.begin(), Entries.end(), std::make_pair(Key, std::numeric_limits<int64_t>::min()));
+				for (; It != Entries.end() && It->first == Key; ++It)
+				{
+					Visit(It->second);
+				}
+			}
+		}
+	}
+}
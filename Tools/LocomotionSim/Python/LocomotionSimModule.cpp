@@ -0,0 +1,139 @@
+// pybind11 module `pls_native`: exposes LocomotionSim over numpy arrays without copying.
+// State tables must be float32 arrays of shape (N, NUM_STATE_FIELDS); any row/column strides
+// are accepted, so slices of a larger table work in place. Anything else raises instead of
+// being converted, since a converted copy would silently drop the update.
+
+#include "LocomotionSim.h"
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <string>
+
+namespace py = pybind11;
+
+namespace
+{
+	LocomotionSim::FStateView MakeStateView(py::array& States, bool bWritable)
+	{
+		if (!States.dtype().is(py::dtype::of<float>()))
+		{
+			throw py::type_error("states must be a float32 numpy array");
+		}
+		if (States.ndim() != 2 || States.shape(1) != LocomotionSim::NumStateFields)
+		{
+			throw py::value_error("states must have shape (N, " + std::to_string(LocomotionSim::NumStateFields) + ")");
+		}
+		if (bWritable && !States.writeable())
+		{
+			throw py::value_error("states must be writable");
+		}
+		if (States.strides(0) % sizeof(float) != 0 || States.strides(1) % sizeof(float) != 0)
+		{
+			throw py::value_error("states strides must be multiples of the element size");
+		}
+
+		LocomotionSim::FStateView View;
+		View.Data = static_cast<float*>(bWritable ? States.mutable_data() : const_cast<void*>(States.data()));
+		View.Count = States.shape(0);
+		View.RowStride = States.strides(0) / static_cast<py::ssize_t>(sizeof(float));
+		View.FieldStride = States.strides(1) / static_cast<py::ssize_t>(sizeof(float));
+		return View;
+	}
+
+	LocomotionSim::EDriver ParseDriver(const std::string& Driver)
+	{
+		if (Driver == "path")
+		{
+			return LocomotionSim::EDriver::Path;
+		}
+		if (Driver == "input")
+		{
+			return LocomotionSim::EDriver::Input;
+		}
+		throw py::value_error("driver must be 'path' or 'input'");
+	}
+}
+
+PYBIND11_MODULE(pls_native, Module)
+{
+	Module.doc() = "Native batch simulation for the procedural locomotion demos";
+
+	Module.attr("NUM_STATE_FIELDS") = static_cast<int>(LocomotionSim::NumStateFields);
+	Module.attr("NUM_SKELETON_POINTS") = static_cast<int>(LocomotionSim::NumSkeletonPoints);
+
+	py::class_<ProceduralLocomotionMath::FLeanParams>(Module, "LeanParams")
+		.def(py::init<>())
+		.def_readwrite("max_lean_angle", &ProceduralLocomotionMath::FLeanParams::MaxLeanAngle)
+		.def_readwrite("acceleration_lean_multiplier", &ProceduralLocomotionMath::FLeanParams::AccelerationLeanMultiplier)
+		.def_readwrite("yaw_rate_lean_multiplier", &ProceduralLocomotionMath::FLeanParams::YawRateLeanMultiplier)
+		.def_readwrite("lean_interp_speed", &ProceduralLocomotionMath::FLeanParams::LeanInterpSpeed);
+
+	py::class_<ProceduralLocomotionMath::FBoneOscillationParams>(Module, "OscillationParams")
+		.def(py::init<>())
+		.def_readwrite("pitch_amplitude", &ProceduralLocomotionMath::FBoneOscillationParams::PitchAmplitude)
+		.def_readwrite("yaw_amplitude", &ProceduralLocomotionMath::FBoneOscillationParams::YawAmplitude)
+		.def_readwrite("speed", &ProceduralLocomotionMath::FBoneOscillationParams::Speed);
+
+	py::class_<LocomotionSim::FSimParams>(Module, "SimParams")
+		.def(py::init<>())
+		.def_readwrite("lean", &LocomotionSim::FSimParams::Lean)
+		.def_readwrite("head_oscillation", &LocomotionSim::FSimParams::HeadOscillation)
+		.def_readwrite("path_angular_speed", &LocomotionSim::FSimParams::PathAngularSpeed)
+		.def_readwrite("path_radius_x", &LocomotionSim::FSimParams::PathRadiusX)
+		.def_readwrite("path_radius_y", &LocomotionSim::FSimParams::PathRadiusY)
+		.def_readwrite("walk_speed", &LocomotionSim::FSimParams::WalkSpeed)
+		.def_readwrite("turn_smoothing", &LocomotionSim::FSimParams::TurnSmoothing)
+		.def_readwrite("max_speed", &LocomotionSim::FSimParams::MaxSpeed)
+		.def_readwrite("acceleration", &LocomotionSim::FSimParams::Acceleration)
+		.def_readwrite("turn_speed", &LocomotionSim::FSimParams::TurnSpeed)
+		.def_readwrite("friction", &LocomotionSim::FSimParams::Friction)
+		.def_readwrite("body_height", &LocomotionSim::FSimParams::BodyHeight)
+		.def_readwrite("head_size", &LocomotionSim::FSimParams::HeadSize)
+		.def_readwrite("leg_length", &LocomotionSim::FSimParams::LegLength)
+		.def_readwrite("min_stride_speed", &LocomotionSim::FSimParams::MinStrideSpeed);
+
+	Module.def("initialize_states", [](py::array States, float Spacing, uint32_t Seed, const LocomotionSim::FSimParams& Params)
+	{
+		const LocomotionSim::FStateView View = MakeStateView(States, true);
+		py::gil_scoped_release Release;
+		LocomotionSim::InitializeStates(View, Spacing, Seed, Params);
+	}, py::arg("states"), py::arg("spacing") = 8.0f, py::arg("seed") = 1u, py::arg("params") = LocomotionSim::FSimParams());
+
+	Module.def("update", [](py::array States, float DeltaSeconds, const std::string& Driver, const LocomotionSim::FSimParams& Params)
+	{
+		const LocomotionSim::FStateView View = MakeStateView(States, true);
+		const LocomotionSim::EDriver SimDriver = ParseDriver(Driver);
+		py::gil_scoped_release Release;
+		LocomotionSim::Update(View, DeltaSeconds, SimDriver, Params);
+	}, py::arg("states"), py::arg("dt"), py::arg("driver") = "path", py::arg("params") = LocomotionSim::FSimParams(),
+	"Advances every row of states in place.");
+
+	Module.def("skeleton_points", [](py::array States, const LocomotionSim::FSimParams& Params, py::object Out)
+	{
+		const LocomotionSim::FStateView View = MakeStateView(States, false);
+
+		py::array_t<float, py::array::c_style> Points;
+		if (Out.is_none())
+		{
+			Points = py::array_t<float, py::array::c_style>({ static_cast<py::ssize_t>(View.Count), static_cast<py::ssize_t>(LocomotionSim::NumSkeletonPoints), static_cast<py::ssize_t>(2) });
+		}
+		else
+		{
+			Points = Out.cast<py::array_t<float, py::array::c_style>>();
+			if (!Out.is(Points) || Points.ndim() != 3 || Points.shape(0) != View.Count
+				|| Points.shape(1) != LocomotionSim::NumSkeletonPoints || Points.shape(2) != 2 || !Points.writeable())
+			{
+				throw py::value_error("out must be a writable C-contiguous float32 array of shape (N, NUM_SKELETON_POINTS, 2)");
+			}
+		}
+
+		float* OutPoints = Points.mutable_data();
+		{
+			py::gil_scoped_release Release;
+			LocomotionSim::ComputeSkeletonPoints(View, Params, OutPoints);
+		}
+		return Points;
+	}, py::arg("states"), py::arg("params") = LocomotionSim::FSimParams(), py::arg("out") = py::none(),
+	"Returns (N, NUM_SKELETON_POINTS, 2) joint positions: hip, spine top, head, feet, hands.");
+}
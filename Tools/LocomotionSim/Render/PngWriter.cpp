@@ -0,0 +1,141 @@
+#include "PngWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+namespace LocomotionRender
+{
+	namespace
+	{
+		const std::array<uint32_t, 256>& GetCrcTable()
+		{
+			static const std::array<uint32_t, 256> Table = []()
+			{
+				std::array<uint32_t, 256> Result{};
+				for (uint32_t Index = 0; Index < 256; ++Index)
+				{
+					uint32_t Crc = Index;
+					for (int32_t Bit = 0; Bit < 8; ++Bit)
+					{
+						Crc = (Crc & 1) ? 0xEDB88320u ^ (Crc >> 1) : Crc >> 1;
+					}
+					Result[Index] = Crc;
+				}
+				return Result;
+			}();
+			return Table;
+		}
+
+		uint32_t UpdateCrc(uint32_t Crc, const uint8_t* Data, size_t Size)
+		{
+			const std::array<uint32_t, 256>& Table = GetCrcTable();
+			for (size_t Index = 0; Index < Size; ++Index)
+			{
+				Crc = Table[(Crc ^ Data[Index]) & 0xFF] ^ (Crc >> 8);
+			}
+			return Crc;
+		}
+
+		void AppendU32(std::vector<uint8_t>& Out, uint32_t Value)
+		{
+			Out.push_back(static_cast<uint8_t>(Value >> 24));
+			Out.push_back(static_cast<uint8_t>(Value >> 16));
+			Out.push_back(static_cast<uint8_t>(Value >> 8));
+			Out.push_back(static_cast<uint8_t>(Value));
+		}
+
+		void AppendChunk(std::vector<uint8_t>& Out, const char Type[4], const std::vector<uint8_t>& Data)
+		{
+			AppendU32(Out, static_cast<uint32_t>(Data.size()));
+			const size_t TypeOffset = Out.size();
+			Out.insert(Out.end(), Type, Type + 4);
+			Out.insert(Out.end(), Data.begin(), Data.end());
+			const uint32_t Crc = UpdateCrc(0xFFFFFFFFu, Out.data() + TypeOffset, 4 + Data.size()) ^ 0xFFFFFFFFu;
+			AppendU32(Out, Crc);
+		}
+	}
+
+	void EncodePng(const uint8_t* Rgb, int32_t Width, int32_t Height, std::vector<uint8_t>& OutPng)
+	{
+		static const uint8_t Signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		OutPng.assign(Signature, Signature + 8);
+
+		std::vector<uint8_t> Header;
+		AppendU32(Header, static_cast<uint32_t>(Width));
+		AppendU32(Header, static_cast<uint32_t>(Height));
+		Header.push_back(8); // bit depth
+		Header.push_back(2); // colour type: RGB
+		Header.push_back(0); // deflate
+		Header.push_back(0); // adaptive filtering
+		Header.push_back(0); // no interlace
+		AppendChunk(OutPng, "IHDR", Header);
+
+		// Scanlines with filter type 0, wrapped in a zlib stream of stored blocks.
+		const size_t RowBytes = static_cast<size_t>(Width) * 3;
+		const size_t RawSize = (RowBytes + 1) * static_cast<size_t>(Height);
+		constexpr size_t MaxStoredBlock = 65535;
+
+		std::vector<uint8_t> Raw(RawSize);
+		for (int32_t Y = 0; Y < Height; ++Y)
+		{
+			uint8_t* Row = &Raw[(RowBytes + 1) * Y];
+			Row[0] = 0;
+			std::memcpy(Row + 1, Rgb + RowBytes * Y, RowBytes);
+		}
+
+		std::vector<uint8_t> Zlib;
+		Zlib.reserve(RawSize + RawSize / MaxStoredBlock * 5 + 16);
+		Zlib.push_back(0x78); // CMF: deflate, 32K window
+		Zlib.push_back(0x01); // FLG: no dictionary, check bits
+
+		uint32_t AdlerA = 1;
+		uint32_t AdlerB = 0;
+		for (size_t Offset = 0; Offset < RawSize || Offset == 0; Offset += MaxStoredBlock)
+		{
+			const size_t BlockSize = std::min(MaxStoredBlock, RawSize - Offset);
+			const bool bFinal = Offset + BlockSize >= RawSize;
+			Zlib.push_back(bFinal ? 1 : 0);
+			Zlib.push_back(static_cast<uint8_t>(BlockSize));
+			Zlib.push_back(static_cast<uint8_t>(BlockSize >> 8));
+			Zlib.push_back(static_cast<uint8_t>(~BlockSize));
+			Zlib.push_back(static_cast<uint8_t>(~BlockSize >> 8));
+			Zlib.insert(Zlib.end(), Raw.begin() + Offset, Raw.begin() + Offset + BlockSize);
+
+			for (size_t Index = Offset; Index < Offset + BlockSize; ++Index)
+			{
+				AdlerA += Raw[Index];
+				AdlerB += AdlerA;
+				// Deferring the modulo is safe for up to 5552 bytes; reduce often enough.
+				if ((Index & 4095) == 4095)
+				{
+					AdlerA %= 65521;
+					AdlerB %= 65521;
+				}
+			}
+			AdlerA %= 65521;
+			AdlerB %= 65521;
+
+			if (BlockSize == 0)
+			{
+				break;
+			}
+		}
+		AppendU32(Zlib, (AdlerB << 16) | AdlerA);
+
+		AppendChunk(OutPng, "IDAT", Zlib);
+		AppendChunk(OutPng, "IEND", {});
+	}
+
+	bool WriteFile(const std::string& Path, const std::vector<uint8_t>& Bytes)
+	{
+		FILE* File = std::fopen(Path.c_str(), "wb");
+		if (!File)
+		{
+			return false;
+		}
+		const bool bOk = std::fwrite(Bytes.data(), 1, Bytes.size(), File) == Bytes.size();
+		return std::fclose(File) == 0 && bOk;
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Dependency-free PNG encoder for RGB8 frames. Image data goes into stored (uncompressed)
+// deflate blocks: files are larger than zlib output but encoding is a memcpy plus checksums,
+// which keeps the renderer disk-bound rather than CPU-bound.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LocomotionRender
+{
+	void EncodePng(const uint8_t* Rgb, int32_t Width, int32_t Height, std::vector<uint8_t>& OutPng);
+
+	bool WriteFile(const std::string& Path, const std::vector<uint8_t>& Bytes);
+}
@@ -0,0 +1,101 @@
+#include "Rasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LocomotionRender
+{
+	namespace
+	{
+		float Saturate(float Value)
+		{
+			return Value < 0.0f ? 0.0f : (Value > 1.0f ? 1.0f : Value);
+		}
+	}
+
+	FImage::FImage(int32_t InWidth, int32_t InHeight)
+		: Width(InWidth)
+		, Height(InHeight)
+		, Pixels(static_cast<size_t>(InWidth) * static_cast<size_t>(InHeight) * 3)
+	{
+	}
+
+	void FImage::Clear(FColor Color)
+	{
+		for (size_t Index = 0; Index < Pixels.size(); Index += 3)
+		{
+			Pixels[Index + 0] = Color.R;
+			Pixels[Index + 1] = Color.G;
+			Pixels[Index + 2] = Color.B;
+		}
+	}
+
+	void FImage::Blend(int32_t X, int32_t Y, FColor Color, float Alpha)
+	{
+		uint8_t* Pixel = &Pixels[(static_cast<size_t>(Y) * Width + X) * 3];
+		const float InvAlpha = 1.0f - Alpha;
+		Pixel[0] = static_cast<uint8_t>(Pixel[0] * InvAlpha + Color.R * Alpha + 0.5f);
+		Pixel[1] = static_cast<uint8_t>(Pixel[1] * InvAlpha + Color.G * Alpha + 0.5f);
+		Pixel[2] = static_cast<uint8_t>(Pixel[2] * InvAlpha + Color.B * Alpha + 0.5f);
+	}
+
+	void FImage::DrawLine(float X0, float Y0, float X1, float Y1, float Radius, FColor Color, float Opacity)
+	{
+		const int32_t MinX = std::max(0, static_cast<int32_t>(std::floor(std::min(X0, X1) - Radius - 1.0f)));
+		const int32_t MaxX = std::min(Width - 1, static_cast<int32_t>(std::ceil(std::max(X0, X1) + Radius + 1.0f)));
+		const int32_t MinY = std::max(0, static_cast<int32_t>(std::floor(std::min(Y0, Y1) - Radius - 1.0f)));
+		const int32_t MaxY = std::min(Height - 1, static_cast<int32_t>(std::ceil(std::max(Y0, Y1) + Radius + 1.0f)));
+
+		const float DX = X1 - X0;
+		const float DY = Y1 - Y0;
+		const float LengthSq = DX * DX + DY * DY;
+		const float InvLengthSq = LengthSq > 0.0f ? 1.0f / LengthSq : 0.0f;
+
+		// Capsule coverage: distance from the pixel centre to the segment against the radius.
+		for (int32_t Y = MinY; Y <= MaxY; ++Y)
+		{
+			const float PY = Y + 0.5f - Y0;
+			for (int32_t X = MinX; X <= MaxX; ++X)
+			{
+				const float PX = X + 0.5f - X0;
+				const float T = Saturate((PX * DX + PY * DY) * InvLengthSq);
+				const float OffX = PX - T * DX;
+				const float OffY = PY - T * DY;
+				const float Coverage = Saturate(Radius + 0.5f - std::sqrt(OffX * OffX + OffY * OffY));
+				if (Coverage > 0.0f)
+				{
+					Blend(X, Y, Color, Coverage * Opacity);
+				}
+			}
+		}
+	}
+
+	void FImage::DrawDisc(float CX, float CY, float Radius, FColor Color)
+	{
+		DrawLine(CX, CY, CX, CY, Radius, Color);
+	}
+
+	void FImage::DrawRing(float CX, float CY, float Radius, float Thickness, FColor Color)
+	{
+		const int32_t MinX = std::max(0, static_cast<int32_t>(std::floor(CX - Radius - Thickness - 1.0f)));
+		const int32_t MaxX = std::min(Width - 1, static_cast<int32_t>(std::ceil(CX + Radius + Thickness + 1.0f)));
+		const int32_t MinY = std::max(0, static_cast<int32_t>(std::floor(CY - Radius - Thickness - 1.0f)));
+		const int32_t MaxY = std::min(Height - 1, static_cast<int32_t>(std::ceil(CY + Radius + Thickness + 1.0f)));
+
+		const float HalfThickness = 0.5f * Thickness;
+		for (int32_t Y = MinY; Y <= MaxY; ++Y)
+		{
+			const float PY = Y + 0.5f - CY;
+			for (int32_t X = MinX; X <= MaxX; ++X)
+			{
+				const float PX = X + 0.5f - CX;
+				const float Distance = std::fabs(std::sqrt(PX * PX + PY * PY) - Radius);
+				const float Coverage = Saturate(HalfThickness + 0.5f - Distance);
+				if (Coverage > 0.0f)
+				{
+					Blend(X, Y, Color, Coverage);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+// Minimal software rasterizer for stick figures: RGB8 image, anti-aliased thick lines and
+// discs. Everything is coverage-based on pixel centres, so output is deterministic across
+// platforms and thread counts.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LocomotionRender
+{
+	struct FColor
+	{
+		uint8_t R = 0;
+		uint8_t G = 0;
+		uint8_t B = 0;
+	};
+
+	class FImage
+	{
+	public:
+		FImage(int32_t InWidth, int32_t InHeight);
+
+		int32_t GetWidth() const { return Width; }
+		int32_t GetHeight() const { return Height; }
+		const uint8_t* GetData() const { return Pixels.data(); }
+		size_t GetSizeBytes() const { return Pixels.size(); }
+
+		void Clear(FColor Color);
+
+		// Pixel coordinates, y down. Radius is half the line width.
+		void DrawLine(float X0, float Y0, float X1, float Y1, float Radius, FColor Color, float Opacity = 1.0f);
+		void DrawDisc(float CX, float CY, float Radius, FColor Color);
+		void DrawRing(float CX, float CY, float Radius, float Thickness, FColor Color);
+
+	private:
+		void Blend(int32_t X, int32_t Y, FColor Color, float Alpha);
+
+		int32_t Width;
+		int32_t Height;
+		std::vector<uint8_t> Pixels;
+	};
+}
@@ -0,0 +1,366 @@
+// pls_render: headless renderer for the procedural locomotion demo.
+//
+// Simulates the demo characters with LocomotionSim (figure-8 path, UE lean, head oscillation,
+// walk cycle) and rasterizes them as stick figures, styled like standalone_animation_demo.py.
+// Simulation is sequential; frames are then rasterized in parallel and emitted in order.
+//
+// Usage:
+//   pls_render [--frames 600] [--fps 30] [--width 640] [--height 480] [--characters 1]
+//              [--spacing 8] [--seed 1] [--extent 5] [--threads N] [--trail 100]
+//              [--format raw|png|none] [--output <dir>]
+//
+//   pls_render --format raw | ffmpeg -f rawvideo -pix_fmt rgb24 -s 640x480 -r 30 -i - demo.mp4
+//   pls_render --format png --output frames/   # frames/frame_00000.png ..., creating frames/
+
+#include "LocomotionSim.h"
+#include "PngWriter.h"
+#include "Rasterizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using namespace LocomotionRender;
+
+	struct FOptions
+	{
+		int32_t Frames = 600;
+		float Fps = 30.0f;
+		int32_t Width = 640;
+		int32_t Height = 480;
+		int32_t Characters = 1;
+		float Spacing = 8.0f;
+		uint32_t Seed = 1;
+		float Extent = 0.0f; // half-width of the view in metres; 0 picks one that fits the crowd
+		int32_t Threads = 0;
+		int32_t Trail = 100;
+		std::string Format = "raw";
+		std::string Output = ".";
+	};
+
+	// Demo palette: body blue, left leg red, right leg green, arms cyan/magenta, yellow head.
+	const FColor Background{ 255, 255, 255 };
+	const FColor GridColor{ 235, 235, 235 };
+	const FColor TrailColor{ 0, 0, 0 };
+	const FColor BodyColor{ 0, 0, 255 };
+	const FColor LeftLegColor{ 255, 0, 0 };
+	const FColor RightLegColor{ 0, 128, 0 };
+	const FColor LeftArmColor{ 0, 191, 191 };
+	const FColor RightArmColor{ 191, 0, 191 };
+	const FColor HeadColor{ 255, 255, 0 };
+	const FColor OutlineColor{ 0, 0, 0 };
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"usage: pls_render [--frames N] [--fps F] [--width W] [--height H] [--characters N]\n"
+			"                  [--spacing M] [--seed S] [--extent M] [--threads N] [--trail N]\n"
+			"                  [--format raw|png|none] [--output DIR]\n");
+	}
+
+	bool ParseOptions(int Argc, char** Argv, FOptions& Options)
+	{
+		for (int Index = 1; Index < Argc; ++Index)
+		{
+			const std::string Arg = Argv[Index];
+			if (Arg == "--help" || Arg == "-h")
+			{
+				return false;
+			}
+			if (Index + 1 >= Argc)
+			{
+				std::fprintf(stderr, "missing value for %s\n", Arg.c_str());
+				return false;
+			}
+
+			const char* Value = Argv[++Index];
+			if (Arg == "--frames") Options.Frames = std::atoi(Value);
+			else if (Arg == "--fps") Options.Fps = static_cast<float>(std::atof(Value));
+			else if (Arg == "--width") Options.Width = std::atoi(Value);
+			else if (Arg == "--height") Options.Height = std::atoi(Value);
+			else if (Arg == "--characters") Options.Characters = std::atoi(Value);
+			else if (Arg == "--spacing") Options.Spacing = static_cast<float>(std::atof(Value));
+			else if (Arg == "--seed") Options.Seed = static_cast<uint32_t>(std::strtoul(Value, nullptr, 10));
+			else if (Arg == "--extent") Options.Extent = static_cast<float>(std::atof(Value));
+			else if (Arg == "--threads") Options.Threads = std::atoi(Value);
+			else if (Arg == "--trail") Options.Trail = std::atoi(Value);
+			else if (Arg == "--format") Options.Format = Value;
+			else if (Arg == "--output") Options.Output = Value;
+			else
+			{
+				std::fprintf(stderr, "unknown option %s\n", Arg.c_str());
+				return false;
+			}
+		}
+
+		if (Options.Frames <= 0 || Options.Fps <= 0.0f || Options.Width <= 0 || Options.Height <= 0 || Options.Characters <= 0)
+		{
+			std::fprintf(stderr, "frames, fps, width, height and characters must be positive\n");
+			return false;
+		}
+		if (Options.Format != "raw" && Options.Format != "png" && Options.Format != "none")
+		{
+			std::fprintf(stderr, "format must be raw, png or none\n");
+			return false;
+		}
+		if (Options.Format == "png")
+		{
+			std::error_code Error;
+			std::filesystem::create_directories(Options.Output, Error);
+			if (!std::filesystem::is_directory(Options.Output))
+			{
+				std::fprintf(stderr, "could not create output directory %s: %s\n", Options.Output.c_str(), Error.message().c_str());
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Runs Work(WorkerIndex, Item) for every item on up to NumThreads threads, the caller's included.
+	template <typename WorkType>
+	void ParallelFor(int32_t NumItems, int32_t NumThreads, WorkType&& Work)
+	{
+		std::atomic<int32_t> NextItem{ 0 };
+		auto Worker = [&](int32_t WorkerIndex)
+		{
+			for (int32_t Item = NextItem++; Item < NumItems; Item = NextItem++)
+			{
+				Work(WorkerIndex, Item);
+			}
+		};
+
+		std::vector<std::thread> Workers;
+		for (int32_t WorkerIndex = 1; WorkerIndex < std::min(NumThreads, NumItems); ++WorkerIndex)
+		{
+			Workers.emplace_back(Worker, WorkerIndex);
+		}
+		Worker(0);
+		for (std::thread& Thread : Workers)
+		{
+			Thread.join();
+		}
+	}
+
+	// Maps demo metres to pixels, y up, centred on the origin.
+	struct FViewTransform
+	{
+		float Scale = 1.0f;
+		float CenterX = 0.0f;
+		float CenterY = 0.0f;
+
+		float ToX(float X) const { return CenterX + X * Scale; }
+		float ToY(float Y) const { return CenterY - Y * Scale; }
+	};
+
+	// Background and one-metre grid, like the demo's axes grid. Drawn once and copied per frame.
+	FImage MakeBackdrop(int32_t Width, int32_t Height, const FViewTransform& View)
+	{
+		FImage Backdrop(Width, Height);
+		Backdrop.Clear(Background);
+
+		const float HalfWidthMetres = 0.5f * Width / View.Scale;
+		const float HalfHeightMetres = 0.5f * Height / View.Scale;
+		for (float X = std::ceil(-HalfWidthMetres); X <= HalfWidthMetres; X += 1.0f)
+		{
+			Backdrop.DrawLine(View.ToX(X), 0.0f, View.ToX(X), static_cast<float>(Height), 0.5f, GridColor);
+		}
+		for (float Y = std::ceil(-HalfHeightMetres); Y <= HalfHeightMetres; Y += 1.0f)
+		{
+			Backdrop.DrawLine(0.0f, View.ToY(Y), static_cast<float>(Width), View.ToY(Y), 0.5f, GridColor);
+		}
+		return Backdrop;
+	}
+
+	void RenderFrame(FImage& Image, const FImage& Backdrop, const FViewTransform& View, const float* Points, int32_t NumCharacters,
+		const float* TrailPoints, int32_t TrailLength)
+	{
+		using namespace LocomotionSim;
+
+		Image = Backdrop;
+
+		for (int32_t Index = 1; Index < TrailLength; ++Index)
+		{
+			const float* A = TrailPoints + (Index - 1) * 2;
+			const float* B = TrailPoints + Index * 2;
+			Image.DrawLine(View.ToX(A[0]), View.ToY(A[1]), View.ToX(B[0]), View.ToY(B[1]), 0.5f, TrailColor, 0.3f);
+		}
+
+		// Line widths in the demo are points at 100 dpi on a ~10 m wide view; scale with zoom.
+		const float LineScale = std::max(0.5f, View.Scale / 70.0f);
+		for (int32_t Character = 0; Character < NumCharacters; ++Character)
+		{
+			const float* P = Points + Character * NumSkeletonPoints * 2;
+			auto Segment = [&](ESkeletonPoint From, ESkeletonPoint To, float Width, FColor Color)
+			{
+				Image.DrawLine(View.ToX(P[From * 2]), View.ToY(P[From * 2 + 1]), View.ToX(P[To * 2]), View.ToY(P[To * 2 + 1]),
+					0.5f * Width * LineScale, Color);
+			};
+
+			Segment(ESkeletonPoint::Hip, ESkeletonPoint::SpineTop, 3.0f, BodyColor);
+			Segment(ESkeletonPoint::Hip, ESkeletonPoint::LeftFoot, 2.5f, LeftLegColor);
+			Segment(ESkeletonPoint::Hip, ESkeletonPoint::RightFoot, 2.5f, RightLegColor);
+			Segment(ESkeletonPoint::SpineTop, ESkeletonPoint::LeftHand, 2.0f, LeftArmColor);
+			Segment(ESkeletonPoint::SpineTop, ESkeletonPoint::RightHand, 2.0f, RightArmColor);
+
+			const float HeadX = View.ToX(P[ESkeletonPoint::Head * 2]);
+			const float HeadY = View.ToY(P[ESkeletonPoint::Head * 2 + 1]);
+			const float HeadRadius = 0.2f * View.Scale;
+			Image.DrawDisc(HeadX, HeadY, HeadRadius, HeadColor);
+			Image.DrawRing(HeadX, HeadY, HeadRadius, 2.0f * LineScale, OutlineColor);
+		}
+	}
+
+	int32_t Run(const FOptions& Options)
+	{
+		using Clock = std::chrono::steady_clock;
+		using namespace LocomotionSim;
+
+		const int32_t NumThreads = Options.Threads > 0 ? Options.Threads : std::max(1u, std::thread::hardware_concurrency());
+		const int32_t NumCharacters = Options.Characters;
+		const int32_t PointsPerFrame = NumCharacters * NumSkeletonPoints * 2;
+		const float DeltaSeconds = 1.0f / Options.Fps;
+
+		FSimParams Params;
+		std::vector<float> States(static_cast<size_t>(NumCharacters) * NumStateFields);
+		FStateView StateView;
+		StateView.Data = States.data();
+		StateView.Count = NumCharacters;
+
+		// A single character starts at the demo's origin; crowds are spread over a grid.
+		if (NumCharacters > 1)
+		{
+			InitializeStates(StateView, Options.Spacing, Options.Seed, Params);
+		}
+
+		const int32_t Columns = static_cast<int32_t>(std::ceil(std::sqrt(static_cast<double>(NumCharacters))));
+		const float Extent = Options.Extent > 0.0f ? Options.Extent
+			: (NumCharacters > 1 ? 0.5f * Options.Spacing * Columns + Params.PathRadiusX : 5.0f);
+
+		FViewTransform View;
+		View.Scale = 0.5f * Options.Width / Extent;
+		View.CenterX = 0.5f * Options.Width;
+		View.CenterY = 0.5f * Options.Height;
+
+		const FImage Backdrop = MakeBackdrop(Options.Width, Options.Height, View);
+
+		FILE* RawOut = nullptr;
+		if (Options.Format == "raw")
+		{
+			RawOut = stdout;
+			std::setvbuf(RawOut, nullptr, _IOFBF, 1 << 20);
+		}
+
+		// Frames are simulated sequentially into a chunk, rasterized in parallel and written in
+		// order. Chunks bound memory for long or crowded renders.
+		const int32_t ChunkFrames = std::max(1, NumThreads * 8);
+		std::vector<float> ChunkPoints(static_cast<size_t>(ChunkFrames) * PointsPerFrame);
+		std::vector<float> ChunkTrails(static_cast<size_t>(ChunkFrames) * std::max(Options.Trail, 1) * 2);
+		std::vector<int32_t> ChunkTrailLengths(ChunkFrames);
+		std::vector<FImage> Images(ChunkFrames, FImage(Options.Width, Options.Height));
+		std::vector<float> Trail;
+		std::vector<std::vector<uint8_t>> Encoded(NumThreads);
+
+		double SimSeconds = 0.0;
+		double RenderSeconds = 0.0;
+		double WriteSeconds = 0.0;
+		std::atomic<bool> bWriteFailed{ false };
+
+		for (int32_t ChunkStart = 0; ChunkStart < Options.Frames && !bWriteFailed; ChunkStart += ChunkFrames)
+		{
+			const int32_t NumChunkFrames = std::min(ChunkFrames, Options.Frames - ChunkStart);
+
+			const Clock::time_point SimStart = Clock::now();
+			for (int32_t Frame = 0; Frame < NumChunkFrames; ++Frame)
+			{
+				Update(StateView, DeltaSeconds, EDriver::Path, Params);
+				float* FramePoints = &ChunkPoints[static_cast<size_t>(Frame) * PointsPerFrame];
+				ComputeSkeletonPoints(StateView, Params, FramePoints);
+
+				// Hip trail of the first character, as in the demo.
+				if (Options.Trail > 0)
+				{
+					Trail.push_back(FramePoints[0]);
+					Trail.push_back(FramePoints[1]);
+					if (static_cast<int32_t>(Trail.size()) > Options.Trail * 2)
+					{
+						Trail.erase(Trail.begin(), Trail.begin() + 2);
+					}
+					std::copy(Trail.begin(), Trail.end(), ChunkTrails.begin() + static_cast<size_t>(Frame) * Options.Trail * 2);
+				}
+				ChunkTrailLengths[Frame] = static_cast<int32_t>(Trail.size() / 2);
+			}
+			const Clock::time_point RenderStart = Clock::now();
+			SimSeconds += std::chrono::duration<double>(RenderStart - SimStart).count();
+
+			ParallelFor(NumChunkFrames, NumThreads, [&](int32_t, int32_t Frame)
+			{
+				RenderFrame(Images[Frame], Backdrop, View, &ChunkPoints[static_cast<size_t>(Frame) * PointsPerFrame], NumCharacters,
+					&ChunkTrails[static_cast<size_t>(Frame) * std::max(Options.Trail, 1) * 2], ChunkTrailLengths[Frame]);
+			});
+			const Clock::time_point WriteStart = Clock::now();
+			RenderSeconds += std::chrono::duration<double>(WriteStart - RenderStart).count();
+
+			// PNG frames are independent files, so they are encoded and written in parallel too,
+			// after rasterizing so the two phases are timed apart.
+			if (Options.Format == "png")
+			{
+				ParallelFor(NumChunkFrames, NumThreads, [&](int32_t WorkerIndex, int32_t Frame)
+				{
+					char Name[64];
+					std::snprintf(Name, sizeof(Name), "/frame_%05d.png", ChunkStart + Frame);
+					EncodePng(Images[Frame].GetData(), Options.Width, Options.Height, Encoded[WorkerIndex]);
+					if (!WriteFile(Options.Output + Name, Encoded[WorkerIndex]))
+					{
+						bWriteFailed = true;
+					}
+				});
+			}
+			if (RawOut)
+			{
+				for (int32_t Frame = 0; Frame < NumChunkFrames && !bWriteFailed; ++Frame)
+				{
+					bWriteFailed = std::fwrite(Images[Frame].GetData(), 1, Images[Frame].GetSizeBytes(), RawOut) != Images[Frame].GetSizeBytes();
+				}
+			}
+			WriteSeconds += std::chrono::duration<double>(Clock::now() - WriteStart).count();
+		}
+
+		if (RawOut)
+		{
+			std::fflush(RawOut);
+		}
+		if (bWriteFailed)
+		{
+			std::fprintf(stderr, "pls_render: failed to write output\n");
+			return 1;
+		}
+
+		const double TotalSeconds = SimSeconds + RenderSeconds + WriteSeconds;
+		std::fprintf(stderr, "pls_render: %d frames, %d characters, %dx%d, %d threads: sim %.1f ms, raster %.1f ms, write %.1f ms (%.0f frames/s)\n",
+			Options.Frames, NumCharacters, Options.Width, Options.Height, NumThreads,
+			SimSeconds * 1000.0, RenderSeconds * 1000.0, WriteSeconds * 1000.0, Options.Frames / std::max(TotalSeconds, 1e-9));
+		return 0;
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	FOptions Options;
+	if (!ParseOptions(Argc, Argv, Options))
+	{
+		PrintUsage();
+		return 2;
+	}
+	return Run(Options);
+}
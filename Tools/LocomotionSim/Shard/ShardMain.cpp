@@ -0,0 +1,635 @@
+// pls_shard: multi-process crowd simulation benchmark.
+//
+// Splits the LocomotionSim crowd update (movement, avoidance, direction, lean) across N worker
+// processes, each owning a strip of the world along X. All state lives in one shared-memory
+// mapping:
+//
+//   - two full state tables: workers read the front table and write their owned rows into the
+//     back table, which becomes the front table next frame
+//   - per shard and side, a double-buffered boundary list: the owned rows within Band of that
+//     edge, which the neighbouring shard uses as ghosts for avoidance and to adopt characters
+//     that cross over
+//
+// The coordinating (main) process only relevancy-filters the finished frame, like a game
+// process that renders. Avoidance reads previous-frame positions, so every process count
+// produces bit-identical states; each run is checked against an in-process reference.
+//
+// Usage:
+//   pls_shard [--characters 20000] [--frames 300] [--fps 30] [--spacing 4] [--seed 1]
+//             [--processes 1,2,4] [--avoidance 0.8] [--view-radius 20] [--no-verify]
+
+#include "LocomotionSim.h"
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using namespace LocomotionSim;
+
+	struct FOptions
+	{
+		int64_t Characters = 20000;
+		int32_t Frames = 300;
+		float Fps = 30.0f;
+		float Spacing = 4.0f;
+		uint32_t Seed = 1;
+		std::vector<int32_t> Processes = { 1, 2, 4 };
+		float AvoidanceRadius = 0.8f;
+		float ViewRadius = 20.0f;
+		bool bVerify = true;
+	};
+
+	enum ESide : int32_t
+	{
+		Left,
+		Right,
+		NumSides
+	};
+
+	// Sense-reversing barrier shared by processes; std::atomic on plain ints is address-free on
+	// the platforms this tool targets, so it works in a MAP_SHARED mapping.
+	struct FProcessBarrier
+	{
+		std::atomic<uint32_t> Arrived{ 0 };
+		std::atomic<uint32_t> Generation{ 0 };
+		uint32_t Participants = 0;
+
+		// Returns false if ShouldAbort() turned true while waiting.
+		template <typename PredicateType>
+		bool Wait(PredicateType&& ShouldAbort)
+		{
+			const uint32_t StartGeneration = Generation.load(std::memory_order_acquire);
+			if (Arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == Participants)
+			{
+				Arrived.store(0, std::memory_order_relaxed);
+				Generation.fetch_add(1, std::memory_order_release);
+				return true;
+			}
+
+			for (uint32_t Spins = 0; Generation.load(std::memory_order_acquire) == StartGeneration; ++Spins)
+			{
+				// Spin briefly for the common case of balanced shards, then give the core away.
+				if (Spins > 256)
+				{
+					if (ShouldAbort())
+					{
+						return false;
+					}
+					sched_yield();
+				}
+			}
+			return true;
+		}
+	};
+
+	struct FSharedHeader
+	{
+		FProcessBarrier BoundariesPublished; // workers
+		FProcessBarrier FrameDone;           // workers + coordinator
+		std::atomic<uint32_t> bAbort{ 0 };
+	};
+
+	// Process-local pointers into the shared mapping.
+	class FSharedCrowd
+	{
+	public:
+		FSharedCrowd(int64_t InNumCharacters, int32_t InNumShards)
+			: NumCharacters(InNumCharacters)
+			, NumShards(InNumShards)
+		{
+			TableFloats = static_cast<size_t>(NumCharacters) * NumStateFields;
+			const size_t NumLists = static_cast<size_t>(2) * NumShards * NumSides;
+			Size = AlignUp(sizeof(FSharedHeader)) + AlignUp(2 * TableFloats * sizeof(float))
+				+ AlignUp(NumLists * sizeof(int64_t)) + NumLists * static_cast<size_t>(NumCharacters) * sizeof(int64_t);
+
+			void* Mapping = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+			if (Mapping == MAP_FAILED)
+			{
+				return;
+			}
+			Base = static_cast<uint8_t*>(Mapping);
+
+			uint8_t* Cursor = Base;
+			Header = new (Cursor) FSharedHeader();
+			Cursor += AlignUp(sizeof(FSharedHeader));
+			Tables = reinterpret_cast<float*>(Cursor);
+			Cursor += AlignUp(2 * TableFloats * sizeof(float));
+			ListCounts = reinterpret_cast<int64_t*>(Cursor);
+			Cursor += AlignUp(NumLists * sizeof(int64_t));
+			ListRows = reinterpret_cast<int64_t*>(Cursor);
+		}
+
+		~FSharedCrowd()
+		{
+			if (Base)
+			{
+				munmap(Base, Size);
+			}
+		}
+
+		FSharedCrowd(const FSharedCrowd&) = delete;
+		FSharedCrowd& operator=(const FSharedCrowd&) = delete;
+
+		bool IsValid() const { return Base != nullptr; }
+
+		FStateView Table(int32_t Buffer) const
+		{
+			FStateView View;
+			View.Data = Tables + static_cast<size_t>(Buffer & 1) * TableFloats;
+			View.Count = NumCharacters;
+			return View;
+		}
+
+		int64_t& ListCount(int32_t Buffer, int32_t Shard, ESide Side) const
+		{
+			return ListCounts[ListIndex(Buffer, Shard, Side)];
+		}
+
+		int64_t* List(int32_t Buffer, int32_t Shard, ESide Side) const
+		{
+			return ListRows + ListIndex(Buffer, Shard, Side) * static_cast<size_t>(NumCharacters);
+		}
+
+		FSharedHeader* Header = nullptr;
+		const int64_t NumCharacters;
+		const int32_t NumShards;
+
+	private:
+		static size_t AlignUp(size_t Bytes) { return (Bytes + 63) & ~static_cast<size_t>(63); }
+
+		size_t ListIndex(int32_t Buffer, int32_t Shard, ESide Side) const
+		{
+			return (static_cast<size_t>(Buffer & 1) * NumShards + Shard) * NumSides + Side;
+		}
+
+		uint8_t* Base = nullptr;
+		size_t Size = 0;
+		size_t TableFloats = 0;
+		float* Tables = nullptr;
+		int64_t* ListCounts = nullptr;
+		int64_t* ListRows = nullptr;
+	};
+
+	struct FShardLayout
+	{
+		// Shard s owns Bounds[s] <= x < Bounds[s + 1].
+		std::vector<float> Bounds;
+		// Ghost and hand-over band: avoidance radius plus the furthest a character can move in a frame.
+		float Band = 0.0f;
+	};
+
+	void CopyRow(const FStateView& From, const FStateView& To, int64_t Row)
+	{
+		std::memcpy(&To.At(Row, 0), &From.At(Row, 0), NumStateFields * sizeof(float));
+	}
+
+	// Runs in a forked worker process.
+	void RunWorker(FSharedCrowd& Crowd, const FShardLayout& Layout, int32_t Shard, const FOptions& Options, const FSimParams& Params)
+	{
+		FSharedHeader& Header = *Crowd.Header;
+		const float Lo = Layout.Bounds[Shard];
+		const float Hi = Layout.Bounds[Shard + 1];
+		const float DeltaSeconds = 1.0f / Options.Fps;
+		auto ShouldAbort = [&Header]() { return Header.bAbort.load(std::memory_order_relaxed) != 0; };
+		auto InStrip = [Lo, Hi](float X) { return X >= Lo && X < Hi; };
+
+		std::vector<int64_t> Owned;
+		std::vector<int64_t> Candidates;
+		std::vector<int64_t> GridRows;
+		FNeighbourGrid Grid;
+
+		const FStateView Initial = Crowd.Table(0);
+		for (int64_t Row = 0; Row < Crowd.NumCharacters; ++Row)
+		{
+			if (InStrip(Initial.At(Row, EStateField::PosX)))
+			{
+				Owned.push_back(Row);
+			}
+		}
+
+		for (int32_t Frame = 0; Frame < Options.Frames; ++Frame)
+		{
+			const FStateView Front = Crowd.Table(Frame);
+			const FStateView Back = Crowd.Table(Frame + 1);
+
+			// Adopt characters that crossed in from a neighbour and drop those that left; both
+			// sides see the same positions, so every character has exactly one owner.
+			if (Frame > 0)
+			{
+				Candidates.assign(Owned.begin(), Owned.end());
+				if (Shard > 0)
+				{
+					const int64_t* Rows = Crowd.List(Frame - 1, Shard - 1, ESide::Right);
+					Candidates.insert(Candidates.end(), Rows, Rows + Crowd.ListCount(Frame - 1, Shard - 1, ESide::Right));
+				}
+				if (Shard + 1 < Crowd.NumShards)
+				{
+					const int64_t* Rows = Crowd.List(Frame - 1, Shard + 1, ESide::Left);
+					Candidates.insert(Candidates.end(), Rows, Rows + Crowd.ListCount(Frame - 1, Shard + 1, ESide::Left));
+				}
+
+				Owned.clear();
+				for (const int64_t Row : Candidates)
+				{
+					if (InStrip(Front.At(Row, EStateField::PosX)))
+					{
+						Owned.push_back(Row);
+					}
+				}
+			}
+
+			// Publish this frame's boundary rows for the neighbours.
+			int64_t* LeftRows = Crowd.List(Frame, Shard, ESide::Left);
+			int64_t* RightRows = Crowd.List(Frame, Shard, ESide::Right);
+			int64_t NumLeft = 0;
+			int64_t NumRight = 0;
+			for (const int64_t Row : Owned)
+			{
+				const float X = Front.At(Row, EStateField::PosX);
+				if (X < Lo + Layout.Band)
+				{
+					LeftRows[NumLeft++] = Row;
+				}
+				if (X >= Hi - Layout.Band)
+				{
+					RightRows[NumRight++] = Row;
+				}
+			}
+			Crowd.ListCount(Frame, Shard, ESide::Left) = NumLeft;
+			Crowd.ListCount(Frame, Shard, ESide::Right) = NumRight;
+
+			if (!Header.BoundariesPublished.Wait(ShouldAbort))
+			{
+				return;
+			}
+
+			GridRows.assign(Owned.begin(), Owned.end());
+			if (Shard > 0)
+			{
+				const int64_t* Rows = Crowd.List(Frame, Shard - 1, ESide::Right);
+				GridRows.insert(GridRows.end(), Rows, Rows + Crowd.ListCount(Frame, Shard - 1, ESide::Right));
+			}
+			if (Shard + 1 < Crowd.NumShards)
+			{
+				const int64_t* Rows = Crowd.List(Frame, Shard + 1, ESide::Left);
+				GridRows.insert(GridRows.end(), Rows, Rows + Crowd.ListCount(Frame, Shard + 1, ESide::Left));
+			}
+			Grid.Build(Front, GridRows.data(), static_cast<int64_t>(GridRows.size()), Params.AvoidanceRadius);
+
+			for (const int64_t Row : Owned)
+			{
+				CopyRow(Front, Back, Row);
+			}
+			UpdateRows(Back, Owned.data(), static_cast<int64_t>(Owned.size()), DeltaSeconds, EDriver::Path, Params, &Grid);
+
+			if (!Header.FrameDone.Wait(ShouldAbort))
+			{
+				return;
+			}
+		}
+	}
+
+	// The main process's per-frame work: count characters near a camera that follows character 0.
+	int64_t CountRelevant(const FStateView& States, float ViewRadius)
+	{
+		const float CameraX = States.At(0, EStateField::PosX);
+		const float CameraY = States.At(0, EStateField::PosY);
+		int64_t Relevant = 0;
+		for (int64_t Row = 0; Row < States.Count; ++Row)
+		{
+			const float DX = States.At(Row, EStateField::PosX) - CameraX;
+			const float DY = States.At(Row, EStateField::PosY) - CameraY;
+			Relevant += (DX * DX + DY * DY <= ViewRadius * ViewRadius) ? 1 : 0;
+		}
+		return Relevant;
+	}
+
+	bool MakeLayout(const std::vector<float>& InitialStates, int64_t NumCharacters, int32_t NumShards, const FOptions& Options,
+		const FSimParams& Params, FShardLayout& OutLayout)
+	{
+		// A character moves at most its walk speed plus full avoidance per frame; double it for slack.
+		const float MaxStep = (Params.WalkSpeed + Params.AvoidanceStrength) / Options.Fps;
+		OutLayout.Band = Params.AvoidanceRadius + 2.0f * MaxStep;
+
+		// Equal-count strips over the initial positions.
+		std::vector<float> Xs(static_cast<size_t>(NumCharacters));
+		for (int64_t Row = 0; Row < NumCharacters; ++Row)
+		{
+			Xs[Row] = InitialStates[static_cast<size_t>(Row) * NumStateFields + EStateField::PosX];
+		}
+		std::sort(Xs.begin(), Xs.end());
+
+		OutLayout.Bounds.assign(1, -std::numeric_limits<float>::infinity());
+		for (int32_t Shard = 1; Shard < NumShards; ++Shard)
+		{
+			OutLayout.Bounds.push_back(Xs[static_cast<size_t>(NumCharacters * Shard / NumShards)]);
+		}
+		OutLayout.Bounds.push_back(std::numeric_limits<float>::infinity());
+
+		// Hand-over only looks one shard away, so inner strips must be wider than the band.
+		for (int32_t Shard = 1; Shard + 1 < NumShards; ++Shard)
+		{
+			if (OutLayout.Bounds[Shard + 1] - OutLayout.Bounds[Shard] <= 2.0f * OutLayout.Band)
+			{
+				std::fprintf(stderr, "pls_shard: %d shards are too narrow for the crowd (band %.2f m); use fewer processes or more characters\n",
+					NumShards, OutLayout.Band);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Single-process run of the same algorithm, for verification.
+	std::vector<float> RunReference(const std::vector<float>& InitialStates, int64_t NumCharacters, const FOptions& Options, const FSimParams& Params)
+	{
+		std::vector<float> Tables[2] = { InitialStates, InitialStates };
+		std::vector<int64_t> AllRows(static_cast<size_t>(NumCharacters));
+		for (int64_t Row = 0; Row < NumCharacters; ++Row)
+		{
+			AllRows[Row] = Row;
+		}
+
+		FNeighbourGrid Grid;
+		for (int32_t Frame = 0; Frame < Options.Frames; ++Frame)
+		{
+			FStateView Front;
+			Front.Data = Tables[Frame & 1].data();
+			Front.Count = NumCharacters;
+			FStateView Back;
+			Back.Data = Tables[(Frame + 1) & 1].data();
+			Back.Count = NumCharacters;
+
+			Grid.Build(Front, AllRows.data(), NumCharacters, Params.AvoidanceRadius);
+			std::copy(Tables[Frame & 1].begin(), Tables[Frame & 1].end(), Tables[(Frame + 1) & 1].begin());
+			UpdateRows(Back, AllRows.data(), NumCharacters, 1.0f / Options.Fps, EDriver::Path, Params, &Grid);
+		}
+		return Tables[Options.Frames & 1];
+	}
+
+	struct FRunResult
+	{
+		bool bSucceeded = false;
+		double Seconds = 0.0;
+		double AverageRelevant = 0.0;
+		std::vector<float> FinalStates;
+	};
+
+	FRunResult RunSharded(const std::vector<float>& InitialStates, int64_t NumCharacters, int32_t NumShards, const FOptions& Options,
+		const FSimParams& Params)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		FRunResult Result;
+		FShardLayout Layout;
+		if (!MakeLayout(InitialStates, NumCharacters, NumShards, Options, Params, Layout))
+		{
+			return Result;
+		}
+
+		FSharedCrowd Crowd(NumCharacters, NumShards);
+		if (!Crowd.IsValid())
+		{
+			std::fprintf(stderr, "pls_shard: could not map shared memory\n");
+			return Result;
+		}
+		FSharedHeader& Header = *Crowd.Header;
+		Header.BoundariesPublished.Participants = static_cast<uint32_t>(NumShards);
+		Header.FrameDone.Participants = static_cast<uint32_t>(NumShards) + 1;
+		std::copy(InitialStates.begin(), InitialStates.end(), Crowd.Table(0).Data);
+
+		std::fflush(nullptr);
+		std::vector<pid_t> Workers;
+		for (int32_t Shard = 0; Shard < NumShards; ++Shard)
+		{
+			const pid_t Pid = fork();
+			if (Pid == 0)
+			{
+				RunWorker(Crowd, Layout, Shard, Options, Params);
+				_exit(Header.bAbort.load() ? 1 : 0);
+			}
+			if (Pid < 0)
+			{
+				std::perror("pls_shard: fork");
+				Header.bAbort = 1;
+				break;
+			}
+			Workers.push_back(Pid);
+		}
+
+		// Workers reaped while waiting, with their exit statuses, so the final wait skips them.
+		std::vector<bool> Reaped(Workers.size(), false);
+		std::vector<int> Statuses(Workers.size(), 0);
+		auto Succeeded = [](int Status) { return WIFEXITED(Status) && WEXITSTATUS(Status) == 0; };
+
+		// Abort everyone if a worker dies, rather than waiting on its barrier forever. A worker may
+		// exit cleanly as soon as it passes the last frame's barrier, possibly before this process
+		// sees the generation advance; a clean exit only means trouble before the last frame.
+		int32_t Frame = 0;
+		auto ShouldAbort = [&]()
+		{
+			for (size_t Index = 0; Index < Workers.size(); ++Index)
+			{
+				if (!Reaped[Index] && waitpid(Workers[Index], &Statuses[Index], WNOHANG) == Workers[Index])
+				{
+					Reaped[Index] = true;
+					if (!Succeeded(Statuses[Index]) || Frame + 1 < Options.Frames)
+					{
+						Header.bAbort = 1;
+					}
+				}
+			}
+			return Header.bAbort.load() != 0;
+		};
+
+		const Clock::time_point Start = Clock::now();
+		int64_t RelevantSum = 0;
+		bool bCompleted = Header.bAbort.load() == 0;
+		for (; Frame < Options.Frames && bCompleted; ++Frame)
+		{
+			// The previous frame's result is this frame's front table; workers only read it now.
+			if (Frame > 0)
+			{
+				RelevantSum += CountRelevant(Crowd.Table(Frame), Options.ViewRadius);
+			}
+			bCompleted = Header.FrameDone.Wait(ShouldAbort);
+		}
+		if (bCompleted)
+		{
+			RelevantSum += CountRelevant(Crowd.Table(Options.Frames), Options.ViewRadius);
+		}
+		Result.Seconds = std::chrono::duration<double>(Clock::now() - Start).count();
+
+		bool bWorkersOk = bCompleted;
+		for (size_t Index = 0; Index < Workers.size(); ++Index)
+		{
+			if (!Reaped[Index] && waitpid(Workers[Index], &Statuses[Index], 0) != Workers[Index])
+			{
+				std::perror("pls_shard: waitpid");
+				bWorkersOk = false;
+				continue;
+			}
+			bWorkersOk = bWorkersOk && Succeeded(Statuses[Index]);
+		}
+		if (!bWorkersOk)
+		{
+			std::fprintf(stderr, "pls_shard: a worker process failed\n");
+			return Result;
+		}
+
+		const FStateView Final = Crowd.Table(Options.Frames);
+		Result.FinalStates.assign(Final.Data, Final.Data + static_cast<size_t>(NumCharacters) * NumStateFields);
+		Result.AverageRelevant = static_cast<double>(RelevantSum) / Options.Frames;
+		Result.bSucceeded = true;
+		return Result;
+	}
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"usage: pls_shard [--characters N] [--frames N] [--fps F] [--spacing M] [--seed S]\n"
+			"                 [--processes 1,2,4] [--avoidance M] [--view-radius M] [--no-verify]\n");
+	}
+
+	bool ParseOptions(int Argc, char** Argv, FOptions& Options)
+	{
+		for (int Index = 1; Index < Argc; ++Index)
+		{
+			const std::string Arg = Argv[Index];
+			if (Arg == "--help" || Arg == "-h")
+			{
+				return false;
+			}
+			if (Arg == "--no-verify")
+			{
+				Options.bVerify = false;
+				continue;
+			}
+			if (Index + 1 >= Argc)
+			{
+				std::fprintf(stderr, "missing value for %s\n", Arg.c_str());
+				return false;
+			}
+
+			const char* Value = Argv[++Index];
+			if (Arg == "--characters") Options.Characters = std::atoll(Value);
+			else if (Arg == "--frames") Options.Frames = std::atoi(Value);
+			else if (Arg == "--fps") Options.Fps = static_cast<float>(std::atof(Value));
+			else if (Arg == "--spacing") Options.Spacing = static_cast<float>(std::atof(Value));
+			else if (Arg == "--seed") Options.Seed = static_cast<uint32_t>(std::strtoul(Value, nullptr, 10));
+			else if (Arg == "--avoidance") Options.AvoidanceRadius = static_cast<float>(std::atof(Value));
+			else if (Arg == "--view-radius") Options.ViewRadius = static_cast<float>(std::atof(Value));
+			else if (Arg == "--processes")
+			{
+				Options.Processes.clear();
+				for (const char* Cursor = Value; *Cursor;)
+				{
+					char* End = nullptr;
+					const long Count = std::strtol(Cursor, &End, 10);
+					if (End == Cursor)
+					{
+						std::fprintf(stderr, "bad process count list %s\n", Value);
+						return false;
+					}
+					Options.Processes.push_back(static_cast<int32_t>(Count));
+					Cursor = (*End == ',') ? End + 1 : End;
+				}
+			}
+			else
+			{
+				std::fprintf(stderr, "unknown option %s\n", Arg.c_str());
+				return false;
+			}
+		}
+
+		if (Options.Characters <= 0 || Options.Frames <= 0 || Options.Fps <= 0.0f || Options.AvoidanceRadius <= 0.0f || Options.Processes.empty())
+		{
+			std::fprintf(stderr, "characters, frames, fps, avoidance and processes must be positive\n");
+			return false;
+		}
+		for (const int32_t Count : Options.Processes)
+		{
+			if (Count <= 0)
+			{
+				std::fprintf(stderr, "process counts must be positive\n");
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	FOptions Options;
+	if (!ParseOptions(Argc, Argv, Options))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	FSimParams Params;
+	Params.AvoidanceRadius = Options.AvoidanceRadius;
+
+	const int64_t NumCharacters = Options.Characters;
+	std::vector<float> InitialStates(static_cast<size_t>(NumCharacters) * NumStateFields);
+	FStateView InitialView;
+	InitialView.Data = InitialStates.data();
+	InitialView.Count = NumCharacters;
+	InitializeStates(InitialView, Options.Spacing, Options.Seed, Params);
+
+	std::vector<float> Reference;
+	if (Options.bVerify)
+	{
+		Reference = RunReference(InitialStates, NumCharacters, Options, Params);
+	}
+
+	std::printf("%lld characters, %d frames at %g fps, avoidance %.2f m\n",
+		static_cast<long long>(NumCharacters), Options.Frames, Options.Fps, Options.AvoidanceRadius);
+	std::printf("%9s %12s %10s %9s %10s %s\n", "processes", "ms/frame", "frames/s", "speedup", "relevant", Options.bVerify ? "matches reference" : "");
+
+	double BaselineSeconds = 0.0;
+	int32_t ExitCode = 0;
+	for (const int32_t NumShards : Options.Processes)
+	{
+		const FRunResult Result = RunSharded(InitialStates, NumCharacters, NumShards, Options, Params);
+		if (!Result.bSucceeded)
+		{
+			ExitCode = 1;
+			continue;
+		}
+
+		// Speedup is relative to the first process count listed.
+		if (BaselineSeconds == 0.0)
+		{
+			BaselineSeconds = Result.Seconds;
+		}
+		const bool bMatches = !Options.bVerify
+			|| std::memcmp(Result.FinalStates.data(), Reference.data(), Reference.size() * sizeof(float)) == 0;
+		if (!bMatches)
+		{
+			ExitCode = 1;
+		}
+
+		std::printf("%9d %12.3f %10.1f %8.2fx %10.1f %s\n", NumShards, Result.Seconds * 1000.0 / Options.Frames,
+			Options.Frames / Result.Seconds, BaselineSeconds / Result.Seconds, Result.AverageRelevant,
+			Options.bVerify ? (bMatches ? "yes" : "NO") : "");
+		std::fflush(stdout);
+	}
+
+	return ExitCode;
+}
@@ -0,0 +1,304 @@
+#include "LocomotionSim.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LocomotionSim
+{
+	namespace
+	{
+		constexpr float Pi = 3.14159265358979323846f;
+
+		float RadiansToDegrees(float Radians)
+		{
+			return Radians * (180.0f / Pi);
+		}
+
+		float DegreesToRadians(float Degrees)
+		{
+			return Degrees * (Pi / 180.0f);
+		}
+
+		// The demos rotate counter-clockwise in a right-handed plane; UE yaw turns clockwise.
+		float ToUnrealYaw(float RotationRadians)
+		{
+			return -RadiansToDegrees(RotationRadians);
+		}
+
+		// xorshift32, so the layout is identical on every platform and in the Python fallback.
+		uint32_t NextRandom(uint32_t& State)
+		{
+			State ^= State << 13;
+			State ^= State >> 17;
+			State ^= State << 5;
+			return State;
+		}
+
+		void MoveAlongPath(const FStateView& States, int64_t Row, float DeltaSeconds, const FSimParams& Params)
+		{
+			float& PosX = States.At(Row, EStateField::PosX);
+			float& PosY = States.At(Row, EStateField::PosY);
+			float& VelX = States.At(Row, EStateField::VelX);
+			float& VelY = States.At(Row, EStateField::VelY);
+			float& Rotation = States.At(Row, EStateField::Rotation);
+
+			const float T = States.At(Row, EStateField::Time) * Params.PathAngularSpeed + States.At(Row, EStateField::PathPhase);
+			const float TargetX = States.At(Row, EStateField::PathCenterX) + Params.PathRadiusX * std::sin(T);
+			const float TargetY = States.At(Row, EStateField::PathCenterY) + Params.PathRadiusY * std::sin(2.0f * T);
+
+			const float ToTargetX = TargetX - PosX;
+			const float ToTargetY = TargetY - PosY;
+			const float Distance = std::sqrt(ToTargetX * ToTargetX + ToTargetY * ToTargetY);
+			if (Distance > 0.1f)
+			{
+				VelX = ToTargetX / Distance * Params.WalkSpeed;
+				VelY = ToTargetY / Distance * Params.WalkSpeed;
+			}
+			else
+			{
+				VelX *= 0.9f;
+				VelY *= 0.9f;
+			}
+
+			PosX += VelX * DeltaSeconds;
+			PosY += VelY * DeltaSeconds;
+
+			const float Speed = std::sqrt(VelX * VelX + VelY * VelY);
+			if (Speed > 0.1f)
+			{
+				float AngleDiff = std::atan2(VelY, VelX) - Rotation;
+				AngleDiff = std::remainder(AngleDiff, 2.0f * Pi);
+				Rotation += AngleDiff * Params.TurnSmoothing * DeltaSeconds;
+			}
+		}
+
+		void MoveFromInput(const FStateView& States, int64_t Row, float DeltaSeconds, const FSimParams& Params)
+		{
+			float& PosX = States.At(Row, EStateField::PosX);
+			float& PosY = States.At(Row, EStateField::PosY);
+			float& VelX = States.At(Row, EStateField::VelX);
+			float& VelY = States.At(Row, EStateField::VelY);
+			float& Rotation = States.At(Row, EStateField::Rotation);
+
+			const float InputForward = States.At(Row, EStateField::InputForward);
+			const float InputTurn = States.At(Row, EStateField::InputTurn);
+
+			Rotation += InputTurn * Params.TurnSpeed * DeltaSeconds;
+
+			const float TargetVelX = InputForward * std::cos(Rotation) * Params.MaxSpeed;
+			const float TargetVelY = InputForward * std::sin(Rotation) * Params.MaxSpeed;
+
+			const float DiffX = TargetVelX - VelX;
+			const float DiffY = TargetVelY - VelY;
+			const float DiffLength = std::sqrt(DiffX * DiffX + DiffY * DiffY);
+			if (DiffLength > 0.001f)
+			{
+				const float Step = ProceduralLocomotionMath::Clamp(Params.Acceleration * DeltaSeconds, 0.0f, DiffLength);
+				VelX += DiffX / DiffLength * Step;
+				VelY += DiffY / DiffLength * Step;
+			}
+
+			VelX *= Params.Friction;
+			VelY *= Params.Friction;
+
+			PosX += VelX * DeltaSeconds;
+			PosY += VelY * DeltaSeconds;
+		}
+	}
+
+	void InitializeStates(const FStateView& States, float Spacing, uint32_t Seed, const FSimParams& Params)
+	{
+		const int64_t Columns = static_cast<int64_t>(std::ceil(std::sqrt(static_cast<double>(States.Count))));
+		uint32_t Random = Seed != 0 ? Seed : 0x9E3779B9u;
+
+		for (int64_t Row = 0; Row < States.Count; ++Row)
+		{
+			for (int32_t Field = 0; Field < NumStateFields; ++Field)
+			{
+				States.At(Row, Field) = 0.0f;
+			}
+
+			const float CenterX = (static_cast<float>(Row % Columns) - 0.5f * static_cast<float>(Columns - 1)) * Spacing;
+			const float CenterY = (static_cast<float>(Row / Columns) - 0.5f * static_cast<float>(Columns - 1)) * Spacing;
+			const float Phase = static_cast<float>(NextRandom(Random) >> 8) * (2.0f * Pi / 16777216.0f);
+
+			States.At(Row, EStateField::PathCenterX) = CenterX;
+			States.At(Row, EStateField::PathCenterY) = CenterY;
+			States.At(Row, EStateField::PathPhase) = Phase;
+			States.At(Row, EStateField::PosX) = CenterX + Params.PathRadiusX * std::sin(Phase);
+			States.At(Row, EStateField::PosY) = CenterY + Params.PathRadiusY * std::sin(2.0f * Phase);
+		}
+	}
+
+	namespace
+	{
+		// Separation velocity pushing Row away from the grid's neighbours, capped at AvoidanceStrength.
+		void ComputeAvoidance(const FStateView& States, int64_t Row, const FSimParams& Params, const FNeighbourGrid& Grid,
+			float& OutVelX, float& OutVelY)
+		{
+			OutVelX = 0.0f;
+			OutVelY = 0.0f;
+
+			const FStateView& Neighbours = Grid.GetNeighbours();
+			const float X = States.At(Row, EStateField::PosX);
+			const float Y = States.At(Row, EStateField::PosY);
+			const float Radius = Params.AvoidanceRadius;
+
+			Grid.ForEachNearby(X, Y, [&](int64_t Other)
+			{
+				const float AwayX = X - Neighbours.At(Other, EStateField::PosX);
+				const float AwayY = Y - Neighbours.At(Other, EStateField::PosY);
+				const float DistanceSquared = AwayX * AwayX + AwayY * AwayY;
+				// Skips the character itself, and anyone exactly on top of it (no direction to push).
+				if (DistanceSquared >= Radius * Radius || DistanceSquared <= 1e-8f)
+				{
+					return;
+				}
+
+				const float Distance = std::sqrt(DistanceSquared);
+				const float Push = (1.0f - Distance / Radius) * Params.AvoidanceStrength / Distance;
+				OutVelX += AwayX * Push;
+				OutVelY += AwayY * Push;
+			});
+
+			const float Speed = std::sqrt(OutVelX * OutVelX + OutVelY * OutVelY);
+			if (Speed > Params.AvoidanceStrength)
+			{
+				OutVelX *= Params.AvoidanceStrength / Speed;
+				OutVelY *= Params.AvoidanceStrength / Speed;
+			}
+		}
+
+		void UpdateRow(const FStateView& States, int64_t Row, float DeltaSeconds, EDriver Driver, const FSimParams& Params,
+			const FNeighbourGrid* Avoidance)
+		{
+			// Sampled before this character moves, like every neighbour in the grid's view.
+			float AvoidVelX = 0.0f;
+			float AvoidVelY = 0.0f;
+			if (Avoidance && Params.AvoidanceRadius > 0.0f)
+			{
+				ComputeAvoidance(States, Row, Params, *Avoidance, AvoidVelX, AvoidVelY);
+			}
+
+			States.At(Row, EStateField::Time) += DeltaSeconds;
+
+			const float PrevVelX = States.At(Row, EStateField::VelX);
+			const float PrevVelY = States.At(Row, EStateField::VelY);
+
+			if (Driver == EDriver::Path)
+			{
+				MoveAlongPath(States, Row, DeltaSeconds, Params);
+			}
+			else
+			{
+				MoveFromInput(States, Row, DeltaSeconds, Params);
+			}
+
+			if (AvoidVelX != 0.0f || AvoidVelY != 0.0f)
+			{
+				States.At(Row, EStateField::VelX) += AvoidVelX;
+				States.At(Row, EStateField::VelY) += AvoidVelY;
+				States.At(Row, EStateField::PosX) += AvoidVelX * DeltaSeconds;
+				States.At(Row, EStateField::PosY) += AvoidVelY * DeltaSeconds;
+			}
+
+			const float VelX = States.At(Row, EStateField::VelX);
+			const float VelY = States.At(Row, EStateField::VelY);
+			const float Rotation = States.At(Row, EStateField::Rotation);
+			States.At(Row, EStateField::GroundSpeed) = std::sqrt(VelX * VelX + VelY * VelY);
+
+			// Sideways acceleration relative to facing, in cm/s^2 like the character movement component.
+			const float SafeDelta = ProceduralLocomotionMath::Max(DeltaSeconds, ProceduralLocomotionMath::KindaSmallNumber);
+			const float AccelX = (VelX - PrevVelX) / SafeDelta;
+			const float AccelY = (VelY - PrevVelY) / SafeDelta;
+			const float LocalAccelY = (AccelX * std::sin(Rotation) - AccelY * std::cos(Rotation)) * 100.0f;
+
+			float& LastYaw = States.At(Row, EStateField::LastYaw);
+			float& LeanAngle = States.At(Row, EStateField::LeanAngle);
+			LeanAngle = ProceduralLocomotionMath::StepLean(LeanAngle, LastYaw, ToUnrealYaw(Rotation), LocalAccelY, DeltaSeconds, Params.Lean);
+		}
+	}
+
+	void Update(const FStateView& States, float DeltaSeconds, EDriver Driver, const FSimParams& Params)
+	{
+		for (int64_t Row = 0; Row < States.Count; ++Row)
+		{
+			UpdateRow(States, Row, DeltaSeconds, Driver, Params, nullptr);
+		}
+	}
+
+	void UpdateRows(const FStateView& States, const int64_t* Rows, int64_t NumRows, float DeltaSeconds, EDriver Driver,
+		const FSimParams& Params, const FNeighbourGrid* Avoidance)
+	{
+		for (int64_t Index = 0; Index < NumRows; ++Index)
+		{
+			UpdateRow(States, Rows[Index], DeltaSeconds, Driver, Params, Avoidance);
+		}
+	}
+
+	void FNeighbourGrid::Build(const FStateView& InNeighbours, const int64_t* Rows, int64_t NumRows, float InCellSize)
+	{
+		Neighbours = InNeighbours;
+		CellSize = InCellSize > 0.0f ? InCellSize : 1.0f;
+
+		Entries.clear();
+		Entries.reserve(static_cast<size_t>(NumRows));
+		for (int64_t Index = 0; Index < NumRows; ++Index)
+		{
+			const int64_t Row = Rows[Index];
+			Entries.emplace_back(CellKey(CellCoord(Neighbours.At(Row, EStateField::PosX)), CellCoord(Neighbours.At(Row, EStateField::PosY))), Row);
+		}
+		std::sort(Entries.begin(), Entries.end());
+	}
+
+	void ComputeSkeletonPoints(const FStateView& States, const FSimParams& Params, float* OutPoints)
+	{
+		for (int64_t Row = 0; Row < States.Count; ++Row)
+		{
+			const float X = States.At(Row, EStateField::PosX);
+			const float Y = States.At(Row, EStateField::PosY);
+			const float Rotation = States.At(Row, EStateField::Rotation);
+			const float Time = States.At(Row, EStateField::Time);
+			const float CosR = std::cos(Rotation);
+			const float SinR = std::sin(Rotation);
+			const float LeanScale = std::cos(DegreesToRadians(States.At(Row, EStateField::LeanAngle)));
+
+			float* Points = OutPoints + Row * NumSkeletonPoints * 2;
+			auto SetPoint = [Points](ESkeletonPoint Point, float PX, float PY)
+			{
+				Points[Point * 2 + 0] = PX;
+				Points[Point * 2 + 1] = PY;
+			};
+			// Rig-space point (sideways, up) leaned and turned to the facing direction.
+			auto SetRigPoint = [&](ESkeletonPoint Point, float PX, float PY)
+			{
+				const float Leaned = PX * LeanScale;
+				SetPoint(Point, X + Leaned * CosR - PY * SinR, Y + Leaned * SinR + PY * CosR);
+			};
+
+			SetPoint(ESkeletonPoint::Hip, X, Y);
+			SetRigPoint(ESkeletonPoint::SpineTop, 0.0f, Params.BodyHeight * 0.6f);
+
+			float HeadPitch = 0.0f;
+			float HeadYaw = 0.0f;
+			ProceduralLocomotionMath::ComputeBoneOscillation(Time, Params.HeadOscillation, HeadPitch, HeadYaw);
+			const float HeadOffsetX = Params.HeadSize * std::sin(DegreesToRadians(HeadYaw));
+			const float HeadOffsetY = Params.HeadSize * std::cos(DegreesToRadians(HeadPitch));
+			SetPoint(ESkeletonPoint::Head,
+				Points[ESkeletonPoint::SpineTop * 2 + 0] + HeadOffsetX * CosR,
+				Points[ESkeletonPoint::SpineTop * 2 + 1] + HeadOffsetY + 0.3f);
+
+			const float StrideSpeed = ProceduralLocomotionMath::Max(States.At(Row, EStateField::GroundSpeed), Params.MinStrideSpeed);
+			const float StrideTime = Time * StrideSpeed * 2.0f;
+			const float LeftPhase = std::sin(StrideTime);
+			const float RightPhase = std::sin(StrideTime + Pi);
+
+			SetRigPoint(ESkeletonPoint::LeftFoot, -0.2f + LeftPhase * 0.3f, -Params.LegLength + std::fabs(LeftPhase) * 0.2f);
+			SetRigPoint(ESkeletonPoint::RightFoot, 0.2f + RightPhase * 0.3f, -Params.LegLength + std::fabs(RightPhase) * 0.2f);
+
+			// Arms swing opposite to the legs.
+			SetRigPoint(ESkeletonPoint::LeftHand, -0.4f - RightPhase * 0.2f, Params.BodyHeight * 0.3f - std::fabs(RightPhase) * 0.1f);
+			SetRigPoint(ESkeletonPoint::RightHand, 0.4f - LeftPhase * 0.2f, Params.BodyHeight * 0.3f - std::fabs(LeftPhase) * 0.1f);
+		}
+	}
+}
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+Live MoCap Stand-in Sender
+Streams a procedural walk cycle in the live MoCap wire format
+(Source/ProceduralLocomotionSystem/Public/ProceduralLocomotionMoCapProtocol.h) so the stage
+pipeline can be exercised without a capture system. Point it at a game running a character
+whose anim instance has bEnableMoCap set.
+
+Usage:
+    python3 Tools/MoCapSender/mocap_sender.py                           # 60 Hz to 127.0.0.1:54321
+    python3 Tools/MoCapSender/mocap_sender.py --rate 120 --port 54322 --subject 1
+    python3 Tools/MoCapSender/mocap_sender.py --receive                 # decode a stream and print it
+
+The rotations are a rough walk for the UE5 mannequin's bone axes; they are meant to show
+latency and layering (lean and foot IK on top), not to be good animation.
+"""
+
+import argparse
+import math
+import socket
+import struct
+import time
+
+MAGIC = 0x4D534C50
+VERSION = 1
+MAX_BONES = 256
+
+PACKET_HEADER = struct.Struct('<IIIIQd')
+BONE_SAMPLE = struct.Struct('<7f')
+assert PACKET_HEADER.size == 32 and BONE_SAMPLE.size == 28
+
+# Default UProceduralLocomotionAnimInstance::MoCapBoneNames, in packet order.
+BONE_NAMES = [
+    'pelvis', 'spine_01', 'spine_02', 'spine_03', 'neck_01', 'head',
+    'thigh_l', 'calf_l', 'foot_l', 'thigh_r', 'calf_r', 'foot_r',
+    'upperarm_l', 'lowerarm_l', 'upperarm_r', 'lowerarm_r',
+]
+
+PELVIS_HEIGHT = 96.0  # cm above the root, mannequin reference pose
+
+
+def quat_from_euler(roll, pitch, yaw):
+    """Degrees to an (x, y, z, w) quaternion, using FRotator's roll/pitch/yaw convention."""
+    sr, cr = math.sin(math.radians(roll) * 0.5), math.cos(math.radians(roll) * 0.5)
+    sp, cp = math.sin(math.radians(pitch) * 0.5), math.cos(math.radians(pitch) * 0.5)
+    sy, cy = math.sin(math.radians(yaw) * 0.5), math.cos(math.radians(yaw) * 0.5)
+    return (cr * sp * sy - sr * cp * cy,
+            -cr * sp * cy - sr * cp * sy,
+            cr * cp * sy - sr * sp * cy,
+            cr * cp * cy + sr * sp * sy)
+
+
+def walk_pose(t, cadence):
+    """Parent-relative (translation, rotation) per bone for a walk cycle at time t."""
+    phase = 2.0 * math.pi * cadence * t
+    swing = math.sin(phase)
+    bob = abs(math.cos(phase))
+
+    def knee(offset):
+        # Knees bend most just after the leg passes under the body.
+        return 5.0 + 35.0 * max(0.0, math.sin(phase + offset - 0.6))
+
+    pose = {
+        'pelvis': ((0.0, 0.0, PELVIS_HEIGHT - 2.0 * bob), quat_from_euler(0.0, 0.0, 4.0 * swing)),
+        'spine_01': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, -2.0 * swing)),
+        'spine_02': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, -2.0 * swing)),
+        'spine_03': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, -2.0 * swing)),
+        'neck_01': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, 0.0)),
+        'head': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 2.0 * bob, 0.0)),
+        'thigh_l': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, 25.0 * swing)),
+        'calf_l': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, -knee(0.0))),
+        'foot_l': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, 10.0 * swing)),
+        'thigh_r': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, -25.0 * swing)),
+        'calf_r': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, -knee(math.pi))),
+        'foot_r': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, -10.0 * swing)),
+        'upperarm_l': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, -20.0 * swing)),
+        'lowerarm_l': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, 15.0 + 10.0 * swing)),
+        'upperarm_r': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, 20.0 * swing)),
+        'lowerarm_r': ((0.0, 0.0, 0.0), quat_from_euler(0.0, 0.0, 15.0 - 10.0 * swing)),
+    }
+    return [pose[name] for name in BONE_NAMES]
+
+
+def encode_frame(buffer, subject, frame_number, capture_time, bones):
+    """Packs one frame into a preallocated bytearray; returns the packet length."""
+    PACKET_HEADER.pack_into(buffer, 0, MAGIC, VERSION, subject, len(bones), frame_number, capture_time)
+    offset = PACKET_HEADER.size
+    for translation, rotation in bones:
+        BONE_SAMPLE.pack_into(buffer, offset, *translation, *rotation)
+        offset += BONE_SAMPLE.size
+    return offset
+
+
+def send(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    buffer = bytearray(PACKET_HEADER.size + MAX_BONES * BONE_SAMPLE.size)
+    view = memoryview(buffer)
+    period = 1.0 / args.rate
+    start = time.perf_counter()
+    next_send = start
+    frame_number = 0
+
+    print(f"Streaming {len(BONE_NAMES)} bones at {args.rate:g} Hz to {args.host}:{args.port} "
+          f"(subject {args.subject}); Ctrl+C to stop")
+    try:
+        while args.frames <= 0 or frame_number < args.frames:
+            now = time.perf_counter()
+            size = encode_frame(buffer, args.subject, frame_number, now - start, walk_pose(now - start, args.cadence))
+            sock.sendto(view[:size], (args.host, args.port))
+            frame_number += 1
+
+            # Fixed-rate schedule that doesn't drift when a send runs late.
+            next_send += period
+            delay = next_send - time.perf_counter()
+            if delay > 0:
+                time.sleep(delay)
+            else:
+                next_send = time.perf_counter()
+    except KeyboardInterrupt:
+        pass
+    print(f"Sent {frame_number} frames")
+
+
+def receive(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.host, args.port))
+    print(f"Listening on {args.host}:{args.port}")
+    try:
+        while True:
+            data = sock.recv(65536)
+            if len(data) < PACKET_HEADER.size:
+                print(f"short packet ({len(data)} bytes)")
+                continue
+            magic, version, subject, num_bones, frame_number, capture_time = PACKET_HEADER.unpack_from(data)
+            if magic != MAGIC or version != VERSION or len(data) < PACKET_HEADER.size + num_bones * BONE_SAMPLE.size:
+                print(f"rejected packet (magic {magic:#x}, version {version}, {len(data)} bytes)")
+                continue
+            pelvis = BONE_SAMPLE.unpack_from(data, PACKET_HEADER.size)
+            print(f"subject {subject} frame {frame_number:6d} t={capture_time:8.3f} bones={num_bones} "
+                  f"pelvis z={pelvis[2]:6.2f}")
+    except KeyboardInterrupt:
+        pass
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Stand-in live MoCap sender for the procedural anim instance.')
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=54321, help='UProceduralLocomotionAnimInstance::MoCapPort')
+    parser.add_argument('--subject', type=int, default=0, help='Subject id written into each packet')
+    parser.add_argument('--rate', type=float, default=60.0, help='Frames per second')
+    parser.add_argument('--cadence', type=float, default=0.9, help='Walk cycles per second')
+    parser.add_argument('--frames', type=int, default=0, help='Stop after this many frames (0 = run until Ctrl+C)')
+    parser.add_argument('--receive', action='store_true', help='Decode and print a stream instead of sending')
+    args = parser.parse_args()
+
+    if args.receive:
+        receive(args)
+    else:
+        send(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,581 @@
+#!/usr/bin/env python3
+"""
+Procedural Locomotion Pose Recording Reader
+Reads the pose recordings written by `pls.Recording.Start` (format described in
+Source/ProceduralLocomotionSystem/Public/ProceduralLocomotionPoseRecordingFormat.h) and runs
+the standard offline checks on them. Import it from analysis scripts, or run it directly.
+
+Library:
+    from pose_recording import PoseRecording
+    rec = PoseRecording('Saved/PoseRecordings/20260101-120000.plsrec')
+    track = rec.track(character_id, start=10.0, end=20.0)  # one character, numpy arrays over time
+    feet = track.world_positions(['foot_l', 'foot_r'])     # (frames, 2, 3) in cm
+
+Usage:
+    python3 Tools/PoseRecording/pose_recording.py summary FILE
+    python3 Tools/PoseRecording/pose_recording.py sliding FILE [--feet foot_l,foot_r]
+    python3 Tools/PoseRecording/pose_recording.py penetration FILE [--bones foot_l,foot_r,ball_l,ball_r]
+    python3 Tools/PoseRecording/pose_recording.py lean FILE [--lean-bones pelvis,head]
+    python3 Tools/PoseRecording/pose_recording.py write-demo FILE [--characters 100 --seconds 60]
+"""
+
+import argparse
+import bisect
+import os
+import struct
+import sys
+import zlib
+
+import numpy as np
+
+MAGIC = 0x52534C50
+VERSION = 1
+SKELETON_BLOCK = 0x4B534C50
+CHARACTER_BLOCK = 0x41534C50
+CHUNK_BLOCK = 0x43534C50
+
+# Mirrors of the structs in ProceduralLocomotionPoseRecordingFormat.h.
+FILE_HEADER = struct.Struct('<IIIIffd')
+BLOCK_HEADER = struct.Struct('<II')
+CHUNK_HEADER = struct.Struct('<QddII')
+assert FILE_HEADER.size == 32 and BLOCK_HEADER.size == 8 and CHUNK_HEADER.size == 32
+
+NUM_CHARACTER_CHANNELS = 10
+NUM_BONE_CHANNELS = 6
+
+
+class Skeleton:
+    def __init__(self, skeleton_id, names, parents):
+        self.id = skeleton_id
+        self.names = names
+        self.parents = np.asarray(parents, dtype=np.int32)
+        self.index = {name: i for i, name in enumerate(names)}
+
+    def bone_index(self, name):
+        if name not in self.index:
+            raise KeyError(f"bone '{name}' is not in skeleton {self.id}")
+        return self.index[name]
+
+    @property
+    def num_channels(self):
+        return NUM_CHARACTER_CHANNELS + len(self.names) * NUM_BONE_CHANNELS
+
+
+class Chunk:
+    def __init__(self, offset, size, first_frame, start, end, num_frames, uncompressed_size):
+        self.offset = offset          # of the compressed payload
+        self.size = size
+        self.first_frame = first_frame
+        self.start = start
+        self.end = end
+        self.num_frames = num_frames
+        self.uncompressed_size = uncompressed_size
+
+
+def _decode_varints(data):
+    """All varints in data, decoded at once."""
+    data = np.frombuffer(data, dtype=np.uint8)
+    if len(data) == 0:
+        return np.zeros(0, dtype=np.uint32)
+    last = (data & 0x80) == 0
+    ends = np.flatnonzero(last)
+    starts = np.concatenate(([0], ends[:-1] + 1))
+    group = np.concatenate(([0], np.cumsum(last[:-1])))
+    shifts = (np.arange(len(data)) - starts[group]) * 7
+    values = (data & 0x7F).astype(np.uint64) << shifts.astype(np.uint64)
+    return np.add.reduceat(values, starts).astype(np.uint32)
+
+
+def _unzigzag(values):
+    values = values.astype(np.int64)
+    return (values >> 1) ^ -(values & 1)
+
+
+def _wrap(values):
+    """Wraps int64 values to int32 the way the writer's arithmetic does."""
+    return ((values + 2**31) % 2**32) - 2**31
+
+
+def _encode_varints(values):
+    """Varint bytes of uint32 values, the inverse of _decode_varints."""
+    values = np.asarray(values, dtype=np.uint64) & 0xFFFFFFFF
+    lengths = np.ones(len(values), dtype=np.int64)
+    for shift in (7, 14, 21, 28):
+        lengths += values >= (1 << shift)
+    starts = np.cumsum(lengths) - lengths
+    position = np.arange(int(lengths.sum())) - np.repeat(starts, lengths)
+    owner = np.repeat(values, lengths)
+    out = ((owner >> (7 * position).astype(np.uint64)) & 0x7F).astype(np.uint8)
+    out[position < np.repeat(lengths, lengths) - 1] |= 0x80
+    return out.tobytes()
+
+
+def _zigzag(values):
+    values = _wrap(np.asarray(values, dtype=np.int64))
+    return ((values << 1) ^ (values >> 31)) & 0xFFFFFFFF
+
+
+def _dequantize_rotations(xyz, scale):
+    """(..., 3) quantized quaternion XYZ to (..., 4) XYZW with W >= 0."""
+    xyz = xyz.astype(np.float64) / scale
+    w = np.sqrt(np.clip(1.0 - np.sum(xyz * xyz, axis=-1), 0.0, 1.0))
+    quat = np.concatenate([xyz, w[..., None]], axis=-1)
+    return quat / np.linalg.norm(quat, axis=-1, keepdims=True)
+
+
+def quat_rotate(q, v):
+    """Rotates vectors v (..., 3) by unit quaternions q (..., 4) XYZW."""
+    u = q[..., :3]
+    w = q[..., 3:4]
+    t = 2.0 * np.cross(u, v)
+    return v + w * t + np.cross(u, t)
+
+
+def quat_multiply(a, b):
+    """a * b for XYZW quaternions: rotates by b first, then a (as FQuat)."""
+    ax, ay, az, aw = np.moveaxis(a, -1, 0)
+    bx, by, bz, bw = np.moveaxis(b, -1, 0)
+    return np.stack([
+        aw * bx + ax * bw + ay * bz - az * by,
+        aw * by - ax * bz + ay * bw + az * bx,
+        aw * bz + ax * by - ay * bx + az * bw,
+        aw * bw - ax * bx - ay * by - az * bz,
+    ], axis=-1)
+
+
+class Track:
+    """One character over a time range. Units follow the engine: cm and world space."""
+
+    def __init__(self, character_id, skeleton, times, channels, rotation_scale, distance_scale):
+        self.character_id = character_id
+        self.skeleton = skeleton
+        self.times = np.asarray(times)
+        channels = np.asarray(channels, dtype=np.int64).reshape(len(self.times), -1)
+        self.location = channels[:, 0:3] / distance_scale
+        self.rotation = _dequantize_rotations(channels[:, 3:6], rotation_scale)
+        self.floor_z = channels[:, 6] / distance_scale
+        self.floor_normal = channels[:, 7:10] / rotation_scale
+        self.has_floor = np.any(channels[:, 7:10] != 0, axis=1)
+        bones = channels[:, NUM_CHARACTER_CHANNELS:].reshape(len(self.times), -1, NUM_BONE_CHANNELS)
+        self.bone_rotations = _dequantize_rotations(bones[:, :, 0:3], rotation_scale)
+        self.bone_translations = bones[:, :, 3:6] / distance_scale
+
+    def __len__(self):
+        return len(self.times)
+
+    def component_transforms(self, bone_names=None):
+        """Component-space (rotations (T, K, 4), positions (T, K, 3)) of the bones, all by default."""
+        parents = self.skeleton.parents
+        count = len(parents)
+        wanted = range(count) if bone_names is None else [self.skeleton.bone_index(n) for n in bone_names]
+        needed = np.zeros(count, dtype=bool)
+        for bone in wanted:
+            while bone >= 0 and not needed[bone]:
+                needed[bone] = True
+                bone = parents[bone]
+
+        rotations = np.empty_like(self.bone_rotations)
+        positions = np.empty_like(self.bone_translations)
+        # Parents come before children, so one pass in bone order resolves every chain.
+        for bone in np.flatnonzero(needed):
+            parent = parents[bone]
+            if parent < 0:
+                rotations[:, bone] = self.bone_rotations[:, bone]
+                positions[:, bone] = self.bone_translations[:, bone]
+            else:
+                rotations[:, bone] = quat_multiply(rotations[:, parent], self.bone_rotations[:, bone])
+                positions[:, bone] = positions[:, parent] + quat_rotate(rotations[:, parent], self.bone_translations[:, bone])
+        wanted = list(wanted)
+        return rotations[:, wanted], positions[:, wanted]
+
+    def world_positions(self, bone_names=None):
+        """World-space bone positions, (T, K, 3)."""
+        _, positions = self.component_transforms(bone_names)
+        rotation = np.repeat(self.rotation[:, None, :], positions.shape[1], axis=1)
+        return self.location[:, None, :] + quat_rotate(rotation, positions)
+
+    def height_above_floor(self, positions):
+        """Signed distance of world positions (T, K, 3) from the floor plane under the character."""
+        normal = np.where(self.has_floor[:, None], self.floor_normal, [0.0, 0.0, 1.0])
+        normal = normal / np.linalg.norm(normal, axis=-1, keepdims=True)
+        point = np.concatenate([self.location[:, :2], self.floor_z[:, None]], axis=1)
+        return np.einsum('tkc,tc->tk', positions - point[:, None, :], normal)
+
+
+class PoseRecording:
+    def __init__(self, path):
+        self.path = path
+        self.skeletons = {}
+        self.characters = {}
+        self.chunks = []
+        with open(path, 'rb') as f:
+            header = f.read(FILE_HEADER.size)
+            if len(header) < FILE_HEADER.size:
+                raise ValueError(f"{path} is not a pose recording")
+            magic, version, header_size, _, self.rotation_scale, self.distance_scale, self.start_unix = FILE_HEADER.unpack(header)
+            if magic != MAGIC:
+                raise ValueError(f"{path} is not a pose recording")
+            if version != VERSION:
+                raise ValueError(f"{path} is version {version}, reader expects {VERSION}")
+            self._scan(f, header_size)
+        self._chunk_starts = [chunk.start for chunk in self.chunks]
+
+    def _scan(self, f, offset):
+        """Indexes every block; only skeleton and character payloads are read."""
+        f.seek(offset)
+        while True:
+            header = f.read(BLOCK_HEADER.size)
+            if len(header) < BLOCK_HEADER.size:
+                break
+            block_type, size = BLOCK_HEADER.unpack(header)
+            payload_offset = f.tell()
+            if block_type == CHUNK_BLOCK:
+                chunk_header = f.read(CHUNK_HEADER.size)
+                if len(chunk_header) < CHUNK_HEADER.size or size < CHUNK_HEADER.size:
+                    break
+                first_frame, start, end, num_frames, uncompressed = CHUNK_HEADER.unpack(chunk_header)
+                self.chunks.append(Chunk(payload_offset + CHUNK_HEADER.size, size - CHUNK_HEADER.size,
+                                         first_frame, start, end, num_frames, uncompressed))
+            elif block_type in (SKELETON_BLOCK, CHARACTER_BLOCK):
+                payload = f.read(size)
+                if len(payload) < size:
+                    break
+                if block_type == SKELETON_BLOCK:
+                    self._read_skeleton(payload)
+                else:
+                    character_id, = struct.unpack_from('<I', payload)
+                    self.characters[character_id] = payload[5:5 + payload[4]].decode('utf-8', 'replace')
+            f.seek(payload_offset + size)
+        # A truncated last chunk is dropped.
+        file_size = os.path.getsize(self.path)
+        while self.chunks and self.chunks[-1].offset + self.chunks[-1].size > file_size:
+            self.chunks.pop()
+
+    def _read_skeleton(self, payload):
+        skeleton_id, count = struct.unpack_from('<II', payload)
+        parents = struct.unpack_from(f'<{count}i', payload, 8)
+        names = []
+        offset = 8 + 4 * count
+        for _ in range(count):
+            length = payload[offset]
+            names.append(payload[offset + 1:offset + 1 + length].decode('utf-8', 'replace'))
+            offset += 1 + length
+        self.skeletons[skeleton_id] = Skeleton(skeleton_id, names, parents)
+
+    @property
+    def start(self):
+        return self.chunks[0].start if self.chunks else 0.0
+
+    @property
+    def end(self):
+        return self.chunks[-1].end if self.chunks else 0.0
+
+    @property
+    def num_frames(self):
+        return sum(chunk.num_frames for chunk in self.chunks)
+
+    def chunks_between(self, start=None, end=None):
+        """Indices of the chunks overlapping [start, end] world seconds."""
+        first = 0 if start is None else max(bisect.bisect_right(self._chunk_starts, start) - 1, 0)
+        indices = []
+        for index in range(first, len(self.chunks)):
+            if end is not None and self.chunks[index].start > end:
+                break
+            if start is None or self.chunks[index].end >= start:
+                indices.append(index)
+        return indices
+
+    def read_chunk(self, index):
+        """Decodes one chunk: (times (F,), frame numbers (F,), {character id: (skeleton id, frame
+        indices, channels (n, C))}), with channels as absolute quantized values."""
+        chunk = self.chunks[index]
+        with open(self.path, 'rb') as f:
+            f.seek(chunk.offset)
+            data = zlib.decompress(f.read(chunk.size))
+        if len(data) != chunk.uncompressed_size:
+            raise ValueError(f"chunk {index} decompressed to {len(data)} bytes, expected {chunk.uncompressed_size}")
+
+        times = np.frombuffer(data, dtype='<f8', count=chunk.num_frames)
+        values = _decode_varints(data[8 * chunk.num_frames:])
+        frame_numbers = np.zeros(chunk.num_frames, dtype=np.uint64)
+
+        tracks = {}
+        previous = {}
+        cursor = 0
+        for frame in range(chunk.num_frames):
+            frame_numbers[frame] = chunk.first_frame + int(values[cursor])
+            count = int(values[cursor + 1])
+            cursor += 2
+            for _ in range(count):
+                character_id = int(values[cursor])
+                skeleton_id = int(values[cursor + 1])
+                cursor += 2
+                num_channels = self.skeletons[skeleton_id].num_channels
+                deltas = _unzigzag(values[cursor:cursor + num_channels])
+                cursor += num_channels
+
+                # Residuals against Previous + (Previous - BeforePrevious), wrapping at 32 bits.
+                base = previous.get(character_id)
+                if base is None or base[0] != skeleton_id:
+                    channels = _wrap(deltas)
+                    change = np.zeros_like(channels)
+                else:
+                    channels = _wrap(base[1] + base[2] + deltas)
+                    change = _wrap(channels - base[1])
+                previous[character_id] = (skeleton_id, channels, change)
+
+                entry = tracks.setdefault(character_id, (skeleton_id, [], []))
+                if entry[0] != skeleton_id:
+                    entry = tracks[character_id] = (skeleton_id, [], [])
+                entry[1].append(frame)
+                entry[2].append(channels)
+
+        return times, frame_numbers, {cid: (sid, np.asarray(frames), np.asarray(rows))
+                                      for cid, (sid, frames, rows) in tracks.items()}
+
+    def character_ids(self, name_filter=None):
+        return sorted(cid for cid, name in self.characters.items() if not name_filter or name_filter in name)
+
+    def track(self, character_id, start=None, end=None):
+        """One character between start and end world seconds, or None if it was not recorded."""
+        skeleton = None
+        times, rows = [], []
+        for index in self.chunks_between(start, end):
+            chunk_times, _, tracks = self.read_chunk(index)
+            if character_id not in tracks:
+                continue
+            skeleton_id, frames, channels = tracks[character_id]
+            if skeleton is None:
+                skeleton = self.skeletons[skeleton_id]
+            elif skeleton.id != skeleton_id:
+                break  # mesh changed; a track keeps one skeleton
+            keep = np.ones(len(frames), dtype=bool)
+            if start is not None:
+                keep &= chunk_times[frames] >= start
+            if end is not None:
+                keep &= chunk_times[frames] <= end
+            times.append(chunk_times[frames][keep])
+            rows.append(channels[keep])
+        if skeleton is None:
+            return None
+        return Track(character_id, skeleton, np.concatenate(times), np.concatenate(rows),
+                     self.rotation_scale, self.distance_scale)
+
+    def tracks(self, name_filter=None, start=None, end=None):
+        for character_id in self.character_ids(name_filter):
+            track = self.track(character_id, start, end)
+            if track is not None and len(track) > 2:
+                yield track
+
+
+# Analysis
+
+
+def _speed(times, positions):
+    """Horizontal speed (T, K) of positions (T, K, 3) by central differences."""
+    if len(times) < 2:
+        return np.zeros(positions.shape[:2])
+    velocity = np.gradient(positions[..., :2], times, axis=0)
+    return np.linalg.norm(velocity, axis=-1)
+
+
+def analyze_sliding(track, feet, contact_height, slide_speed):
+    """Horizontal foot speed while the foot is within contact_height of the floor."""
+    positions = track.world_positions(feet)
+    height = track.height_above_floor(positions)
+    speed = _speed(track.times, positions)
+    results = {}
+    for k, foot in enumerate(feet):
+        contact = (height[:, k] < contact_height) & track.has_floor
+        planted = speed[contact, k]
+        results[foot] = {
+            'contact': float(np.mean(contact)) if len(contact) else 0.0,
+            'mean': float(np.mean(planted)) if len(planted) else 0.0,
+            'p95': float(np.percentile(planted, 95)) if len(planted) else 0.0,
+            'sliding': float(np.mean(planted > slide_speed)) if len(planted) else 0.0,
+        }
+    return results
+
+
+def analyze_penetration(track, bones, tolerance):
+    """How far the bones go below the floor plane."""
+    positions = track.world_positions(bones)
+    depth = np.where(track.has_floor[:, None], -track.height_above_floor(positions), 0.0)
+    results = {}
+    for k, bone in enumerate(bones):
+        below = depth[:, k] > tolerance
+        results[bone] = {
+            'frames': float(np.mean(below)),
+            'max': float(max(np.max(depth[:, k]), 0.0)) if len(depth) else 0.0,
+            'mean': float(np.mean(depth[below, k])) if np.any(below) else 0.0,
+        }
+    return results
+
+
+def analyze_lean(track, lower, upper, gravity=980.0):
+    """Compares the body's sideways lean with the lean the character's acceleration calls for.
+    Returns RMS error and correlation between the measured and expected angles, in degrees."""
+    positions = track.world_positions([lower, upper])
+    axis = positions[:, 1] - positions[:, 0]
+    if len(track) < 3:
+        return None
+
+    velocity = np.gradient(track.location, track.times, axis=0)
+    acceleration = np.gradient(velocity, track.times, axis=0)
+    heading = velocity[:, :2]
+    speed = np.linalg.norm(heading, axis=1)
+    moving = speed > 10.0
+    if not np.any(moving):
+        return None
+    forward = heading / np.maximum(speed, 1e-6)[:, None]
+    right = np.stack([-forward[:, 1], forward[:, 0]], axis=1)
+
+    lateral_acceleration = np.einsum('tc,tc->t', acceleration[:, :2], right)
+    expected = np.degrees(np.arctan2(lateral_acceleration, gravity))
+    lateral_offset = np.einsum('tc,tc->t', axis[:, :2], right)
+    measured = np.degrees(np.arctan2(lateral_offset, axis[:, 2]))
+
+    expected, measured = expected[moving], measured[moving]
+    error = measured - expected
+    correlation = float(np.corrcoef(expected, measured)[0, 1]) if np.std(expected) > 1e-6 and np.std(measured) > 1e-6 else 0.0
+    return {'rms': float(np.sqrt(np.mean(error ** 2))), 'bias': float(np.mean(error)),
+            'correlation': correlation, 'peak_expected': float(np.max(np.abs(expected))),
+            'peak_measured': float(np.max(np.abs(measured)))}
+
+
+# Demo writer
+
+
+def write_demo(path, characters=100, seconds=60.0, rate=60.0, num_bones=70, chunk_seconds=1.0):
+    """Writes a synthetic recording in the game's format: a crowd walking circles, each with legs,
+    spine and arms swinging and the remaining bones (fingers, twist, IK targets) still, as in a
+    typical humanoid. For testing readers and tools without Unreal."""
+    rng = np.random.default_rng(7)
+    names = ['root', 'pelvis', 'foot_l', 'foot_r', 'spine', 'head'] + [f'bone_{b}' for b in range(6, num_bones)]
+    parents = [-1, 0, 1, 1, 1, 4] + [int(rng.integers(1, b)) for b in range(6, num_bones)]
+    offsets = rng.normal(0.0, 10.0, (num_bones, 3))
+    offsets[:6] = [[0, 0, 0], [0, 0, 95], [0, -10, -93], [0, 10, -93], [0, 0, 30], [0, 0, 40]]
+    animated = np.zeros(num_bones, dtype=bool)
+    animated[2:min(24, num_bones)] = True
+    amplitude = np.where(animated, rng.uniform(0.05, 0.4, num_bones), 0.0)
+    amplitude[2:4] = 0.3
+    phase = rng.uniform(0.0, 2.0 * np.pi, characters)
+    radius = rng.uniform(300.0, 2000.0, characters)
+    frequency = rng.uniform(0.8, 1.2, characters)
+    translations = np.round(offsets * 100.0).astype(np.int64)
+
+    def rotation_channels(angle, axis):
+        return np.round(np.sin(angle[..., None] / 2.0) * axis * 16383.0).astype(np.int64)
+
+    def frame_channels(t):
+        angle = phase + t * 150.0 / radius
+        location = np.stack([radius * np.cos(angle), radius * np.sin(angle), np.zeros(characters)], axis=1)
+        swing = amplitude * np.sin(2.0 * np.pi * frequency[:, None] * t + phase[:, None] + np.arange(num_bones))
+        bones = np.concatenate([rotation_channels(swing, np.array([0.0, 1.0, 0.0])),
+                                np.broadcast_to(translations, (characters, num_bones, 3))], axis=2)
+        return np.concatenate([
+            np.round(location * 100.0).astype(np.int64),
+            rotation_channels(angle + np.pi / 2.0, np.array([0.0, 0.0, 1.0])),
+            np.zeros((characters, 1), dtype=np.int64), np.tile([0, 0, 16383], (characters, 1)),
+            bones.reshape(characters, -1)], axis=1)
+
+    with open(path, 'wb') as f:
+        f.write(FILE_HEADER.pack(MAGIC, VERSION, FILE_HEADER.size, 0, 16383.0, 100.0, 0.0))
+        payload = struct.pack('<II', 0, num_bones) + struct.pack(f'<{num_bones}i', *parents)
+        payload += b''.join(bytes([len(n)]) + n.encode() for n in names)
+        f.write(BLOCK_HEADER.pack(SKELETON_BLOCK, len(payload)) + payload)
+        for c in range(characters):
+            name = f'BP_ProceduralCharacter_C_{c}'.encode()
+            payload = struct.pack('<I', c) + bytes([len(name)]) + name
+            f.write(BLOCK_HEADER.pack(CHARACTER_BLOCK, len(payload)) + payload)
+
+        num_frames = int(seconds * rate)
+        per_chunk = max(int(chunk_seconds * rate), 1)
+        for first in range(0, num_frames, per_chunk):
+            frames = np.arange(first, min(first + per_chunk, num_frames))
+            times = frames / rate
+            channels = np.stack([frame_channels(t) for t in times])  # (F, characters, C)
+            residuals = channels.copy()
+            residuals[1:] -= channels[:-1]
+            residuals[2:] -= channels[1:-1] - channels[:-2]
+            # Per frame: offset, count, then per character: id, skeleton, residuals.
+            ids = np.broadcast_to(np.stack([np.arange(characters), np.zeros(characters, dtype=np.int64)], axis=1),
+                                  (len(frames), characters, 2))
+            rows = np.concatenate([ids, _zigzag(residuals)], axis=2).reshape(len(frames), -1)
+            prefix = np.stack([frames - first, np.full(len(frames), characters)], axis=1)
+            data = times.astype('<f8').tobytes() + _encode_varints(np.concatenate([prefix, rows], axis=1).ravel())
+            compressed = zlib.compress(data, 6)
+            header = CHUNK_HEADER.pack(int(first), times[0], times[-1], len(times), len(data))
+            f.write(BLOCK_HEADER.pack(CHUNK_BLOCK, len(header) + len(compressed)) + header + compressed)
+
+
+# Command line
+
+
+def _print_summary(rec):
+    size = os.path.getsize(rec.path)
+    duration = max(rec.end - rec.start, 1e-6)
+    character_frames = 0
+    for index in range(len(rec.chunks)):
+        _, _, tracks = rec.read_chunk(index)
+        character_frames += sum(len(frames) for _, frames, _ in tracks.values())
+    print(f"{rec.path}: {size / 2**20:.2f} MB, {duration:.1f} s, {rec.num_frames} frames in {len(rec.chunks)} chunks")
+    print(f"  {len(rec.characters)} characters, {len(rec.skeletons)} skeletons "
+          f"({', '.join(f'{len(s.names)} bones' for s in rec.skeletons.values())})")
+    print(f"  {size / 2**20 / duration * 60.0:.2f} MB per minute, "
+          f"{size / max(character_frames, 1):.1f} bytes per character frame")
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description='Reads and analyzes procedural locomotion pose recordings.')
+    parser.add_argument('command', choices=['summary', 'sliding', 'penetration', 'lean', 'write-demo'])
+    parser.add_argument('file')
+    parser.add_argument('--characters', default=None,
+                        help='Only characters whose name contains this (write-demo: number of characters)')
+    parser.add_argument('--start', type=float, default=None, help='World seconds')
+    parser.add_argument('--end', type=float, default=None, help='World seconds')
+    parser.add_argument('--feet', default='foot_l,foot_r')
+    parser.add_argument('--bones', default='foot_l,foot_r', help='Bones checked for penetration')
+    parser.add_argument('--lean-bones', default='pelvis,head', help='Lower and upper bone of the lean axis')
+    parser.add_argument('--contact-height', type=float, default=5.0, help='cm above the floor counted as planted')
+    parser.add_argument('--slide-speed', type=float, default=5.0, help='cm/s of planted motion counted as sliding')
+    parser.add_argument('--tolerance', type=float, default=0.5, help='cm below the floor ignored')
+    parser.add_argument('--seconds', type=float, default=60.0, help='write-demo: length')
+    args = parser.parse_args(argv)
+
+    if args.command == 'write-demo':
+        write_demo(args.file, characters=int(args.characters or 100), seconds=args.seconds)
+        _print_summary(PoseRecording(args.file))
+        return 0
+
+    rec = PoseRecording(args.file)
+    if args.command == 'summary':
+        _print_summary(rec)
+        return 0
+
+    for track in rec.tracks(args.characters, args.start, args.end):
+        name = rec.characters.get(track.character_id, str(track.character_id))
+        try:
+            if args.command == 'sliding':
+                feet = args.feet.split(',')
+                for foot, r in analyze_sliding(track, feet, args.contact_height, args.slide_speed).items():
+                    print(f"{name} {foot}: planted {r['contact']:.0%}, slide mean {r['mean']:.1f} cm/s, "
+                          f"p95 {r['p95']:.1f} cm/s, {r['sliding']:.0%} of planted frames over {args.slide_speed:g} cm/s")
+            elif args.command == 'penetration':
+                for bone, r in analyze_penetration(track, args.bones.split(','), args.tolerance).items():
+                    print(f"{name} {bone}: below floor {r['frames']:.1%} of frames, mean {r['mean']:.2f} cm, max {r['max']:.2f} cm")
+            else:
+                lower, upper = args.lean_bones.split(',')
+                r = analyze_lean(track, lower, upper)
+                if r is None:
+                    print(f"{name}: not moving")
+                else:
+                    print(f"{name}: lean error RMS {r['rms']:.2f} deg, bias {r['bias']:+.2f} deg, correlation "
+                          f"{r['correlation']:.2f}, peak {r['peak_measured']:.1f} deg vs {r['peak_expected']:.1f} deg expected")
+        except KeyError as error:
+            print(f"{name}: {error.args[0]}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
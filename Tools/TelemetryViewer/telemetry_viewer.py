@@ -0,0 +1,424 @@
+#!/usr/bin/env python3
+"""
+Live Procedural Locomotion Telemetry Viewer
+Attach to a running game with `pls.Telemetry.Enable 1` and plot its characters' locomotion
+state as it happens. Reads the shared-memory ring described in
+Source/ProceduralLocomotionSystem/Public/ProceduralLocomotionTelemetryLayout.h.
+
+Usage:
+    python3 Tools/TelemetryViewer/telemetry_viewer.py               # plot live
+    python3 Tools/TelemetryViewer/telemetry_viewer.py --dump        # print frames, no display
+    python3 Tools/TelemetryViewer/telemetry_viewer.py --fake-writer # publish the demo crowd instead of a game
+
+Controls (plot):
+    N / P - Select next / previous character
+    ESC   - Quit
+"""
+
+import argparse
+import mmap
+import os
+import signal
+import sys
+import time
+
+import numpy as np
+
+MAGIC = 0x54534C50
+VERSION = 1
+
+# Mirrors of the structs in ProceduralLocomotionTelemetryLayout.h.
+REGION_HEADER = np.dtype([
+    ('magic', '<u4'), ('version', '<u4'), ('header_size', '<u4'), ('frame_slot_size', '<u4'),
+    ('frame_capacity', '<u4'), ('record_capacity', '<u4'), ('record_size', '<u4'),
+    ('writer_process_id', '<u4'), ('frames_written', '<u8'), ('records_dropped', '<u8'),
+    ('reserved', 'u1', 16),
+])
+FRAME_HEADER = np.dtype([
+    ('sequence', '<u8'), ('frame_number', '<u8'), ('world_time', '<f8'),
+    ('num_records', '<u4'), ('reserved', '<u4'),
+])
+CHARACTER_RECORD = np.dtype([
+    ('id', '<u4'), ('flags', '<u4'), ('position', '<f4', 3), ('velocity', '<f4', 3),
+    ('yaw', '<f4'), ('ground_speed', '<f4'), ('direction', '<f4'), ('lean_angle', '<f4'),
+    ('phase', '<f4'), ('left_foot_offset', '<f4'), ('right_foot_offset', '<f4'),
+    ('pelvis_offset', '<f4'), ('foot_ik_alpha', '<f4'), ('reserved', '<f4'),
+])
+assert REGION_HEADER.itemsize == 64 and FRAME_HEADER.itemsize == 32 and CHARACTER_RECORD.itemsize == 72
+
+FLAG_ACCELERATING = 1 << 0
+FLAG_LEANING = 1 << 1
+FLAG_FOOT_IK = 1 << 2
+FLAG_PROCEDURAL_BONE = 1 << 3
+
+
+def _map_region(name, size, write=False):
+    """Maps the named region the way FPlatformMemory::MapNamedSharedMemoryRegion creates it."""
+    if os.name == 'nt':
+        return mmap.mmap(-1, size, tagname=name, access=mmap.ACCESS_WRITE if write else mmap.ACCESS_READ)
+    path = os.path.join('/dev/shm', name.lstrip('/'))
+    flags = os.O_RDWR | os.O_CREAT if write else os.O_RDONLY
+    fd = os.open(path, flags, 0o600)
+    try:
+        if write:
+            os.ftruncate(fd, size)
+        if size == 0:
+            size = os.fstat(fd).st_size
+        return mmap.mmap(fd, size, access=mmap.ACCESS_WRITE if write else mmap.ACCESS_READ)
+    finally:
+        os.close(fd)
+
+
+class TelemetryReader:
+    """Lock-free reader of the telemetry ring; never blocks the writer."""
+
+    def __init__(self, name):
+        self.name = name
+        self.region = None
+        self.header = None
+        self.last_frame = -1
+
+    def attach(self):
+        """Maps the region if a compatible writer is publishing. Returns True when attached."""
+        if self.region is not None:
+            if self._header()['magic'] == MAGIC:
+                return True
+            self.detach()  # writer stopped or restarted
+
+        try:
+            region = _map_region(self.name, REGION_HEADER.itemsize if os.name == 'nt' else 0)
+        except (FileNotFoundError, OSError):
+            return False
+        header = np.frombuffer(region, REGION_HEADER, count=1)[0].copy()
+        if header['magic'] != MAGIC:
+            region.close()
+            return False
+        if header['version'] != VERSION or header['record_size'] != CHARACTER_RECORD.itemsize:
+            region.close()
+            raise RuntimeError(f"telemetry region '{self.name}' is version {header['version']}, "
+                               f"viewer expects {VERSION}")
+
+        size = int(header['header_size']) + int(header['frame_capacity']) * int(header['frame_slot_size'])
+        if len(region) < size:
+            region.close()
+            region = _map_region(self.name, size)
+        self.region = region
+        self.header = header
+        self.last_frame = -1
+        return True
+
+    def detach(self):
+        if self.region is not None:
+            self.region.close()
+        self.region = None
+        self.header = None
+
+    def _header(self):
+        return np.frombuffer(self.region, REGION_HEADER, count=1)[0]
+
+    def frames_written(self):
+        return int(self._header()['frames_written'])
+
+    def records_dropped(self):
+        return int(self._header()['records_dropped'])
+
+    def read_frame(self, frame_index):
+        """Copies one frame. Returns (frame header, records) or None if it was overwritten."""
+        header = self.header
+        offset = int(header['header_size']) + (frame_index % int(header['frame_capacity'])) * int(header['frame_slot_size'])
+        expected = 2 * frame_index + 2
+
+        slot = np.frombuffer(self.region, np.uint8, count=int(header['frame_slot_size']), offset=offset)
+        sequence = slot[:8].view('<u8')
+        if sequence[0] != expected:
+            return None
+        frame = slot[:FRAME_HEADER.itemsize].view(FRAME_HEADER)[0].copy()
+        count = min(int(frame['num_records']), int(header['record_capacity']))
+        records = slot[FRAME_HEADER.itemsize:FRAME_HEADER.itemsize + count * CHARACTER_RECORD.itemsize] \
+            .view(CHARACTER_RECORD).copy()
+        if sequence[0] != expected:
+            return None  # the writer lapped us mid-copy
+        return frame, records
+
+    def poll(self):
+        """Yields every frame published since the last poll that is still intact, oldest first."""
+        written = self.frames_written()
+        first = max(self.last_frame + 1, written - int(self.header['frame_capacity']))
+        for index in range(first, written):
+            result = self.read_frame(index)
+            if result is not None:
+                yield result
+        self.last_frame = max(self.last_frame, written - 1)
+
+
+class FakeWriter:
+    """Publishes the demo crowd from locomotion_backend in the game's layout, for testing
+    the viewer (or other readers) without running Unreal."""
+
+    def __init__(self, name, characters, frame_capacity=64):
+        sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+        import locomotion_backend as backend
+        self.backend = backend
+
+        self.name = name
+        self.params = backend.make_params()
+        self.states = backend.make_states(characters, params=self.params)
+        self.phase = np.zeros(characters, dtype=np.float32)
+        self.frame_capacity = frame_capacity
+        self.slot_size = FRAME_HEADER.itemsize + characters * CHARACTER_RECORD.itemsize
+        size = REGION_HEADER.itemsize + frame_capacity * self.slot_size
+        self.region = _map_region(name, size, write=True)
+        self.region[:] = bytes(size)
+
+        header = np.frombuffer(self.region, REGION_HEADER, count=1)
+        header['version'] = VERSION
+        header['header_size'] = REGION_HEADER.itemsize
+        header['frame_slot_size'] = self.slot_size
+        header['frame_capacity'] = frame_capacity
+        header['record_capacity'] = characters
+        header['record_size'] = CHARACTER_RECORD.itemsize
+        header['writer_process_id'] = os.getpid()
+        header['magic'] = MAGIC
+        self.header = header
+        self.frames_written = 0
+
+    def step(self, dt):
+        backend = self.backend
+        backend.update(self.states, dt, 'path', self.params)
+        s = self.states
+        # Demo units are metres; the game publishes centimetres.
+        self.phase = np.mod(self.phase + s[:, backend.GROUND_SPEED] * dt / 1.5, 1.0).astype(np.float32)
+
+        offset = REGION_HEADER.itemsize + (self.frames_written % self.frame_capacity) * self.slot_size
+        slot = np.frombuffer(self.region, np.uint8, count=self.slot_size, offset=offset)
+        sequence = slot[:8].view('<u8')
+        sequence[0] = 2 * self.frames_written + 1
+
+        records = slot[FRAME_HEADER.itemsize:].view(CHARACTER_RECORD)
+        records['id'] = np.arange(len(s))
+        records['flags'] = FLAG_LEANING | FLAG_PROCEDURAL_BONE
+        records['position'][:, 0] = s[:, backend.POS_X] * 100.0
+        records['position'][:, 1] = s[:, backend.POS_Y] * 100.0
+        records['velocity'][:, 0] = s[:, backend.VEL_X] * 100.0
+        records['velocity'][:, 1] = s[:, backend.VEL_Y] * 100.0
+        records['yaw'] = np.degrees(s[:, backend.ROTATION])
+        records['ground_speed'] = s[:, backend.GROUND_SPEED] * 100.0
+        records['lean_angle'] = s[:, backend.LEAN_ANGLE]
+        records['phase'] = self.phase
+
+        frame = slot[:FRAME_HEADER.itemsize].view(FRAME_HEADER)
+        frame['frame_number'] = self.frames_written
+        frame['world_time'] = s[0, backend.TIME]
+        frame['num_records'] = len(s)
+
+        sequence[0] = 2 * self.frames_written + 2
+        self.frames_written += 1
+        self.header['frames_written'] = self.frames_written
+
+    def close(self):
+        self.header['magic'] = 0
+        del self.header  # release the buffer export before closing the mapping
+        self.region.close()
+        if os.name != 'nt':
+            os.unlink(os.path.join('/dev/shm', self.name.lstrip('/')))
+
+
+class TelemetryRenderer:
+    """Top-down view of every published character plus history plots of the selected one."""
+
+    def __init__(self, reader, history):
+        import matplotlib.pyplot as plt
+        self.plt = plt
+        self.reader = reader
+        self.history = history
+        self.selected_index = 0
+        self.selected_id = None
+        self.samples = {}  # character id -> list of (time, speed, lean, left, right, pelvis, phase)
+
+        self.fig = plt.figure(figsize=(16, 8))
+        self.fig.canvas.manager.set_window_title(f"Procedural Locomotion Telemetry - {reader.name}")
+        self.fig.suptitle('Live Procedural Locomotion Telemetry', fontsize=16, fontweight='bold')
+        grid = self.fig.add_gridspec(3, 2)
+
+        self.ax_map = self.fig.add_subplot(grid[:, 0])
+        self.ax_map.set_aspect('equal')
+        self.ax_map.grid(True, alpha=0.3)
+        self.ax_map.set_title('Characters (top-down, m) - N/P to select')
+        self.crowd = self.ax_map.scatter([], [], s=20, c=[], cmap='coolwarm', vmin=-20, vmax=20)
+        self.selected_marker, = self.ax_map.plot([], [], 'ko', markersize=12, fillstyle='none', markeredgewidth=2)
+        self.heading_line, = self.ax_map.plot([], [], 'k-', linewidth=2)
+        self.trail_line, = self.ax_map.plot([], [], 'b--', alpha=0.3, linewidth=1)
+        self.status_text = self.ax_map.text(0.02, 0.98, '', transform=self.ax_map.transAxes, va='top',
+                                            family='monospace', fontsize=9,
+                                            bbox=dict(boxstyle='round', facecolor='wheat', alpha=0.8))
+
+        self.ax_speed = self.fig.add_subplot(grid[0, 1])
+        self.ax_speed.set_ylabel('Speed (cm/s)')
+        self.speed_line, = self.ax_speed.plot([], [], 'b-')
+        self.ax_lean = self.fig.add_subplot(grid[1, 1], sharex=self.ax_speed)
+        self.ax_lean.set_ylabel('Lean (deg) / phase')
+        self.lean_line, = self.ax_lean.plot([], [], 'r-', label='Lean')
+        self.phase_line, = self.ax_lean.plot([], [], 'g-', alpha=0.5, label='Phase x 10')
+        self.ax_lean.legend(loc='upper right', fontsize=8)
+        self.ax_feet = self.fig.add_subplot(grid[2, 1], sharex=self.ax_speed)
+        self.ax_feet.set_ylabel('Offset (cm)')
+        self.ax_feet.set_xlabel('World time (s)')
+        self.left_line, = self.ax_feet.plot([], [], 'r-', label='Left foot')
+        self.right_line, = self.ax_feet.plot([], [], 'g-', label='Right foot')
+        self.pelvis_line, = self.ax_feet.plot([], [], 'b-', label='Pelvis')
+        self.ax_feet.legend(loc='upper right', fontsize=8)
+        for ax in (self.ax_speed, self.ax_lean, self.ax_feet):
+            ax.grid(True, alpha=0.3)
+
+        self.latest = None
+        self.fig.canvas.mpl_connect('key_press_event', self.on_key_press)
+
+    def on_key_press(self, event):
+        if event.key == 'n':
+            self.selected_index += 1
+            self.selected_id = None
+        elif event.key == 'p':
+            self.selected_index -= 1
+            self.selected_id = None
+        elif event.key == 'escape':
+            self.plt.close(self.fig)
+
+    def _ingest(self):
+        for frame, records in self.reader.poll():
+            self.latest = (frame, records)
+            now = float(frame['world_time'])
+            for record in records:
+                samples = self.samples.setdefault(int(record['id']), [])
+                samples.append((now, record['ground_speed'], record['lean_angle'], record['left_foot_offset'],
+                                record['right_foot_offset'], record['pelvis_offset'], record['phase'],
+                                record['position'][0] / 100.0, record['position'][1] / 100.0))
+                if len(samples) > self.history:
+                    del samples[:len(samples) - self.history]
+
+    def update_frame(self, _):
+        try:
+            attached = self.reader.attach()
+        except RuntimeError as error:
+            self.status_text.set_text(str(error))
+            return
+        if not attached:
+            self.status_text.set_text(f"Waiting for '{self.reader.name}'...\n(pls.Telemetry.Enable 1)")
+            return
+
+        self._ingest()
+        if self.latest is None:
+            return
+        frame, records = self.latest
+        if len(records) == 0:
+            self.status_text.set_text('No characters registered')
+            return
+
+        positions = records['position'][:, :2] / 100.0
+        self.crowd.set_offsets(positions)
+        self.crowd.set_array(records['lean_angle'])
+        low, high = positions.min(axis=0) - 2.0, positions.max(axis=0) + 2.0
+        self.ax_map.set_xlim(low[0], high[0])
+        self.ax_map.set_ylim(low[1], high[1])
+
+        ids = records['id']
+        if self.selected_id is None or self.selected_id not in ids:
+            self.selected_index %= len(records)
+            self.selected_id = int(ids[self.selected_index])
+        record = records[int(np.flatnonzero(ids == self.selected_id)[0])]
+
+        x, y = record['position'][0] / 100.0, record['position'][1] / 100.0
+        yaw = np.radians(record['yaw'])
+        self.selected_marker.set_data([x], [y])
+        self.heading_line.set_data([x, x + np.cos(yaw)], [y, y + np.sin(yaw)])
+
+        history = np.array(self.samples.get(self.selected_id, []), dtype=np.float64)
+        if len(history):
+            t = history[:, 0]
+            self.trail_line.set_data(history[:, 7], history[:, 8])
+            self.speed_line.set_data(t, history[:, 1])
+            self.lean_line.set_data(t, history[:, 2])
+            self.phase_line.set_data(t, history[:, 6] * 10.0)
+            self.left_line.set_data(t, history[:, 3])
+            self.right_line.set_data(t, history[:, 4])
+            self.pelvis_line.set_data(t, history[:, 5])
+            for ax in (self.ax_speed, self.ax_lean, self.ax_feet):
+                ax.relim()
+                ax.autoscale_view()
+
+        flags = int(record['flags'])
+        layers = ' '.join(name for bit, name in ((FLAG_LEANING, 'Lean'), (FLAG_FOOT_IK, 'FootIK'),
+                                                 (FLAG_PROCEDURAL_BONE, 'Bone')) if flags & bit) or 'none'
+        self.status_text.set_text(
+            f"Frame:      {int(frame['frame_number'])}\n"
+            f"Characters: {len(records)} (dropped {self.reader.records_dropped()})\n"
+            f"Selected:   {self.selected_id}\n"
+            f"Speed:      {record['ground_speed']:.1f} cm/s\n"
+            f"Direction:  {record['direction']:.1f} deg\n"
+            f"Lean:       {record['lean_angle']:.2f} deg\n"
+            f"Phase:      {record['phase']:.2f}\n"
+            f"Accel:      {'yes' if flags & FLAG_ACCELERATING else 'no'}\n"
+            f"Layers:     {layers}")
+
+    def run(self, interval_ms):
+        import matplotlib.animation as animation
+        anim = animation.FuncAnimation(self.fig, self.update_frame, interval=interval_ms, cache_frame_data=False)
+        self.plt.tight_layout()
+        self.plt.show()
+        return anim
+
+
+def dump(reader, interval):
+    """Prints a one-line summary of each new frame; useful over SSH or in CI."""
+    while not reader.attach():
+        time.sleep(interval)
+    print(f"Attached to '{reader.name}' (writer pid {int(reader.header['writer_process_id'])}, "
+          f"{int(reader.header['frame_capacity'])} frames x {int(reader.header['record_capacity'])} characters)")
+    while reader.attach():
+        for frame, records in reader.poll():
+            speed = records['ground_speed']
+            lean = records['lean_angle']
+            print(f"frame {int(frame['frame_number']):8d}  t={float(frame['world_time']):8.3f}  "
+                  f"chars={len(records):4d}  "
+                  f"speed avg={speed.mean() if len(speed) else 0.0:7.1f}  "
+                  f"|lean| max={np.abs(lean).max() if len(lean) else 0.0:6.2f}")
+        time.sleep(interval)
+    print('Writer stopped publishing')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Live viewer for procedural locomotion telemetry.')
+    parser.add_argument('--name', default='PLSTelemetry', help='Shared-memory region name (pls.Telemetry.Name)')
+    parser.add_argument('--history', type=int, default=600, help='Samples kept per character for the plots')
+    parser.add_argument('--interval', type=int, default=33, help='Refresh interval in milliseconds')
+    parser.add_argument('--dump', action='store_true', help='Print frame summaries instead of plotting')
+    parser.add_argument('--fake-writer', type=int, metavar='CHARACTERS', nargs='?', const=16,
+                        help='Publish a simulated crowd into the region instead of reading it')
+    args = parser.parse_args()
+
+    if args.fake_writer is not None:
+        writer = FakeWriter(args.name, args.fake_writer)
+        signal.signal(signal.SIGTERM, signal.default_int_handler)
+        print(f"Publishing {args.fake_writer} simulated characters to '{args.name}' (Ctrl+C to stop)")
+        try:
+            while True:
+                writer.step(1.0 / 60.0)
+                time.sleep(1.0 / 60.0)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            writer.close()
+        return
+
+    reader = TelemetryReader(args.name)
+    if args.dump:
+        try:
+            dump(reader, args.interval / 1000.0)
+        except KeyboardInterrupt:
+            pass
+        return
+
+    TelemetryRenderer(reader, args.history).run(args.interval)
+
+
+if __name__ == '__main__':
+    main()
@@ -18,160 +18,54 @@ import matplotlib.animation as animation
 from matplotlib.patches import Circle
 import math
 
+import locomotion_backend as backend
+
 class InteractiveCharacter:
-    """Character with keyboard-controlled procedural locomotion"""
+    """Character with keyboard-controlled procedural locomotion.
+
+    The state lives in a one-row table of locomotion_backend, so movement and leaning run
+    through the same C++ locomotion math as the Unreal anim instance when the native module
+    is built (numpy fallback otherwise).
+    """
     
     def __init__(self):
-        # State
-        self.position = np.array([0.0, 0.0])
-        self.velocity = np.array([0.0, 0.0])
-        self.rotation = 0.0  # radians
-        self.lean_angle = 0.0
-        self.ground_speed = 0.0
-        self.time = 0.0
-        self.last_rotation = 0.0
-        
-        # Input state
-        self.input_forward = 0.0
-        self.input_turn = 0.0
-        
-        # Movement parameters
-        self.max_speed = 3.0  # units per second
-        self.acceleration = 8.0
-        self.turn_speed = 2.5  # radians per second
-        self.friction = 0.85
-        
-        # Animation parameters (from Unreal C++ implementation)
-        self.max_lean_angle = 20.0  # degrees
-        self.lean_interp_speed = 6.0
-        self.head_pitch_amplitude = 10.0
-        self.head_yaw_amplitude = 10.0
-        self.head_oscillation_speed = 1.5
-        
-        # Skeleton proportions
-        self.body_height = 1.8
-        self.head_size = 0.2
-        self.leg_length = 0.9
+        # Movement (max speed 3 u/s, accel 8, turn 2.5 rad/s, friction 0.85) and animation
+        # parameters (from the Unreal C++ implementation) are the backend defaults.
+        self.params = backend.make_params(min_stride_speed=0.5)
+        self.states = np.zeros((1, backend.NUM_STATE_FIELDS), dtype=np.float32)
+        self.row = self.states[0]
+        
+    def _field(index):
+        return property(lambda self: float(self.row[index]),
+                        lambda self, value: self.row.__setitem__(index, value))
+    
+    time = _field(backend.TIME)
+    rotation = _field(backend.ROTATION)  # radians
+    lean_angle = _field(backend.LEAN_ANGLE)
+    ground_speed = _field(backend.GROUND_SPEED)
+    input_forward = _field(backend.INPUT_FORWARD)
+    input_turn = _field(backend.INPUT_TURN)
+    del _field
+    
+    @property
+    def position(self):
+        return self.row[backend.POS_X:backend.POS_Y + 1]
+    
+    @property
+    def velocity(self):
+        return self.row[backend.VEL_X:backend.VEL_Y + 1]
+    
+    @velocity.setter
+    def velocity(self, value):
+        self.row[backend.VEL_X:backend.VEL_Y + 1] = value
         
     def update(self, dt):
         """Update character state based on input"""
-        self.time += dt
-        
-        # Update rotation from input
-        if self.input_turn != 0:
-            rotation_change = self.input_turn * self.turn_speed * dt
-            self.last_rotation = self.rotation
-            self.rotation += rotation_change
-        
-        # Calculate target velocity from input
-        cos_r = math.cos(self.rotation)
-        sin_r = math.sin(self.rotation)
-        
-        target_velocity = np.array([
-            self.input_forward * cos_r * self.max_speed,
-            self.input_forward * sin_r * self.max_speed
-        ])
-        
-        # Apply acceleration toward target velocity
-        velocity_diff = target_velocity - self.velocity
-        accel_magnitude = min(self.acceleration * dt, np.linalg.norm(velocity_diff))
-        
-        if np.linalg.norm(velocity_diff) > 0.001:
-            velocity_diff = velocity_diff / np.linalg.norm(velocity_diff) * accel_magnitude
-            self.velocity += velocity_diff
-        
-        # Apply friction
-        self.velocity *= self.friction
-        
-        # Update position
-        self.position += self.velocity * dt
-        
-        # Calculate ground speed
-        self.ground_speed = np.linalg.norm(self.velocity)
-        
-        # Calculate lean angle based on turning (like Unreal implementation)
-        yaw_rate = (self.rotation - self.last_rotation) / max(dt, 0.001)
-        self.last_rotation = self.rotation
-        
-        # Convert yaw rate to lean angle (procedural leaning)
-        target_lean = math.degrees(yaw_rate) * 0.5
-        target_lean = np.clip(target_lean, -self.max_lean_angle, self.max_lean_angle)
-        
-        # Interpolate lean angle smoothly
-        self.lean_angle += (target_lean - self.lean_angle) * self.lean_interp_speed * dt
+        backend.update(self.states, dt, 'input', self.params)
         
     def get_skeleton_points(self):
         """Calculate skeleton joint positions for rendering"""
-        x, y = self.position
-        rot = self.rotation
-        
-        # Apply lean
-        lean_rad = math.radians(self.lean_angle)
-        
-        cos_r = math.cos(rot)
-        sin_r = math.sin(rot)
-        
-        def rotate_point(px, py):
-            """Rotate and position point"""
-            px_lean = px * math.cos(lean_rad)
-            return (x + px_lean * cos_r - py * sin_r,
-                    y + px_lean * sin_r + py * cos_r)
-        
-        # Hip (base)
-        hip = (x, y)
-        
-        # Spine top
-        spine_top = rotate_point(0, self.body_height * 0.6)
-        
-        # Head with procedural oscillation
-        head_time = self.time * self.head_oscillation_speed
-        head_pitch = math.sin(head_time) * math.radians(self.head_pitch_amplitude)
-        head_yaw = math.cos(head_time) * math.radians(self.head_yaw_amplitude)
-        
-        head_offset_x = self.head_size * math.sin(head_yaw)
-        head_offset_y = self.head_size * math.cos(head_pitch)
-        
-        head_x = spine_top[0] + head_offset_x * cos_r
-        head_y = spine_top[1] + head_offset_y + 0.3
-        head = (head_x, head_y)
-        
-        # Procedural walk cycle for legs
-        stride_time = self.time * max(self.ground_speed, 0.5) * 2.0
-        
-        # Left leg
-        left_phase = math.sin(stride_time)
-        left_foot = rotate_point(
-            -0.2 + left_phase * 0.3,
-            -self.leg_length + abs(left_phase) * 0.2
-        )
-        
-        # Right leg
-        right_phase = math.sin(stride_time + math.pi)
-        right_foot = rotate_point(
-            0.2 + right_phase * 0.3,
-            -self.leg_length + abs(right_phase) * 0.2
-        )
-        
-        # Arms swing opposite to legs
-        left_hand = rotate_point(
-            -0.4 - right_phase * 0.2,
-            self.body_height * 0.3 - abs(right_phase) * 0.1
-        )
-        
-        right_hand = rotate_point(
-            0.4 - left_phase * 0.2,
-            self.body_height * 0.3 - abs(left_phase) * 0.1
-        )
-        
-        return {
-            'hip': hip,
-            'spine_top': spine_top,
-            'head': head,
-            'left_foot': left_foot,
-            'right_foot': right_foot,
-            'left_hand': left_hand,
-            'right_hand': right_hand,
-        }
+        return backend.skeleton_dict(backend.skeleton_points(self.states, self.params)[0])
 
 class InteractiveRenderer:
     """Interactive animation renderer with keyboard controls"""
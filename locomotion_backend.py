@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+"""
+Batch simulation backend for the procedural locomotion demos.
+
+Characters are rows of a float32 state table (see the field indices below). When the native
+`pls_native` module from Tools/LocomotionSim is importable, update() and skeleton_points()
+run the same C++ locomotion math as the Unreal anim instance, in place and without copies.
+Otherwise a vectorized numpy fallback with the same API and formulas is used.
+
+Build the native module with:
+    cmake -S Tools/LocomotionSim -B Tools/LocomotionSim/build \\
+          -Dpybind11_DIR=$(python3 -m pybind11 --cmakedir)
+    cmake --build Tools/LocomotionSim/build
+The build directory (or $PLS_NATIVE_PATH) is searched automatically.
+"""
+
+import math
+import os
+import sys
+from dataclasses import dataclass, field
+
+import numpy as np
+
+_here = os.path.dirname(os.path.abspath(__file__))
+for _path in (os.environ.get('PLS_NATIVE_PATH'), os.path.join(_here, 'Tools', 'LocomotionSim', 'build')):
+    if _path and os.path.isdir(_path) and _path not in sys.path:
+        sys.path.append(_path)
+
+try:
+    import pls_native as _native
+except ImportError:
+    _native = None
+
+NATIVE = _native is not None
+
+# State table columns (must match LocomotionSim::EStateField)
+(POS_X, POS_Y, VEL_X, VEL_Y, ROTATION, LEAN_ANGLE, GROUND_SPEED, TIME, LAST_YAW,
+ INPUT_FORWARD, INPUT_TURN, PATH_PHASE, PATH_CENTER_X, PATH_CENTER_Y) = range(14)
+NUM_STATE_FIELDS = 14
+
+# Skeleton points (must match LocomotionSim::ESkeletonPoint)
+SKELETON_POINTS = ('hip', 'spine_top', 'head', 'left_foot', 'right_foot', 'left_hand', 'right_hand')
+NUM_SKELETON_POINTS = len(SKELETON_POINTS)
+
+if NATIVE:
+    assert _native.NUM_STATE_FIELDS == NUM_STATE_FIELDS
+    assert _native.NUM_SKELETON_POINTS == NUM_SKELETON_POINTS
+
+_F = np.float32
+
+
+@dataclass
+class _LeanParams:
+    """Defaults of UProceduralLocomotionAnimInstance"""
+    max_lean_angle: float = 20.0
+    acceleration_lean_multiplier: float = 0.02
+    yaw_rate_lean_multiplier: float = 0.02
+    lean_interp_speed: float = 6.0
+
+
+@dataclass
+class _OscillationParams:
+    pitch_amplitude: float = 10.0
+    yaw_amplitude: float = 10.0
+    speed: float = 1.5
+
+
+@dataclass
+class _SimParams:
+    lean: _LeanParams = field(default_factory=_LeanParams)
+    head_oscillation: _OscillationParams = field(default_factory=_OscillationParams)
+    path_angular_speed: float = 0.3
+    path_radius_x: float = 3.0
+    path_radius_y: float = 1.5
+    walk_speed: float = 2.0
+    turn_smoothing: float = 5.0
+    max_speed: float = 3.0
+    acceleration: float = 8.0
+    turn_speed: float = 2.5
+    friction: float = 0.85
+    body_height: float = 1.8
+    head_size: float = 0.2
+    leg_length: float = 0.9
+    min_stride_speed: float = 0.0
+
+
+SimParams = _native.SimParams if NATIVE else _SimParams
+
+
+def make_params(**overrides):
+    """SimParams with the given top-level fields overridden"""
+    params = SimParams()
+    for name, value in overrides.items():
+        setattr(params, name, value)
+    return params
+
+
+def make_states(count, spacing=8.0, seed=1, params=None):
+    """Allocates and initializes a state table of `count` characters on a grid of figure-8 paths"""
+    states = np.zeros((count, NUM_STATE_FIELDS), dtype=_F)
+    initialize_states(states, spacing, seed, params)
+    return states
+
+
+def initialize_states(states, spacing=8.0, seed=1, params=None):
+    params = params or SimParams()
+    if NATIVE:
+        _native.initialize_states(states, spacing, seed, params)
+        return
+
+    count = states.shape[0]
+    columns = int(math.ceil(math.sqrt(count))) if count else 1
+    rows = np.arange(count)
+    random = seed if seed != 0 else 0x9E3779B9
+    phases = np.empty(count, dtype=_F)
+    for i in range(count):
+        # xorshift32, as in LocomotionSim.cpp
+        random ^= (random << 13) & 0xFFFFFFFF
+        random ^= random >> 17
+        random ^= (random << 5) & 0xFFFFFFFF
+        phases[i] = _F(random >> 8) * _F(2.0 * math.pi / 16777216.0)
+
+    states[:] = 0.0
+    states[:, PATH_CENTER_X] = ((rows % columns) - 0.5 * (columns - 1)) * spacing
+    states[:, PATH_CENTER_Y] = ((rows // columns) - 0.5 * (columns - 1)) * spacing
+    states[:, PATH_PHASE] = phases
+    states[:, POS_X] = states[:, PATH_CENTER_X] + _F(params.path_radius_x) * np.sin(phases)
+    states[:, POS_Y] = states[:, PATH_CENTER_Y] + _F(params.path_radius_y) * np.sin(_F(2.0) * phases)
+
+
+def _interp_to(current, target, dt, speed):
+    """FMath::FInterpTo, vectorized"""
+    if speed <= 0.0:
+        return target
+    dist = target - current
+    step = dist * _F(min(max(dt * speed, 0.0), 1.0))
+    return np.where(dist * dist < _F(1e-8), target, current + step)
+
+
+def update(states, dt, driver='path', params=None):
+    """Advances every row of `states` by dt seconds, in place"""
+    params = params or SimParams()
+    if NATIVE:
+        _native.update(states, dt, driver, params)
+        return
+
+    dt = _F(dt)
+    states[:, TIME] += dt
+    prev_vel = states[:, VEL_X:VEL_Y + 1].copy()
+    pos = states[:, POS_X:POS_Y + 1]
+    vel = states[:, VEL_X:VEL_Y + 1]
+    rot = states[:, ROTATION]
+
+    if driver == 'path':
+        t = states[:, TIME] * _F(params.path_angular_speed) + states[:, PATH_PHASE]
+        target = np.stack((states[:, PATH_CENTER_X] + _F(params.path_radius_x) * np.sin(t),
+                           states[:, PATH_CENTER_Y] + _F(params.path_radius_y) * np.sin(_F(2.0) * t)), axis=1)
+        to_target = target - pos
+        distance = np.sqrt(np.sum(to_target * to_target, axis=1))
+        far = distance > _F(0.1)
+        vel[far] = to_target[far] / distance[far, None] * _F(params.walk_speed)
+        vel[~far] *= _F(0.9)
+        pos += vel * dt
+
+        speed = np.sqrt(np.sum(vel * vel, axis=1))
+        moving = speed > _F(0.1)
+        diff = np.arctan2(vel[:, 1], vel[:, 0]) - rot
+        two_pi = _F(2.0 * math.pi)
+        diff = diff - two_pi * np.round(diff / two_pi)
+        rot[moving] += diff[moving] * _F(params.turn_smoothing) * dt
+    elif driver == 'input':
+        rot += states[:, INPUT_TURN] * _F(params.turn_speed) * dt
+        forward = states[:, INPUT_FORWARD] * _F(params.max_speed)
+        target_vel = np.stack((forward * np.cos(rot), forward * np.sin(rot)), axis=1)
+        diff = target_vel - vel
+        diff_length = np.sqrt(np.sum(diff * diff, axis=1))
+        accelerating = diff_length > _F(0.001)
+        step = np.minimum(_F(params.acceleration) * dt, diff_length)
+        vel[accelerating] += diff[accelerating] / diff_length[accelerating, None] * step[accelerating, None]
+        vel *= _F(params.friction)
+        pos += vel * dt
+    else:
+        raise ValueError("driver must be 'path' or 'input'")
+
+    states[:, GROUND_SPEED] = np.sqrt(np.sum(vel * vel, axis=1))
+
+    # Lean step of the anim instance (ProceduralLocomotionMath::StepLean)
+    safe_dt = max(dt, _F(1e-4))
+    accel = (vel - prev_vel) / safe_dt
+    local_accel_y = (accel[:, 0] * np.sin(rot) - accel[:, 1] * np.cos(rot)) * _F(100.0)
+    yaw = -np.degrees(rot).astype(_F)
+    yaw_delta = yaw - states[:, LAST_YAW]
+    yaw_delta = np.where(yaw_delta > 180.0, yaw_delta - _F(360.0),
+                         np.where(yaw_delta < -180.0, yaw_delta + _F(360.0), yaw_delta))
+    states[:, LAST_YAW] = yaw
+
+    lean = params.lean
+    target_lean = np.clip(local_accel_y * _F(lean.acceleration_lean_multiplier) +
+                          yaw_delta / safe_dt * _F(lean.yaw_rate_lean_multiplier),
+                          -lean.max_lean_angle, lean.max_lean_angle).astype(_F)
+    states[:, LEAN_ANGLE] = _interp_to(states[:, LEAN_ANGLE], target_lean, float(dt), lean.lean_interp_speed)
+
+
+def skeleton_points(states, params=None, out=None):
+    """Returns (N, NUM_SKELETON_POINTS, 2) joint positions in SKELETON_POINTS order"""
+    params = params or SimParams()
+    if NATIVE:
+        return _native.skeleton_points(states, params, out)
+
+    count = states.shape[0]
+    points = out if out is not None else np.empty((count, NUM_SKELETON_POINTS, 2), dtype=_F)
+    x, y = states[:, POS_X], states[:, POS_Y]
+    rot, time = states[:, ROTATION], states[:, TIME]
+    cos_r, sin_r = np.cos(rot), np.sin(rot)
+    lean_scale = np.cos(np.radians(states[:, LEAN_ANGLE]))
+
+    def set_rig_point(index, px, py):
+        leaned = px * lean_scale
+        points[:, index, 0] = x + leaned * cos_r - py * sin_r
+        points[:, index, 1] = y + leaned * sin_r + py * cos_r
+
+    points[:, 0, 0] = x
+    points[:, 0, 1] = y
+    set_rig_point(1, _F(0.0), _F(params.body_height * 0.6))
+
+    osc = params.head_oscillation
+    head_pitch = np.sin(time * _F(osc.speed)) * _F(osc.pitch_amplitude)
+    head_yaw = np.cos(time * _F(osc.speed)) * _F(osc.yaw_amplitude)
+    points[:, 2, 0] = points[:, 1, 0] + _F(params.head_size) * np.sin(np.radians(head_yaw)) * cos_r
+    points[:, 2, 1] = points[:, 1, 1] + _F(params.head_size) * np.cos(np.radians(head_pitch)) + _F(0.3)
+
+    stride_time = time * np.maximum(states[:, GROUND_SPEED], _F(params.min_stride_speed)) * _F(2.0)
+    left_phase = np.sin(stride_time)
+    right_phase = np.sin(stride_time + _F(math.pi))
+
+    set_rig_point(3, -0.2 + left_phase * 0.3, -params.leg_length + np.abs(left_phase) * 0.2)
+    set_rig_point(4, 0.2 + right_phase * 0.3, -params.leg_length + np.abs(right_phase) * 0.2)
+    set_rig_point(5, -0.4 - right_phase * 0.2, params.body_height * 0.3 - np.abs(right_phase) * 0.1)
+    set_rig_point(6, 0.4 - left_phase * 0.2, params.body_height * 0.3 - np.abs(left_phase) * 0.1)
+    return points
+
+
+def skeleton_dict(points):
+    """Joint positions of one character as the {'hip': (x, y), ...} dict the demos draw from"""
+    return {name: (float(points[i, 0]), float(points[i, 1])) for i, name in enumerate(SKELETON_POINTS)}
@@ -11,10 +11,13 @@ Showcases procedural animation techniques without requiring Unreal Engine:
 import numpy as np
 import matplotlib.pyplot as plt
 import matplotlib.animation as animation
+from matplotlib.collections import LineCollection
 from matplotlib.patches import Circle, Polygon
 from dataclasses import dataclass
 import math
 
+import locomotion_backend as backend
+
 @dataclass
 class CharacterState:
     """Represents the character's current state"""
@@ -27,162 +30,38 @@ class CharacterState:
     time: float
     
 class ProceduralCharacter:
-    """Character with procedural locomotion animation"""
+    """Character with procedural locomotion animation.
+
+    Simulation runs through locomotion_backend: the same C++ locomotion math as the Unreal
+    anim instance when the native module is built, a numpy fallback otherwise.
+    """
     
     def __init__(self):
-        self.state = CharacterState(
-            position=np.array([0.0, 0.0]),
-            velocity=np.array([0.0, 0.0]),
-            rotation=0.0,
-            lean_angle=0.0,
-            ground_speed=0.0,
+        # Animation parameters (matching Unreal implementation), walk speed 2 m/s and the
+        # figure-8 path are the backend defaults. A zeroed row starts at the path origin.
+        self.params = backend.SimParams()
+        self.states = np.zeros((1, backend.NUM_STATE_FIELDS), dtype=np.float32)
+        
+    @property
+    def state(self):
+        row = self.states[0]
+        return CharacterState(
+            position=row[backend.POS_X:backend.POS_Y + 1].copy(),
+            velocity=row[backend.VEL_X:backend.VEL_Y + 1].copy(),
+            rotation=float(row[backend.ROTATION]),
+            lean_angle=float(row[backend.LEAN_ANGLE]),
+            ground_speed=float(row[backend.GROUND_SPEED]),
             direction=0.0,
-            time=0.0
+            time=float(row[backend.TIME])
         )
         
-        # Animation parameters (matching Unreal implementation)
-        self.max_lean_angle = 20.0  # degrees
-        self.lean_interp_speed = 6.0
-        self.head_pitch_amplitude = 10.0
-        self.head_yaw_amplitude = 10.0
-        self.head_oscillation_speed = 1.5
-        
-        # Locomotion parameters
-        self.walk_speed = 2.0
-        self.turn_rate = 90.0  # degrees per second
-        
-        # Skeleton proportions (relative units)
-        self.body_height = 1.8
-        self.head_size = 0.2
-        self.leg_length = 0.9
-        self.arm_length = 0.6
-        
-        # Movement path (creates a figure-8 pattern to show leaning)
-        self.path_index = 0
-        
     def update(self, dt):
         """Update character state (called each frame)"""
-        self.state.time += dt
-        
-        # Create a figure-8 movement path to showcase leaning
-        t = self.state.time * 0.3
-        target_x = 3.0 * math.sin(t)
-        target_y = 1.5 * math.sin(2 * t)
-        
-        # Calculate velocity toward target
-        target_pos = np.array([target_x, target_y])
-        direction_to_target = target_pos - self.state.position
-        distance = np.linalg.norm(direction_to_target)
-        
-        if distance > 0.1:
-            direction_to_target /= distance
-            self.state.velocity = direction_to_target * self.walk_speed
-        else:
-            self.state.velocity *= 0.9
-            
-        # Update position
-        self.state.position += self.state.velocity * dt
-        
-        # Calculate ground speed and direction
-        self.state.ground_speed = np.linalg.norm(self.state.velocity)
-        
-        # Update rotation to face movement direction
-        angle_diff = 0.0
-        if self.state.ground_speed > 0.1:
-            target_rotation = math.atan2(self.state.velocity[1], self.state.velocity[0])
-            # Smooth rotation
-            angle_diff = target_rotation - self.state.rotation
-            # Normalize to [-pi, pi]
-            while angle_diff > math.pi:
-                angle_diff -= 2 * math.pi
-            while angle_diff < -math.pi:
-                angle_diff += 2 * math.pi
-            self.state.rotation += angle_diff * 5.0 * dt
-            
-        # Calculate lean angle based on turning rate (like Unreal implementation)
-        yaw_rate = angle_diff / max(dt, 0.001)  # degrees per second
-        target_lean = yaw_rate * 0.3  # Convert to lean degrees
-        target_lean = np.clip(target_lean, -self.max_lean_angle, self.max_lean_angle)
-        
-        # Interpolate lean angle
-        self.state.lean_angle += (target_lean - self.state.lean_angle) * self.lean_interp_speed * dt
+        backend.update(self.states, dt, 'path', self.params)
         
     def get_skeleton_points(self):
         """Calculate skeleton joint positions for rendering"""
-        # Base position
-        x, y = self.state.position
-        rot = self.state.rotation
-        
-        # Apply lean (tilt the whole body)
-        lean_rad = math.radians(self.state.lean_angle)
-        
-        # Rotation matrix
-        cos_r = math.cos(rot)
-        sin_r = math.sin(rot)
-        
-        def rotate_point(px, py):
-            """Rotate point around character facing direction"""
-            # Apply lean
-            px_lean = px * math.cos(lean_rad)
-            # Apply rotation
-            return (x + px_lean * cos_r - py * sin_r,
-                    y + px_lean * sin_r + py * cos_r)
-        
-        # Hip
-        hip = (x, y)
-        
-        # Spine top
-        spine_top = rotate_point(0, self.body_height * 0.6)
-        
-        # Head with procedural oscillation
-        head_time = self.state.time * self.head_oscillation_speed
-        head_pitch = math.sin(head_time) * math.radians(self.head_pitch_amplitude)
-        head_yaw = math.cos(head_time) * math.radians(self.head_yaw_amplitude)
-        
-        head_offset_x = self.head_size * math.sin(head_yaw)
-        head_offset_y = self.head_size * math.cos(head_pitch)
-        
-        head_x = spine_top[0] + head_offset_x * cos_r
-        head_y = spine_top[1] + head_offset_y + 0.3
-        head = (head_x, head_y)
-        
-        # Legs - procedural walk cycle
-        stride_time = self.state.time * self.state.ground_speed * 2.0
-        
-        # Left leg
-        left_phase = math.sin(stride_time)
-        left_foot = rotate_point(
-            -0.2 + left_phase * 0.3,
-            -self.leg_length + abs(left_phase) * 0.2
-        )
-        
-        # Right leg
-        right_phase = math.sin(stride_time + math.pi)
-        right_foot = rotate_point(
-            0.2 + right_phase * 0.3,
-            -self.leg_length + abs(right_phase) * 0.2
-        )
-        
-        # Arms - swing opposite to legs
-        left_hand = rotate_point(
-            -0.4 - right_phase * 0.2,
-            self.body_height * 0.3 - abs(right_phase) * 0.1
-        )
-        
-        right_hand = rotate_point(
-            0.4 - left_phase * 0.2,
-            self.body_height * 0.3 - abs(left_phase) * 0.1
-        )
-        
-        return {
-            'hip': hip,
-            'spine_top': spine_top,
-            'head': head,
-            'left_foot': left_foot,
-            'right_foot': right_foot,
-            'left_hand': left_hand,
-            'right_hand': right_hand,
-        }
+        return backend.skeleton_dict(backend.skeleton_points(self.states, self.params)[0])
 
 class AnimationRenderer:
     """Renders and animates the procedural character"""
@@ -329,6 +208,41 @@ class AnimationRenderer:
         
         return anim
 
+class CrowdRenderer:
+    """Draws a crowd of characters driven by one batch backend update per frame"""
+    
+    # Skeleton segments as (from, to) indices into backend.SKELETON_POINTS
+    SEGMENTS = ((0, 1), (1, 2), (0, 3), (0, 4), (1, 5), (1, 6))
+    
+    def __init__(self, count):
+        self.params = backend.SimParams()
+        self.states = backend.make_states(count, spacing=8.0, seed=1, params=self.params)
+        self.segments = np.empty((count * len(self.SEGMENTS), 2, 2), dtype=np.float32)
+        self.points = None
+        
+        extent = 4.0 * math.ceil(math.sqrt(count)) + 4.0
+        self.fig, self.ax = plt.subplots(figsize=(10, 10))
+        self.ax.set_xlim(-extent, extent)
+        self.ax.set_ylim(-extent, extent)
+        self.ax.set_aspect('equal')
+        self.ax.set_title(f'{count} characters ({"native" if backend.NATIVE else "numpy"} backend)')
+        self.lines = LineCollection([], linewidths=0.8)
+        self.ax.add_collection(self.lines)
+        
+    def update_frame(self, frame):
+        backend.update(self.states, 1.0 / 30.0, 'path', self.params)
+        self.points = backend.skeleton_points(self.states, self.params, out=self.points)
+        for i, (a, b) in enumerate(self.SEGMENTS):
+            self.segments[i::len(self.SEGMENTS), 0] = self.points[:, a]
+            self.segments[i::len(self.SEGMENTS), 1] = self.points[:, b]
+        self.lines.set_segments(self.segments)
+        return (self.lines,)
+    
+    def run(self):
+        anim = animation.FuncAnimation(self.fig, self.update_frame, frames=600, interval=33, blit=True)
+        plt.show()
+        return anim
+
 def main():
     """Main entry point"""
     print("=" * 60)
@@ -348,12 +262,18 @@ def main():
     print("\n" + "=" * 60)
     print("\nStarting animation... (Close window to exit)")
     print("To save as video, use: --save animation.mp4")
+    print("To simulate a crowd, use: --crowd 2000")
+    print(f"Simulation backend: {'native (pls_native)' if backend.NATIVE else 'numpy fallback'}")
     print("=" * 60 + "\n")
     
+    import sys
+    if len(sys.argv) > 2 and sys.argv[1] == '--crowd':
+        CrowdRenderer(int(sys.argv[2])).run()
+        return
+    
     renderer = AnimationRenderer()
     
     # Check if save argument provided
-    import sys
     save_path = None
     if len(sys.argv) > 2 and sys.argv[1] == '--save':
         save_path = sys.argv[2]